@@ -105,12 +105,10 @@ void CommManager::send(const Message& message){
 	bool ret = true;
 	uint32_t trial_cnt = 0;
 	zmq::message_t msg;
-	// Data serialized.
-	std::string serializedData;
-	message.message->SerializeToString(&serializedData);
-	const unsigned sz = serializedData.length();
+	// Serialize straight into the 0MQ message, avoiding an intermediate string.
+	const size_t sz = message.message->ByteSizeLong();
 	msg.rebuild(sz);
-	memcpy((void *) msg.data (), serializedData.c_str(), sz);
+	message.message->SerializeWithCachedSizesToArray(static_cast<uint8_t*>(msg.data()));
 	// Try sending the message.
 	try {
 		do {
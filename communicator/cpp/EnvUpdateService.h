@@ -0,0 +1,181 @@
+/*
+ * EnvUpdateService.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef ENVUPDATESERVICE_H_
+#define ENVUPDATESERVICE_H_
+
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <poll.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/inotify.h>
+
+namespace communicator {
+
+/*
+ * Immutable snapshot of the environment parameters. A new one is created every time the file is parsed.
+ */
+struct EnvSnapshot {
+	double			competition_center_freq;
+	double			competition_bw;
+	// Increases by one every time a new snapshot is published. The first snapshot has version 1.
+	uint64_t		version;
+};
+
+/*
+ * EnvUpdateService watches the environment file with inotify and parses it in its own thread whenever it is written.
+ * Each successful parse publishes a new immutable snapshot, which is swapped in atomically, so readers never wait on
+ * disk or on the parser. A failed parse keeps the previous snapshot.
+ * The file is also parsed once in the constructor, so the snapshot is up to date right after construction.
+ */
+class EnvUpdateService {
+public:
+	/*
+	 * Parses the file into a snapshot (version is set by the service)
+	 * @return False if the file does not exist or could not be parsed
+	 */
+	typedef std::function<bool(const std::string& pathname, EnvSnapshot& snapshot)> Parser;
+
+	/*
+	 * @param pathname: Path to the environment file
+	 * @param parser: Function used to parse the file
+	 */
+	EnvUpdateService(const std::string& pathname, Parser parser);
+
+	/*
+	 * Stops the watching thread
+	 */
+	virtual ~EnvUpdateService();
+
+	/*
+	 * Latest snapshot, never blocks on file I/O
+	 * @return nullptr if the file was never parsed successfully
+	 */
+	inline std::shared_ptr<const EnvSnapshot> snapshot() const { return std::atomic_load(&m_snapshot); }
+
+	/*
+	 * Number of times the file could not be parsed
+	 */
+	inline uint64_t nofParseErrors() const { return m_nof_parse_errors.load(std::memory_order_relaxed); }
+
+	// Time between checks of the running flag and, if the directory could not be watched yet, between new attempts.
+	static const int poll_timeout_ms = 100;
+
+private:
+	void parse();
+
+	bool watch();
+
+	void watching();
+
+	std::string								m_pathname;
+	std::string								m_dirname;
+	std::string								m_basename;
+	Parser									m_parser;
+	std::shared_ptr<const EnvSnapshot>		m_snapshot;
+	uint64_t								m_version;
+	int										m_inotify_fd;
+	int										m_watch_fd;
+	std::atomic<bool>						m_running;
+	std::atomic<uint64_t>					m_nof_parse_errors;
+	std::thread								m_thread;
+};
+
+
+//IMPLEMENTATION
+
+inline EnvUpdateService::EnvUpdateService(const std::string& pathname, Parser parser):
+	m_pathname(pathname), m_dirname("."), m_basename(pathname), m_parser(parser), m_snapshot(),
+	m_version(0), m_inotify_fd(-1), m_watch_fd(-1), m_running(true), m_nof_parse_errors(0), m_thread()
+{
+	size_t pos = m_pathname.find_last_of('/');
+	if(pos != std::string::npos){
+		m_dirname = (pos == 0) ? "/" : m_pathname.substr(0, pos);
+		m_basename = m_pathname.substr(pos + 1);
+	}
+	m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(m_inotify_fd < 0){
+		std::cerr << "[ENV ERROR] Not possible to create inotify instance, environment file will not be watched." << std::endl;
+	}
+	watch();
+	parse();
+	std::thread watching([this] {this->watching();});
+	m_thread.swap(watching);
+}
+
+inline EnvUpdateService::~EnvUpdateService(){
+	m_running.store(false);
+	m_thread.join();
+	if(m_inotify_fd >= 0){
+		close(m_inotify_fd);
+	}
+}
+
+// Only called from the constructor and the watching thread, so m_version needs no protection.
+inline void EnvUpdateService::parse(){
+	EnvSnapshot snapshot;
+	if(!m_parser(m_pathname, snapshot)){
+		m_nof_parse_errors.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	snapshot.version = ++m_version;
+	std::atomic_store(&m_snapshot, std::shared_ptr<const EnvSnapshot>(new EnvSnapshot(snapshot)));
+}
+
+// The directory is watched instead of the file, so that files replaced by rename are also detected.
+inline bool EnvUpdateService::watch(){
+	if(m_inotify_fd < 0){
+		return false;
+	}
+	m_watch_fd = inotify_add_watch(m_inotify_fd, m_dirname.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	return m_watch_fd >= 0;
+}
+
+inline void EnvUpdateService::watching(){
+	char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	struct pollfd pfd;
+	pfd.fd = m_inotify_fd;
+	pfd.events = POLLIN;
+	while(m_running.load()){
+		if(m_watch_fd < 0){
+			// The directory may be created after the PHY starts.
+			usleep(poll_timeout_ms*1000);
+			if(watch()){
+				parse();
+			}
+			continue;
+		}
+		if(poll(&pfd, 1, poll_timeout_ms) <= 0){
+			continue;
+		}
+		bool changed = false;
+		ssize_t len;
+		while((len = read(m_inotify_fd, buffer, sizeof(buffer))) > 0){
+			for(char* ptr = buffer; ptr < buffer + len; ptr += sizeof(struct inotify_event) + ((struct inotify_event*)ptr)->len){
+				const struct inotify_event* event = (const struct inotify_event*)ptr;
+				if(event->mask & IN_IGNORED){
+					// The directory was removed, it has to be watched again.
+					m_watch_fd = -1;
+				}else if(event->len > 0 && m_basename == event->name){
+					changed = true;
+				}
+			}
+		}
+		// Several events for the same write are handled with a single parse.
+		if(changed){
+			parse();
+		}
+	}
+}
+
+}
+
+#endif /* ENVUPDATESERVICE_H_ */
@@ -0,0 +1,133 @@
+/*
+ * LatencyHistogram.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef LATENCYHISTOGRAM_H_
+#define LATENCYHISTOGRAM_H_
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <stdint.h>
+
+namespace communicator {
+
+/*
+ * LatencyHistogram is a lock free histogram of latencies with power of two bins.
+ * Bin 0 counts latencies below 2 us and bin i (i > 0) counts latencies in [2^i, 2^(i+1)) us. The last bin also
+ * counts everything above its lower limit. It can be updated by one thread while being read by another one.
+ */
+class LatencyHistogram {
+public:
+	static const uint32_t nof_bins = 24;
+
+	LatencyHistogram();
+
+	virtual ~LatencyHistogram() {};
+
+	/*
+	 * Add a latency to the histogram
+	 * @param latency_ns: latency in nanoseconds
+	 */
+	void record(uint64_t latency_ns);
+
+	/*
+	 * Clear all the bins and statistics
+	 */
+	void reset();
+
+	inline uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+	inline uint64_t sum() const { return m_sum.load(std::memory_order_relaxed); }
+	inline uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+	inline uint64_t bin(uint32_t idx) const { return idx < nof_bins ? m_bins[idx].load(std::memory_order_relaxed) : 0; }
+
+	/*
+	 * Upper limit of a bin
+	 * @return upper limit in microseconds
+	 */
+	static inline uint64_t bin_upper_limit(uint32_t idx) { return ((uint64_t)1) << (idx + 1); }
+
+	/*
+	 * Estimate a percentile as the upper limit of the bin where it falls
+	 * @param percentile: value between 0 and 100
+	 * @return latency in microseconds (0 if the histogram is empty)
+	 */
+	uint64_t percentile(double percentile) const;
+
+	/*
+	 * Print a summary and the non empty bins of the histogram
+	 */
+	void print(std::ostream& os, const std::string& name) const;
+
+private:
+	std::atomic<uint64_t>	m_bins[nof_bins];
+	std::atomic<uint64_t>	m_count;
+	std::atomic<uint64_t>	m_sum;
+	std::atomic<uint64_t>	m_max;
+};
+
+
+//IMPLEMENTATION
+
+inline LatencyHistogram::LatencyHistogram(): m_count(0), m_sum(0), m_max(0){
+	for(uint32_t i = 0; i < nof_bins; i++){
+		m_bins[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+inline void LatencyHistogram::record(uint64_t latency_ns){
+	uint64_t latency_us = latency_ns/1000;
+	// The bin is the position of the most significant bit, found with a single instruction.
+	uint32_t idx = latency_us < 2 ? 0 : 63 - __builtin_clzll(latency_us);
+	if(idx > nof_bins - 1){
+		idx = nof_bins - 1;
+	}
+	m_bins[idx].fetch_add(1, std::memory_order_relaxed);
+	m_count.fetch_add(1, std::memory_order_relaxed);
+	m_sum.fetch_add(latency_ns, std::memory_order_relaxed);
+	uint64_t max = m_max.load(std::memory_order_relaxed);
+	while(latency_ns > max && !m_max.compare_exchange_weak(max, latency_ns, std::memory_order_relaxed));
+}
+
+inline void LatencyHistogram::reset(){
+	for(uint32_t i = 0; i < nof_bins; i++){
+		m_bins[i].store(0, std::memory_order_relaxed);
+	}
+	m_count.store(0, std::memory_order_relaxed);
+	m_sum.store(0, std::memory_order_relaxed);
+	m_max.store(0, std::memory_order_relaxed);
+}
+
+inline uint64_t LatencyHistogram::percentile(double percentile) const{
+	uint64_t total = count();
+	if(total == 0) return 0;
+	uint64_t target = (uint64_t)((percentile/100.0)*(double)total);
+	uint64_t accumulated = 0;
+	for(uint32_t i = 0; i < nof_bins; i++){
+		accumulated += bin(i);
+		if(accumulated > target || accumulated == total){
+			return bin_upper_limit(i);
+		}
+	}
+	return bin_upper_limit(nof_bins - 1);
+}
+
+inline void LatencyHistogram::print(std::ostream& os, const std::string& name) const{
+	uint64_t total = count();
+	os << name << ": " << total << " samples";
+	if(total > 0){
+		os << " - avg: " << (sum()/total)/1000 << " us - max: " << max()/1000 << " us - p50 < " << percentile(50.0) << " us - p99 < " << percentile(99.0) << " us";
+	}
+	os << std::endl;
+	for(uint32_t i = 0; i < nof_bins; i++){
+		if(bin(i) > 0){
+			os << "\t< " << bin_upper_limit(i) << " us: " << bin(i) << std::endl;
+		}
+	}
+}
+
+}
+
+#endif /* LATENCYHISTOGRAM_H_ */
@@ -10,7 +10,8 @@
 namespace communicator{
 
 AbstractLayerCommunicator::AbstractLayerCommunicator(MODULE module):
-	m_running(true), m_ownModule(module), m_threads(), m_sending(), m_mutex(), m_cv()
+	m_running(true), m_ownModule(module), m_threads(), m_sending(), m_mutex(), m_cv(),
+	m_stats_export(), m_stats_mutex(), m_stats_cv()
 {
 
 }
@@ -27,6 +28,14 @@ void AbstractLayerCommunicator::terminate_communicator() {
 		delete i.second.commManager;
 	}
 	m_sending.join();
+	// Wake up and stop the statistics export thread, if any.
+	{
+		std::lock_guard<std::mutex> lck(m_stats_mutex);
+	}
+	m_stats_cv.notify_all();
+	if(m_stats_export.joinable()){
+		m_stats_export.join();
+	}
 
 	// Optional:  Delete all global objects allocated by libprotobuf. This was added here to avoid lots of annoying unnecessary messages when running valgrind.
 	google::protobuf::ShutdownProtobufLibrary();
@@ -75,10 +84,48 @@ void AbstractLayerCommunicator::init_high_priority(std::vector<MODULE> connectTo
 
 bool AbstractLayerCommunicator::waitForMessage() const{
 	std::unique_lock<std::mutex> lck(m_mutex);
-	m_cv.wait(lck, [this]{return this->empty();});
+	m_cv.wait(lck, [this]{return !this->empty();});
 	return true;
 }
 
+std::vector<Message> AbstractLayerCommunicator::unbatch(Message& m) const{
+	std::vector<Message> messages;
+	Phy_stat_batch* batch = m.message->mutable_phy_stat_batch();
+	messages.reserve(batch->entries_size());
+	for(int i = 0; i < batch->entries_size(); i++){
+		Phy_stat_batch_entry* entry = batch->mutable_entries(i);
+		std::shared_ptr<Internal> internal = std::make_shared<Internal>();
+		internal->set_transaction_index(entry->transaction_index());
+		internal->set_owner_module(m.message->owner_module());
+		// Move the payload, the batch is not used anymore.
+		if(entry->payload_case() == Phy_stat_batch_entry::kReceiver){
+			internal->set_allocated_receiver(entry->release_receiver());
+		}else if(entry->payload_case() == Phy_stat_batch_entry::kSendr){
+			internal->set_allocated_sendr(entry->release_sendr());
+		}else{
+			continue;
+		}
+		Message single(m.source, m.destination, internal);
+		single.setCreated(m.getCreated());
+		messages.push_back(std::move(single));
+	}
+	return messages;
+}
+
+void AbstractLayerCommunicator::printQueueStats(std::ostream& os) const{
+	getQueueStats(None).print(os, "[COMM INFO] Sending queue");
+	getQueueStats(High).print(os, "[COMM INFO] High queue");
+	getQueueStats(Low).print(os, "[COMM INFO] Low queue");
+}
+
+void AbstractLayerCommunicator::notifyMessage(){
+	// Taking the mutex makes sure a waiting thread either sees the new message or is already waiting for the notification.
+	{
+		std::lock_guard<std::mutex> lck(m_mutex);
+	}
+	m_cv.notify_all();
+}
+
 AbstractLayerCommunicator::Queue AbstractLayerCommunicator::filter(const Message& m) const{
 	if(m.source == communicator::MODULE_RF_MON) return Low;
 	switch (m.message->payload_case()) {
@@ -92,6 +139,7 @@ AbstractLayerCommunicator::Queue AbstractLayerCommunicator::filter(const Message
 		case communicator::Internal::kStats:
 		case communicator::Internal::kReceiver:
 		case communicator::Internal::kSendr:
+		case communicator::Internal::kPhyStatBatch:
 			return High;
 		default:
 			return Low;
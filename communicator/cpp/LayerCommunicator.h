@@ -22,6 +22,8 @@
 #include "CommManager.h"
 #include "SafeQueue.h"
 #include "PriorityQueue.h"
+#include "LatencyHistogram.h"
+#include "utils.h"
 #include "logging/Logger.h"
 
 #define CHECK_LAYER_COMM_OUT_OF_SEQUENCE 0
@@ -40,6 +42,12 @@ struct CommManagerThreads {
 
 class AbstractLayerCommunicator{
 public:
+	enum Queue{
+		None	= 0,
+		Low		= 1,
+		High	= 2
+	};
+
 	/*
 	 * Constructor for the module
 	 * @param module: This module
@@ -92,6 +100,41 @@ public:
 		return m_cv.wait_for(lck, rel_time, [this]{return !this->empty();});
 	}
 
+	/*
+	 * Pop a message from the High queue or, if the High queue is empty, from the Low queue. If both are empty, wait until
+	 * a message is pushed in any of them or maximum rel_time. High priority messages are always served first and the
+	 * wait ends as soon as a message of either priority arrives.
+	 * The time each message spent in its queue is added to the residence time histogram of that queue.
+	 * @param rel_time: maximal time to block
+	 * @param m: the popped message
+	 * @param include_high: if False only the Low queue is served (and the High queue is left untouched)
+	 * @return the queue the message was popped from, None if we waited rel_time without a message
+	 */
+	template<class Rep, class Period>
+	Queue popWaitFor(const std::chrono::duration<Rep, Period>& rel_time, Message& m, bool include_high = true);
+
+	/*
+	 * Histogram of the time messages spent in the High or Low queue before being popped
+	 */
+	inline const LatencyHistogram& getWaitHistogram(Queue q) const { return getQueueStats(q).residence(); }
+
+	/*
+	 * Statistics of the High or Low receive queue (None returns the ones of the sending queue)
+	 */
+	virtual const SafeQueue::QueueStats& getQueueStats(Queue q) const = 0;
+
+	/*
+	 * Print the statistics of the sending, High and Low queues
+	 */
+	void printQueueStats(std::ostream& os) const;
+
+	/*
+	 * Print the statistics of all queues to stdout every period, in an own thread. Can only be started once.
+	 * @param period: time between two prints, a zero period does nothing
+	 */
+	template<class Rep, class Period>
+	void exportQueueStats(const std::chrono::duration<Rep, Period>& period);
+
 	inline MODULE getDestinationModule(uint32_t idx=0) {
 		MODULE mod;
 		if(idx < m_destModule.size()) {
@@ -103,14 +146,10 @@ public:
 	}
 
 	virtual bool empty() const = 0;
+	virtual bool highEmpty() const = 0;
+	virtual bool lowEmpty() const = 0;
 
 protected:
-	enum Queue{
-		None	= 0,
-		Low		= 1,
-		High	= 2
-	};
-
 	/*
 	 * Filter that decides if a messages belong to the high prior queue (return True) or low Priority queue (return False)
 	 */
@@ -118,6 +157,17 @@ protected:
 
 	void terminate_communicator();
 
+	/*
+	 * Split a Phy_stat_batch message into one message per PHY statistic, as if they were received one by one.
+	 * The payloads are moved out of the batch.
+	 */
+	std::vector<Message> unbatch(Message& m) const;
+
+	/*
+	 * Wake up the threads waiting for a message in any queue. Must be called after pushing into a receive queue.
+	 */
+	void notifyMessage();
+
 	virtual void receiving(CommManager* comm) = 0;
 	virtual void sending() = 0;
 
@@ -130,8 +180,46 @@ protected:
 
 	mutable std::mutex						m_mutex;
 	mutable std::condition_variable			m_cv;
+
+	std::thread								m_stats_export;
+	std::mutex								m_stats_mutex;
+	std::condition_variable					m_stats_cv;
 };
 
+template<class Rep, class Period>
+AbstractLayerCommunicator::Queue AbstractLayerCommunicator::popWaitFor(const std::chrono::duration<Rep, Period>& rel_time, Message& m, bool include_high){
+	auto deadline = std::chrono::steady_clock::now() + rel_time;
+	while(true){
+		if(include_high && highPriorityPop(m)){
+			return High;
+		}
+		if(lowPriorityPop(m)){
+			return Low;
+		}
+		std::unique_lock<std::mutex> lck(m_mutex);
+		if(!m_cv.wait_until(lck, deadline, [this, include_high]{return (include_high && !this->highEmpty()) || !this->lowEmpty();})){
+			return None;
+		}
+	}
+}
+
+template<class Rep, class Period>
+void AbstractLayerCommunicator::exportQueueStats(const std::chrono::duration<Rep, Period>& period){
+	if(period.count() <= 0 || m_stats_export.joinable()){
+		return;
+	}
+	std::chrono::steady_clock::duration interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+	std::thread exporting([this, interval] {
+		std::unique_lock<std::mutex> lck(this->m_stats_mutex);
+		while(this->m_running){
+			if(!this->m_stats_cv.wait_for(lck, interval, [this]{return !this->m_running;})){
+				this->printQueueStats(std::cout);
+			}
+		}
+	});
+	m_stats_export.swap(exporting);
+}
+
 
 /*
  * LayerCommunicator class will setup ZMQ and all queues necessary for the communication
@@ -179,6 +267,14 @@ public:
 
 	inline bool empty() const {return m_high_receive.empty() && m_low_receive.empty();}
 
+	inline bool highEmpty() const {return m_high_receive.empty();}
+
+	inline bool lowEmpty() const {return m_low_receive.empty();}
+
+	inline const SafeQueue::QueueStats& getQueueStats(Queue q) const {
+		return q == High ? m_high_receive.stats() : (q == Low ? m_low_receive.stats() : m_send.stats());
+	}
+
 protected:
 	/*
 	 * Receiving function (this will run in an own thread)
@@ -220,19 +316,26 @@ void LayerCommunicator<ContainerLow, ContainerHigh, ContainerSending>::receiving
 		try{
 			Message m;
 			if(comm->receive(m, 1000)){
+				// Queue residence time is measured from the push into the receive queue.
 				m.calculatePriority();
 				Queue q = filter(m);
 				switch (q){
 				case Low:
 					Logger::log_trace<LayerCommunicator<ContainerLow, ContainerHigh, ContainerSending>>("Received message (low queue) from {0} with transaction index ({1},{2})", communicator::MODULE_Name(m.source), (int)m.message->owner_module(), m.message->transaction_index());
 					m_low_receive.push(m);
-					m_cv.notify_all();
+					notifyMessage();
 					break;
 				case High:
 				{
 					Logger::log_trace<LayerCommunicator<ContainerLow, ContainerHigh, ContainerSending>>("Received message (high queue) from {0} with transaction index ({1}, {2})", communicator::MODULE_Name(m.source), (int)m.message->owner_module(), m.message->transaction_index());
-					m_high_receive.push(m);
-					m_cv.notify_all();
+					if(m.message->payload_case() == communicator::Internal::kPhyStatBatch){
+						for(Message& single: unbatch(m)){
+							m_high_receive.push(std::move(single));
+						}
+					}else{
+						m_high_receive.push(m);
+					}
+					notifyMessage();
 
 #if(CHECK_LAYER_COMM_OUT_OF_SEQUENCE==1)
 					static uint32_t data_cnt[2] = {0,0};
@@ -127,6 +127,9 @@ public:
 	double getPriority() const { return priority; }
 	void calculatePriority() const;
 
+	uint64_t getCreated() const { return created; }
+	void setCreated(uint64_t time) { created = time; }
+
 	communicator::MODULE						source;
 	communicator::MODULE						destination;
 	std::shared_ptr<communicator::Internal>		message;
@@ -0,0 +1,102 @@
+/*
+ * MessagePool.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef MESSAGEPOOL_H_
+#define MESSAGEPOOL_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <stdint.h>
+#include "interf.pb.h"
+
+namespace communicator {
+
+/*
+ * MessagePool keeps a fixed set of preallocated Internal messages that are handed out as shared_ptrs.
+ * A pooled message becomes free again as soon as all the other copies of its shared_ptr (e.g., the one held by the
+ * sending queue until the message is serialized) are released. Messages are never cleared when reused, so the
+ * sub-messages and the payload string keep their memory and a steady state flow does no heap allocation at all.
+ * The caller MUST therefore overwrite every field of the layout it uses.
+ * If every message of the pool is still in flight a new one is allocated on the heap and counted as a fallback.
+ */
+class MessagePool {
+public:
+	/*
+	 * Create a pool of messages
+	 * @param size: Number of preallocated messages
+	 * @param layout: Function called once for each message to create its (fixed) payload layout, i.e., its sub-messages
+	 */
+	MessagePool(uint32_t size, const std::function<void(Internal&)>& layout);
+
+	virtual ~MessagePool() {};
+
+	/*
+	 * Get a free message from the pool. If there is none, a new message is allocated.
+	 * @return message with the layout created by the layout function and the contents of its last use
+	 */
+	std::shared_ptr<Internal> acquire();
+
+	/*
+	 * Number of messages handed out by acquire()
+	 */
+	inline uint64_t acquired() const { return m_acquired.load(std::memory_order_relaxed); }
+
+	/*
+	 * Number of messages that had to be allocated because the pool was exhausted
+	 */
+	inline uint64_t fallbacks() const { return m_fallbacks.load(std::memory_order_relaxed); }
+
+	inline uint32_t size() const { return m_pool.size(); }
+
+private:
+	std::vector<std::shared_ptr<Internal>>	m_pool;
+	std::function<void(Internal&)>			m_layout;
+	uint32_t								m_next;
+	std::mutex								m_mutex;
+	std::atomic<uint64_t>					m_acquired;
+	std::atomic<uint64_t>					m_fallbacks;
+};
+
+
+//IMPLEMENTATION
+
+inline MessagePool::MessagePool(uint32_t size, const std::function<void(Internal&)>& layout):
+	m_pool(size), m_layout(layout), m_next(0), m_mutex(), m_acquired(0), m_fallbacks(0)
+{
+	for(auto& message: m_pool){
+		message = std::make_shared<Internal>();
+		m_layout(*message);
+	}
+}
+
+inline std::shared_ptr<Internal> MessagePool::acquire(){
+	m_acquired.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		// Round robin search for a message only referenced by the pool. Only this function creates new references, so a
+		// use count of 1 can not grow behind our back.
+		for(uint32_t i = 0; i < m_pool.size(); i++){
+			std::shared_ptr<Internal>& message = m_pool[m_next];
+			m_next = (m_next + 1) % m_pool.size();
+			if(message.use_count() == 1){
+				// Make sure the last user (e.g., the serialization in the sending thread) is done with the message.
+				std::atomic_thread_fence(std::memory_order_acquire);
+				return message;
+			}
+		}
+	}
+	m_fallbacks.fetch_add(1, std::memory_order_relaxed);
+	std::shared_ptr<Internal> message = std::make_shared<Internal>();
+	m_layout(*message);
+	return message;
+}
+
+}
+
+#endif /* MESSAGEPOOL_H_ */
@@ -0,0 +1,214 @@
+/*
+ * PhyStatBatcher.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef PHYSTATBATCHER_H_
+#define PHYSTATBATCHER_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <stdint.h>
+#include "LayerCommunicator.h"
+#include "MessagePool.h"
+#include "interf.pb.h"
+
+namespace communicator {
+
+/*
+ * PhyStatBatcher coalesces PHY statistics (Receive_r and Send_r payloads) into Phy_stat_batch messages.
+ * Every statistic keeps its full detail and transaction index as one entry of the batch. A batch is sent as soon as it
+ * holds max_stats entries or its oldest entry waited max_delay, whichever comes first. The delay is enforced by an own
+ * thread, so a batch is never held back waiting for more statistics.
+ * The receiving LayerCommunicator splits batches back into individual messages (see LayerCommunicator::receiving).
+ * Batches come from an own MessagePool and their entries are reused, so the steady state flow does no heap allocation
+ * and no payload copy.
+ */
+class PhyStatBatcher {
+public:
+	/*
+	 * @param comm: LayerCommunicator used to send the batches
+	 * @param source: Module sending the statistics
+	 * @param max_stats: Maximum number of statistics in one batch
+	 * @param max_delay: Maximum time a statistic waits in a batch
+	 * @param nof_pooled_batches: Number of preallocated batch messages
+	 */
+	template<class Rep, class Period>
+	PhyStatBatcher(AbstractLayerCommunicator* comm, MODULE source, uint32_t max_stats, const std::chrono::duration<Rep, Period>& max_delay, uint32_t nof_pooled_batches);
+
+	/*
+	 * Sends all the pending batches and stops the flushing thread
+	 */
+	virtual ~PhyStatBatcher();
+
+	/*
+	 * Add a statistic to the batch of a destination. The payload is swapped into the batch, not copied. The message is
+	 * left with the payload of an earlier statistic, or an empty one, and must be entirely overwritten before it is used
+	 * again, as pooled messages are anyway.
+	 * @param destination: Module the statistic is addressed to
+	 * @param stat: Internal message with a Receive_r or Send_r payload
+	 * @return False if the message does not carry PHY statistics
+	 */
+	bool add(MODULE destination, Internal&& stat);
+
+	/*
+	 * Number of batch messages that had to be allocated because the pool was exhausted
+	 */
+	inline uint64_t nofPoolFallbacks() const { return m_pool.fallbacks(); }
+
+	/*
+	 * Send all the pending batches
+	 */
+	void flush();
+
+	/*
+	 * Number of statistics added to batches
+	 */
+	inline uint64_t nofStats() const { return m_nof_stats.load(std::memory_order_relaxed); }
+
+	/*
+	 * Number of batch messages sent
+	 */
+	inline uint64_t nofBatches() const { return m_nof_batches.load(std::memory_order_relaxed); }
+
+private:
+	struct Pending{
+		std::shared_ptr<Internal>					batch;
+		// Number of entries in use. A pooled batch keeps the entries of its last use, which are overwritten first.
+		int											nof_entries;
+		std::chrono::steady_clock::time_point		deadline;
+	};
+
+	void send(MODULE destination, Pending& pending);
+
+	void flushing();
+
+	AbstractLayerCommunicator*						m_comm;
+	MODULE											m_source;
+	uint32_t										m_max_stats;
+	std::chrono::steady_clock::duration				m_max_delay;
+	MessagePool										m_pool;
+	std::map<MODULE, Pending>						m_pending;
+	bool											m_running;
+	std::mutex										m_mutex;
+	std::condition_variable							m_cv;
+	std::atomic<uint64_t>							m_nof_stats;
+	std::atomic<uint64_t>							m_nof_batches;
+	std::thread										m_thread;
+};
+
+
+//IMPLEMENTATION
+
+template<class Rep, class Period>
+PhyStatBatcher::PhyStatBatcher(AbstractLayerCommunicator* comm, MODULE source, uint32_t max_stats, const std::chrono::duration<Rep, Period>& max_delay, uint32_t nof_pooled_batches):
+	m_comm(comm), m_source(source), m_max_stats(max_stats),
+	m_max_delay(std::chrono::duration_cast<std::chrono::steady_clock::duration>(max_delay)),
+	m_pool(nof_pooled_batches, [](Internal& batch) {batch.mutable_phy_stat_batch();}),
+	m_pending(), m_running(true), m_mutex(), m_cv(), m_nof_stats(0), m_nof_batches(0), m_thread()
+{
+	std::thread flushing([this] {this->flushing();});
+	m_thread.swap(flushing);
+}
+
+inline PhyStatBatcher::~PhyStatBatcher(){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+	m_cv.notify_all();
+	m_thread.join();
+	flush();
+}
+
+inline bool PhyStatBatcher::add(MODULE destination, Internal&& stat){
+	if(stat.payload_case() != Internal::kReceiver && stat.payload_case() != Internal::kSendr){
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Pending& pending = m_pending[destination];
+	bool first = (pending.batch == nullptr);
+	if(first){
+		pending.batch = m_pool.acquire();
+		pending.batch->set_owner_module(m_source);
+		pending.nof_entries = 0;
+		pending.deadline = std::chrono::steady_clock::now() + m_max_delay;
+	}
+	Phy_stat_batch* batch = pending.batch->mutable_phy_stat_batch();
+	Phy_stat_batch_entry* entry = pending.nof_entries < batch->entries_size() ? batch->mutable_entries(pending.nof_entries):batch->add_entries();
+	pending.nof_entries++;
+	entry->set_transaction_index(stat.transaction_index());
+	if(stat.payload_case() == Internal::kReceiver){
+		entry->mutable_receiver()->Swap(stat.mutable_receiver());
+	}else{
+		entry->mutable_sendr()->Swap(stat.mutable_sendr());
+	}
+	m_nof_stats.fetch_add(1, std::memory_order_relaxed);
+	if((uint32_t)pending.nof_entries >= m_max_stats){
+		send(destination, pending);
+	}else if(first){
+		// Let the flushing thread know about the new deadline.
+		m_cv.notify_all();
+	}
+	return true;
+}
+
+inline void PhyStatBatcher::flush(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for(auto& pending: m_pending){
+		if(pending.second.batch != nullptr){
+			send(pending.first, pending.second);
+		}
+	}
+}
+
+// Must be called with m_mutex locked.
+inline void PhyStatBatcher::send(MODULE destination, Pending& pending){
+	// Drop the entries left over from the last use of the batch.
+	Phy_stat_batch* batch = pending.batch->mutable_phy_stat_batch();
+	while(batch->entries_size() > pending.nof_entries){
+		batch->mutable_entries()->RemoveLast();
+	}
+	// The transaction index of a batch is the one of its last entry.
+	pending.batch->set_transaction_index(batch->entries(batch->entries_size() - 1).transaction_index());
+	m_comm->send(Message(m_source, destination, pending.batch));
+	pending.batch.reset();
+	m_nof_batches.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void PhyStatBatcher::flushing(){
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(m_running){
+		// Find the oldest pending batch.
+		bool has_pending = false;
+		std::chrono::steady_clock::time_point deadline;
+		for(auto& pending: m_pending){
+			if(pending.second.batch != nullptr && (!has_pending || pending.second.deadline < deadline)){
+				deadline = pending.second.deadline;
+				has_pending = true;
+			}
+		}
+		if(!has_pending){
+			m_cv.wait(lock);
+			continue;
+		}
+		if(m_cv.wait_until(lock, deadline) == std::cv_status::timeout){
+			auto now = std::chrono::steady_clock::now();
+			for(auto& pending: m_pending){
+				if(pending.second.batch != nullptr && pending.second.deadline <= now){
+					send(pending.first, pending.second);
+				}
+			}
+		}
+	}
+}
+
+}
+
+#endif /* PHYSTATBATCHER_H_ */
@@ -0,0 +1,100 @@
+/*
+ * QueueStats.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef QUEUESTATS_H_
+#define QUEUESTATS_H_
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <stdint.h>
+#include "LatencyHistogram.h"
+
+namespace SafeQueue{
+
+/*
+ * QueueStats holds the instrumentation of a SafeQueue: number of pushed and popped elements, maximum depth and a
+ * histogram of the time elements spent in the queue (residence time).
+ * It is updated by the queue with its mutex locked, so there is a single writer at a time and the counters do not
+ * need atomic read-modify-write operations. Any other thread can read (or print) it at the same time.
+ */
+class QueueStats{
+public:
+	QueueStats();
+
+	virtual ~QueueStats() {};
+
+	/*
+	 * Account a push
+	 * @param depth: number of elements in the queue after the push
+	 */
+	void pushed(size_t depth);
+
+	/*
+	 * Account a pop
+	 * @param residence_ns: time the element spent in the queue in nanoseconds (0 if unknown, i.e., not recorded)
+	 */
+	void popped(uint64_t residence_ns);
+
+	/*
+	 * Clear the counters and the histogram (the maximum depth restarts from the current one)
+	 */
+	void reset(size_t depth = 0);
+
+	inline uint64_t nofPushed() const { return m_nof_pushed.load(std::memory_order_relaxed); }
+	inline uint64_t nofPopped() const { return m_nof_popped.load(std::memory_order_relaxed); }
+	inline uint64_t maxDepth() const { return m_max_depth.load(std::memory_order_relaxed); }
+
+	inline const communicator::LatencyHistogram& residence() const { return m_residence; }
+
+	/*
+	 * Print the counters and the residence time histogram
+	 */
+	void print(std::ostream& os, const std::string& name) const;
+
+private:
+	communicator::LatencyHistogram		m_residence;
+	std::atomic<uint64_t>				m_nof_pushed;
+	std::atomic<uint64_t>				m_nof_popped;
+	std::atomic<uint64_t>				m_max_depth;
+};
+
+
+//IMPLEMENTATION
+
+inline QueueStats::QueueStats(): m_residence(), m_nof_pushed(0), m_nof_popped(0), m_max_depth(0){
+
+}
+
+inline void QueueStats::pushed(size_t depth){
+	m_nof_pushed.store(m_nof_pushed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	if(depth > m_max_depth.load(std::memory_order_relaxed)){
+		m_max_depth.store(depth, std::memory_order_relaxed);
+	}
+}
+
+inline void QueueStats::popped(uint64_t residence_ns){
+	m_nof_popped.store(m_nof_popped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	if(residence_ns > 0){
+		m_residence.record(residence_ns);
+	}
+}
+
+inline void QueueStats::reset(size_t depth){
+	m_residence.reset();
+	m_nof_pushed.store(0, std::memory_order_relaxed);
+	m_nof_popped.store(0, std::memory_order_relaxed);
+	m_max_depth.store(depth, std::memory_order_relaxed);
+}
+
+inline void QueueStats::print(std::ostream& os, const std::string& name) const{
+	os << name << " - pushed: " << nofPushed() << " - popped: " << nofPopped() << " - max depth: " << maxDepth() << std::endl;
+	m_residence.print(os, name + " residence");
+}
+
+}
+
+#endif /* QUEUESTATS_H_ */
@@ -11,6 +11,7 @@
 #define SafeQueueTimeLog
 
 #include <queue>
+#include <atomic>
 #include <deque>
 #include <mutex>
 #include <chrono>
@@ -20,9 +21,24 @@
 #include "logging/Logger.h"
 #include "Message.h"
 #include "PriorityQueue.h"
+#include "QueueStats.h"
 
 namespace SafeQueue{
 
+/*
+ * Residence time stamping. Elements are stamped with SQ_NOW right before being pushed and the stamp is read back when
+ * they are popped. Only Message keeps the stamp (in its created field), for other types the residence time is not recorded.
+ */
+template<class T>
+inline void stampElement(T&, uint64_t) {}
+
+template<class T>
+inline uint64_t elementStamp(const T&) { return 0; }
+
+inline void stampElement(communicator::Message& m, uint64_t now) { if(now != 0) m.setCreated(now); }
+
+inline uint64_t elementStamp(const communicator::Message& m) { return m.getCreated(); }
+
 /*
  * SafeQueue is a tread safe queue. It can be used for all kind of types with all kind of containers.
  * @type T: Type of an element in the queue
@@ -208,41 +224,67 @@ public:
 	 */
 	void swap(SafeQueue<T, Container>& other);
 
+	/*
+	 * Counters, maximum depth and residence time histogram of the queue. It can be read while the queue is in use.
+	 */
+	inline const QueueStats& stats() const { return m_stats; }
+
+	/*
+	 * Clear the statistics of the queue
+	 */
+	void resetStats();
+
+	/*
+	 * Enable or disable the statistics (enabled by default). While disabled, elements are not stamped, the counters
+	 * are not updated and the time returned by pop is 0.
+	 */
+	inline void enableStats(bool enable) { m_stats_enabled.store(enable, std::memory_order_relaxed); }
+
+	inline bool statsEnabled() const { return m_stats_enabled.load(std::memory_order_relaxed); }
+
 private:
+	/*
+	 * Account the pop of an element. Must be called with m_mutex locked, before the element is popped.
+	 * @return the time the element spent in the queue (0 if unknown)
+	 */
+	uint64_t popped(const T& element);
+
 	Container										m_queue;
 	mutable std::mutex								m_mutex;
 	std::condition_variable							m_cv;
+	QueueStats										m_stats;
+	std::atomic<bool>								m_stats_enabled;
 };
 
 
 //IMPLEMENTATION
 template<class T, class Container>
-SafeQueue<T, Container>::SafeQueue(const Container& cnt): m_queue(cnt), m_mutex(), m_cv(){
+SafeQueue<T, Container>::SafeQueue(const Container& cnt): m_queue(cnt), m_mutex(), m_cv(), m_stats(), m_stats_enabled(true){
 
 }
 
 template<class T, class Container>
-SafeQueue<T, Container>::SafeQueue(Container&& cnt): m_queue(std::move(cnt)), m_mutex(), m_cv(){
+SafeQueue<T, Container>::SafeQueue(Container&& cnt): m_queue(std::move(cnt)), m_mutex(), m_cv(), m_stats(), m_stats_enabled(true){
 
 }
 
 template<class T, class Container>
 template<class Alloc>
-SafeQueue<T, Container>::SafeQueue(const Alloc& alloc): m_queue(alloc), m_mutex(), m_cv(){
+SafeQueue<T, Container>::SafeQueue(const Alloc& alloc): m_queue(alloc), m_mutex(), m_cv(), m_stats(), m_stats_enabled(true){
 
 }
 
 template<class T, class Container>
 template<class Alloc>
 SafeQueue<T, Container>::SafeQueue(const Container& ctnr, const Alloc& alloc): m_queue(ctnr, alloc),
-	m_mutex(), m_cv(){
+	m_mutex(), m_cv(), m_stats(), m_stats_enabled(true){
 
 }
 
 template<class T, class Container>
 template<class Alloc>
 SafeQueue<T, Container>::SafeQueue(Container&& ctnr, const Alloc& alloc): m_queue(std::move(ctnr), alloc),
-	m_mutex(), m_cv(){
+	m_mutex(), m_cv(), m_stats(), m_stats_enabled(true){
 
 }
 
@@ -328,25 +370,37 @@ bool SafeQueue<T, Container>::back(T& front_element) const{
 	}
 }
 
+// The element is stamped before taking the lock, so reading the clock does not add to the critical section.
 template<class T, class Container>
 void SafeQueue<T, Container>::push(const T& value){
+	T element(value);
+	bool stats_enabled = statsEnabled();
+	if(stats_enabled) stampElement(element, SQ_NOW);
 	std::lock_guard<std::mutex> lock(m_mutex);
-	m_queue.push(value);
+	m_queue.push(std::move(element));
+	if(stats_enabled) m_stats.pushed(m_queue.size());
 	m_cv.notify_one();
 }
 
 template<class T, class Container>
 void SafeQueue<T, Container>::push(T&& value){
+	bool stats_enabled = statsEnabled();
+	if(stats_enabled) stampElement(value, SQ_NOW);
 	std::lock_guard<std::mutex> lock(m_mutex);
 	m_queue.push(std::move(value));
+	if(stats_enabled) m_stats.pushed(m_queue.size());
 	m_cv.notify_one();
 }
 
 template<class T, class Container>
 template<class ...Args>
 void SafeQueue<T, Container>::emplace(Args&&... args){
+	T element(args...);
+	bool stats_enabled = statsEnabled();
+	if(stats_enabled) stampElement(element, SQ_NOW);
 	std::lock_guard<std::mutex> lock(m_mutex);
-	m_queue.emplace(args...);
+	m_queue.push(std::move(element));
+	if(stats_enabled) m_stats.pushed(m_queue.size());
 	m_cv.notify_one();
 }
 
@@ -354,7 +408,7 @@ template<class T, class Container>
 bool SafeQueue<T, Container>::pop(){
 	std::lock_guard<std::mutex> lock(m_mutex);
 	if(m_queue.empty()) return false;
-	T& element = m_queue.front();
+	popped(m_queue.front());
 	m_queue.pop();
 	return true;
 }
@@ -363,7 +417,7 @@ template<class T, class Container>
 bool SafeQueue<T, Container>::pop(uint64_t& time){
 	std::lock_guard<std::mutex> lock(m_mutex);
 	if(m_queue.empty()) return false;
-	T& element = m_queue.front();
+	time = popped(m_queue.front());
 	m_queue.pop();
 	return true;
 }
@@ -373,6 +427,7 @@ bool SafeQueue<T, Container>::pop(T& front_element){
 	std::lock_guard<std::mutex> lock(m_mutex);
 	if(m_queue.empty()) return false;
 	const T& element = m_queue.front();
+	popped(element);
 	front_element = element;
 	m_queue.pop();
 	return true;
@@ -383,6 +438,7 @@ bool SafeQueue<T, Container>::pop(T& front_element, uint64_t& time){
 	std::lock_guard<std::mutex> lock(m_mutex);
 	if(m_queue.empty()) return false;
 	const T& element = m_queue.front();
+	time = popped(element);
 	front_element = element;
 	m_queue.pop();
 	return true;
@@ -394,7 +450,8 @@ T SafeQueue<T, Container>::pop_wait(){
 	if(m_queue.empty()){
 		m_cv.wait(lock, [this]{return !this->m_queue.empty();});
 	}
-	const T& result = m_queue.front();
+	T result = m_queue.front();
+	popped(result);
 	m_queue.pop();
 	return result;
 }
@@ -405,7 +462,8 @@ T SafeQueue<T, Container>::pop_wait(uint64_t& time){
 	if(m_queue.empty()){
 		m_cv.wait(lock, [this]{return !this->m_queue.empty();});
 	}
-	const T& result = m_queue.front();
+	T result = m_queue.front();
+	time = popped(result);
 	m_queue.pop();
 	return result;
 }
@@ -419,6 +477,7 @@ bool SafeQueue<T, Container>::pop_wait_for(const std::chrono::duration<Rep, Peri
 		if(!pred) return false;
 	}
 	const T& result = m_queue.front();
+	popped(result);
 	pop_element = result;
 	m_queue.pop();
 	return true;
@@ -433,6 +492,7 @@ bool SafeQueue<T, Container>::pop_wait_for(const std::chrono::duration<Rep, Peri
 		if(!pred) return false;
 	}
 	const T& result = m_queue.front();
+	time = popped(result);
 	pop_element = result;
 	m_queue.pop();
 	return true;
@@ -447,5 +507,26 @@ void SafeQueue<T, Container>::swap(SafeQueue<T, Container>& other){
 	m_queue.swap(other.m_queue);
 }
 
+template<class T, class Container>
+void SafeQueue<T, Container>::resetStats(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats.reset(m_queue.size());
+}
+
+template<class T, class Container>
+uint64_t SafeQueue<T, Container>::popped(const T& element){
+	uint64_t residence = 0;
+	if(!statsEnabled()) return residence;
+#ifdef SafeQueueTimeLog
+	uint64_t stamp = elementStamp(element);
+	if(stamp != 0){
+		uint64_t now = SQ_NOW;
+		residence = now > stamp ? now - stamp : 0;
+	}
+#endif
+	m_stats.popped(residence);
+	return residence;
+}
+
 } //End nanespace
 #endif
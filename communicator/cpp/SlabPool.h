@@ -0,0 +1,171 @@
+/*
+ * SlabPool.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef SLABPOOL_H_
+#define SLABPOOL_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stdlib.h>
+#include <stdint.h>
+
+namespace communicator {
+
+/*
+ * SlabPool is a thread safe, reference counted, fixed size buffer allocator.
+ * All slots live in one contiguous slab allocated at construction time. A slot is leased with a reference count of 1,
+ * additional holders call retain() and every holder calls release() when done with it. The slot goes back to the pool
+ * when its count drops to zero, so it can never be overwritten while someone still holds it.
+ * Free slots are kept in a LIFO so that the most recently released (and probably still cached) slot is leased first.
+ */
+class SlabPool {
+public:
+	/*
+	 * Create a slab with a fixed number of slots
+	 * @param nof_slots: Number of slots
+	 * @param slot_size: Size of a slot in bytes (rounded up to a multiple of the cache line size)
+	 */
+	SlabPool(uint32_t nof_slots, uint32_t slot_size);
+
+	virtual ~SlabPool();
+
+	/*
+	 * @return True if the slab memory was allocated
+	 */
+	inline bool valid() const { return m_slab != nullptr; }
+
+	/*
+	 * Lease a free slot with reference count 1
+	 * @return pointer to the slot or nullptr if the slab is exhausted
+	 */
+	unsigned char* lease();
+
+	/*
+	 * Add a reference to a leased slot
+	 * @return False if the pointer does not belong to a leased slot
+	 */
+	bool retain(const unsigned char* slot);
+
+	/*
+	 * Remove a reference from a leased slot, returning it to the pool when there are no references left
+	 * @return False if the pointer does not belong to a leased slot
+	 */
+	bool release(const unsigned char* slot);
+
+	inline uint32_t nof_slots() const { return m_nof_slots; }
+	inline uint32_t slot_size() const { return m_slot_size; }
+
+	/*
+	 * Number of slots currently leased
+	 */
+	inline uint32_t in_use() const { return m_in_use.load(std::memory_order_relaxed); }
+
+	/*
+	 * Maximum number of slots leased at the same time
+	 */
+	inline uint32_t high_water() const { return m_high_water.load(std::memory_order_relaxed); }
+
+	/*
+	 * Number of times lease() failed because all the slots were leased
+	 */
+	inline uint64_t exhaustions() const { return m_exhaustions.load(std::memory_order_relaxed); }
+
+	static const uint32_t cache_line_size = 64;
+
+private:
+	int64_t index_of(const unsigned char* slot) const;
+
+	unsigned char*								m_slab;
+	uint32_t									m_nof_slots;
+	uint32_t									m_slot_size;
+	std::unique_ptr<std::atomic<uint32_t>[]>	m_ref_count;
+	std::vector<uint32_t>						m_free;
+	std::mutex									m_mutex;
+	std::atomic<uint32_t>						m_in_use;
+	std::atomic<uint32_t>						m_high_water;
+	std::atomic<uint64_t>						m_exhaustions;
+};
+
+
+//IMPLEMENTATION
+
+inline SlabPool::SlabPool(uint32_t nof_slots, uint32_t slot_size):
+	m_slab(nullptr), m_nof_slots(nof_slots),
+	m_slot_size(((slot_size + cache_line_size - 1)/cache_line_size)*cache_line_size),
+	m_ref_count(new std::atomic<uint32_t>[nof_slots]), m_free(), m_mutex(),
+	m_in_use(0), m_high_water(0), m_exhaustions(0)
+{
+	void* ptr;
+	if(posix_memalign(&ptr, cache_line_size, (size_t)m_nof_slots*m_slot_size) == 0){
+		m_slab = static_cast<unsigned char*>(ptr);
+	}
+	m_free.reserve(m_nof_slots);
+	// Push in reverse order so that slot 0 is the first one to be leased.
+	for(uint32_t i = m_nof_slots; i > 0; i--){
+		m_ref_count[i - 1].store(0, std::memory_order_relaxed);
+		m_free.push_back(i - 1);
+	}
+}
+
+inline SlabPool::~SlabPool(){
+	free(m_slab);
+}
+
+inline unsigned char* SlabPool::lease(){
+	uint32_t idx;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if(m_slab == nullptr || m_free.empty()){
+			m_exhaustions.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		idx = m_free.back();
+		m_free.pop_back();
+		m_ref_count[idx].store(1, std::memory_order_relaxed);
+		uint32_t in_use = m_in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+		if(in_use > m_high_water.load(std::memory_order_relaxed)){
+			m_high_water.store(in_use, std::memory_order_relaxed);
+		}
+	}
+	return m_slab + (size_t)idx*m_slot_size;
+}
+
+inline bool SlabPool::retain(const unsigned char* slot){
+	int64_t idx = index_of(slot);
+	if(idx < 0 || m_ref_count[idx].load(std::memory_order_relaxed) == 0){
+		return false;
+	}
+	m_ref_count[idx].fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+inline bool SlabPool::release(const unsigned char* slot){
+	int64_t idx = index_of(slot);
+	if(idx < 0 || m_ref_count[idx].load(std::memory_order_relaxed) == 0){
+		return false;
+	}
+	// The last holder makes the slot available again.
+	if(m_ref_count[idx].fetch_sub(1, std::memory_order_acq_rel) == 1){
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_free.push_back((uint32_t)idx);
+		m_in_use.fetch_sub(1, std::memory_order_relaxed);
+	}
+	return true;
+}
+
+// Any pointer inside a slot identifies it, e.g., data plus the offset of the current TB.
+inline int64_t SlabPool::index_of(const unsigned char* slot) const{
+	if(m_slab == nullptr || slot < m_slab || slot >= m_slab + (size_t)m_nof_slots*m_slot_size){
+		return -1;
+	}
+	return (int64_t)((slot - m_slab)/m_slot_size);
+}
+
+}
+
+#endif /* SLABPOOL_H_ */
@@ -13,8 +13,6 @@ int communicator_initialization(char* module_name, char* target1_name, char* tar
     std::cerr << "[COMM ERROR] Error when allocating memory for communicator." << std::endl;
     return -1;
   }
-  // Set circular buffer counter to zero.
-  communicator_handle->user_data_buffer_cnt = 0;
   // Set the number of radios being used.
   communicator_handle->nof_radios           = nof_radios;
   // Allocate memory for environment path name.
@@ -30,6 +28,9 @@ int communicator_initialization(char* module_name, char* target1_name, char* tar
     strcpy(communicator_handle->env_pathname, DEFAULT_ENV_PATHNAME);
   }
   std::cout << "[COMM INFO] Environment path set to " << communicator_handle->env_pathname << std::endl;
+  // Start watching the environment file. It is parsed right away and then every time it is written.
+  communicator_handle->env_update_version   = 0;
+  communicator_handle->env_update_service   = new communicator::EnvUpdateService(communicator_handle->env_pathname, communicator_parse_environment_file);
   // Make sure user data buffer is all set to NULL.
   communicator_set_user_data_buffer_to_null();
   // Check if needs to free the buffer.
@@ -38,6 +39,10 @@ int communicator_initialization(char* module_name, char* target1_name, char* tar
   if(communicator_allocate_user_data_buffer() < 0) {
     return -1;
   }
+  // Preallocate the messages used in the hot path.
+  if(communicator_allocate_message_pools() < 0) {
+    return -1;
+  }
   // Instantiate communicator module so that we can receive/transmit commands and data.
   if(communicator_make(module_name, target1_name, target2_name, handle) < 0) {
     return -1;
@@ -47,10 +52,17 @@ int communicator_initialization(char* module_name, char* target1_name, char* tar
 }
 
 int communicator_uninitialization(LayerCommunicator_handle* const handle) {
-  // Free user data vector.
-  communicator_free_user_data_buffer();
   // After use, communicator handle MUST be freed.
   communicator_free(handle);
+  // Free user data slab only after the receiving thread is gone.
+  communicator_free_user_data_buffer();
+  // Free the message pools. Messages still referenced somewhere else are freed with their last reference.
+  communicator_free_message_pools();
+  // Stop watching the environment file.
+  if(communicator_handle->env_update_service) {
+    delete communicator_handle->env_update_service;
+    communicator_handle->env_update_service = NULL;
+  }
   // Free memory used to store environment pathname string.
   if(communicator_handle->env_pathname) {
     free(communicator_handle->env_pathname);
@@ -80,6 +92,7 @@ int communicator_make(char* module_name, char* target1_name, char* target2_name,
     if(success && m != communicator::MODULE_UNKNOWN && t1 != communicator::MODULE_UNKNOWN) {
       *handle = new layer_communicator_t;
       (*handle)->layer_communicator_cpp = new communicator::DefaultLayerCommunicator(m, {t1});
+      (*handle)->phy_stat_batcher = NULL;
     } else {
       std::cerr << "[COMM ERROR] This should not have happened, invalid modules for communicator_make" << std::endl;
     }
@@ -91,6 +104,7 @@ int communicator_make(char* module_name, char* target1_name, char* target2_name,
     if(success && m != communicator::MODULE_UNKNOWN && t1 != communicator::MODULE_UNKNOWN && t2 != communicator::MODULE_UNKNOWN) {
       *handle = new layer_communicator_t;
       (*handle)->layer_communicator_cpp = new communicator::DefaultLayerCommunicator(m, {t1, t2});
+      (*handle)->phy_stat_batcher = NULL;
     } else {
       std::cerr << "[COMM ERROR] This should not have happened, invalid modules for communicator_make" << std::endl;
     }
@@ -102,6 +116,47 @@ int communicator_make(char* module_name, char* target1_name, char* target2_name,
   return 0;
 }
 
+// ************ Layout of the pooled messages ************
+static void communicator_rx_stat_layout(communicator::Internal& internal) {
+  internal.mutable_receiver()->mutable_stat()->mutable_rx_stat();
+}
+
+static void communicator_tx_stat_layout(communicator::Internal& internal) {
+  internal.mutable_sendr()->mutable_phy_stat()->mutable_tx_stat();
+}
+
+static void communicator_sensing_stat_layout(communicator::Internal& internal) {
+  internal.mutable_receiver()->mutable_stat()->mutable_sensing_stat();
+}
+
+static void communicator_tx_basic_ctrl_layout(communicator::Internal& internal) {
+  internal.mutable_send()->mutable_basic_ctrl();
+  internal.mutable_send()->mutable_app_data();
+}
+
+static void communicator_rx_basic_ctrl_layout(communicator::Internal& internal) {
+  internal.mutable_receive()->mutable_basic_ctrl();
+}
+
+// Fill the PHY structure with the given environment snapshot and remember it as the one applied by the PHY.
+static void fill_environment(environment_t *env, const std::shared_ptr<const communicator::EnvSnapshot>& snapshot) {
+  env->environment_updated      = true;
+  env->competition_center_freq  = snapshot->competition_center_freq;
+  env->competition_bw           = snapshot->competition_bw;
+  communicator_handle->env_update_version = snapshot->version;
+}
+
+// Get a message with the given layout, from the pool if it is available, otherwise from the heap.
+// Fields of pooled messages hold the values of their last use, therefore, callers MUST set all the fields of the layout.
+static std::shared_ptr<communicator::Internal> communicator_get_message(communicator::MessagePool* const pool, void (*layout)(communicator::Internal&)) {
+  if(communicator_handle != NULL && communicator_handle->message_pool_enabled && pool != NULL) {
+    return pool->acquire();
+  }
+  std::shared_ptr<communicator::Internal> internal = std::make_shared<communicator::Internal>();
+  layout(*internal);
+  return internal;
+}
+
 int communicator_send_phy_stat_message(LayerCommunicator_handle handle, stat_e type, phy_stat_t *phy_stats, message_handle *msg_handle) {
   return communicator_send_phy_stat_msg_dest(handle, handle->layer_communicator_cpp->getDestinationModule(), type, phy_stats, msg_handle);
 }
@@ -121,15 +176,26 @@ int communicator_send_phy_stat_msg_dest(LayerCommunicator_handle handle, int des
     return -1;
   }
 
-  // Create a Internal Message.
-  std::shared_ptr<communicator::Internal> internal = std::make_shared<communicator::Internal>();
+  // Get an Internal Message with the layout of the requested statistics.
+  std::shared_ptr<communicator::Internal> internal;
+  communicator::Phy_stat* stat;
+  if(type == RX_STAT) {
+    internal = communicator_get_message(communicator_handle ? communicator_handle->rx_stat_pool : NULL, communicator_rx_stat_layout);
+    stat = internal->mutable_receiver()->mutable_stat();
+  } else if(type == TX_STAT) {
+    internal = communicator_get_message(communicator_handle ? communicator_handle->tx_stat_pool : NULL, communicator_tx_stat_layout);
+    stat = internal->mutable_sendr()->mutable_phy_stat();
+  } else if(type == SENSING_STAT) {
+    internal = communicator_get_message(communicator_handle ? communicator_handle->sensing_stat_pool : NULL, communicator_sensing_stat_layout);
+    stat = internal->mutable_receiver()->mutable_stat();
+  } else {
+    std::cout << "[COMM ERROR] Undefined type of statistics." << std::endl;
+    return -1;
+  }
 
   // Sequence number used by upper layer to track the response of PHY, i.e., correlates one basic_control message with a phy_stat message.
   internal->set_transaction_index(phy_stats->seq_number); // Transaction index is the same as sequence number.
 
-  // Create PHY stat message.
-  communicator::Phy_stat* stat = new communicator::Phy_stat();
-
   // Set statistics common for both RX and TX.
   stat->set_phy_id(phy_stats->phy_id);
   stat->set_host_timestamp(phy_stats->host_timestamp);
@@ -143,12 +209,12 @@ int communicator_send_phy_stat_msg_dest(LayerCommunicator_handle handle, int des
   stat->set_wrong_decoding_counter(phy_stats->wrong_decoding_counter);
   // Set the corresponding statistics for RX or TX.
   if(type == RX_STAT) {
-    // Create a Receive_r message.
-    communicator::Receive_r *receive_r = new communicator::Receive_r();
+    // Receive_r message, internal has ownership over it.
+    communicator::Receive_r *receive_r = internal->mutable_receiver();
     // Set the status comming from PHY so that the upper layer knows what happened.
     receive_r->set_result((communicator::TRANSACTION_RESULT)phy_stats->status);
-    // Create a PHY stat RX message
-    communicator::Phy_rx_stat *stat_rx = new communicator::Phy_rx_stat();
+    // PHY stat RX message, stat has ownership over it.
+    communicator::Phy_rx_stat *stat_rx = stat->mutable_rx_stat();
     stat_rx->set_nof_slots_in_frame(phy_stats->stat.rx_stat.nof_slots_in_frame);
     stat_rx->set_slot_counter(phy_stats->stat.rx_stat.slot_counter);
     stat_rx->set_gain(phy_stats->stat.rx_stat.gain);
@@ -176,32 +242,26 @@ int communicator_send_phy_stat_msg_dest(LayerCommunicator_handle handle, int des
           std::cout << "[COMM ERROR] Data length is incorrect: " << phy_stats->stat.rx_stat.length << " !" << std::endl;
           return -1;
         }
-        // Instantiate string with data.
-        std::string data_str((char*)phy_stats->stat.rx_stat.data, phy_stats->stat.rx_stat.length);
-        receive_r->set_data(data_str);
+        // Copy data straight into the message, reusing the memory of its last use.
+        receive_r->set_data((char*)phy_stats->stat.rx_stat.data, phy_stats->stat.rx_stat.length);
       } catch(const std::length_error &e) {
         std::cout << "[COMM ERROR] Exception Caught " << e.what() << std::endl;
         std::cout << "[COMM ERROR] Exception Type " << typeid(e).name() << std::endl;
         return -1;
       }
     } else {
+      receive_r->clear_data();
       if(phy_stats->status == PHY_SUCCESS) {
         std::cout << "[COMM WARNING] PHY status is success but received data is NULL..." << std::endl;
 		  }
     }
-    // Add PHY RX Stats to PHY Stat.
-    stat->set_allocated_rx_stat(stat_rx);
-    // Add PHY stat to Send_r message.
-    receive_r->set_allocated_stat(stat);	// receive_r has ownership over the stat pointer
-    // Add Send_r to the message
-    internal->set_allocated_receiver(receive_r); // internal has ownership over the receive_r pointer
   } else if(type == TX_STAT) {
-    // Create a Send_r message.
-    communicator::Send_r *send_r = new communicator::Send_r();
+    // Send_r message, internal has ownership over it.
+    communicator::Send_r *send_r = internal->mutable_sendr();
     // Set the status comming from PHY so that the upper layer knows what happened.
     send_r->set_result((communicator::TRANSACTION_RESULT)phy_stats->status);
-    // Create a PHY stat TX message
-    communicator::Phy_tx_stat* stat_tx = new communicator::Phy_tx_stat();
+    // PHY stat TX message, stat has ownership over it.
+    communicator::Phy_tx_stat* stat_tx = stat->mutable_tx_stat();
     stat_tx->set_power(phy_stats->stat.tx_stat.power);
     stat_tx->set_channel_free_cnt(phy_stats->stat.tx_stat.channel_free_cnt);
     stat_tx->set_channel_busy_cnt(phy_stats->stat.tx_stat.channel_busy_cnt);
@@ -210,18 +270,13 @@ int communicator_send_phy_stat_msg_dest(LayerCommunicator_handle handle, int des
     stat_tx->set_total_dropped_slots(phy_stats->stat.tx_stat.total_dropped_slots);
     stat_tx->set_coding_time(phy_stats->stat.tx_stat.coding_time);
     stat_tx->set_rf_boost(phy_stats->stat.tx_stat.rf_boost);
-    stat->set_allocated_tx_stat(stat_tx);
-    // Add PHY stat to Send_r message.
-    send_r->set_allocated_phy_stat(stat);	// send_r has ownership over the stat pointer
-    // Add Send_r to the message
-    internal->set_allocated_sendr(send_r); // internal has ownership over the send_r pointer
-  } else if(type == SENSING_STAT) {
-    // Create a Receive_r message.
-    communicator::Receive_r *receive_r = new communicator::Receive_r();
+  } else {
+    // Receive_r message, internal has ownership over it.
+    communicator::Receive_r *receive_r = internal->mutable_receiver();
     // Set the status comming from PHY so that the upper layer knows what happened.
     receive_r->set_result((communicator::TRANSACTION_RESULT)phy_stats->status);
-    // Create a PHY stat RX message
-    communicator::Phy_sensing_stat *stat_sensing = new communicator::Phy_sensing_stat();
+    // PHY stat Sensing message, stat has ownership over it.
+    communicator::Phy_sensing_stat *stat_sensing = stat->mutable_sensing_stat();
     stat_sensing->set_frequency(phy_stats->stat.sensing_stat.frequency);
     stat_sensing->set_sample_rate(phy_stats->stat.sensing_stat.sample_rate);
     stat_sensing->set_gain(phy_stats->stat.sensing_stat.gain);
@@ -234,36 +289,24 @@ int communicator_send_phy_stat_msg_dest(LayerCommunicator_handle handle, int des
           std::cout << "[COMM ERROR] Data length is incorrect: " << phy_stats->stat.sensing_stat.length << " !" << std::endl;
           return -1;
         }
-        // Instantiate string with data.
-        std::string data_str((char*)phy_stats->stat.sensing_stat.data, phy_stats->stat.sensing_stat.length);
-        receive_r->set_data(data_str);
+        // Copy data straight into the message, reusing the memory of its last use.
+        receive_r->set_data((char*)phy_stats->stat.sensing_stat.data, phy_stats->stat.sensing_stat.length);
       } catch(const std::length_error &e) {
         std::cout << "[COMM ERROR] Exception Caught " << e.what() << std::endl;
         std::cout << "[COMM ERROR] Exception Type " << typeid(e).name() << std::endl;
         return -1;
       }
     } else {
+      receive_r->clear_data();
       if(phy_stats->status == PHY_SUCCESS) {
         std::cout << "[COMM ERROR] PHY status is success but sensing data is NULL..." << std::endl;
 		  }
     }
-    // Add PHY Sensing Stats to PHY Stat.
-    stat->set_allocated_sensing_stat(stat_sensing);
-    // Add PHY stat to Send_r message.
-    receive_r->set_allocated_stat(stat);	// receive_r has ownership over the stat pointer
-    // Add Send_r to the message
-    internal->set_allocated_receiver(receive_r); // internal has ownership over the receive_r pointer
-  } else {
-    std::cout << "[COMM ERROR] Undefined type of statistics." << std::endl;
-    return -1;
   }
 
   // Create a Message object what will be sent upwards.
   communicator::Message msg(communicator::MODULE_PHY, (communicator::MODULE)destination, internal);
 
-  // Put message in the sensing queue.
-  handle->layer_communicator_cpp->send(msg);
-
 #if(CHECK_COMM_OUT_OF_SEQUENCE_RX==1)
   static uint8_t expected_rx_byte = 1;
   std::string data_str = internal->receiver().data().c_str();
@@ -277,6 +320,18 @@ int communicator_send_phy_stat_msg_dest(LayerCommunicator_handle handle, int des
   }
 #endif
 
+  // Put message in the sending queue or, if batching is enabled, in the batch of its destination. Sensing statistics are never batched.
+  // The batch takes the payload over, unless the caller keeps the message through msg_handle.
+  if(handle->phy_stat_batcher != NULL && type != SENSING_STAT) {
+    if(msg_handle != NULL) {
+      handle->phy_stat_batcher->add((communicator::MODULE)destination, communicator::Internal(*internal));
+    } else {
+      handle->phy_stat_batcher->add((communicator::MODULE)destination, std::move(*internal));
+    }
+  } else {
+    handle->layer_communicator_cpp->send(msg);
+  }
+
   // Add a Message object only if different from NULL.
   if(msg_handle != NULL) {
     *msg_handle = new message_t;
@@ -286,6 +341,25 @@ int communicator_send_phy_stat_msg_dest(LayerCommunicator_handle handle, int des
   return 0;
 }
 
+// Coalesce RX/TX statistics into batch messages sent when max_nof_stats statistics are pending or the oldest one waited max_delay_us.
+// A max_nof_stats less than 2 disables batching, sending the pending statistics first.
+// It must be called before other threads start sending statistics through this handle.
+int communicator_enable_phy_stat_batching(LayerCommunicator_handle handle, uint32_t max_nof_stats, uint32_t max_delay_us) {
+  if(handle == NULL || handle->layer_communicator_cpp == NULL) {
+    std::cout << "[COMM ERROR] Communicator Handle is NULL." << std::endl;
+    return -1;
+  }
+  if(handle->phy_stat_batcher != NULL) {
+    std::cout << "[COMM INFO] PHY stats batching: " << handle->phy_stat_batcher->nofStats() << " statistics sent in " << handle->phy_stat_batcher->nofBatches() << " messages." << std::endl;
+    delete handle->phy_stat_batcher;
+    handle->phy_stat_batcher = NULL;
+  }
+  if(max_nof_stats > 1) {
+    handle->phy_stat_batcher = new communicator::PhyStatBatcher(handle->layer_communicator_cpp, communicator::MODULE_PHY, max_nof_stats, std::chrono::microseconds(max_delay_us), NUMBER_OF_POOLED_PHY_STAT_BATCHES);
+  }
+  return 0;
+}
+
 // This function will retrieve messages (basic_control) addressed to the PHY from the QUEUE.
 // OBS.: It is a blocking call.
 // MUST cast to basic_ctrl_t *
@@ -420,6 +494,8 @@ void communicator_print_message(message_handle msg_handle) {
 }
 
 void communicator_free(LayerCommunicator_handle* handle) {
+  // Send pending batches while the communicator is still running.
+  communicator_enable_phy_stat_batching(*handle, 0, 0);
   communicator::DefaultLayerCommunicator *ptr = ((*handle)->layer_communicator_cpp);
   delete ptr;
   delete *handle;
@@ -488,6 +564,8 @@ int parse_received_message(communicator::Message msg, void *msg_struct) {
         basic_ctrl->gain      = internal->receive().basic_ctrl().gain();
         basic_ctrl->rf_boost  = internal->receive().basic_ctrl().rf_boost();
         basic_ctrl->length    = internal->receive().basic_ctrl().length();
+        basic_ctrl->harq_pid  = internal->receive().basic_ctrl().harq_pid();
+        basic_ctrl->retx_cnt  = internal->receive().basic_ctrl().retx_cnt();
         break;
       }
       case communicator::Internal::kSend:
@@ -521,6 +599,8 @@ int parse_received_message(communicator::Message msg, void *msg_struct) {
         basic_ctrl->gain      = internal->send().basic_ctrl().gain();
         basic_ctrl->rf_boost  = internal->send().basic_ctrl().rf_boost();
         basic_ctrl->length    = internal->send().basic_ctrl().length();
+        basic_ctrl->harq_pid  = internal->send().basic_ctrl().harq_pid();
+        basic_ctrl->retx_cnt  = internal->send().basic_ctrl().retx_cnt();
         // Only do basic checking. Other checking is done by PHY.
         if(basic_ctrl->length <= 0) {
           std::cout << "[COMM ERROR] Invalid Basic control length field: " << basic_ctrl->length << std::endl;
@@ -538,11 +618,15 @@ int parse_received_message(communicator::Message msg, void *msg_struct) {
           std::cout << "[COMM ERROR] Basic control length: " << data_length << " is greater than the allocated buffers: " << USER_DATA_BUFFER_LEN << std::endl;
           return -1;
         }
-        // Copy received user data into user data buffer.
-        memcpy(communicator_handle->user_data_buffer[communicator_handle->user_data_buffer_cnt], (unsigned char*)internal->send().app_data().data().c_str(), data_length);
-        basic_ctrl->data = communicator_handle->user_data_buffer[communicator_handle->user_data_buffer_cnt];
-        // Increment the counter used in the circular user data buffer.
-        communicator_handle->user_data_buffer_cnt = (communicator_handle->user_data_buffer_cnt + 1)%NUMBER_OF_USER_DATA_BUFFERS;
+        // Lease a slot from the user data slab. It is released by PHY once the data is encoded.
+        unsigned char *slot = communicator_handle->user_data_slab->lease();
+        if(slot == NULL) {
+          std::cout << "[COMM ERROR] User data slab exhausted: all " << NUMBER_OF_USER_DATA_BUFFERS << " buffers are in use. Dropping basic control." << std::endl;
+          return -1;
+        }
+        // Copy received user data into the leased slot.
+        memcpy(slot, (unsigned char*)internal->send().app_data().data().c_str(), data_length);
+        basic_ctrl->data = slot;
         break;
       }
       case communicator::Internal::kSet:
@@ -551,19 +635,15 @@ int parse_received_message(communicator::Message msg, void *msg_struct) {
         environment_t *env = (environment_t *)msg_struct;
         // Set flag to false in order to make sure if nothing is updated, then no configuration takes place.
         env->environment_updated = false;
-        // Parse environment updated parameters.
+        // Take environment updated parameters from the latest snapshot of the json file, without waiting for the
+        // environment update service thread. If the snapshot was already applied, or the file written just before
+        // this message is not parsed yet, the per-iteration poll of trx picks up the newer snapshot.
         if(internal->set().environment_updated() == true) {
-          // Instantiate environment update object.
-          Envupdates env_updates;
-          // Try to parse the json file.
-          env_updates.read_envupdates(communicator_handle->env_pathname);
-          // If any update, then set the PHY structure.
-          if(env_updates.has_envupdates()) {
-            env->environment_updated      = true;
-            env->competition_center_freq  = (double)env_updates.get_envupdate().scenario_center_frequency;
-            env->competition_bw           = (double)env_updates.get_envupdate().scenario_rf_bandwidth;
-          } else {
+          std::shared_ptr<const communicator::EnvSnapshot> snapshot = communicator_handle->env_update_service->snapshot();
+          if(!snapshot) {
             std::cout << "[COMM ERROR] Error parsing the environment.json file." << std::endl;
+          } else if(snapshot->version > communicator_handle->env_update_version) {
+            fill_environment(env, snapshot);
           }
         } else {
           std::cout << "[COMM INFO] environment_updated flag set to False, parameters won't be changed." << std::endl;
@@ -663,25 +743,106 @@ int parse_received_message(communicator::Message msg, void *msg_struct) {
   return 0;
 }
 
-bool communicator_verify_environment_update(environment_t *env) {
-  // Set flag to false in order to make sure if nothing is updated, then no configuration takes place.
-  env->environment_updated = false;
+// Parse the json file into an environment snapshot. Called by the environment update service thread only.
+bool communicator_parse_environment_file(const std::string& pathname, communicator::EnvSnapshot& snapshot) {
   // Instantiate environment update object.
   Envupdates env_updates;
   // Try to parse the json file.
-  env_updates.read_envupdates(communicator_handle->env_pathname);
-  // If any update, then set the PHY structure.
-  if(env_updates.has_envupdates()) {
-    env->environment_updated      = true;
-    env->competition_center_freq  = (double)env_updates.get_envupdate().scenario_center_frequency;
-    env->competition_bw           = (double)env_updates.get_envupdate().scenario_rf_bandwidth;
-  } else {
-    std::cout << "[COMM ERROR] Error parsing the environment.json file." << std::endl;
+  env_updates.read_envupdates((char*)pathname.c_str());
+  if(!env_updates.has_envupdates()) {
+    return false;
   }
+  snapshot.competition_center_freq  = (double)env_updates.get_envupdate().scenario_center_frequency;
+  snapshot.competition_bw           = (double)env_updates.get_envupdate().scenario_rf_bandwidth;
+  return true;
+}
 
+// Fill the PHY structure with the latest environment snapshot. It never waits on the file, which is parsed by the
+// environment update service. Returns false if the file was never parsed successfully.
+bool communicator_verify_environment_update(environment_t *env) {
+  // Set flag to false in order to make sure if nothing is updated, then no configuration takes place.
+  env->environment_updated = false;
+  std::shared_ptr<const communicator::EnvSnapshot> snapshot = communicator_handle->env_update_service->snapshot();
+  // If any update, then set the PHY structure.
+  if(snapshot) {
+    fill_environment(env, snapshot);
+  }
   return env->environment_updated;
 }
 
+// Check if the environment file was updated since the last snapshot handed to the PHY, if so, fill the PHY structure with it.
+bool communicator_get_environment_update(environment_t *env) {
+  std::shared_ptr<const communicator::EnvSnapshot> snapshot = communicator_handle->env_update_service->snapshot();
+  if(!snapshot || snapshot->version == communicator_handle->env_update_version) {
+    return false;
+  }
+  return communicator_verify_environment_update(env);
+}
+
+// Blocking call, it waits until someone pushes a message into any of the QUEUEs or the waiting times out.
+// High priority messages are always served first. If high_msg_struct is NULL only the low priority QUEUE is served.
+// Returns the QUEUE the message was popped from, COMM_NO_QUEUE if the waiting timed out or -1 if the message could not be parsed.
+int communicator_get_any_queue_wait_for(LayerCommunicator_handle handle, uint32_t timeout, void* const high_msg_struct, void* const low_msg_struct, message_handle *msg_handle) {
+  communicator::Message msg;
+  // Wait until there is a message in any of the QUEUEs.
+  communicator::AbstractLayerCommunicator::Queue queue = handle->layer_communicator_cpp->popWaitFor(std::chrono::microseconds(timeout), msg, high_msg_struct != NULL);
+  if(queue == communicator::AbstractLayerCommunicator::None) {
+    return COMM_NO_QUEUE;
+  }
+  // Parse message into the structure of the corresponding QUEUE.
+  if(parse_received_message(msg, queue == communicator::AbstractLayerCommunicator::High ? high_msg_struct : low_msg_struct) < 0) {
+    return -1;
+  }
+  // Add a Message object only if diffrent from NULL.
+  if(msg_handle != NULL) {
+    *msg_handle = new message_t;
+    (*msg_handle)->message_cpp = msg;
+  }
+  return (queue == communicator::AbstractLayerCommunicator::High) ? COMM_HIGH_QUEUE : COMM_LOW_QUEUE;
+}
+
+static_assert(COMM_NOF_LATENCY_BINS == communicator::LatencyHistogram::nof_bins, "COMM_NOF_LATENCY_BINS must match the number of bins of LatencyHistogram.");
+
+// Copy the histogram of the time messages waited in a QUEUE before being popped.
+int communicator_get_queue_wait_histogram(LayerCommunicator_handle handle, comm_queue_e queue, comm_latency_histogram_t* const histogram) {
+  if(queue != COMM_HIGH_QUEUE && queue != COMM_LOW_QUEUE) {
+    return -1;
+  }
+  const communicator::LatencyHistogram& hist = handle->layer_communicator_cpp->getWaitHistogram(queue == COMM_HIGH_QUEUE ? communicator::AbstractLayerCommunicator::High : communicator::AbstractLayerCommunicator::Low);
+  histogram->count  = hist.count();
+  histogram->sum_ns = hist.sum();
+  histogram->max_ns = hist.max();
+  for(uint32_t i = 0; i < COMM_NOF_LATENCY_BINS; i++) {
+    histogram->bins[i] = hist.bin(i);
+  }
+  return 0;
+}
+
+// Print counters, maximum depth and residence time histogram of the sending, high and low priority QUEUEs.
+void communicator_print_queue_stats(LayerCommunicator_handle handle) {
+  handle->layer_communicator_cpp->printQueueStats(std::cout);
+}
+
+// Print the QUEUE statistics every period_ms milliseconds from an own thread. A period of 0 disables it.
+void communicator_enable_queue_stats_export(LayerCommunicator_handle handle, uint32_t period_ms) {
+  handle->layer_communicator_cpp->exportQueueStats(std::chrono::milliseconds(period_ms));
+}
+
+// Average time in nanoseconds of a push or a pop on an uncontended QUEUE of the same type as the communicator ones,
+// with or without QUEUE statistics. Pushes and pops alternate, so the QUEUE never holds more than one message.
+double communicator_measure_queue_operation_time(uint32_t nof_operations, bool enable_stats) {
+  ::SafeQueue::SafeQueue<communicator::Message> queue;
+  communicator::Message msg(communicator::MODULE_PHY, communicator::MODULE_MAC, std::make_shared<communicator::Internal>());
+  communicator::Message popped_msg;
+  queue.enableStats(enable_stats);
+  uint64_t start = clock_get_time_ns();
+  for(uint32_t i = 0; i < nof_operations; i++) {
+    queue.push(msg);
+    queue.pop(popped_msg);
+  }
+  return (double)(clock_get_time_ns() - start)/(2.0*(double)nof_operations);
+}
+
 bool communicator_is_high_queue_empty(LayerCommunicator_handle handle) {
   return handle->layer_communicator_cpp->get_high_queue().empty();
 }
@@ -692,12 +853,8 @@ bool communicator_is_low_queue_empty(LayerCommunicator_handle handle) {
 
 int communicator_send_basic_control(LayerCommunicator_handle handle, basic_ctrl_t* const basic_ctrl) {
 
-  std::shared_ptr<communicator::Internal> message = std::make_shared<communicator::Internal>();
-  message->set_transaction_index(basic_ctrl->seq_number);
-  message->set_owner_module(communicator::MODULE_MAC);
-  communicator::Message mes = communicator::Message(communicator::MODULE_MAC, communicator::MODULE_PHY, message);
-
-  communicator::Basic_ctrl *ctrl = new communicator::Basic_ctrl();
+  std::shared_ptr<communicator::Internal> message;
+  communicator::Basic_ctrl *ctrl;
 
   switch(basic_ctrl->trx_flag) {
     case PHY_TX_ST:
@@ -714,13 +871,13 @@ int communicator_send_basic_control(LayerCommunicator_handle handle, basic_ctrl_
         return -1;
       }
 
-      communicator::Send* send = new communicator::Send();
-      mes.message->set_allocated_send(send);
+      message = communicator_get_message(communicator_handle ? communicator_handle->tx_basic_ctrl_pool : NULL, communicator_tx_basic_ctrl_layout);
+
+      communicator::Send* send = message->mutable_send();
 
-      send->set_allocated_basic_ctrl(ctrl);
+      ctrl = send->mutable_basic_ctrl();
 
-      communicator::Application_data *app_data = new communicator::Application_data();
-      send->set_allocated_app_data(app_data);
+      communicator::Application_data *app_data = send->mutable_app_data();
 
       ctrl->set_trx_flag((communicator::Basic_ctrl_TRX)basic_ctrl->trx_flag);
       ctrl->set_bw_index((communicator::BW_INDEX)basic_ctrl->bw_idx);
@@ -733,18 +890,19 @@ int communicator_send_basic_control(LayerCommunicator_handle handle, basic_ctrl_
       ctrl->set_rf_boost(basic_ctrl->rf_boost);
       ctrl->set_gain(basic_ctrl->gain);
       ctrl->set_length(basic_ctrl->length);
+      ctrl->set_harq_pid(basic_ctrl->harq_pid);
+      ctrl->set_retx_cnt(basic_ctrl->retx_cnt);
 
-      std::string *data_str = new std::string((char*)basic_ctrl->data, basic_ctrl->length);
-      app_data->set_allocated_data(data_str);
+      // Copy data straight into the message, reusing the memory of its last use.
+      app_data->set_data((char*)basic_ctrl->data, basic_ctrl->length);
 
       break;
     }
     case PHY_RX_ST:
     {
-      communicator::Receive* receive = new communicator::Receive();
-      mes.message->set_allocated_receive(receive);
+      message = communicator_get_message(communicator_handle ? communicator_handle->rx_basic_ctrl_pool : NULL, communicator_rx_basic_ctrl_layout);
 
-      receive->set_allocated_basic_ctrl(ctrl);
+      ctrl = message->mutable_receive()->mutable_basic_ctrl();
 
       ctrl->set_trx_flag((communicator::Basic_ctrl_TRX)basic_ctrl->trx_flag);
       ctrl->set_bw_index((communicator::BW_INDEX)basic_ctrl->bw_idx);
@@ -757,6 +915,8 @@ int communicator_send_basic_control(LayerCommunicator_handle handle, basic_ctrl_
       ctrl->set_gain(basic_ctrl->gain);
       ctrl->set_rf_boost(basic_ctrl->rf_boost);
       ctrl->set_length(basic_ctrl->length);
+      ctrl->set_harq_pid(basic_ctrl->harq_pid);
+      ctrl->set_retx_cnt(basic_ctrl->retx_cnt);
 
       break;
     }
@@ -764,6 +924,9 @@ int communicator_send_basic_control(LayerCommunicator_handle handle, basic_ctrl_
       std::cout << "[COMM ERROR] Message type not addressed..." << std::endl;
       return -1;
   }
+  message->set_transaction_index(basic_ctrl->seq_number);
+  message->set_owner_module(communicator::MODULE_MAC);
+  communicator::Message mes = communicator::Message(communicator::MODULE_MAC, communicator::MODULE_PHY, message);
   // Send message to PHY module.
   handle->layer_communicator_cpp->send(mes);
   // Everyhting went well.
@@ -789,36 +952,107 @@ void communicator_send_channel_emulator_config(LayerCommunicator_handle handle,
   handle->layer_communicator_cpp->send(mes);
 }
 
-// Allocate heap memory used to store user data comming from upper layers.
+// Allocate the slab used to store user data comming from upper layers.
 int communicator_allocate_user_data_buffer() {
-  for(uint32_t i = 0; i < NUMBER_OF_USER_DATA_BUFFERS; i++) {
-    communicator_handle->user_data_buffer[i] = (unsigned char*)communicator_vec_malloc(USER_DATA_BUFFER_LEN);
-    if(communicator_handle->user_data_buffer[i] == NULL) {
-      std::cout << "[COMM ERROR] User data buffer malloc failed." << std::endl;
-      return -1;
-    }
+  try {
+    communicator_handle->user_data_slab = new communicator::SlabPool(NUMBER_OF_USER_DATA_BUFFERS, USER_DATA_BUFFER_LEN);
+  } catch(const std::bad_alloc &e) {
+    communicator_handle->user_data_slab = NULL;
+  }
+  if(communicator_handle->user_data_slab == NULL || !communicator_handle->user_data_slab->valid()) {
+    std::cout << "[COMM ERROR] User data buffer malloc failed." << std::endl;
+    return -1;
   }
   // Everything went well.
   return 0;
 }
 
-// Deallocate heap memory used to store user data comming from upper layers.
+// Deallocate the user data slab and report its usage.
 void communicator_free_user_data_buffer() {
-  for(uint32_t i = 0; i < NUMBER_OF_USER_DATA_BUFFERS; i++) {
-    if(communicator_handle->user_data_buffer[i] != NULL) {
-      free(communicator_handle->user_data_buffer[i]);
-      communicator_handle->user_data_buffer[i] = NULL;
-    }
+  if(communicator_handle->user_data_slab != NULL) {
+    std::cout << "[COMM INFO] User data buffers: high-water mark: " << communicator_handle->user_data_slab->high_water() << " out of " << communicator_handle->user_data_slab->nof_slots() << " - exhaustions: " << communicator_handle->user_data_slab->exhaustions() << " - still in use: " << communicator_handle->user_data_slab->in_use() << std::endl;
+    delete communicator_handle->user_data_slab;
+    communicator_handle->user_data_slab = NULL;
   }
 }
 
-// make sure the user data buffer is initialized with NULL.
+// make sure the user data slab pointer is initialized with NULL.
 void communicator_set_user_data_buffer_to_null() {
-  for(uint32_t i = 0; i < NUMBER_OF_USER_DATA_BUFFERS; i++) {
-    if(communicator_handle->user_data_buffer[i] != NULL) {
-      communicator_handle->user_data_buffer[i] = NULL;
+  communicator_handle->user_data_slab = NULL;
+}
+
+// Add a reference to user data, e.g., when the same data is held by two PHYs.
+bool communicator_retain_user_data_buffer(unsigned char* const data) {
+  if(communicator_handle == NULL || communicator_handle->user_data_slab == NULL) {
+    return false;
+  }
+  return communicator_handle->user_data_slab->retain(data);
+}
+
+// Give user data back to the slab once it is not needed anymore.
+bool communicator_release_user_data_buffer(unsigned char* const data) {
+  if(communicator_handle == NULL || communicator_handle->user_data_slab == NULL) {
+    return false;
+  }
+  if(!communicator_handle->user_data_slab->release(data)) {
+    std::cout << "[COMM ERROR] Releasing user data buffer that was not leased." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Get current usage of the user data slab.
+void communicator_get_user_data_buffer_stats(uint32_t* const in_use, uint32_t* const high_water, uint64_t* const exhaustions) {
+  bool valid = (communicator_handle != NULL && communicator_handle->user_data_slab != NULL);
+  *in_use      = valid ? communicator_handle->user_data_slab->in_use() : 0;
+  *high_water  = valid ? communicator_handle->user_data_slab->high_water() : 0;
+  *exhaustions = valid ? communicator_handle->user_data_slab->exhaustions() : 0;
+}
+
+// Preallocate the messages used to send PHY stats and basic controls.
+int communicator_allocate_message_pools() {
+  // Communicator object is not zeroed when allocated.
+  communicator_handle->message_pool_enabled = false;
+  communicator_handle->rx_stat_pool         = NULL;
+  communicator_handle->tx_stat_pool         = NULL;
+  communicator_handle->sensing_stat_pool    = NULL;
+  communicator_handle->tx_basic_ctrl_pool   = NULL;
+  communicator_handle->rx_basic_ctrl_pool   = NULL;
+  try {
+    communicator_handle->rx_stat_pool       = new communicator::MessagePool(NUMBER_OF_POOLED_MESSAGES, communicator_rx_stat_layout);
+    communicator_handle->tx_stat_pool       = new communicator::MessagePool(NUMBER_OF_POOLED_MESSAGES, communicator_tx_stat_layout);
+    communicator_handle->sensing_stat_pool  = new communicator::MessagePool(NUMBER_OF_POOLED_MESSAGES, communicator_sensing_stat_layout);
+    communicator_handle->tx_basic_ctrl_pool = new communicator::MessagePool(NUMBER_OF_POOLED_MESSAGES, communicator_tx_basic_ctrl_layout);
+    communicator_handle->rx_basic_ctrl_pool = new communicator::MessagePool(NUMBER_OF_POOLED_MESSAGES, communicator_rx_basic_ctrl_layout);
+  } catch(const std::bad_alloc &e) {
+    std::cout << "[COMM ERROR] Message pool allocation failed." << std::endl;
+    return -1;
+  }
+  communicator_handle->message_pool_enabled = true;
+  // Everything went well.
+  return 0;
+}
+
+// Deallocate the message pools and report how many messages had to be allocated on the heap.
+void communicator_free_message_pools() {
+  communicator::MessagePool** pools[] = {&communicator_handle->rx_stat_pool, &communicator_handle->tx_stat_pool, &communicator_handle->sensing_stat_pool, &communicator_handle->tx_basic_ctrl_pool, &communicator_handle->rx_basic_ctrl_pool};
+  for(uint32_t i = 0; i < sizeof(pools)/sizeof(pools[0]); i++) {
+    if(*pools[i] != NULL) {
+      if((*pools[i])->fallbacks() > 0) {
+        std::cout << "[COMM INFO] Message pool " << i << ": " << (*pools[i])->fallbacks() << " out of " << (*pools[i])->acquired() << " messages were allocated on the heap." << std::endl;
+      }
+      delete *pools[i];
+      *pools[i] = NULL;
     }
   }
+  communicator_handle->message_pool_enabled = false;
+}
+
+// Enable or disable the use of the message pools, e.g., to compare against heap allocated messages.
+void communicator_enable_message_pools(bool enable) {
+  if(communicator_handle != NULL) {
+    communicator_handle->message_pool_enabled = enable;
+  }
 }
 
 // Note: We align memory to 32 bytes (for AVX compatibility)
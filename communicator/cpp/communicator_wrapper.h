@@ -2,8 +2,10 @@
 #define _COMMUNICATOR_WRAPPER_H
 
 // *********** Definition of COMM macros ***********
-// As we can have overlapping of Tx data we create a vector with a given number of buffers.
-#define NUMBER_OF_USER_DATA_BUFFERS 400000
+// Number of slots in the user data slab. A slot is leased when a TX basic control is received and released by the
+// PHY after its data is encoded, so this only has to cover the TX controls queued at the same time. The slab is
+// shared by all PHYs, each one queues at most NUMBER_OF_USER_DATA_BUFFERS/(2*nof_phys) TX controls.
+#define NUMBER_OF_USER_DATA_BUFFERS 256
 
 // Maximum allowed number of transmitted TBs in a single transmission.
 #define MAX_NOF_TBS 25
@@ -13,9 +15,20 @@
 
 #define DEFAULT_ENV_PATHNAME "/root/radio_api/environment.json"
 
+// Number of preallocated messages for each one of the hot-path message types (PHY stats and basic controls).
+// It must be greater than the number of messages in flight, i.e., waiting in the sending queue to be serialized.
+#define NUMBER_OF_POOLED_MESSAGES 128
+
+// Number of preallocated PHY stat batch messages. Batches are sent far less often than the statistics they carry.
+#define NUMBER_OF_POOLED_PHY_STAT_BATCHES 16
+
 #ifdef __cplusplus
 
 #include "LayerCommunicator.h"
+#include "MessagePool.h"
+#include "SlabPool.h"
+#include "PhyStatBatcher.h"
+#include "EnvUpdateService.h"
 #include "interf.pb.h"
 #include <iostream>
 #include <stdexcept>
@@ -36,6 +49,8 @@
 
 struct layer_communicator_t {
   communicator::DefaultLayerCommunicator *layer_communicator_cpp;
+  // Coalesces RX/TX statistics into batch messages. NULL when statistics are sent one by one.
+  communicator::PhyStatBatcher *phy_stat_batcher;
 };
 
 struct message_t {
@@ -43,18 +58,30 @@ struct message_t {
 };
 
 typedef struct {
-  // This is a pointer to the user data buffer.
-  unsigned char *user_data_buffer[NUMBER_OF_USER_DATA_BUFFERS];
-  // This counter is used to change the current buffer row so that we don't have overlapping even when Tx is fast enough.
-  uint32_t user_data_buffer_cnt;
+  // Reference counted slab used to store user data sent by upper layers. Slots are only reused after being released.
+  communicator::SlabPool *user_data_slab;
   // Hold the number of radios being used.
   uint32_t nof_radios;
   // File path name to the place where the enviroment .json file will be stored.
   char* env_pathname;
+  // Watches and parses the enviroment file in its own thread, so that the PHY only reads the latest snapshot.
+  communicator::EnvUpdateService *env_update_service;
+  // Version of the last environment snapshot handed to the PHY.
+  uint64_t env_update_version;
+  // Enable the use of the message pools below. If disabled, every message is allocated on the heap.
+  bool message_pool_enabled;
+  // Pools of preallocated messages used to send PHY stats and basic controls without heap allocation.
+  communicator::MessagePool *rx_stat_pool;
+  communicator::MessagePool *tx_stat_pool;
+  communicator::MessagePool *sensing_stat_pool;
+  communicator::MessagePool *tx_basic_ctrl_pool;
+  communicator::MessagePool *rx_basic_ctrl_pool;
 } communicator_t;
 
 int parse_received_message(communicator::Message msg, void *msg_struct);
 
+bool communicator_parse_environment_file(const std::string& pathname, communicator::EnvSnapshot& snapshot);
+
 extern "C" {
 #else
 struct layer_communicator_t;
@@ -65,6 +92,19 @@ typedef struct layer_communicator_t* LayerCommunicator_handle;
 
 typedef struct message_t* message_handle;
 
+// Queue a received message was popped from.
+typedef enum {COMM_NO_QUEUE = 0, COMM_LOW_QUEUE = 1, COMM_HIGH_QUEUE = 2} comm_queue_e;
+
+// Number of bins of the queue wait latency histograms. Bin 0 counts latencies below 2 us and bin i counts latencies in [2^i, 2^(i+1)) us.
+#define COMM_NOF_LATENCY_BINS 24
+
+typedef struct {
+  uint64_t count;
+  uint64_t sum_ns;
+  uint64_t max_ns;
+  uint64_t bins[COMM_NOF_LATENCY_BINS];
+} comm_latency_histogram_t;
+
 int communicator_initialization(char* module_name, char* target1_name, char* target2_name, LayerCommunicator_handle* const handle, uint32_t nof_radios, char* const env_update_pathname);
 
 int communicator_uninitialization(LayerCommunicator_handle* const handle);
@@ -75,6 +115,8 @@ int communicator_send_phy_stat_message(LayerCommunicator_handle handle, stat_e t
 
 int communicator_send_phy_stat_msg_dest(LayerCommunicator_handle handle, int destination, stat_e type, phy_stat_t *phy_stats, message_handle *msg_handle);
 
+int communicator_enable_phy_stat_batching(LayerCommunicator_handle handle, uint32_t max_nof_stats, uint32_t max_delay_us);
+
 bool communicator_get_high_queue(LayerCommunicator_handle handle, void *msg_struct, message_handle *msg_handle);
 
 int communicator_get_high_queue_wait(LayerCommunicator_handle handle, void *msg_struct, message_handle *msg_handle);
@@ -87,6 +129,16 @@ int communicator_get_low_queue_wait(LayerCommunicator_handle handle, void *msg_s
 
 bool communicator_get_low_queue_wait_for(LayerCommunicator_handle handle, uint32_t timeout, void* const msg_struct, message_handle *msg_handle);
 
+int communicator_get_any_queue_wait_for(LayerCommunicator_handle handle, uint32_t timeout, void* const high_msg_struct, void* const low_msg_struct, message_handle *msg_handle);
+
+int communicator_get_queue_wait_histogram(LayerCommunicator_handle handle, comm_queue_e queue, comm_latency_histogram_t* const histogram);
+
+void communicator_print_queue_stats(LayerCommunicator_handle handle);
+
+void communicator_enable_queue_stats_export(LayerCommunicator_handle handle, uint32_t period_ms);
+
+double communicator_measure_queue_operation_time(uint32_t nof_operations, bool enable_stats);
+
 bool communicator_is_high_queue_empty(LayerCommunicator_handle handle);
 
 bool communicator_is_low_queue_empty(LayerCommunicator_handle handle);
@@ -107,10 +159,24 @@ void communicator_free_user_data_buffer();
 
 void communicator_set_user_data_buffer_to_null();
 
+bool communicator_retain_user_data_buffer(unsigned char* const data);
+
+bool communicator_release_user_data_buffer(unsigned char* const data);
+
+void communicator_get_user_data_buffer_stats(uint32_t* const in_use, uint32_t* const high_water, uint64_t* const exhaustions);
+
 void *communicator_vec_malloc(uint32_t size);
 
+int communicator_allocate_message_pools();
+
+void communicator_free_message_pools();
+
+void communicator_enable_message_pools(bool enable);
+
 bool communicator_verify_environment_update(environment_t *env);
 
+bool communicator_get_environment_update(environment_t *env);
+
 uint64_t communicator_get_host_time_now();
 
 #ifdef __cplusplus
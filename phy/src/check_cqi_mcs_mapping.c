@@ -82,7 +82,7 @@ int main(int argc, char *argv[]) {
 
   FILE *fid;
   char fileName[100];
-  sprintf(fileName, "cqi_mcs_map_phy_bw_%d_mcs_%d.dat", tput_context->args.phy_bw_idx, tput_context->args.mcs);
+  sprintf(fileName, "cqi_mcs_map_phy_bw_%d_mcs_%d%s.dat", tput_context->args.phy_bw_idx, tput_context->args.mcs, tput_context->args.mcs_table==SRSLTE_RA_DL_MCS_TABLE_256QAM?"_256qam":"");
   fid = fopen(fileName, "w");
 
   printf("\n\n--------------------------------------------------------------------\n");
@@ -303,11 +303,11 @@ void *tx_side_work(void *h) {
   // Calculate number of bytes per slot.
   if(tput_context->args.phy_bw_idx == BW_IDX_OneDotFour && tput_context->args.mcs > 28) {
     // Number of bytes for 1.4 MHz and MCS 28.
-    numOfBytes = srslte_ra_get_tb_size_scatter(tput_context->args.phy_bw_idx-1, 28);
+    numOfBytes = srslte_ra_get_tb_size_mcs_table_scatter(tput_context->args.mcs_table, tput_context->args.phy_bw_idx-1, 28);
     // Number of bytes for 1.4 MHz and MCS > 28.
-    numOfBytes += (tput_context->args.nof_slots_to_tx-1)*srslte_ra_get_tb_size_scatter(tput_context->args.phy_bw_idx-1, tput_context->args.mcs);
+    numOfBytes += (tput_context->args.nof_slots_to_tx-1)*srslte_ra_get_tb_size_mcs_table_scatter(tput_context->args.mcs_table, tput_context->args.phy_bw_idx-1, tput_context->args.mcs);
   } else {
-    numOfBytes = tput_context->args.nof_slots_to_tx*srslte_ra_get_tb_size_scatter(tput_context->args.phy_bw_idx-1, tput_context->args.mcs);
+    numOfBytes = tput_context->args.nof_slots_to_tx*srslte_ra_get_tb_size_mcs_table_scatter(tput_context->args.mcs_table, tput_context->args.phy_bw_idx-1, tput_context->args.mcs);
   }
   // Allocate memory for data slots.
   data = (uchar*)srslte_vec_malloc(numOfBytes);
@@ -347,9 +347,9 @@ void *tx_side_work(void *h) {
         basic_ctrl.data[data_pos] = data_cnt;
         // Increment data position.
         if(tput_context->args.phy_bw_idx == BW_IDX_OneDotFour && tput_context->args.mcs > 28 && tb_cnt == 0) {
-          data_pos += srslte_ra_get_tb_size_scatter(tput_context->args.phy_bw_idx-1, 28);
+          data_pos += srslte_ra_get_tb_size_mcs_table_scatter(tput_context->args.mcs_table, tput_context->args.phy_bw_idx-1, 28);
         } else {
-          data_pos += srslte_ra_get_tb_size_scatter(tput_context->args.phy_bw_idx-1, tput_context->args.mcs);
+          data_pos += srslte_ra_get_tb_size_mcs_table_scatter(tput_context->args.mcs_table, tput_context->args.phy_bw_idx-1, tput_context->args.mcs);
         }
         // Increment counter.
         data_cnt = (data_cnt + 1) % tput_context->maximum_counter_value;
@@ -437,6 +437,7 @@ void default_args(tput_test_args_t *args) {
   args->frame_type = 1;
   args->rf_boost = 0.8;
   args->node_id = 0;
+  args->mcs_table = SRSLTE_RA_DL_MCS_TABLE_64QAM;
 }
 
 int start_tx_side_thread(tput_context_t *tput_context) {
@@ -494,7 +495,7 @@ inline double time_diff(struct timespec *start, struct timespec *stop) {
 void parse_args(tput_test_args_t *args, int argc, char **argv) {
   int opt;
   default_args(args);
-  while((opt = getopt(argc, argv, "bdgikmnoprstI0123456789")) != -1) {
+  while((opt = getopt(argc, argv, "bdgikmnoprstuI0123456789")) != -1) {
     switch(opt) {
     case 'b':
       args->tx_gain = atoi(argv[optind]);
@@ -540,6 +541,10 @@ void parse_args(tput_test_args_t *args, int argc, char **argv) {
       args->tx_channel = atoi(argv[optind]);
       printf("[Input argument] Tx channel: %d\n", args->tx_channel);
       break;
+    case 'u':
+      args->mcs_table = SRSLTE_RA_DL_MCS_TABLE_256QAM;
+      printf("[Input argument] 256QAM MCS table: enabled\n");
+      break;
     case 'd':
       args->nof_phys = atoi(argv[optind]);
       printf("[Input argument] Number of PHYs: %d\n", args->nof_phys);
@@ -572,6 +577,11 @@ void parse_args(tput_test_args_t *args, int argc, char **argv) {
       exit(-1);
     }
   }
+  // The 256QAM table only defines MCS 0 to 27, the trx must also be started with the 256QAM MCS table enabled.
+  if(args->mcs > srslte_ra_max_mcs_scatter(args->mcs_table)) {
+    printf("[Input argument] Invalid MCS: %d. It has to be less than or equal to %d.\n", args->mcs, srslte_ra_max_mcs_scatter(args->mcs_table));
+    exit(-1);
+  }
 }
 
 void generateData(uint32_t numOfBytes, uchar *data) {
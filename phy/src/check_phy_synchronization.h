@@ -19,7 +19,7 @@
 #include "srslte/intf/intf.h"
 #include "../../../../communicator/cpp/communicator_wrapper.h"
 
-#define MAX_NOF_PHYS 2
+#define MAX_NOF_PHYS MAX_NUM_CONCURRENT_PHYS
 
 #define MAX_TX_SLOTS 100000
 
@@ -48,6 +48,7 @@ typedef struct {
   uint32_t frame_type;
   double rf_boost;
   uint32_t node_id;
+  srslte_ra_dl_mcs_table_t mcs_table;
 } tput_test_args_t;
 
 typedef struct {
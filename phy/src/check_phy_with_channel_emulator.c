@@ -110,27 +110,27 @@ void rx_side(tput_context_t *tput_context) {
   phy_stat_t phy_rx_stat;
   uchar data[10000];
   bool ret;
-  uint32_t errors[2] = {0, 0}, nof_errors = 0, nof_decoded[2] = {0, 0}, nof_detected[2] = {0, 0};
-  uint32_t last_nof_decoded_counter[2] = {0, 0}, last_nof_detected_counter[2] = {0, 0};
-  double prr[2] = {0.0, 0.0};
-  uint32_t correct_cnt[MAX_NOF_PHYS] = {0, 0};
-  uint32_t error_cnt[MAX_NOF_PHYS] = {0, 0};
+  uint32_t errors[MAX_NOF_PHYS] = {0}, nof_errors = 0, nof_decoded[MAX_NOF_PHYS] = {0}, nof_detected[MAX_NOF_PHYS] = {0};
+  uint32_t last_nof_decoded_counter[MAX_NOF_PHYS] = {0}, last_nof_detected_counter[MAX_NOF_PHYS] = {0};
+  double prr[MAX_NOF_PHYS] = {0.0};
+  uint32_t correct_cnt[MAX_NOF_PHYS] = {0};
+  uint32_t error_cnt[MAX_NOF_PHYS] = {0};
 #if(CHECK_RX_SEQUENCE==1)
-  uint32_t sequence_error_cnt[MAX_NOF_PHYS] = {0, 0};
-  uint32_t cnt[MAX_NOF_PHYS] = {0, 0};
-  uint32_t loop_cnt[MAX_NOF_PHYS] = {0, 0};
+  uint32_t sequence_error_cnt[MAX_NOF_PHYS] = {0};
+  uint32_t cnt[MAX_NOF_PHYS] = {0};
+  uint32_t loop_cnt[MAX_NOF_PHYS] = {0};
   uint32_t data_cnt[MAX_NOF_PHYS];
-  uint32_t last_tb_error_cnt[MAX_NOF_PHYS] = {0, 0};
+  uint32_t last_tb_error_cnt[MAX_NOF_PHYS] = {0};
   // Initialize expected data vector.
   for(uint32_t i = 0; i < MAX_NOF_PHYS; i++) {
     data_cnt[i] = i*tput_context->args.nof_slots_to_tx;
   }
 #endif
 #if(ENABLE_DECODING_TIME_PROFILLING==1)
-  double decoding_time[MAX_NOF_PHYS] = {0.0, 0.0};
-  double synch_plus_decoding_time[MAX_NOF_PHYS] = {0.0, 0.0};
-  double max_decoding_time[MAX_NOF_PHYS] = {0.0, 0.0};
-  uint32_t max_decoding_time_cnt[MAX_NOF_PHYS] = {0, 0};
+  double decoding_time[MAX_NOF_PHYS] = {0.0};
+  double synch_plus_decoding_time[MAX_NOF_PHYS] = {0.0};
+  double max_decoding_time[MAX_NOF_PHYS] = {0.0};
+  uint32_t max_decoding_time_cnt[MAX_NOF_PHYS] = {0};
 #endif
   uint32_t send_to = 0, intf_id = 0;
   uint64_t timestamp, last_msg_timestamp = 0;
@@ -259,15 +259,22 @@ void rx_side(tput_context_t *tput_context) {
   }
 
   uint32_t total_correct_cnt = 0, total_error_cnt = 0;
-  for(uint32_t i = 0; i < MAX_NOF_PHYS; i++) {
+  for(uint32_t i = 0; i < tput_context->args.nof_phys; i++) {
     total_correct_cnt += correct_cnt[i];
     total_error_cnt += error_cnt[i];
     printf("[Rx side] PHY Rx Id: %d - Total # of Errors: %d\n", i, sequence_error_cnt[i]);
   }
 
   printf("\n\n[Rx side] # Correct pkts: %d - # Error pkts: %d\n", total_correct_cnt, total_error_cnt);
-  nof_errors = (errors[0]+errors[1]);
-  printf("[Rx side] MCS: %d - PRR[0]: %1.2f - PRR[1]: %1.2f - # Decoded[0]: %d - # Decoded[1]: %d - # Detected[0]: %d - # Detected[1]: %d - # errors: %d\n", phy_rx_stat.mcs, prr[0], prr[1], nof_decoded[0], nof_decoded[1], nof_detected[0], nof_detected[1], nof_errors);
+  tput_context->total_nof_detected_slots = 0;
+  tput_context->total_nof_decoded_slots = 0;
+  for(uint32_t i = 0; i < tput_context->args.nof_phys; i++) {
+    nof_errors += errors[i];
+    tput_context->total_nof_detected_slots += nof_detected[i];
+    tput_context->total_nof_decoded_slots += nof_decoded[i];
+    printf("[Rx side] MCS: %d - PRR[%d]: %1.2f - # Decoded[%d]: %d - # Detected[%d]: %d\n", phy_rx_stat.mcs, i, prr[i], i, nof_decoded[i], i, nof_detected[i]);
+  }
+  printf("[Rx side] MCS: %d - # errors: %d\n", phy_rx_stat.mcs, nof_errors);
 
 #if(ENABLE_DECODING_TIME_PROFILLING==1)
   for(uint32_t i = 0; i < tput_context->args.nof_phys; i++) {
@@ -275,10 +282,6 @@ void rx_side(tput_context_t *tput_context) {
   }
 #endif
 
-  tput_context->total_nof_detected_slots = (nof_detected[0] + nof_detected[1]);
-
-  tput_context->total_nof_decoded_slots = (nof_decoded[0] + nof_decoded[1]);
-
   printf("[Rx side] Leaving Rx side.\n");
 }
 
@@ -542,6 +545,10 @@ void parse_args(tput_test_args_t *args, int argc, char **argv) {
       break;
     case 'd':
       args->nof_phys = atoi(argv[optind]);
+      if(args->nof_phys == 0 || args->nof_phys > MAX_NOF_PHYS) {
+        printf("[Input argument] Number of PHYs must be between 1 and %d.\n", MAX_NOF_PHYS);
+        exit(-1);
+      }
       printf("[Input argument] Number of PHYs: %d\n", args->nof_phys);
       break;
     case 'o':
@@ -20,6 +20,7 @@
 #include "../../../../communicator/cpp/communicator_wrapper.h"
 #include "helpers.h"
 #include "transceiver.h"
+#include "rx_channelizer.h"
 #include "plot.h"
 
 // ************************** Definition of macros *****************************
@@ -35,6 +36,12 @@
 // Number of Rx basic control messages to be stored in the circular buffer.
 #define NUMBER_OF_CONTROL_MSGS_TO_STORE 1000
 
+// Number of synchronization and decoding contexts, one per PHY BW index.
+#define PHY_RX_NOF_BW_CONTEXTS (BW_IDX_Twenty+1)
+
+// Flag used to build the contexts of all PHY BWs at start up. Otherwise, each one is built the first time its BW is configured.
+#define PHY_RX_PREBUILD_BW_CONTEXTS 0
+
 // ***************************** Debugging macros ******************************
 #define CHECK_TIME_BETWEEN_DEMOD_ITER 0
 
@@ -105,7 +112,11 @@ typedef struct {
   uint32_t bw_idx;
   uint32_t max_turbo_decoder_noi;
   uint32_t max_turbo_decoder_noi_for_high_mcs;
+  srslte_ra_dl_mcs_table_t mcs_table;
   bool phy_filtering;
+  uint32_t nof_harq_processes;
+  uint32_t harq_timeout;
+  bool burst_tracking;
 
   pthread_attr_t rx_decoding_thread_attr;
   pthread_t rx_decoding_thread_id;
@@ -121,9 +132,16 @@ typedef struct {
   // This basic controls stores the last configured values.
   basic_ctrl_t last_rx_basic_control;
 
-  // Structures used to decode subframes.
-  srslte_ue_dl_t ue_dl;
-  srslte_ue_sync_t ue_sync;
+  // Structures used to decode subframes, one set per PHY BW index. They are kept until the PHY is stopped so that a BW change only swaps pointers.
+  srslte_ue_dl_t ue_dl_bw[PHY_RX_NOF_BW_CONTEXTS];
+  srslte_ue_sync_t ue_sync_bw[PHY_RX_NOF_BW_CONTEXTS];
+  bool bw_context_ready[PHY_RX_NOF_BW_CONTEXTS];
+  // Structures in use by the synchronization thread and by the decoding thread respectively.
+  srslte_ue_sync_t *ue_sync;
+  srslte_ue_dl_t *ue_dl;
+  // BW index of the structures used by the synchronization thread and BW index it has to switch to.
+  uint32_t active_bw_idx;
+  volatile sig_atomic_t requested_bw_idx;
   srslte_cell_t cell_ue;
 
   // This mutex is used to synchronize the access to the last configured basic control.
@@ -189,12 +207,18 @@ void set_rx_gain(phy_reception_t* const phy_reception_ctx, uint32_t rx_gain);
 
 uint32_t get_rx_gain(phy_reception_t* const phy_reception_ctx);
 
+void set_harq_info(phy_reception_t* const phy_reception_ctx, uint32_t harq_pid, uint32_t retx_cnt);
+
+void get_harq_info(phy_reception_t* const phy_reception_ctx, uint32_t *harq_pid, uint32_t *retx_cnt);
+
 void *phy_reception_decoding_work(void *h);
 
 void phy_reception_send_rx_statistics(LayerCommunicator_handle handle, phy_stat_t* const phy_rx_stat);
 
 int phy_reception_ue_init(phy_reception_t* const phy_reception_ctx);
 
+int phy_reception_ue_init_bw_context(phy_reception_t* const phy_reception_ctx, uint32_t bw_idx);
+
 int phy_reception_stop_rx_stream_and_flush_buffer(phy_reception_t* const phy_reception_ctx);
 
 int phy_reception_initialize_rx_stream(phy_reception_t* const phy_reception_ctx);
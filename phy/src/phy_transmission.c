@@ -39,7 +39,9 @@ int phy_transmission_start_thread(LayerCommunicator_handle handle, srslte_rf_t*
 
 int phy_transmission_init_thread_context(phy_transmission_t* const phy_transmission_ctx, LayerCommunicator_handle handle, srslte_rf_t* const rf, transceiver_args_t* const args) {
   // Instantiate and reserve positions for Tx basic control information.
-  tx_cb_make(&phy_transmission_ctx->tx_basic_control_handle, NUMBER_OF_USER_DATA_BUFFERS/2);
+  // All PHYs lease their user data from the same slab, so it is split among them, keeping half of it for the
+  // basic controls being encoded or leased by the communicator and not queued yet.
+  tx_pq_make(&phy_transmission_ctx->tx_basic_control_handle, NUMBER_OF_USER_DATA_BUFFERS/(2*args->nof_phys));
   // Set PHY transmission context.
   phy_transmission_init_context(phy_transmission_ctx, handle, rf, args);
   // Set Tx sample rate for Tx chain accoring to the number of PRBs.
@@ -59,10 +61,16 @@ int phy_transmission_init_thread_context(phy_transmission_t* const phy_transmiss
     trx_filter_init_filter_length(phy_transmission_ctx->trx_filter_idx);
   }
 #endif
-  // Allocate memory for transmission buffers.
-  phy_transmission_init_buffers(phy_transmission_ctx);
-  // Initialize base station structures.
-  phy_transmission_base_init(phy_transmission_ctx);
+  // Generate the synchronization sequences.
+  if(phy_transmission_sync_signals_init(phy_transmission_ctx) < 0) {
+    PHY_TX_ERROR("PHY ID: %d - Error generating synchronization sequences.\n", phy_transmission_ctx->phy_id);
+    return -1;
+  }
+  // Allocate transmission buffers and initialize base station structures of the initial PHY BW, or of all of them.
+  if(phy_transmission_init_bw_contexts(phy_transmission_ctx) < 0) {
+    PHY_TX_ERROR("PHY ID: %d - Error initializing Tx structs.\n", phy_transmission_ctx->phy_id);
+    return -1;
+  }
   PHY_TX_PRINT("PHY ID: %d - phy_transmission_base_init done!\n", phy_transmission_ctx->phy_id);
   // Initial update of allocation with MCS 0 and initial number of resource blocks.
   phy_transmission_update_radl(phy_transmission_ctx, 0, args->nof_prb);
@@ -111,13 +119,14 @@ void phy_transmission_init_context(phy_transmission_t* const phy_transmission_ct
   phy_transmission_ctx->bw_idx                      = helpers_get_bw_index_from_prb(args->nof_prb); // Convert from number of Resource Blocks to BW Index.
   phy_transmission_ctx->last_nof_subframes_to_tx    = 0;
   phy_transmission_ctx->last_mcs                    = 0;
+  bzero(phy_transmission_ctx->harq_ndi, sizeof(phy_transmission_ctx->harq_ndi));
   phy_transmission_ctx->number_of_tx_offset_samples = 0;
-  phy_transmission_ctx->sf_n_re                     = 0;
-  phy_transmission_ctx->sf_n_samples                = 0;
-  phy_transmission_ctx->sf_buffer_eb                = NULL;
-  phy_transmission_ctx->output_buffer               = NULL;
-  phy_transmission_ctx->subframe_ofdm_symbols       = NULL;
+  phy_transmission_ctx->bw                          = NULL;
+  phy_transmission_ctx->pss_signal                  = NULL;
+  phy_transmission_ctx->pss_signal_end              = NULL;
   phy_transmission_ctx->competition_center_freq     = args->competition_center_frequency;
+  phy_transmission_ctx->tx_reconfiguration_time     = 0;
+  tx_lead_time_init(&phy_transmission_ctx->tx_lead_time);
   phy_transmission_ctx->competition_bw              = args->competition_bw;
   phy_transmission_ctx->env_update                  = false;
   phy_transmission_ctx->competition_freq_updated    = false;
@@ -129,6 +138,7 @@ void phy_transmission_init_context(phy_transmission_t* const phy_transmission_ct
   phy_transmission_ctx->pss_len                     = args->pss_len;
   phy_transmission_ctx->pss_boost_factor            = args->pss_boost_factor;
   phy_transmission_ctx->enable_eob_pss              = args->enable_eob_pss;
+  phy_transmission_ctx->mcs_table                   = args->enable_256qam?SRSLTE_RA_DL_MCS_TABLE_256QAM:SRSLTE_RA_DL_MCS_TABLE_64QAM;
 }
 
 // Free all the resources used by the PHY transmission module.
@@ -147,6 +157,7 @@ int phy_transmission_stop_thread(uint32_t phy_id) {
   // Destroy mutexes.
   pthread_mutex_destroy(&phy_tx_threads[phy_id]->tx_basic_control_mutex);
   pthread_mutex_destroy(&phy_tx_threads[phy_id]->tx_env_update_mutex);
+  tx_lead_time_free(&phy_tx_threads[phy_id]->tx_lead_time);
   // Destory conditional variable.
   if(pthread_cond_destroy(&phy_tx_threads[phy_id]->tx_basic_control_cv) != 0) {
     PHY_TX_ERROR("PHY ID: %d - Encoding/transmission conditional variable destruction failed.\n",phy_id);
@@ -156,14 +167,20 @@ int phy_transmission_stop_thread(uint32_t phy_id) {
   // Free FIR Filter kernel.
   trx_filter_free_simd_kernel_mm256();
 #endif
-  // Free all base station structures.
-  phy_transmission_free_base(phy_tx_threads[phy_id]);
-  PHY_TX_INFO("PHY ID: %d - phy_transmission_free_base done!\n",phy_id);
-  // Free memory used for transmission buffers.
-  phy_transmission_free_buffers(phy_tx_threads[phy_id]);
-  PHY_TX_INFO("PHY ID: %d - phy_transmission_free_buffers done!\n",phy_id);
-  // Delete circular buffer.
-  tx_cb_free(&phy_tx_threads[phy_id]->tx_basic_control_handle);
+  // Free all base station structures and transmission buffers of every PHY BW built so far.
+  for(uint32_t bw_idx = 0; bw_idx < PHY_TX_NOF_BW_CONTEXTS; bw_idx++) {
+    if(phy_tx_threads[phy_id]->bw_ctx[bw_idx].ready) {
+      phy_tx_threads[phy_id]->bw = &phy_tx_threads[phy_id]->bw_ctx[bw_idx];
+      phy_transmission_free_base(phy_tx_threads[phy_id]);
+      phy_transmission_free_buffers(phy_tx_threads[phy_id]);
+      phy_tx_threads[phy_id]->bw_ctx[bw_idx].ready = false;
+      PHY_TX_INFO("PHY ID: %d - Structures of BW index %d freed!\n",phy_id,bw_idx);
+    }
+  }
+  // Free synchronization sequences.
+  phy_transmission_free_sync_signals(phy_tx_threads[phy_id]);
+  // Delete deadline ordered queue.
+  tx_pq_free(&phy_tx_threads[phy_id]->tx_basic_control_handle);
   // Free memory used to store PHY Tx context object.
   if(phy_tx_threads[phy_id]) {
     free(phy_tx_threads[phy_id]);
@@ -201,6 +218,59 @@ void phy_transmission_init_last_basic_control(phy_transmission_t* const phy_tran
   phy_transmission_ctx->last_tx_basic_control.length       = 1;
 }
 
+// Make the context of the given PHY BW the one used for encoding, building its structures the first time the BW is used.
+int phy_transmission_select_bw_context(phy_transmission_t* const phy_transmission_ctx, uint32_t bw_idx) {
+  if(bw_idx == BW_IDX_UNKNOWN || bw_idx >= PHY_TX_NOF_BW_CONTEXTS) {
+    PHY_TX_ERROR("PHY ID: %d - Undefined BW Index: %d....\n", phy_transmission_ctx->phy_id, bw_idx);
+    return -1;
+  }
+  // Update paramters for new PHY BW.
+  phy_transmission_ctx->bw                          = &phy_transmission_ctx->bw_ctx[bw_idx];
+  phy_transmission_ctx->cell_enb.nof_prb            = helpers_get_prb_from_bw_index(bw_idx);
+  phy_transmission_ctx->nof_prb                     = phy_transmission_ctx->cell_enb.nof_prb;
+  phy_transmission_ctx->default_tx_bandwidth        = helpers_get_bw_from_nprb(phy_transmission_ctx->nof_prb);
+  phy_transmission_ctx->bw_idx                      = bw_idx;
+  if(!phy_transmission_ctx->bw->ready) {
+    phy_transmission_ctx->bw->sf_buffer_eb          = NULL;
+    phy_transmission_ctx->bw->output_buffer         = NULL;
+    phy_transmission_ctx->bw->subframe_ofdm_symbols = NULL;
+    // Allocate memory for transmission buffers.
+    if(phy_transmission_init_buffers(phy_transmission_ctx) < 0) {
+      PHY_TX_ERROR("PHY ID: %d - Error initializing Tx buffers.\n", phy_transmission_ctx->phy_id);
+      return -1;
+    }
+    // Initialize base station structures.
+    if(phy_transmission_base_init(phy_transmission_ctx) < 0) {
+      PHY_TX_ERROR("PHY ID: %d - Error initializing Tx structs.\n", phy_transmission_ctx->phy_id);
+      return -1;
+    }
+    phy_transmission_ctx->bw->ready = true;
+  }
+#if(ENABLE_PHY_TX_FILTERING==1)
+  // Create filter kernel.
+  if(phy_transmission_ctx->trx_filter_idx > 0) {
+   trx_filter_create_tx_simd_kernel_mm256(helpers_get_bw_index(phy_transmission_ctx->bw_idx));
+  }
+#endif
+  // Everything went well.
+  return 0;
+}
+
+int phy_transmission_init_bw_contexts(phy_transmission_t* const phy_transmission_ctx) {
+  uint32_t initial_bw_idx = phy_transmission_ctx->bw_idx;
+  for(uint32_t bw_idx = 0; bw_idx < PHY_TX_NOF_BW_CONTEXTS; bw_idx++) {
+    phy_transmission_ctx->bw_ctx[bw_idx].ready = false;
+  }
+#if(PHY_TX_PREBUILD_BW_CONTEXTS==1)
+  for(uint32_t bw_idx = BW_IDX_OneDotFour; bw_idx < PHY_TX_NOF_BW_CONTEXTS; bw_idx++) {
+    if(phy_transmission_select_bw_context(phy_transmission_ctx, bw_idx) < 0) {
+      return -1;
+    }
+  }
+#endif
+  return phy_transmission_select_bw_context(phy_transmission_ctx, initial_bw_idx);
+}
+
 static inline int phy_transmission_change_bw(phy_transmission_t* const phy_transmission_ctx, basic_ctrl_t* const bc) {
   int ret = 0;
   // Lock this section of the code so that PHY Tx threads do not interfere with each other when changing the USRP parameters.
@@ -211,36 +281,14 @@ static inline int phy_transmission_change_bw(phy_transmission_t* const phy_trans
     ret = -1;
     goto exit_phy_tx_change_bw;
   }
-  // Set eNodeB PRB based on BW index.
-  phy_transmission_ctx->cell_enb.nof_prb = helpers_get_prb_from_bw_index(bc->bw_idx);
-  // Free all related Tx structures.
-  phy_transmission_free_base(phy_transmission_ctx);
-  // Free the transmission buffers.
-  phy_transmission_free_buffers(phy_transmission_ctx);
-  // Update paramters for new PHY BW.
-  phy_transmission_ctx->nof_prb                     = phy_transmission_ctx->cell_enb.nof_prb;
-  phy_transmission_ctx->default_tx_bandwidth        = helpers_get_bw_from_nprb(phy_transmission_ctx->nof_prb);
-  phy_transmission_ctx->bw_idx                      = helpers_get_bw_index_from_prb(phy_transmission_ctx->nof_prb);
-  phy_transmission_ctx->sf_n_re                     = 0;
-  phy_transmission_ctx->sf_n_samples                = 0;
-  phy_transmission_ctx->sf_buffer_eb                = NULL;
-  phy_transmission_ctx->output_buffer               = NULL;
-  phy_transmission_ctx->subframe_ofdm_symbols       = NULL;
-  // Set new Tx sample rate.
-  if(phy_transmission_set_tx_sample_rate(phy_transmission_ctx) < 0) {
-    PHY_TX_ERROR("Error setting Tx sample rate.\n", 0);
-    ret = -1;
-    goto exit_phy_tx_change_bw;
-  }
-  // Allocate memory for transmission buffers.
-  if(phy_transmission_init_buffers(phy_transmission_ctx) < 0) {
-    PHY_TX_ERROR("Error initializing Tx buffers.\n", 0);
+  // Switch to the structures of the new PHY BW, they are only built the first time the BW is used.
+  if(phy_transmission_select_bw_context(phy_transmission_ctx, bc->bw_idx) < 0) {
     ret = -1;
     goto exit_phy_tx_change_bw;
   }
-  // Initialize base station structures.
-  if(phy_transmission_base_init(phy_transmission_ctx) < 0) {
-    PHY_TX_ERROR("Error initializing Tx structs.\n", 0);
+  // Set new Tx sample rate.
+  if(phy_transmission_set_tx_sample_rate(phy_transmission_ctx) < 0) {
+    PHY_TX_ERROR("Error setting Tx sample rate.\n", 0);
     ret = -1;
     goto exit_phy_tx_change_bw;
   }
@@ -268,8 +316,16 @@ int phy_transmission_change_parameters(phy_transmission_t* const phy_transmissio
     PHY_TX_ERROR("PHY ID: %d - Invalid Tx BW Index: %d\n", phy_transmission_ctx->phy_id, bc->bw_idx);
     return -1;
   }
+#if(ENABLE_TX_COMBINER==1)
+  // The combiner feeds the shared RF channel at a rate fixed by the PHY BW given to trx, so the PHY BW can not be changed.
+  // Reject the command before any parameter or BW related state is touched.
+  if(phy_transmission_ctx->last_tx_basic_control.bw_idx != bc->bw_idx) {
+    PHY_TX_ERROR("PHY ID: %d - PHY BW index can not be changed from %d to %d while the Tx combiner is enabled.\n", phy_transmission_ctx->phy_id, phy_transmission_ctx->last_tx_basic_control.bw_idx, bc->bw_idx);
+    return -1;
+  }
+#endif
   // Check MCS index range.
-  if(bc->mcs > 31) {
+  if(bc->mcs > srslte_ra_max_mcs_scatter(phy_transmission_ctx->mcs_table)) {
     PHY_TX_ERROR("PHY ID: %d - Invalid MCS: %d!\n", phy_transmission_ctx->phy_id, bc->mcs);
     return -1;
   }
@@ -289,7 +345,7 @@ int phy_transmission_change_parameters(phy_transmission_t* const phy_transmissio
     return -1;
   }
   // Check TB size.
-  if(phy_transmission_validate_tb_size(bc, bw_idx, phy_transmission_ctx->phy_id) < 0) {
+  if(phy_transmission_validate_tb_size(bc, phy_transmission_ctx->mcs_table, bw_idx, phy_transmission_ctx->phy_id) < 0) {
     PHY_TX_ERROR("PHY ID: %d - Invalid TB size.\n", phy_transmission_ctx->phy_id);
     return -1;
   }
@@ -336,10 +392,12 @@ int phy_transmission_change_parameters(phy_transmission_t* const phy_transmissio
   // All parameters and sampling rate are changed according to the new BW index.
   if(phy_transmission_ctx->last_tx_basic_control.bw_idx != bc->bw_idx) {
     // Change all related BW parameters.
+    uint64_t reconfiguration_start = helpers_get_host_time_now();
     if(phy_transmission_change_bw(phy_transmission_ctx, bc) < 0) {
       PHY_TX_ERROR("PHY ID: %d - Error changing bandwidth.\n", phy_transmission_ctx->phy_id);
       return -1;
     }
+    phy_transmission_ctx->tx_reconfiguration_time += helpers_get_host_time_now() - reconfiguration_start;
     // Execute non-timed parameter configuration as when changing BW timed ones doesn't work.
     if(phy_transmission_change_non_timed_parameters(phy_transmission_ctx, bc) < 0) {
       PHY_TX_ERROR("PHY ID: %d - Error changing non-timed parameters.\n", phy_transmission_ctx->phy_id);
@@ -376,7 +434,15 @@ int phy_transmission_change_timed_parameters(phy_transmission_t* const phy_trans
     tx_bandwidth = helpers_get_bandwidth_float(bc->bw_idx);
     // Calculate central Tx frequency for the channels.
     tx_channel_center_freq = phy_transmission_calculate_channel_center_frequency(phy_transmission_ctx, tx_bandwidth, bc->ch);
-#if(ENABLE_HW_RF_MONITOR==1)
+#if(ENABLE_TX_COMBINER==1)
+    // The channel is placed inside the shared RF channel, so the change is applied right away.
+    lo_offset = 0.0;
+    actual_tx_freq = tx_combiner_set_channel_freq(tx_combiner_get_handle(), phy_transmission_ctx->phy_id, tx_channel_center_freq);
+    if(actual_tx_freq < 0.0) {
+      PHY_TX_ERROR("PHY ID: %d - Error setting Tx combiner frequency. Returning error: %f\n", phy_transmission_ctx->phy_id, actual_tx_freq);
+      return -10;
+    }
+#elif(ENABLE_HW_RF_MONITOR==1)
     // Always apply offset when HW RF Monitor is enabled.
     lo_offset = (double)PHY_TX_LO_OFFSET;
     // Change the RF front-end center frequency only if there is an environment update
@@ -432,7 +498,9 @@ int phy_transmission_change_timed_parameters(phy_transmission_t* const phy_trans
     PHY_TX_DEBUG_TIME("PHY ID: %d - Tx ---> BW[%d]: %1.1f [MHz] - Channel: %d - Set freq to: %.2f [MHz] - Offset: %.2f [MHz]\n", phy_transmission_ctx->phy_id, bc->bw_idx, (tx_bandwidth/1000000.0), bc->ch, (actual_tx_freq/1000000.0),(lo_offset/1000000.0));
   }
   // Change Tx gain only if the parameter has changed.
-  if(phy_transmission_ctx->last_tx_basic_control.gain != bc->gain) {
+  // The gain of the RF channel shared through the combiner is not changed by any single PHY.
+  // Likewise, its sampling rate is fixed, so PHY BW changes are rejected in phy_transmission_change_parameters().
+  if(phy_transmission_ctx->last_tx_basic_control.gain != bc->gain && ENABLE_TX_COMBINER == 0) {
     // Set Tx gain.
     tx_gain = srslte_rf_set_tx_gain_cmd(phy_transmission_ctx->rf, (float)bc->gain, bc->timestamp, TX_TIME_ADVANCE_FOR_COMMANDS, phy_transmission_ctx->phy_id);
     if(tx_gain < 0.0) {
@@ -459,7 +527,15 @@ int phy_transmission_change_non_timed_parameters(phy_transmission_t* const phy_t
     tx_bandwidth = helpers_get_bandwidth_float(bc->bw_idx);
     // Calculate central Tx frequency for the channels.
     tx_channel_center_freq = phy_transmission_calculate_channel_center_frequency(phy_transmission_ctx, tx_bandwidth, bc->ch);
-#if(ENABLE_HW_RF_MONITOR==1)
+#if(ENABLE_TX_COMBINER==1)
+    // The channel is placed inside the shared RF channel, so the change is applied right away.
+    lo_offset = 0.0;
+    actual_tx_freq = tx_combiner_set_channel_freq(tx_combiner_get_handle(), phy_transmission_ctx->phy_id, tx_channel_center_freq);
+    if(actual_tx_freq < 0.0) {
+      PHY_TX_ERROR("PHY ID: %d - Error setting Tx combiner frequency. Returning error: %f\n", phy_transmission_ctx->phy_id, actual_tx_freq);
+      return -10;
+    }
+#elif(ENABLE_HW_RF_MONITOR==1)
     // Set frequency offset for transmission.
     lo_offset = (double)PHY_TX_LO_OFFSET;
     // Change the RF front-end center frequency only if there is an environment update
@@ -495,7 +571,9 @@ int phy_transmission_change_non_timed_parameters(phy_transmission_t* const phy_t
     PHY_TX_DEBUG_TIME("PHY ID: %d - Tx ---> BW[%d]: %1.1f [MHz] - Channel: %d - Set freq to: %.2f [MHz] - Offset: %.2f [MHz]\n", phy_transmission_ctx->phy_id, bc->bw_idx, (tx_bandwidth/1000000.0), bc->ch, (actual_tx_freq/1000000.0),(lo_offset/1000000.0));
   }
   // Change Tx gain only if the parameter has changed.
-  if(phy_transmission_ctx->last_tx_basic_control.gain != bc->gain) {
+  // The gain of the RF channel shared through the combiner is not changed by any single PHY.
+  // Likewise, its sampling rate is fixed, so PHY BW changes are rejected in phy_transmission_change_parameters().
+  if(phy_transmission_ctx->last_tx_basic_control.gain != bc->gain && ENABLE_TX_COMBINER == 0) {
     // Set Tx gain.
     tx_gain = srslte_rf_set_tx_gain(phy_transmission_ctx->rf, (float)bc->gain, phy_transmission_ctx->phy_id);
     if(tx_gain < 0) {
@@ -510,24 +588,29 @@ int phy_transmission_change_non_timed_parameters(phy_transmission_t* const phy_t
   return 0;
 }
 
-int phy_transmission_validate_tb_size(basic_ctrl_t *bc, uint32_t bw_idx, uint32_t phy_id) {
+int phy_transmission_validate_tb_size(basic_ctrl_t *bc, srslte_ra_dl_mcs_table_t mcs_table, uint32_t bw_idx, uint32_t phy_id) {
+  // The TB size is 0 if the MCS is out of the range of the MCS table.
+  if(phy_transmission_get_tb_size(mcs_table, bw_idx, bc->mcs) == 0 || (bc->bw_idx == BW_IDX_OneDotFour && bc->mcs > 28 && phy_transmission_get_tb_size(mcs_table, bw_idx, 28) == 0)) {
+    PHY_TX_ERROR("PHY ID: %d - No TB size for MCS: %d and BW index: %d with the selected MCS table.\n", phy_id, bc->mcs, bc->bw_idx);
+    return -1;
+  }
   // Change MCS. For 1.4 MHz we can not set MCS greater than 28 for the very first subframe.
   if(bc->bw_idx == BW_IDX_OneDotFour && bc->mcs > 28) {
     // Check size.
-    int length = bc->length - phy_transmission_get_tb_size(bw_idx, 28);
-    if(length > 0 && length % phy_transmission_get_tb_size(bw_idx, bc->mcs) != 0) {
-      PHY_TX_ERROR("PHY ID: %d - Data length set by MAC to subsequent subframes is invalid. Length field in Basic control command: %d - expected size: %d\n", phy_id, bc->length, phy_transmission_get_tb_size(bw_idx, bc->mcs));
+    int length = bc->length - phy_transmission_get_tb_size(mcs_table, bw_idx, 28);
+    if(length > 0 && length % phy_transmission_get_tb_size(mcs_table, bw_idx, bc->mcs) != 0) {
+      PHY_TX_ERROR("PHY ID: %d - Data length set by MAC to subsequent subframes is invalid. Length field in Basic control command: %d - expected size: %d\n", phy_id, bc->length, phy_transmission_get_tb_size(mcs_table, bw_idx, bc->mcs));
       return -1;
     }
     // Check if expected TB size is not bigger than length field in basic control message.
     if(length < 0) {
-      PHY_TX_ERROR("PHY ID: %d - Data length set by MAC is invalid (negative). Length field in Basic control command: %d - expected size: %d\n", phy_id, bc->length, phy_transmission_get_tb_size(bw_idx, bc->mcs));
+      PHY_TX_ERROR("PHY ID: %d - Data length set by MAC is invalid (negative). Length field in Basic control command: %d - expected size: %d\n", phy_id, bc->length, phy_transmission_get_tb_size(mcs_table, bw_idx, bc->mcs));
       return -1;
     }
   } else {
     // Check size.
-    if(bc->length % phy_transmission_get_tb_size(bw_idx, bc->mcs) != 0) {
-      PHY_TX_ERROR("PHY ID: %d - Data length set by MAC is invalid. Length field in Basic control command: %d - expected size: %d\n", phy_id,bc->length, phy_transmission_get_tb_size(bw_idx, bc->mcs));
+    if(bc->length % phy_transmission_get_tb_size(mcs_table, bw_idx, bc->mcs) != 0) {
+      PHY_TX_ERROR("PHY ID: %d - Data length set by MAC is invalid. Length field in Basic control command: %d - expected size: %d\n", phy_id,bc->length, phy_transmission_get_tb_size(mcs_table, bw_idx, bc->mcs));
       return -1;
     }
   }
@@ -547,18 +630,18 @@ void phy_transmission_change_allocation(phy_transmission_t* const phy_transmissi
   }
 }
 
-uint32_t phy_transmission_calculate_nof_subframes(uint32_t mcs, uint32_t bw_idx, uint32_t length) {
+uint32_t phy_transmission_calculate_nof_subframes(srslte_ra_dl_mcs_table_t mcs_table, uint32_t mcs, uint32_t bw_idx, uint32_t length) {
   uint32_t nof_subframes = 0;
   // Verify if BW is 1.4 MHz and MCS greater than 28.
   if((bw_idx+1) == BW_IDX_OneDotFour && mcs > 28) {
-    length = length - phy_transmission_get_tb_size(bw_idx, 28);
+    length = length - phy_transmission_get_tb_size(mcs_table, bw_idx, 28);
     nof_subframes = 1;
     if(length > 0) {
-      nof_subframes = nof_subframes + (length/phy_transmission_get_tb_size(bw_idx, mcs));
+      nof_subframes = nof_subframes + (length/phy_transmission_get_tb_size(mcs_table, bw_idx, mcs));
     }
   } else {
     // Calculate number of slots to be transmitted.
-    nof_subframes = (length/phy_transmission_get_tb_size(bw_idx, mcs));
+    nof_subframes = (length/phy_transmission_get_tb_size(mcs_table, bw_idx, mcs));
   }
   return nof_subframes;
 }
@@ -569,7 +652,7 @@ void *phy_transmission_work(void *h) {
   phy_stat_t phy_tx_stat;
   srslte_rf_t *rf = phy_transmission_ctx->rf;
   int sf_idx, subframe_cnt, tx_data_offset, number_of_additional_samples, subframe_buffer_offset, ret = 0, change_param_status = 0;
-  uint32_t bw_idx, nof_subframes_to_tx, mcs_local, nof_zero_padding_samples;
+  uint32_t bw_idx, nof_subframes_to_tx, mcs_local, nof_zero_padding_samples, harq_pid;
   bool start_of_burst, end_of_burst;
   time_t full_secs = 0;
   double frac_secs = 0.0, coding_time = 0.0;
@@ -578,6 +661,7 @@ void *phy_transmission_work(void *h) {
   basic_ctrl_t bc;
   lbt_stats_t lbt_stats;
   uint64_t number_of_dropped_packets = 0, fpga_time = 0;
+  uint64_t pop_timestamp = 0, sob_timestamp = 0;
   uint32_t filter_zero_padding_length = 0;
   srslte_dci_msg_t dci_msg;
 
@@ -622,6 +706,19 @@ void *phy_transmission_work(void *h) {
     if(phy_transmission_ctx->phy_id != bc.phy_id) {
       PHY_TX_ERROR("PHY ID: %d - Context PHY ID: %d is different from basic control PHY ID: %d. Dropping MAC message.\n", phy_transmission_ctx->phy_id, phy_transmission_ctx->phy_id, bc.phy_id);
       number_of_dropped_packets++;
+      // Give user data back to the communicator.
+      communicator_release_user_data_buffer(bc.data);
+      continue;
+    }
+
+    // Check if there is still enough time to encode the basic control before its deadline, otherwise drop it.
+    pop_timestamp = helpers_get_host_time_now();
+    phy_transmission_ctx->tx_reconfiguration_time = 0;
+    if(!phy_transmission_can_make_deadline(phy_transmission_ctx, &bc, pop_timestamp)) {
+      PHY_TX_ERROR("PHY ID: %d - Basic control can not make its deadline. Time to deadline: %d [us] - Avg. lead time: %1.0f [us]. Dropping MAC message.\n", phy_transmission_ctx->phy_id, (int)(bc.timestamp - pop_timestamp), tx_lead_time_get(&phy_transmission_ctx->tx_lead_time));
+      number_of_dropped_packets++;
+      // Give user data back to the communicator.
+      communicator_release_user_data_buffer(bc.data);
       continue;
     }
 
@@ -649,10 +746,12 @@ void *phy_transmission_work(void *h) {
       bw_idx = helpers_get_bw_index(bc.bw_idx);
 
       // Calculate number of slots to be transmitted.
-      nof_subframes_to_tx = phy_transmission_calculate_nof_subframes(bc.mcs, bw_idx, bc.length);
+      nof_subframes_to_tx = phy_transmission_calculate_nof_subframes(phy_transmission_ctx->mcs_table, bc.mcs, bw_idx, bc.length);
       if(nof_subframes_to_tx > MAX_NOF_TBS) {
         PHY_TX_ERROR("Invalid number of TBs: %d. It has to be less than %d TBs. Dropping MAC message.\n", nof_subframes_to_tx, MAX_NOF_TBS);
         number_of_dropped_packets++;
+        // Give user data back to the communicator.
+        communicator_release_user_data_buffer(bc.data);
         continue;
       }
       PHY_TX_DEBUG("PHY ID: %d - Number of slots to be transmitted: %d\n", phy_transmission_ctx->phy_id, nof_subframes_to_tx);
@@ -676,7 +775,7 @@ void *phy_transmission_work(void *h) {
       PHY_TX_DEBUG("PHY ID: %d - Entering Transmission (Tx) loop...\n",phy_transmission_ctx->phy_id);
       while(subframe_cnt < nof_subframes_to_tx && phy_transmission_ctx->run_tx_encoding_thread) {
 
-        bzero(phy_transmission_ctx->sf_buffer_eb, sizeof(cf_t) * phy_transmission_ctx->sf_n_re);
+        bzero(phy_transmission_ctx->bw->sf_buffer_eb, sizeof(cf_t) * phy_transmission_ctx->bw->sf_n_re);
 
         // Increase subframe counter number.
         subframe_cnt++;
@@ -684,7 +783,7 @@ void *phy_transmission_work(void *h) {
         // Add SCH/PSS/SSS to the very first subframe only.
         if(sf_idx == 0 || sf_idx == 5) {
           // Map PSS sequence into the resource grid.
-          srslte_pss_put_slot_scatter(phy_transmission_ctx->pss_signal, phy_transmission_ctx->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, phy_transmission_ctx->pss_len);
+          srslte_pss_put_slot_scatter(phy_transmission_ctx->pss_signal, phy_transmission_ctx->bw->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, phy_transmission_ctx->pss_len);
           // If decode PDCCH/PCFICH is enabled, then we map SSS sequence carrying number of transmitted slots, otherwise, we map SCH sequences carrying SRN ID/Radio Interface ID and MCS/number of transmitted slots.
           if(phy_transmission_ctx->decode_pdcch) {
             // Check if current number of subframes to transmit is different from last one.
@@ -695,7 +794,7 @@ void *phy_transmission_work(void *h) {
               phy_transmission_ctx->last_nof_subframes_to_tx = nof_subframes_to_tx;
             }
             // Insert SSS sequence into resource grid.
-            srslte_sss_put_slot(phy_transmission_ctx->sss_signal, phy_transmission_ctx->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp);
+            srslte_sss_put_slot(phy_transmission_ctx->sss_signal, phy_transmission_ctx->bw->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp);
           } else {
             // If PHY filtering is enable then we encode SRN ID and Radio Interface ID.
             if(phy_transmission_ctx->phy_filtering) {
@@ -708,7 +807,7 @@ void *phy_transmission_work(void *h) {
                 phy_transmission_ctx->last_tx_basic_control.intf_id = bc.intf_id;
               }
               // Map SCH sequence into resource grid.
-              srslte_sch_put_slot_generic(phy_transmission_ctx->sch_signal0, phy_transmission_ctx->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, 6);
+              srslte_sch_put_slot_generic(phy_transmission_ctx->sch_signal0, phy_transmission_ctx->bw->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, 6);
             }
 
             // Check if current number of subframes to transmit or MCS are different from the last ones.
@@ -720,12 +819,12 @@ void *phy_transmission_work(void *h) {
               phy_transmission_ctx->last_nof_subframes_to_tx = nof_subframes_to_tx;
             }
             // Map SCH sequence into resource grid. The same position as SSS, i.e., the 6th OFDM symbol.
-            srslte_sch_put_slot_generic(phy_transmission_ctx->sch_signal1, phy_transmission_ctx->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, 2);
+            srslte_sch_put_slot_generic(phy_transmission_ctx->sch_signal1, phy_transmission_ctx->bw->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, 2);
 
             // If filtering is not enabled, then use the first, i.e., the 2nd OFDM symbol, to carry the redundant SCH signal so that the probability decoding of SCH information is higher due to combining.
             if(!phy_transmission_ctx->phy_filtering) {
               // Map redundant SCH signal into the front of the first subframe (2nd OFDM symbol).
-              srslte_sch_put_slot_generic(phy_transmission_ctx->sch_signal1, phy_transmission_ctx->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, 6);
+              srslte_sch_put_slot_generic(phy_transmission_ctx->sch_signal1, phy_transmission_ctx->bw->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, 6);
             }
           }
         }
@@ -733,11 +832,11 @@ void *phy_transmission_work(void *h) {
         // Subframe index 7 now means it is the last subframe in a sequenece of subframes, i.e., a MAC slot.
         if(phy_transmission_ctx->enable_eob_pss && sf_idx == 7) {
           // Map PSS sequence into the resource grid of the last transmitted subframe, indicating end of transmission.
-          srslte_pss_put_slot_scatter(phy_transmission_ctx->pss_signal_end, phy_transmission_ctx->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, phy_transmission_ctx->pss_len);
+          srslte_pss_put_slot_scatter(phy_transmission_ctx->pss_signal_end, phy_transmission_ctx->bw->sf_buffer_eb, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->cell_enb.cp, phy_transmission_ctx->pss_len);
         }
 
         // Add reference signals (RS) so that we can estimate the channel.
-        srslte_refsignal_cs_put_sf(phy_transmission_ctx->cell_enb, 0, phy_transmission_ctx->est.csr_signal.pilots[0][sf_idx], phy_transmission_ctx->sf_buffer_eb);
+        srslte_refsignal_cs_put_sf(phy_transmission_ctx->cell_enb, 0, phy_transmission_ctx->bw->est.csr_signal.pilots[0][sf_idx], phy_transmission_ctx->bw->sf_buffer_eb);
 
         // Change MCS of subsequent subframes to the highest possible value.
         if(subframe_cnt == 2 && bc.bw_idx == BW_IDX_OneDotFour && bc.mcs > 28) {
@@ -745,15 +844,24 @@ void *phy_transmission_work(void *h) {
         }
         PHY_TX_DEBUG("PHY ID: %d - subframe_cnt: %d - MCS set to: %d\n", phy_transmission_ctx->phy_id, subframe_cnt, phy_transmission_ctx->ra_dl.mcs_idx);
 
+        // Every subframe carries a TB of its own HARQ process, starting from the one set by MAC. The NDI of the process is toggled for new data and the redundancy version follows the retransmission counter.
+        harq_pid = (bc.harq_pid + subframe_cnt - 1)%SRSLTE_RA_NOF_HARQ_PROCESSES_SCATTER;
+        if(bc.retx_cnt == 0) {
+          phy_transmission_ctx->harq_ndi[harq_pid] = !phy_transmission_ctx->harq_ndi[harq_pid];
+        }
+        phy_transmission_ctx->ra_dl.harq_process = harq_pid;
+        phy_transmission_ctx->ra_dl.ndi          = phy_transmission_ctx->harq_ndi[harq_pid];
+        phy_transmission_ctx->ra_dl.rv_idx       = srslte_ra_rvidx_scatter(bc.retx_cnt);
+
         // If decode PDCCH/PCFICH is enabled, then we map those signals into the resource grid.
         if(phy_transmission_ctx->decode_pdcch) {
           // Encode PCFICH.
-          srslte_pcfich_encode(&phy_transmission_ctx->pcfich, DEFAULT_CFI, phy_transmission_ctx->sf_symbols, sf_idx);
+          srslte_pcfich_encode(&phy_transmission_ctx->bw->pcfich, DEFAULT_CFI, phy_transmission_ctx->bw->sf_symbols, sf_idx);
 
           // Encode PDCCH with control for user data decoding.
-          PHY_TX_DEBUG("PHY ID: %d - Putting DCI to location: n = %d, L = %d\n", phy_transmission_ctx->phy_id, phy_transmission_ctx->locations[sf_idx][0].ncce, phy_transmission_ctx->locations[sf_idx][0].L);
+          PHY_TX_DEBUG("PHY ID: %d - Putting DCI to location: n = %d, L = %d\n", phy_transmission_ctx->phy_id, phy_transmission_ctx->bw->locations[sf_idx][0].ncce, phy_transmission_ctx->bw->locations[sf_idx][0].L);
           srslte_dci_msg_pack_pdsch(&phy_transmission_ctx->ra_dl, SRSLTE_DCI_FORMAT1, &dci_msg, phy_transmission_ctx->cell_enb.nof_prb, false);
-          if(srslte_pdcch_encode(&phy_transmission_ctx->pdcch, &dci_msg, phy_transmission_ctx->locations[sf_idx][0], phy_transmission_ctx->rnti, phy_transmission_ctx->sf_symbols, sf_idx, DEFAULT_CFI)) {
+          if(srslte_pdcch_encode(&phy_transmission_ctx->bw->pdcch, &dci_msg, phy_transmission_ctx->bw->locations[sf_idx][0], phy_transmission_ctx->rnti, phy_transmission_ctx->bw->sf_symbols, sf_idx, DEFAULT_CFI)) {
             PHY_TX_ERROR("PHY ID: %d - Error encoding DCI message. Dropping MAC message.\n", phy_transmission_ctx->phy_id);
             number_of_dropped_packets++;
             break;
@@ -762,7 +870,7 @@ void *phy_transmission_work(void *h) {
 
         // Configure PDSCH to transmit the requested allocation.
         srslte_ra_dl_dci_to_grant_scatter(&phy_transmission_ctx->ra_dl, phy_transmission_ctx->cell_enb.nof_prb, phy_transmission_ctx->rnti, &phy_transmission_ctx->grant);
-        if(srslte_pdsch_cfg_scatter(&phy_transmission_ctx->pdsch_cfg, !phy_transmission_ctx->phy_filtering, phy_transmission_ctx->pss_len, phy_transmission_ctx->cell_enb, &phy_transmission_ctx->grant, DEFAULT_CFI, sf_idx, 0)) {
+        if(srslte_pdsch_cfg_scatter(&phy_transmission_ctx->pdsch_cfg, !phy_transmission_ctx->phy_filtering, phy_transmission_ctx->pss_len, phy_transmission_ctx->cell_enb, &phy_transmission_ctx->grant, DEFAULT_CFI, sf_idx, phy_transmission_ctx->ra_dl.rv_idx)) {
           PHY_TX_ERROR("PHY ID: %d - Error configuring PDSCH. Dropping MAC message.\n", phy_transmission_ctx->phy_id);
           number_of_dropped_packets++;
           break;
@@ -780,7 +888,7 @@ void *phy_transmission_work(void *h) {
   #endif
 
         // Encode PDSCH.
-        if(srslte_pdsch_encode_scatter(&phy_transmission_ctx->pdsch, &phy_transmission_ctx->pdsch_cfg, &phy_transmission_ctx->softbuffer, (bc.data+tx_data_offset), phy_transmission_ctx->sf_symbols)) {
+        if(srslte_pdsch_encode_scatter(&phy_transmission_ctx->bw->pdsch, &phy_transmission_ctx->pdsch_cfg, &phy_transmission_ctx->bw->softbuffer, (bc.data+tx_data_offset), phy_transmission_ctx->bw->sf_symbols)) {
           PHY_TX_ERROR("PHY ID: %d - Error encoding PDSCH. Dropping MAC message.\n",phy_transmission_ctx->phy_id);
           number_of_dropped_packets++;
           break;
@@ -791,9 +899,9 @@ void *phy_transmission_work(void *h) {
         if(subframe_cnt == 1 && bc.bw_idx == BW_IDX_OneDotFour && bc.mcs > 28) {
           mcs_local = 28;
         }
-        tx_data_offset = tx_data_offset + phy_transmission_get_tb_size(bw_idx, mcs_local);
+        tx_data_offset = tx_data_offset + phy_transmission_get_tb_size(phy_transmission_ctx->mcs_table, bw_idx, mcs_local);
 
-        //PHY_TX_DEBUG("mcs_local: %d - tx_data_offset: %d - TB size: %d - MCS: %d - PRB: %d\n",mcs_local,tx_data_offset,phy_transmission_get_tb_size(bw_idx, mcs_local),mcs_local,phy_transmission_handle->cell_enb.nof_prb);
+        //PHY_TX_DEBUG("mcs_local: %d - tx_data_offset: %d - TB size: %d - MCS: %d - PRB: %d\n",mcs_local,tx_data_offset,phy_transmission_get_tb_size(phy_transmission_ctx->mcs_table, bw_idx, mcs_local),mcs_local,phy_transmission_handle->cell_enb.nof_prb);
 
         // Check if it is necessary to add zeros before the subframe.
         number_of_additional_samples = 0;
@@ -808,21 +916,21 @@ void *phy_transmission_work(void *h) {
         // Apply filter with zero padding so that we have a kind of f-OFDM implementation.
         if(phy_transmission_ctx->trx_filter_idx > 0) {
           // Transform to OFDM symbols.
-          srslte_ofdm_tx_sf(&phy_transmission_ctx->ifft, phy_transmission_ctx->sf_buffer_eb, phy_transmission_ctx->subframe_ofdm_symbols);
+          srslte_ofdm_tx_sf(&phy_transmission_ctx->bw->ifft, phy_transmission_ctx->bw->sf_buffer_eb, phy_transmission_ctx->bw->subframe_ofdm_symbols);
           filter_zero_padding_length = 0;
           if(subframe_cnt == nof_subframes_to_tx) {
             filter_zero_padding_length = trx_filter_length;
           }
           //struct timespec start_filter;
           //clock_gettime(CLOCK_REALTIME, &start_filter);
-          trx_filter_run_fir_tx_filter_sse_mm256_complex3(phy_transmission_ctx->subframe_ofdm_symbols, (phy_transmission_ctx->sf_n_samples+filter_zero_padding_length), phy_transmission_ctx->output_buffer+FIX_TX_OFFSET_SAMPLES, subframe_cnt, nof_subframes_to_tx);
+          trx_filter_run_fir_tx_filter_sse_mm256_complex3(phy_transmission_ctx->bw->subframe_ofdm_symbols, (phy_transmission_ctx->bw->sf_n_samples+filter_zero_padding_length), phy_transmission_ctx->bw->output_buffer+FIX_TX_OFFSET_SAMPLES, subframe_cnt, nof_subframes_to_tx);
           //PHY_PROFILLING_AVG3("Avg. filtering time: %f [ms] - min: %f - max: %f - max counter %d - diff >= 1.5ms: %d - total counter: %d - perc: %f\n", helpers_profiling_diff_time(&start_filter), 1.5, 1000);
         } else {
   #endif
           // Case filtering is not enabled, then only OFDM generation is performed.
           filter_zero_padding_length = 0;
           // Transform to OFDM symbols.
-          srslte_ofdm_tx_sf(&phy_transmission_ctx->ifft, phy_transmission_ctx->sf_buffer_eb, phy_transmission_ctx->output_buffer+FIX_TX_OFFSET_SAMPLES);
+          srslte_ofdm_tx_sf(&phy_transmission_ctx->bw->ifft, phy_transmission_ctx->bw->sf_buffer_eb, phy_transmission_ctx->bw->output_buffer+FIX_TX_OFFSET_SAMPLES);
   #if(ENABLE_PHY_TX_FILTERING==1)
         }
   #endif
@@ -836,7 +944,7 @@ void *phy_transmission_work(void *h) {
           nof_zero_padding_samples = NOF_PADDING_ZEROS;
         }
         float norm_factor = (float) phy_transmission_ctx->cell_enb.nof_prb/15/sqrtf(phy_transmission_ctx->pdsch_cfg.grant.nof_prb);
-        srslte_vec_sc_prod_cfc(phy_transmission_ctx->output_buffer+FIX_TX_OFFSET_SAMPLES, (phy_transmission_ctx->rf_amp*norm_factor), phy_transmission_ctx->output_buffer+FIX_TX_OFFSET_SAMPLES, SRSLTE_SF_LEN_PRB(phy_transmission_ctx->cell_enb.nof_prb)+filter_zero_padding_length);
+        srslte_vec_sc_prod_cfc(phy_transmission_ctx->bw->output_buffer+FIX_TX_OFFSET_SAMPLES, (phy_transmission_ctx->rf_amp*norm_factor), phy_transmission_ctx->bw->output_buffer+FIX_TX_OFFSET_SAMPLES, SRSLTE_SF_LEN_PRB(phy_transmission_ctx->cell_enb.nof_prb)+filter_zero_padding_length);
 
 #if(ENBALE_TX_PROFILLING==1)
         uhd_transfer_start = helpers_get_host_time_now();
@@ -845,7 +953,10 @@ void *phy_transmission_work(void *h) {
 #ifndef ENABLE_CH_EMULATOR
         // Check if transmit_at timestamp field is still in the future so that subframe can be transmitted in time, otherwise it is dropped.
         if(start_of_burst) {
-          int tdiff = (int)(bc.timestamp - helpers_get_host_time_now());
+          sob_timestamp = helpers_get_host_time_now();
+          // Update the measured time it takes to get from the queue to the first subframe, without the one-off reconfiguration time.
+          tx_lead_time_update(&phy_transmission_ctx->tx_lead_time, sob_timestamp - pop_timestamp - phy_transmission_ctx->tx_reconfiguration_time);
+          int tdiff = (int)(bc.timestamp - sob_timestamp);
           if(tdiff <= 0) {
             PHY_TX_ERROR("PHY ID: %d - Transmit_at field was in the past. Time difference is: %d [us]. Dropping MAC message.\n", phy_transmission_ctx->phy_id, tdiff);
             number_of_dropped_packets++;
@@ -854,7 +965,13 @@ void *phy_transmission_work(void *h) {
         }
 #endif
 
-        ret = srslte_rf_send_timed3(rf, (phy_transmission_ctx->output_buffer+subframe_buffer_offset), (phy_transmission_ctx->sf_n_samples+number_of_additional_samples+nof_zero_padding_samples+filter_zero_padding_length), full_secs, frac_secs, has_time_spec, true, start_of_burst, end_of_burst, phy_transmission_ctx->is_lbt_enabled, (void*)&lbt_stats, phy_transmission_ctx->phy_id);
+#if(ENABLE_TX_COMBINER==1)
+        // LBT is not available on the RF channel shared by all the PHYs.
+        bzero(&lbt_stats, sizeof(lbt_stats_t));
+        ret = tx_combiner_send_timed(tx_combiner_get_handle(), (phy_transmission_ctx->bw->output_buffer+subframe_buffer_offset), (phy_transmission_ctx->bw->sf_n_samples+number_of_additional_samples+nof_zero_padding_samples+filter_zero_padding_length), full_secs, frac_secs, has_time_spec, start_of_burst, end_of_burst, phy_transmission_ctx->phy_id);
+#else
+        ret = srslte_rf_send_timed3(rf, (phy_transmission_ctx->bw->output_buffer+subframe_buffer_offset), (phy_transmission_ctx->bw->sf_n_samples+number_of_additional_samples+nof_zero_padding_samples+filter_zero_padding_length), full_secs, frac_secs, has_time_spec, true, start_of_burst, end_of_burst, phy_transmission_ctx->is_lbt_enabled, (void*)&lbt_stats, phy_transmission_ctx->phy_id);
+#endif
         // Set SOB to false after transferring the very first subframe.
         start_of_burst = false;
 
@@ -867,14 +984,14 @@ void *phy_transmission_work(void *h) {
 #endif
 
 #if(WRITE_TX_SUBFRAME_INTO_FILE==1)
-        static uint32_t dump_cnt[2] = {0, 0};
+        static uint32_t dump_cnt[MAX_NUM_CONCURRENT_PHYS] = {0};
         char output_file_name[200];
         sprintf(output_file_name,"check_subframe_sf_%d_cnt_%d_phy_id_%d.dat", subframe_cnt, dump_cnt[phy_transmission_ctx->phy_id], phy_transmission_ctx->phy_id);
         srslte_filesink_t file_sink;
         if(dump_cnt[phy_transmission_ctx->phy_id] < 5 && subframe_cnt == 1) {
           filesink_init(&file_sink, output_file_name, SRSLTE_COMPLEX_FLOAT_BIN);
           // Write samples into file.
-          filesink_write(&file_sink, (phy_transmission_ctx->output_buffer+FIX_TX_OFFSET_SAMPLES), (phy_transmission_ctx->sf_n_samples+filter_zero_padding_length));
+          filesink_write(&file_sink, (phy_transmission_ctx->bw->output_buffer+FIX_TX_OFFSET_SAMPLES), (phy_transmission_ctx->bw->sf_n_samples+filter_zero_padding_length));
           // Close file.
           filesink_free(&file_sink);
           dump_cnt[phy_transmission_ctx->phy_id]++;
@@ -926,6 +1043,9 @@ void *phy_transmission_work(void *h) {
       number_of_dropped_packets++;
     }
 
+    // User data is not needed anymore, give it back to the communicator so that its slot can be reused.
+    communicator_release_user_data_buffer(bc.data);
+
 #ifndef ENABLE_CH_EMULATOR
     // Disarm watchdog timer for transmission thread.
     if(timer_disarm(&phy_transmission_ctx->tx_thread_timer_id) < 0) {
@@ -944,6 +1064,7 @@ void *phy_transmission_work(void *h) {
   }
   /****************************** PHY Transmission loop - END ******************************/
 
+  PHY_TX_PRINT("PHY ID: %d - Rejected basic controls: %" PRIu64 " - Avg. lead time: %1.0f [us]\n", phy_transmission_ctx->phy_id, tx_lead_time_get_nof_rejections(&phy_transmission_ctx->tx_lead_time), tx_lead_time_get(&phy_transmission_ctx->tx_lead_time));
   PHY_TX_PRINT("PHY ID: %d - Leaving PHY Encoding/transmission thread.\n", phy_transmission_ctx->phy_id);
   // Exit thread with result code.
   pthread_exit(NULL);
@@ -988,6 +1109,7 @@ int phy_transmission_update_radl(phy_transmission_t* const phy_transmission_ctx,
   phy_transmission_ctx->ra_dl.rv_idx                  = 0;
   phy_transmission_ctx->ra_dl.alloc_type              = SRSLTE_RA_ALLOC_TYPE0;
   phy_transmission_ctx->ra_dl.type0_alloc.rbg_bitmask = phy_transmission_prbset_to_bitmask(nof_prb);
+  phy_transmission_ctx->ra_dl.mcs_table               = phy_transmission_ctx->mcs_table;
   // Everything went well.
   return 0;
 }
@@ -995,11 +1117,11 @@ int phy_transmission_update_radl(phy_transmission_t* const phy_transmission_ctx,
 int phy_transmission_init_buffers(phy_transmission_t* const phy_transmission_ctx) {
 
   // calculate number of resource elements and IQ samples.
-  phy_transmission_ctx->sf_n_re = 2 * SRSLTE_CP_NORM_NSYMB * phy_transmission_ctx->nof_prb * SRSLTE_NRE;
-  phy_transmission_ctx->sf_n_samples = 2 * SRSLTE_SLOT_LEN(srslte_symbol_sz(phy_transmission_ctx->nof_prb));
+  phy_transmission_ctx->bw->sf_n_re = 2 * SRSLTE_CP_NORM_NSYMB * phy_transmission_ctx->nof_prb * SRSLTE_NRE;
+  phy_transmission_ctx->bw->sf_n_samples = 2 * SRSLTE_SLOT_LEN(srslte_symbol_sz(phy_transmission_ctx->nof_prb));
 
-  PHY_TX_PRINT("PHY ID: %d - sf_n_re: %d\n", phy_transmission_ctx->phy_id, phy_transmission_ctx->sf_n_re);
-  PHY_TX_PRINT("PHY ID: %d - sf_n_samples: %d\n", phy_transmission_ctx->phy_id, phy_transmission_ctx->sf_n_samples);
+  PHY_TX_PRINT("PHY ID: %d - sf_n_re: %d\n", phy_transmission_ctx->phy_id, phy_transmission_ctx->bw->sf_n_re);
+  PHY_TX_PRINT("PHY ID: %d - sf_n_samples: %d\n", phy_transmission_ctx->phy_id, phy_transmission_ctx->bw->sf_n_samples);
 
   // Retrieve filter length.
   uint32_t trx_filter_length = 0;
@@ -1015,10 +1137,10 @@ int phy_transmission_init_buffers(phy_transmission_t* const phy_transmission_ctx
   PHY_TX_DEBUG("PHY ID: %d - Device name: %s\n", phy_transmission_ctx->phy_id, devname);
 
   // Decide the number of samples in a subframe.
-  int number_of_subframe_samples = phy_transmission_ctx->sf_n_samples;
+  int number_of_subframe_samples = phy_transmission_ctx->bw->sf_n_samples;
   phy_transmission_ctx->number_of_tx_offset_samples = 0;
   if(strcmp(devname,DEVNAME_X300) == 0 && FIX_TX_OFFSET_SAMPLES > 0) {
-    number_of_subframe_samples = phy_transmission_ctx->sf_n_samples + FIX_TX_OFFSET_SAMPLES;
+    number_of_subframe_samples = phy_transmission_ctx->bw->sf_n_samples + FIX_TX_OFFSET_SAMPLES;
     phy_transmission_ctx->number_of_tx_offset_samples = FIX_TX_OFFSET_SAMPLES;
     PHY_TX_DEBUG("PHY ID: %d - HW: %s and Tx Offset: %d - zero padding: %d\n", phy_transmission_ctx->phy_id,devname,FIX_TX_OFFSET_SAMPLES,NOF_PADDING_ZEROS);
   }
@@ -1029,29 +1151,28 @@ int phy_transmission_init_buffers(phy_transmission_t* const phy_transmission_ctx
   }
 
   // init memory.
-  phy_transmission_ctx->subframe_ofdm_symbols = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*(phy_transmission_ctx->sf_n_samples+trx_filter_length));
-  if(!phy_transmission_ctx->subframe_ofdm_symbols) {
+  phy_transmission_ctx->bw->subframe_ofdm_symbols = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*(phy_transmission_ctx->bw->sf_n_samples+trx_filter_length));
+  if(!phy_transmission_ctx->bw->subframe_ofdm_symbols) {
     PHY_TX_ERROR("PHY ID: %d - Error allocating memory to subframe_ofdm_symbols\n",phy_transmission_ctx->phy_id);
     return -1;
   }
   // Set allocated memory to 0.
-  bzero(phy_transmission_ctx->subframe_ofdm_symbols, sizeof(cf_t)*(phy_transmission_ctx->sf_n_samples+trx_filter_length));
+  bzero(phy_transmission_ctx->bw->subframe_ofdm_symbols, sizeof(cf_t)*(phy_transmission_ctx->bw->sf_n_samples+trx_filter_length));
   PHY_TX_PRINT("PHY ID: %d - subframe_ofdm_symbols allocated and zeroed\n",phy_transmission_ctx->phy_id);
 
   // Init output buffer memory.
-  phy_transmission_ctx->output_buffer = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*(number_of_subframe_samples+trx_filter_length));
-  if(!phy_transmission_ctx->output_buffer) {
+  phy_transmission_ctx->bw->output_buffer = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*(number_of_subframe_samples+trx_filter_length));
+  if(!phy_transmission_ctx->bw->output_buffer) {
     PHY_TX_ERROR("PHY ID: %d - Error allocating memory to output_buffer\n",phy_transmission_ctx->phy_id);
     return -1;
   }
-  // Set allocated memory to 0.
-  // TODO: when online bandwidth change is implemented this setting of memory to 0 will have an impact on the time to change the bandwidth. That should be taken into account.
-  bzero(phy_transmission_ctx->output_buffer, sizeof(cf_t)*(number_of_subframe_samples+trx_filter_length));
+  // Set allocated memory to 0. It is only done once per PHY BW, as the buffers are kept until the PHY is stopped.
+  bzero(phy_transmission_ctx->bw->output_buffer, sizeof(cf_t)*(number_of_subframe_samples+trx_filter_length));
   PHY_TX_PRINT("PHY ID: %d - output_buffer allocated and zeroed\n",phy_transmission_ctx->phy_id);
 
   // init memory.
-  phy_transmission_ctx->sf_buffer_eb = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*phy_transmission_ctx->sf_n_re);
-  if(!phy_transmission_ctx->sf_buffer_eb) {
+  phy_transmission_ctx->bw->sf_buffer_eb = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*phy_transmission_ctx->bw->sf_n_re);
+  if(!phy_transmission_ctx->bw->sf_buffer_eb) {
     PHY_TX_ERROR("PHY ID: %d - Error allocating memory to sf_buffer_eb\n",phy_transmission_ctx->phy_id);
     return -1;
   }
@@ -1061,77 +1182,91 @@ int phy_transmission_init_buffers(phy_transmission_t* const phy_transmission_ctx
 }
 
 void phy_transmission_free_buffers(phy_transmission_t* const phy_transmission_ctx) {
-  if(phy_transmission_ctx->sf_buffer_eb) {
-    free(phy_transmission_ctx->sf_buffer_eb);
-    phy_transmission_ctx->sf_buffer_eb = NULL;
+  if(phy_transmission_ctx->bw->sf_buffer_eb) {
+    free(phy_transmission_ctx->bw->sf_buffer_eb);
+    phy_transmission_ctx->bw->sf_buffer_eb = NULL;
   }
-  if(phy_transmission_ctx->output_buffer) {
-    free(phy_transmission_ctx->output_buffer);
-    phy_transmission_ctx->output_buffer = NULL;
+  if(phy_transmission_ctx->bw->output_buffer) {
+    free(phy_transmission_ctx->bw->output_buffer);
+    phy_transmission_ctx->bw->output_buffer = NULL;
   }
-  if(phy_transmission_ctx->subframe_ofdm_symbols) {
-    free(phy_transmission_ctx->subframe_ofdm_symbols);
-    phy_transmission_ctx->subframe_ofdm_symbols = NULL;
+  if(phy_transmission_ctx->bw->subframe_ofdm_symbols) {
+    free(phy_transmission_ctx->bw->subframe_ofdm_symbols);
+    phy_transmission_ctx->bw->subframe_ofdm_symbols = NULL;
   }
   PHY_TX_PRINT("PHY ID: %d - phy_transmission_free_buffers DONE!\n",phy_transmission_ctx->phy_id);
 }
 
+// Initialize the base station structures of the selected PHY BW context.
 int phy_transmission_base_init(phy_transmission_t* const phy_transmission_ctx) {
-
-#if(ENABLE_PHY_TX_FILTERING==1)
-  // Create filter kernel.
-  if(phy_transmission_ctx->trx_filter_idx > 0) {
-   trx_filter_create_tx_simd_kernel_mm256(helpers_get_bw_index(phy_transmission_ctx->bw_idx));
-  }
-#endif
   // create ifft object.
-  if(srslte_ofdm_tx_init(&phy_transmission_ctx->ifft, phy_transmission_ctx->cell_enb.cp, phy_transmission_ctx->cell_enb.nof_prb)) {
+  if(srslte_ofdm_tx_init(&phy_transmission_ctx->bw->ifft, phy_transmission_ctx->cell_enb.cp, phy_transmission_ctx->cell_enb.nof_prb)) {
     PHY_TX_ERROR("PHY ID: %d - Error creating iFFT object\n",phy_transmission_ctx->phy_id);
     return -1;
   }
   // Set normalization to true in IFFT object.
-  srslte_ofdm_set_normalize(&phy_transmission_ctx->ifft, true);
+  srslte_ofdm_set_normalize(&phy_transmission_ctx->bw->ifft, true);
   // Initialize control channels only if enabled.
   if(phy_transmission_ctx->decode_pdcch) {
     // Initialize registers.
-    if(srslte_regs_init(&phy_transmission_ctx->regs, phy_transmission_ctx->cell_enb)) {
+    if(srslte_regs_init(&phy_transmission_ctx->bw->regs, phy_transmission_ctx->cell_enb)) {
       PHY_TX_ERROR("PHY ID: %d - Error initiating regs\n",phy_transmission_ctx->phy_id);
       return -1;
     }
     // Initialize PCFICH object.
-    if(srslte_pcfich_init(&phy_transmission_ctx->pcfich, &phy_transmission_ctx->regs, phy_transmission_ctx->cell_enb)) {
+    if(srslte_pcfich_init(&phy_transmission_ctx->bw->pcfich, &phy_transmission_ctx->bw->regs, phy_transmission_ctx->cell_enb)) {
       PHY_TX_ERROR("PHY ID: %d - Error creating PCFICH object\n",phy_transmission_ctx->phy_id);
       return -1;
     }
     // Initialize CFI register object.
-    if(srslte_regs_set_cfi(&phy_transmission_ctx->regs, DEFAULT_CFI)) {
+    if(srslte_regs_set_cfi(&phy_transmission_ctx->bw->regs, DEFAULT_CFI)) {
       PHY_TX_ERROR("PHY ID: %d - Error setting CFI\n",phy_transmission_ctx->phy_id);
       return -1;
     }
     // Initialize PDCCH object.
-    if(srslte_pdcch_init(&phy_transmission_ctx->pdcch, &phy_transmission_ctx->regs, phy_transmission_ctx->cell_enb)) {
+    if(srslte_pdcch_init(&phy_transmission_ctx->bw->pdcch, &phy_transmission_ctx->bw->regs, phy_transmission_ctx->cell_enb)) {
       PHY_TX_ERROR("PHY ID: %d - Error creating PDCCH object\n",phy_transmission_ctx->phy_id);
       return -1;
     }
     // Initiate valid DCI locations.
     for(int i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
-      srslte_pdcch_ue_locations(&phy_transmission_ctx->pdcch, phy_transmission_ctx->locations[i], 30, i, DEFAULT_CFI, phy_transmission_ctx->rnti);
+      srslte_pdcch_ue_locations(&phy_transmission_ctx->bw->pdcch, phy_transmission_ctx->bw->locations[i], 30, i, DEFAULT_CFI, phy_transmission_ctx->rnti);
     }
   }
   // Initialize PDSCH object.
-  if(srslte_pdsch_init_generic(&phy_transmission_ctx->pdsch, phy_transmission_ctx->cell_enb, phy_transmission_ctx->phy_id, !phy_transmission_ctx->phy_filtering)) {
+  if(srslte_pdsch_init_generic(&phy_transmission_ctx->bw->pdsch, phy_transmission_ctx->cell_enb, phy_transmission_ctx->phy_id, !phy_transmission_ctx->phy_filtering)) {
     PHY_TX_ERROR("PHY ID: %d - Error creating PDSCH object\n",phy_transmission_ctx->phy_id);
     return -1;
   }
   // Set RNTI for PDSCH object.
-  srslte_pdsch_set_rnti(&phy_transmission_ctx->pdsch, phy_transmission_ctx->rnti);
+  srslte_pdsch_set_rnti(&phy_transmission_ctx->bw->pdsch, phy_transmission_ctx->rnti);
+  // Encode code blocks in parallel if enabled.
+  if(srslte_sch_set_encode_workers(&phy_transmission_ctx->bw->pdsch.dl_sch, PHY_TX_NOF_ENCODE_WORKERS)) {
+    PHY_TX_ERROR("PHY ID: %d - Error creating %d encode workers\n", phy_transmission_ctx->phy_id, PHY_TX_NOF_ENCODE_WORKERS);
+    return -1;
+  }
   // Initialize softbuffer object.
-  if(srslte_softbuffer_tx_init_scatter(&phy_transmission_ctx->softbuffer, phy_transmission_ctx->cell_enb.nof_prb)) {
+  if(srslte_softbuffer_tx_init_scatter(&phy_transmission_ctx->bw->softbuffer, phy_transmission_ctx->cell_enb.nof_prb)) {
     PHY_TX_ERROR("PHY ID: %d - Error initiating soft buffer\n",phy_transmission_ctx->phy_id);
     return -1;
   }
   // Reset softbuffer.
-  srslte_softbuffer_tx_reset(&phy_transmission_ctx->softbuffer);
+  srslte_softbuffer_tx_reset(&phy_transmission_ctx->bw->softbuffer);
+  // Generate CRS signals.
+  if(srslte_chest_dl_init(&phy_transmission_ctx->bw->est, phy_transmission_ctx->cell_enb)) {
+    PHY_TX_ERROR("PHY ID: %d - Error initializing equalizer\n", phy_transmission_ctx->phy_id);
+    return -1;
+  }
+  // Initialize slot (subframe).
+  for(int i = 0; i < SRSLTE_MAX_PORTS; i++) { // now there's only 1 port
+    phy_transmission_ctx->bw->sf_symbols[i] = phy_transmission_ctx->bw->sf_buffer_eb;
+  }
+  // Everything went well.
+  return 0;
+}
+
+// Generate the synchronization sequences, they do not depend on the PHY BW.
+int phy_transmission_sync_signals_init(phy_transmission_t* const phy_transmission_ctx) {
   // Allocate memory for PSS sync.
   phy_transmission_ctx->pss_signal = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*phy_transmission_ctx->pss_len);
   // Check if memory allocation was correctly done.
@@ -1164,29 +1299,11 @@ int phy_transmission_base_init(phy_transmission_t* const phy_transmission_ctx) {
   srslte_sch_generate_from_pair(phy_transmission_ctx->sch_signal0, true, phy_transmission_ctx->last_tx_basic_control.send_to, phy_transmission_ctx->last_tx_basic_control.intf_id);
   // Generate SCH sequence carrying MCS plus number of transmitted slots set to 0.
   srslte_sch_generate_from_pair(phy_transmission_ctx->sch_signal1, false, phy_transmission_ctx->last_mcs, phy_transmission_ctx->last_nof_subframes_to_tx);
-  // Generate CRS signals.
-  if(srslte_chest_dl_init(&phy_transmission_ctx->est, phy_transmission_ctx->cell_enb)) {
-    PHY_TX_ERROR("PHY ID: %d - Error initializing equalizer\n", phy_transmission_ctx->phy_id);
-    return -1;
-  }
-  // Initialize slot (subframe).
-  for(int i = 0; i < SRSLTE_MAX_PORTS; i++) { // now there's only 1 port
-    phy_transmission_ctx->sf_symbols[i] = phy_transmission_ctx->sf_buffer_eb;
-  }
   // Everything went well.
   return 0;
 }
 
-void phy_transmission_free_base(phy_transmission_t* const phy_transmission_ctx) {
-  srslte_softbuffer_tx_free_scatter(&phy_transmission_ctx->softbuffer);
-  srslte_pdsch_free(&phy_transmission_ctx->pdsch);
-  srslte_chest_dl_free(&phy_transmission_ctx->est);
-  srslte_ofdm_tx_free(&phy_transmission_ctx->ifft);
-  if(phy_transmission_ctx->decode_pdcch) {
-    srslte_pcfich_free(&phy_transmission_ctx->pcfich);
-    srslte_pdcch_free(&phy_transmission_ctx->pdcch);
-    srslte_regs_free(&phy_transmission_ctx->regs);
-  }
+void phy_transmission_free_sync_signals(phy_transmission_t* const phy_transmission_ctx) {
   if(phy_transmission_ctx->pss_signal) {
     free(phy_transmission_ctx->pss_signal);
     phy_transmission_ctx->pss_signal = NULL;
@@ -1199,6 +1316,18 @@ void phy_transmission_free_base(phy_transmission_t* const phy_transmission_ctx)
   }
 }
 
+void phy_transmission_free_base(phy_transmission_t* const phy_transmission_ctx) {
+  srslte_softbuffer_tx_free_scatter(&phy_transmission_ctx->bw->softbuffer);
+  srslte_pdsch_free(&phy_transmission_ctx->bw->pdsch);
+  srslte_chest_dl_free(&phy_transmission_ctx->bw->est);
+  srslte_ofdm_tx_free(&phy_transmission_ctx->bw->ifft);
+  if(phy_transmission_ctx->decode_pdcch) {
+    srslte_pcfich_free(&phy_transmission_ctx->bw->pcfich);
+    srslte_pdcch_free(&phy_transmission_ctx->bw->pdcch);
+    srslte_regs_free(&phy_transmission_ctx->bw->regs);
+  }
+}
+
 int phy_transmission_set_tx_sample_rate(phy_transmission_t* const phy_transmission_ctx) {
   int srate = -1;
   float srate_rf = 0.0;
@@ -1209,14 +1338,21 @@ int phy_transmission_set_tx_sample_rate(phy_transmission_t* const phy_transmissi
     PHY_TX_PRINT("PHY ID: %d - Setting a non-standard sampling rate: %1.2f [MHz]\n", phy_transmission_ctx->phy_id, srate/1000000.0);
   }
   if(srate != -1) {
+#if(ENABLE_TX_COMBINER==1)
+    // The RF channel sampling rate is set once for all PHYs, each channel being sampled at a fraction of it.
+    srate_rf = tx_combiner_get_channel_srate(tx_combiner_get_handle());
+#else
     srate_rf = srslte_rf_set_tx_srate(phy_transmission_ctx->rf, (double)srate, phy_transmission_ctx->phy_id);
+#endif
     if(srate_rf != srate) {
       PHY_TX_ERROR("PHY ID: %d - Could not set Tx sampling rate\n",phy_transmission_ctx->phy_id);
       return -1;
     }
     PHY_TX_PRINT("PHY ID: %d - Set Tx sampling rate to: %.2f [MHz]\n", phy_transmission_ctx->phy_id, srate_rf/1000000.0);
 
+#if(ENABLE_TX_COMBINER==0)
     srslte_rf_set_fir_taps(phy_transmission_ctx->rf, phy_transmission_ctx->nof_prb, phy_transmission_ctx->phy_id);
+#endif
   } else {
     PHY_TX_ERROR("PHY ID: %d - Invalid number of PRB (Tx): %d\n", phy_transmission_ctx->phy_id, phy_transmission_ctx->nof_prb);
     return -1;
@@ -1228,11 +1364,20 @@ int phy_transmission_set_tx_sample_rate(phy_transmission_t* const phy_transmissi
 int phy_transmission_set_initial_tx_freq_and_gain(phy_transmission_t* const phy_transmission_ctx) {
   double tx_channel_center_freq, lo_offset, actual_tx_freq;
 
+#if(ENABLE_TX_COMBINER==1)
+  // Gain of the shared RF channel is set by trx.
+  float current_tx_gain = phy_transmission_ctx->initial_tx_gain;
+#else
   // Set default Tx gain.
   float current_tx_gain = srslte_rf_set_tx_gain(phy_transmission_ctx->rf, phy_transmission_ctx->initial_tx_gain, phy_transmission_ctx->phy_id);
+#endif
   // Calculate the default central Tx frequency.
   tx_channel_center_freq = helpers_calculate_channel_center_frequency(phy_transmission_ctx->competition_center_freq, phy_transmission_ctx->competition_bw, phy_transmission_ctx->default_tx_bandwidth, (phy_transmission_ctx->default_tx_channel + phy_transmission_ctx->phy_id));
-#if(ENABLE_HW_RF_MONITOR==1)
+#if(ENABLE_TX_COMBINER==1)
+  // Gain and center frequency of the shared RF channel are set by trx, only the channel of this PHY is placed here.
+  lo_offset = 0.0;
+  actual_tx_freq = tx_combiner_set_channel_freq(tx_combiner_get_handle(), phy_transmission_ctx->phy_id, tx_channel_center_freq);
+#elif(ENABLE_HW_RF_MONITOR==1)
   // Always apply offset when HW RF Monitor is enabled.
   lo_offset = (double)PHY_TX_LO_OFFSET;
   // Set channel center frequency for transmission.
@@ -1263,16 +1408,38 @@ int phy_transmission_set_initial_tx_freq_and_gain(phy_transmission_t* const phy_
   return 0;
 }
 
+// A timed basic control is only admitted if it can still be encoded before its deadline, given the measured lead time.
+bool phy_transmission_can_make_deadline(phy_transmission_t* const phy_transmission_ctx, basic_ctrl_t* const bc, uint64_t now) {
+#ifndef ENABLE_CH_EMULATOR
+  return tx_lead_time_can_make_deadline(&phy_transmission_ctx->tx_lead_time, bc->timestamp, now);
+#else
+  return true;
+#endif
+}
+
 // Functions to transfer basic control message from main thread to transmission thread.
-void phy_transmission_push_tx_basic_control_into_container(basic_ctrl_t* const basic_ctrl) {
- // Lock mutex so that we can push basic control to container.
- pthread_mutex_lock(&phy_tx_threads[basic_ctrl->phy_id]->tx_basic_control_mutex);
- // Push basic control into container.
- tx_cb_push_back(phy_tx_threads[basic_ctrl->phy_id]->tx_basic_control_handle, basic_ctrl);
- // Unlock mutex so that function can do other things.
- pthread_mutex_unlock(&phy_tx_threads[basic_ctrl->phy_id]->tx_basic_control_mutex);
- // Notify other thread that basic control was pushed into container.
- pthread_cond_signal(&phy_tx_threads[basic_ctrl->phy_id]->tx_basic_control_cv);
+int phy_transmission_push_tx_basic_control_into_container(basic_ctrl_t* const basic_ctrl) {
+  phy_transmission_t* const phy_transmission_ctx = phy_tx_threads[basic_ctrl->phy_id];
+  // Reject basic controls that can not be transmitted in time anymore.
+  if(!phy_transmission_can_make_deadline(phy_transmission_ctx, basic_ctrl, helpers_get_host_time_now())) {
+    PHY_TX_ERROR("PHY ID: %d - Basic control can not make its deadline. Avg. lead time: %1.0f [us]. Dropping MAC message.\n", basic_ctrl->phy_id, tx_lead_time_get(&phy_transmission_ctx->tx_lead_time));
+    communicator_release_user_data_buffer(basic_ctrl->data);
+    return -1;
+  }
+  // Lock mutex so that we can push basic control to container.
+  pthread_mutex_lock(&phy_transmission_ctx->tx_basic_control_mutex);
+  // Push basic control into container, it is sorted by its transmission timestamp.
+  if(!tx_pq_push(phy_transmission_ctx->tx_basic_control_handle, basic_ctrl)) {
+    pthread_mutex_unlock(&phy_transmission_ctx->tx_basic_control_mutex);
+    PHY_TX_ERROR("PHY ID: %d - Tx basic control container is full. Dropping MAC message.\n", basic_ctrl->phy_id);
+    communicator_release_user_data_buffer(basic_ctrl->data);
+    return -1;
+  }
+  // Unlock mutex so that function can do other things.
+  pthread_mutex_unlock(&phy_transmission_ctx->tx_basic_control_mutex);
+  // Notify other thread that basic control was pushed into container.
+  pthread_cond_signal(&phy_transmission_ctx->tx_basic_control_cv);
+  return 0;
 }
 
 // Check if container is not empty, if so, wait until it is not empty and get the context, incrementing the counter.
@@ -1282,14 +1449,14 @@ bool phy_transmission_timedwait_and_pop_tx_basic_control_from_container(phy_tran
   // Lock mutex.
   pthread_mutex_lock(&phy_transmission_ctx->tx_basic_control_mutex);
   // Wait for conditional variable only if container is empty.
-  if(tx_cb_empty(phy_transmission_ctx->tx_basic_control_handle)) {
+  if(tx_pq_empty(phy_transmission_ctx->tx_basic_control_handle)) {
     do {
       // Timeout in 0.1 ms.
       helpers_get_timeout(10000, &timeout);
       // Timed wait for conditional variable to be true.
       pthread_cond_timedwait(&phy_transmission_ctx->tx_basic_control_cv, &phy_transmission_ctx->tx_basic_control_mutex, &timeout);
       // Check status of the circular buffer again.
-      is_cb_empty = tx_cb_empty(phy_transmission_ctx->tx_basic_control_handle);
+      is_cb_empty = tx_pq_empty(phy_transmission_ctx->tx_basic_control_handle);
       // Check if the threads are still running, if not, then leave with false.
       if(!phy_transmission_ctx->run_tx_encoding_thread) {
         ret = false;
@@ -1299,9 +1466,9 @@ bool phy_transmission_timedwait_and_pop_tx_basic_control_from_container(phy_tran
 
   // Only retrieve the context if the thread is still running.
   if(ret) {
-    // Retrieve mapped element from container.
-    tx_cb_front(phy_transmission_ctx->tx_basic_control_handle, basic_ctrl);
-    tx_cb_pop_front(phy_transmission_ctx->tx_basic_control_handle);
+    // Retrieve the element with the earliest deadline from container.
+    tx_pq_top(phy_transmission_ctx->tx_basic_control_handle, basic_ctrl);
+    tx_pq_pop(phy_transmission_ctx->tx_basic_control_handle);
   }
   // Unlock mutex.
   pthread_mutex_unlock(& phy_transmission_ctx->tx_basic_control_mutex);
@@ -1428,6 +1595,10 @@ timer_t* phy_transmission_get_timer_id(uint32_t phy_id) {
 }
 
 // Retrieve Transport Block Size size.
-uint32_t phy_transmission_get_tb_size(uint32_t bw_idx, uint32_t mcs) {
-  return srslte_ra_get_tb_size_scatter(bw_idx, mcs);
+uint32_t phy_transmission_get_tb_size(srslte_ra_dl_mcs_table_t mcs_table, uint32_t bw_idx, uint32_t mcs) {
+  return srslte_ra_get_tb_size_mcs_table_scatter(mcs_table, bw_idx, mcs);
+}
+
+int srslte_rf_send_timed_wrapper(void *h, void *data, int nsamples, time_t secs, double frac_secs, bool has_time_spec, bool is_start_of_burst, bool is_end_of_burst, size_t channel) {
+  return srslte_rf_send_timed3(h, data, nsamples, secs, frac_secs, has_time_spec, true, is_start_of_burst, is_end_of_burst, false, NULL, channel);
 }
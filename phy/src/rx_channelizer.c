@@ -0,0 +1,242 @@
+#include "rx_channelizer.h"
+
+// *********** Global variables ***********
+static rx_channelizer_t *rx_channelizer = NULL;
+
+int rx_channelizer_start(void *source_handle, int (*source_callback)(void*, void*, uint32_t, srslte_timestamp_t*, size_t), size_t source_channel, double channel_srate, double center_freq) {
+  // Allocate memory for the channelizer context.
+  rx_channelizer = (rx_channelizer_t*)srslte_vec_malloc(sizeof(rx_channelizer_t));
+  if(rx_channelizer == NULL) {
+    RX_CHANNELIZER_ERROR("Error allocating memory for Rx channelizer context.\n",0);
+    return -1;
+  }
+  bzero(rx_channelizer, sizeof(rx_channelizer_t));
+  rx_channelizer->source_handle        = source_handle;
+  rx_channelizer->source_callback      = source_callback;
+  rx_channelizer->source_channel       = source_channel;
+  rx_channelizer->nof_channels         = RX_CHANNELIZER_NOF_CHANNELS;
+  rx_channelizer->channel_srate        = channel_srate;
+  rx_channelizer->center_freq          = center_freq;
+  rx_channelizer->nof_samples_per_read = RX_CHANNELIZER_NOF_SUBFRAMES_PER_READ*RX_CHANNELIZER_NOF_CHANNELS*(uint32_t)(channel_srate/1000.0);
+  // Create the polyphase channelizer and its buffers.
+  if(srslte_channelizer_init(&rx_channelizer->channelizer, rx_channelizer->nof_channels, SRSLTE_CHANNELIZER_DEFAULT_TAPS, rx_channelizer->nof_samples_per_read)) {
+    RX_CHANNELIZER_ERROR("Error creating channelizer with %d channels.\n", rx_channelizer->nof_channels);
+    return -1;
+  }
+  rx_channelizer->wideband_buffer = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*rx_channelizer->nof_samples_per_read);
+  rx_channelizer->rotated_buffer = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*rx_channelizer->nof_samples_per_read/rx_channelizer->nof_channels);
+  if(rx_channelizer->wideband_buffer == NULL || rx_channelizer->rotated_buffer == NULL) {
+    RX_CHANNELIZER_ERROR("Error allocating memory for Rx channelizer buffers.\n",0);
+    return -1;
+  }
+  for(uint32_t k = 0; k < rx_channelizer->nof_channels; k++) {
+    rx_channelizer->channel_buffers[k] = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*rx_channelizer->nof_samples_per_read/rx_channelizer->nof_channels);
+    if(rx_channelizer->channel_buffers[k] == NULL) {
+      RX_CHANNELIZER_ERROR("Error allocating memory for channel buffer %d.\n", k);
+      return -1;
+    }
+  }
+  // The stream of each PHY is created when it configures its channel frequency.
+  for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+    rx_channelizer->streams[phy_id].ready = false;
+    rx_channelizer->streams[phy_id].branch = -1;
+  }
+  pthread_mutex_init(&rx_channelizer->streams_mutex, NULL);
+  // Start the thread feeding the PHY streams.
+  rx_channelizer->run = true;
+  pthread_attr_init(&rx_channelizer->thread_attr);
+  pthread_attr_setdetachstate(&rx_channelizer->thread_attr, PTHREAD_CREATE_JOINABLE);
+  int rc = pthread_create(&rx_channelizer->thread_id, &rx_channelizer->thread_attr, rx_channelizer_work, (void *)rx_channelizer);
+  if(rc) {
+    RX_CHANNELIZER_ERROR("Return code from Rx channelizer pthread_create() is %d\n", rc);
+    return -1;
+  }
+  RX_CHANNELIZER_PRINT("%d channels of %1.2f [MHz] around %1.2f [MHz] started.\n", rx_channelizer->nof_channels, channel_srate/1000000.0, center_freq/1000000.0);
+  // Everything went well.
+  return 0;
+}
+
+int rx_channelizer_stop() {
+  if(rx_channelizer == NULL) {
+    return 0;
+  }
+  // Stop the thread and join it.
+  rx_channelizer->run = false;
+  pthread_attr_destroy(&rx_channelizer->thread_attr);
+  int rc = pthread_join(rx_channelizer->thread_id, NULL);
+  if(rc) {
+    RX_CHANNELIZER_ERROR("Return code from Rx channelizer pthread_join() is %d\n", rc);
+    return -1;
+  }
+  // Free the streams and buffers.
+  for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+    if(rx_channelizer->streams[phy_id].buffer.capacity > 0) {
+      if(rx_channelizer->streams[phy_id].nof_overflows > 0) {
+        RX_CHANNELIZER_PRINT("PHY ID: %d - Stream overflowed %d times.\n", phy_id, rx_channelizer->streams[phy_id].nof_overflows);
+      }
+      srslte_ringbuffer_free(&rx_channelizer->streams[phy_id].buffer);
+    }
+  }
+  for(uint32_t k = 0; k < rx_channelizer->nof_channels; k++) {
+    if(rx_channelizer->channel_buffers[k]) {
+      free(rx_channelizer->channel_buffers[k]);
+    }
+  }
+  if(rx_channelizer->wideband_buffer) {
+    free(rx_channelizer->wideband_buffer);
+  }
+  if(rx_channelizer->rotated_buffer) {
+    free(rx_channelizer->rotated_buffer);
+  }
+  srslte_channelizer_free(&rx_channelizer->channelizer);
+  pthread_mutex_destroy(&rx_channelizer->streams_mutex);
+  free(rx_channelizer);
+  rx_channelizer = NULL;
+  RX_CHANNELIZER_PRINT("Rx channelizer stopped.\n",0);
+  // Everything went well.
+  return 0;
+}
+
+void *rx_channelizer_get_handle() {
+  return (void*)rx_channelizer;
+}
+
+double rx_channelizer_get_channel_srate(void *h) {
+  return ((rx_channelizer_t*)h)->channel_srate;
+}
+
+// Map the PHY channel to the closest branch. The residual offset is removed by a phase rotator, so the actual
+// frequency is always the requested one.
+double rx_channelizer_set_channel_freq(void *h, uint32_t phy_id, double freq) {
+  rx_channelizer_t *q = (rx_channelizer_t*)h;
+  double relative_freq = (freq - q->center_freq)/q->channel_srate;
+  int branch = (int)lround(relative_freq);
+  double offset = (relative_freq - branch)*q->channel_srate;
+
+  if(phy_id >= MAX_NUM_CONCURRENT_PHYS) {
+    RX_CHANNELIZER_ERROR("Invalid PHY ID: %d\n", phy_id);
+    return -1.0;
+  }
+  // Only the branches entirely inside the RF channel band are used.
+  if(abs(branch) > (int)(q->nof_channels-1)/2 || fabs(offset) > RX_CHANNELIZER_MAX_FREQ_OFFSET) {
+    RX_CHANNELIZER_ERROR("PHY ID: %d - Freq.: %1.2f [MHz] can not be received around %1.2f [MHz]: closest branch: %d - Offset: %1.2f [kHz]\n", phy_id, freq/1000000.0, q->center_freq/1000000.0, branch, offset/1000.0);
+    return -1.0;
+  }
+  rx_channelizer_stream_t *stream = &q->streams[phy_id];
+  if(stream->buffer.capacity == 0) {
+    if(srslte_ringbuffer_init(&stream->buffer, sizeof(cf_t)*RX_CHANNELIZER_BUFFER_NOF_SUBFRAMES*(uint32_t)(q->channel_srate/1000.0))) {
+      RX_CHANNELIZER_ERROR("PHY ID: %d - Error creating stream.\n", phy_id);
+      return -1.0;
+    }
+  }
+  pthread_mutex_lock(&q->streams_mutex);
+  stream->branch = branch < 0 ? branch + (int)q->nof_channels:branch;
+  stream->freq_offset = (float)(offset/q->channel_srate);
+  stream->phase = 0.0;
+  stream->ready = true;
+  // Drop the samples of the previous channel, so that the PHY only reads the new one after the retune. The filter bank
+  // itself is shared by all branches and keeps running, so the new branch needs no reset.
+  srslte_ringbuffer_reset(&stream->buffer);
+  pthread_mutex_unlock(&q->streams_mutex);
+  RX_CHANNELIZER_INFO("PHY ID: %d - Freq.: %1.2f [MHz] - Branch: %d - Offset: %1.2f [kHz]\n", phy_id, freq/1000000.0, stream->branch, offset/1000.0);
+  return freq;
+}
+
+// Drop the samples the PHY has not read yet.
+void rx_channelizer_flush_channel(void *h, uint32_t phy_id) {
+  rx_channelizer_t *q = (rx_channelizer_t*)h;
+  if(phy_id < MAX_NUM_CONCURRENT_PHYS) {
+    srslte_ringbuffer_reset(&q->streams[phy_id].buffer);
+  }
+}
+
+// Stop feeding the PHY and wake it up if it is waiting for samples.
+void rx_channelizer_stop_channel(void *h, uint32_t phy_id) {
+  rx_channelizer_t *q = (rx_channelizer_t*)h;
+  if(phy_id < MAX_NUM_CONCURRENT_PHYS && q->streams[phy_id].buffer.capacity > 0) {
+    pthread_mutex_lock(&q->streams_mutex);
+    q->streams[phy_id].ready = false;
+    pthread_mutex_unlock(&q->streams_mutex);
+    srslte_ringbuffer_stop(&q->streams[phy_id].buffer);
+  }
+}
+
+// Same prototype as the RF receive wrappers, the channel being the PHY ID. The timestamp is the one of the first
+// sample read, derived from the time of the last sample written and the number of samples still in the stream.
+int rx_channelizer_recv_with_time_wrapper(void *h, void *data, uint32_t nsamples, srslte_timestamp_t *t, size_t channel) {
+  rx_channelizer_t *q = (rx_channelizer_t*)h;
+  int nof_bytes = nsamples*sizeof(cf_t);
+  double delay;
+
+  if(channel >= MAX_NUM_CONCURRENT_PHYS || !q->streams[channel].ready) {
+    return -1;
+  }
+  rx_channelizer_stream_t *stream = &q->streams[channel];
+  if(srslte_ringbuffer_read(&stream->buffer, data, nof_bytes) != nof_bytes) {
+    return -1;
+  }
+  if(t != NULL) {
+    pthread_mutex_lock(&q->streams_mutex);
+    delay = ((double)(srslte_ringbuffer_status(&stream->buffer)/sizeof(cf_t)) + nsamples)/q->channel_srate;
+    *t = q->next_timestamp;
+    pthread_mutex_unlock(&q->streams_mutex);
+    srslte_timestamp_sub(t, (time_t)floor(delay), delay - floor(delay));
+  }
+  return nsamples;
+}
+
+void *rx_channelizer_work(void *h) {
+  rx_channelizer_t *q = (rx_channelizer_t*)h;
+  rx_channelizer_stream_t *stream;
+  srslte_timestamp_t timestamp;
+  int nof_samples, nof_channel_samples, nof_bytes;
+  cf_t *samples;
+  // The prototype filter delays each output by half its length, minus the samples waited for to complete a block.
+  double filter_delay = (((double)q->nof_channels*q->channelizer.nof_taps - 1.0)/2.0 - (q->nof_channels - 1))/(q->nof_channels*q->channel_srate);
+
+  while(q->run) {
+    srslte_timestamp_init(&timestamp, 0, 0.0);
+    nof_samples = q->source_callback(q->source_handle, q->wideband_buffer, q->nof_samples_per_read, &timestamp, q->source_channel);
+    if(nof_samples <= 0) {
+      RX_CHANNELIZER_ERROR("Error receiving wideband samples: %d\n", nof_samples);
+      break;
+    }
+    nof_channel_samples = srslte_channelizer_execute(&q->channelizer, q->wideband_buffer, q->channel_buffers, nof_samples - (nof_samples % q->nof_channels));
+    if(nof_channel_samples <= 0) {
+      continue;
+    }
+    nof_bytes = nof_channel_samples*sizeof(cf_t);
+    srslte_timestamp_sub(&timestamp, 0, filter_delay);
+    pthread_mutex_lock(&q->streams_mutex);
+    for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+      stream = &q->streams[phy_id];
+      if(!stream->ready) {
+        continue;
+      }
+      samples = q->channel_buffers[stream->branch];
+      if(stream->freq_offset != 0.0) {
+        stream->phase = srslte_cfo_correct_rotator(samples, q->rotated_buffer, -stream->freq_offset, stream->phase, nof_channel_samples);
+        samples = q->rotated_buffer;
+      }
+      // Drop what the PHY did not read instead of blocking the other PHYs.
+      if(srslte_ringbuffer_space(&stream->buffer) < nof_bytes) {
+        srslte_ringbuffer_reset(&stream->buffer);
+        stream->nof_overflows++;
+        RX_CHANNELIZER_INFO("PHY ID: %d - Stream overflow.\n", phy_id);
+      }
+      srslte_ringbuffer_write(&stream->buffer, samples, nof_bytes);
+    }
+    q->next_timestamp = timestamp;
+    srslte_timestamp_add(&q->next_timestamp, 0, nof_channel_samples/q->channel_srate);
+    pthread_mutex_unlock(&q->streams_mutex);
+  }
+  // Wake up the PHYs waiting for samples.
+  for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+    if(q->streams[phy_id].buffer.capacity > 0) {
+      srslte_ringbuffer_stop(&q->streams[phy_id].buffer);
+    }
+  }
+  RX_CHANNELIZER_PRINT("Leaving Rx channelizer thread.\n",0);
+  // Exit thread with result code.
+  pthread_exit(NULL);
+}
@@ -11,6 +11,9 @@ extern int errno;
 
 #define ENABLE_ENV_UPDATE 1
 
+// Maximum time in microseconds the main loop waits for a message before checking if it has to exit.
+#define TRX_QUEUE_WAIT_TIMEOUT 100000
+
 //************************************************************************
 //                   Program arguments processing
 // ***********************************************************************
@@ -73,10 +76,17 @@ void trx_args_default(transceiver_args_t *args) {
   args->pss_first_stage_threshold = 2.0; // Threshold of the first stage in the two-stage PSS detection mechanism.
   args->pss_second_stage_threshold = 3.5; // Threshold of the second stage in the two-stage PSS detection mechanism.
   args->enable_eob_pss = true; // Enable/Disable End of Busrt PSS.
+  args->phy_stat_batch_size = 1; // By default every RX/TX statistics is sent to MAC in its own message.
+  args->phy_stat_batch_delay = 1000; // Maximum time in microseconds a statistics waits in a batch.
+  args->queue_stats_period = 0; // By default communicator queue statistics are only printed at exit.
+  args->enable_256qam = false; // By default the 64QAM MCS table is used. Both sides of the link must use the same table.
+  args->nof_harq_processes = SRSLTE_UE_DL_DEFAULT_HARQ_PROCESSES; // Number of RX HARQ processes combining retransmissions.
+  args->harq_timeout = SRSLTE_UE_DL_DEFAULT_HARQ_TIMEOUT; // Soft bits of a HARQ process older than this are discarded. Given in milliseconds.
+  args->enable_burst_tracking = false; // By default the channel is estimated from scratch in every subframe.
 }
 
 void trx_usage(transceiver_args_t *args, char *prog) {
-  printf("Usage: %s [abcdegiplomnsxqzwEXBPCRdDvrfUSZTIFLMNGQYWhV]\n", prog);
+  printf("Usage: %s [abcdegiplomnsxqzwEXBPCRdDvrfUSZTIFLMNGQYWkKjuHJyhV]\n", prog);
   printf("\t-a RF args [Default %s]\n", args->rf_args);
   printf("\t-b RF amp. [Default %s]\n", args->rf_amp);
   printf("\t-B Set competition bandwidth [Default %1.2f MHz]\n", args->competition_bw/1000000.0);
@@ -117,15 +127,22 @@ void trx_usage(transceiver_args_t *args, char *prog) {
   printf("\t-w Set the subframe index to be used to start from. [Default %d]\n", args->initial_subframe_index);
   printf("\t-W Enable RX info plot. [Default %s]\n", args->plot_rx_info?"TRUE":"FALSE");
   printf("\t-E Set number of PHYs. [Default %d]\n", args->nof_phys);
-  printf("\t-Y Default radio when nof_phys = 1. [Default %d]\n", args->default_phy_id);
+  printf("\t-Y ID of the first PHY, the PHYs created are -Y to -Y + -E - 1. [Default %d]\n", args->default_phy_id);
   printf("\t-z Set environment pathname. [Default %s]\n", args->env_pathname);
+  printf("\t-k Number of RX/TX statistics batched into a single message to MAC, 1 disables batching. [Default %d]\n", args->phy_stat_batch_size);
+  printf("\t-K Maximum time a statistics waits in a batch in microseconds. [Default %d]\n", args->phy_stat_batch_delay);
+  printf("\t-j Period in milliseconds to print communicator queue statistics, 0 prints them only at exit. [Default %d]\n", args->queue_stats_period);
+  printf("\t-u Use the 256QAM MCS table (MCS 0-27) instead of the 64QAM one. Must be set on both TX and RX sides. [Default %s]\n", args->enable_256qam?"Enabled":"Disabled");
+  printf("\t-H Number of RX HARQ processes combining retransmissions, from 1 to %d. [Default %d]\n", SRSLTE_RA_NOF_HARQ_PROCESSES_SCATTER, args->nof_harq_processes);
+  printf("\t-J RX HARQ process timeout in milliseconds, 0 disables it. [Default %d]\n", args->harq_timeout);
+  printf("\t-y Track the channel estimates across the subframes of a burst. [Default %s]\n", args->enable_burst_tracking?"Enabled":"Disabled");
   printf("\t-h Print this help message\n");
 }
 
 void trx_parse_args(transceiver_args_t *args, int argc, char **argv) {
   int opt;
   trx_args_default(args);
-  while((opt = getopt(argc, argv, "abcdeogiplmnsxqzwEXBPQOCDvrfUSZTIFLMNGRAVYWht0123456789")) != -1) {
+  while((opt = getopt(argc, argv, "abcdeogiplmnsxqzwEXBPQOCDvrfUSZTIFLMNGRAVYWkKjuHJhty0123456789")) != -1) {
     switch (opt) {
     case 'i':
       args->radio_id = atoi(argv[optind]);
@@ -214,8 +231,8 @@ void trx_parse_args(transceiver_args_t *args, int argc, char **argv) {
       break;
     case 'Y':
       args->default_phy_id = atoi(argv[optind]);
-      if(args->default_phy_id > 1) {
-        TRX_ERROR("Default PHY ID has to be lesser than or equal to 1. Value set: %d\n", args->default_phy_id);
+      if(args->default_phy_id >= MAX_NUM_CONCURRENT_PHYS) {
+        TRX_ERROR("Default PHY ID has to be less than %d. Value set: %d\n", MAX_NUM_CONCURRENT_PHYS, args->default_phy_id);
         exit(-1);
       }
       TRX_PRINT("Default radio when nof_phys = 1: %d\n",args->default_phy_id);
@@ -329,6 +346,34 @@ void trx_parse_args(transceiver_args_t *args, int argc, char **argv) {
     case 'G':
       args->sensing_rx_gain = atof(argv[optind]);
       break;
+    case 'k':
+      args->phy_stat_batch_size = atoi(argv[optind]);
+      TRX_PRINT("PHY stats batch size: %d\n",args->phy_stat_batch_size);
+      break;
+    case 'K':
+      args->phy_stat_batch_delay = atoi(argv[optind]);
+      TRX_PRINT("PHY stats batch delay: %d [us]\n",args->phy_stat_batch_delay);
+      break;
+    case 'j':
+      args->queue_stats_period = atoi(argv[optind]);
+      TRX_PRINT("Queue stats period: %d [ms]\n",args->queue_stats_period);
+      break;
+    case 'u':
+      args->enable_256qam = true;
+      TRX_PRINT("256QAM MCS table is enabled.\n",0);
+      break;
+    case 'H':
+      args->nof_harq_processes = atoi(argv[optind]);
+      TRX_PRINT("Number of RX HARQ processes: %d\n",args->nof_harq_processes);
+      break;
+    case 'J':
+      args->harq_timeout = atoi(argv[optind]);
+      TRX_PRINT("RX HARQ process timeout: %d [ms]\n",args->harq_timeout);
+      break;
+    case 'y':
+      args->enable_burst_tracking = true;
+      TRX_PRINT("Burst-level channel estimate tracking is enabled.\n",0);
+      break;
     case '0':
     case '1':
     case '2':
@@ -346,6 +391,11 @@ void trx_parse_args(transceiver_args_t *args, int argc, char **argv) {
       exit(-1);
     }
   }
+  // PHY IDs go from the default PHY ID up to default PHY ID + number of PHYs - 1.
+  if(args->default_phy_id + args->nof_phys > MAX_NUM_CONCURRENT_PHYS) {
+    TRX_ERROR("Default PHY ID plus number of PHYs must be less than or equal to %d. Values set: %d and %d\n", MAX_NUM_CONCURRENT_PHYS, args->default_phy_id, args->nof_phys);
+    exit(-1);
+  }
   char fft_size_string[100];
   if(strcmp(args->rf_args, "")) {
     sprintf(fft_size_string, ",fft_size=%d", args->rf_monitor_fft_size);
@@ -393,6 +443,22 @@ void trx_close_rf_device() {
   TRX_PRINT("srslte_rf_close done!\n",0);
 }
 
+void trx_load_fftw_wisdom() {
+  // Plans of the transforms found in the wisdom are created without measuring them.
+  if(srslte_dft_load(DEFAULT_FFTW_WISDOM_FILENAME) == 0) {
+    TRX_PRINT("FFTW wisdom loaded from %s\n", DEFAULT_FFTW_WISDOM_FILENAME);
+  } else {
+    TRX_PRINT("No FFTW wisdom found at %s, FFTs will be measured.\n", DEFAULT_FFTW_WISDOM_FILENAME);
+  }
+}
+
+void trx_save_fftw_wisdom() {
+  // Keep the transforms measured during this run for the next one.
+  if(srslte_dft_save(DEFAULT_FFTW_WISDOM_FILENAME) == 0) {
+    TRX_PRINT("FFTW wisdom saved to %s\n", DEFAULT_FFTW_WISDOM_FILENAME);
+  }
+}
+
 void trx_change_process_priority(int inc) {
   errno = 0;
   if(nice(inc) == -1) {
@@ -412,6 +478,94 @@ void trx_set_master_clock_rate() {
   TRX_PRINT("Set master clock rate to: %.2f [MHz]\n", (float)srate/1000000);
 }
 
+#if(ENABLE_RX_CHANNELIZER==1)
+void trx_start_rx_channelizer() {
+  transceiver_args_t* const args = &trx_handle->prog_args;
+  double lo_offset, actual_freq, channel_srate;
+  // Each channelizer branch is sampled at the PHY sampling rate.
+  if(args->use_std_carrier_sep) {
+    channel_srate = (double)srslte_sampling_freq_hz(args->nof_prb);
+  } else {
+    channel_srate = (double)helpers_non_std_sampling_freq_hz(args->nof_prb);
+  }
+  double srate = srslte_rf_set_rx_srate(&trx_handle->rf, RX_CHANNELIZER_NOF_CHANNELS*channel_srate, RX_CHANNELIZER_RF_CHANNEL);
+  if(srate != RX_CHANNELIZER_NOF_CHANNELS*channel_srate) {
+    TRX_ERROR("Could not set Rx channelizer sampling rate to %1.2f [MHz].\n", RX_CHANNELIZER_NOF_CHANNELS*channel_srate/1000000.0);
+    exit(-1);
+  }
+  // Tune the RF channel to the competition center frequency, the PHYs select their channels out of it.
+  lo_offset = trx_handle->rf.num_of_channels == 1 ? 0.0:(double)PHY_RX_LO_OFFSET;
+  actual_freq = srslte_rf_set_rx_freq2(&trx_handle->rf, args->competition_center_frequency, lo_offset, RX_CHANNELIZER_RF_CHANNEL);
+  if(actual_freq < (args->competition_center_frequency - 10.0) || actual_freq > (args->competition_center_frequency + 10.0)) {
+    TRX_ERROR("Requested Rx channelizer freq.: %1.2f [MHz] - Actual freq.: %1.2f [MHz]\n", args->competition_center_frequency/1000000.0, actual_freq/1000000.0);
+    exit(-1);
+  }
+  srslte_rf_rx_wait_lo_locked(&trx_handle->rf, RX_CHANNELIZER_RF_CHANNEL);
+  // AGC is not supported as the gain is shared by all the PHYs.
+  if(args->initial_rx_gain >= 0.0) {
+    srslte_rf_set_rx_gain(&trx_handle->rf, args->initial_rx_gain, RX_CHANNELIZER_RF_CHANNEL);
+  }
+  if(srslte_rf_start_rx_stream(&trx_handle->rf, RX_CHANNELIZER_RF_CHANNEL) != 0) {
+    TRX_ERROR("Error starting Rx channelizer stream.\n",0);
+    exit(-1);
+  }
+  if(rx_channelizer_start((void*)&trx_handle->rf, srslte_rf_recv_with_time_wrapper, RX_CHANNELIZER_RF_CHANNEL, channel_srate, args->competition_center_frequency) < 0) {
+    TRX_ERROR("It was not possible to start the Rx channelizer.\n",0);
+    exit(-1);
+  }
+}
+
+void trx_stop_rx_channelizer() {
+  if(srslte_rf_stop_rx_stream(&trx_handle->rf, RX_CHANNELIZER_RF_CHANNEL) != 0) {
+    TRX_ERROR("Error stopping Rx channelizer stream.\n",0);
+  }
+  if(rx_channelizer_stop() < 0) {
+    TRX_ERROR("It was not possible to stop the Rx channelizer.\n",0);
+    exit(-1);
+  }
+  TRX_PRINT("Rx channelizer uninitialization done!\n",0);
+}
+#endif // ENABLE_RX_CHANNELIZER
+
+#if(ENABLE_TX_COMBINER==1)
+void trx_start_tx_combiner() {
+  transceiver_args_t* const args = &trx_handle->prog_args;
+  double lo_offset, actual_freq, channel_srate;
+  // Each synthesizer branch is sampled at the PHY sampling rate.
+  if(args->use_std_carrier_sep) {
+    channel_srate = (double)srslte_sampling_freq_hz(args->nof_prb);
+  } else {
+    channel_srate = (double)helpers_non_std_sampling_freq_hz(args->nof_prb);
+  }
+  double srate = srslte_rf_set_tx_srate(&trx_handle->rf, TX_COMBINER_NOF_CHANNELS*channel_srate, TX_COMBINER_RF_CHANNEL);
+  if(srate != TX_COMBINER_NOF_CHANNELS*channel_srate) {
+    TRX_ERROR("Could not set Tx combiner sampling rate to %1.2f [MHz].\n", TX_COMBINER_NOF_CHANNELS*channel_srate/1000000.0);
+    exit(-1);
+  }
+  // Tune the RF channel to the competition center frequency, the PHYs place their channels inside it.
+  lo_offset = trx_handle->rf.num_of_channels == 1 ? 0.0:(double)PHY_TX_LO_OFFSET;
+  actual_freq = srslte_rf_set_tx_freq2(&trx_handle->rf, args->competition_center_frequency, lo_offset, TX_COMBINER_RF_CHANNEL);
+  if(actual_freq < (args->competition_center_frequency - 10.0) || actual_freq > (args->competition_center_frequency + 10.0)) {
+    TRX_ERROR("Requested Tx combiner freq.: %1.2f [MHz] - Actual freq.: %1.2f [MHz]\n", args->competition_center_frequency/1000000.0, actual_freq/1000000.0);
+    exit(-1);
+  }
+  // The gain is shared by all the PHYs.
+  srslte_rf_set_tx_gain(&trx_handle->rf, args->initial_tx_gain, TX_COMBINER_RF_CHANNEL);
+  if(tx_combiner_start((void*)&trx_handle->rf, srslte_rf_send_timed_wrapper, TX_COMBINER_RF_CHANNEL, channel_srate, args->competition_center_frequency) < 0) {
+    TRX_ERROR("It was not possible to start the Tx combiner.\n",0);
+    exit(-1);
+  }
+}
+
+void trx_stop_tx_combiner() {
+  if(tx_combiner_stop() < 0) {
+    TRX_ERROR("It was not possible to stop the Tx combiner.\n",0);
+    exit(-1);
+  }
+  TRX_PRINT("Tx combiner uninitialization done!\n",0);
+}
+#endif // ENABLE_TX_COMBINER
+
 #if(ENABLE_SENSING_THREAD==1)
 void trx_initialize_rf_monitor() {
   if(trx_handle->prog_args.rf_monitor_option <= 4 && trx_handle->rf.num_of_channels > 1) {
@@ -470,10 +624,14 @@ int main(int argc, char **argv) {
 
   LayerCommunicator_handle handle = NULL;
   char module_name[100], target1_name[100], target2_name[100];
-  bool ret;
+  int queue;
   basic_ctrl_t basic_ctrl;
 #if(ENABLE_ENV_UPDATE==1)
   environment_t env_update;
+  void * const high_msg_struct = (void *)&env_update;
+#else
+  // Environment updates are not handled, so the high priority QUEUE is not served.
+  void * const high_msg_struct = NULL;
 #endif
 
   // Set priority to main thread.
@@ -509,11 +667,21 @@ int main(int argc, char **argv) {
   // Rertieve target name.
   trx_get_module_and_target_name(module_name, target1_name, target2_name);
   // Instantiate communicator module so that we can receive/transmit commands and data
-  communicator_initialization(module_name, target1_name, target2_name, &handle, MAX_NUM_CONCURRENT_PHYS, trx_handle->prog_args.env_pathname);
+  communicator_initialization(module_name, target1_name, target2_name, &handle, (trx_handle->prog_args.default_phy_id + trx_handle->prog_args.nof_phys), trx_handle->prog_args.env_pathname);
+  // Coalesce RX/TX statistics sent to MAC into batches if requested.
+  communicator_enable_phy_stat_batching(handle, trx_handle->prog_args.phy_stat_batch_size, trx_handle->prog_args.phy_stat_batch_delay);
+  // Periodically print depth, counters and residence time of the communicator queues if requested.
+  communicator_enable_queue_stats_export(handle, trx_handle->prog_args.queue_stats_period);
   // Verify if enviroment update file exists and if the parameters are different from default ones.
   trx_verify_environment_update_file_existence(&trx_handle->prog_args);
+  // Load the FFTW wisdom before the PHYs create their FFT plans.
+  trx_load_fftw_wisdom();
 
 #if(ENABLE_RX==1)
+#if(ENABLE_RX_CHANNELIZER==1)
+  // Split the RF channel into the PHY channels before the PHYs start reading them.
+  trx_start_rx_channelizer();
+#endif
   // Initialize PHY reception thread.
   for(int phy_id = 0; phy_id < trx_handle->prog_args.nof_phys; phy_id++) {
     if(phy_reception_start_thread(handle, &trx_handle->rf, &trx_handle->prog_args, (trx_handle->prog_args.default_phy_id + phy_id)) < 0) {
@@ -522,12 +690,16 @@ int main(int argc, char **argv) {
     }
     TRX_PRINT("PHY ID: %d - PHY reception thread initialized.\n", phy_id);
     // Keep reception timer id's address for checking.
-    trx_handle->rx_timer_ids[phy_id] = phy_reception_get_timer_id(phy_id);
+    trx_handle->rx_timer_ids[phy_id] = phy_reception_get_timer_id((trx_handle->prog_args.default_phy_id + phy_id));
   }
   TRX_PRINT("All Rx threads were successfully started.\n", 0);
 #endif
 
 #if(ENABLE_TX==1)
+#if(ENABLE_TX_COMBINER==1)
+  // Combine the PHY channels into the RF channel before the PHYs start transmitting.
+  trx_start_tx_combiner();
+#endif
   for(int phy_id = 0; phy_id < trx_handle->prog_args.nof_phys; phy_id++) {
     // Initialize PHY transmission thread.
     if(phy_transmission_start_thread(handle, &trx_handle->rf, &trx_handle->prog_args, (trx_handle->prog_args.default_phy_id + phy_id)) < 0) {
@@ -536,7 +708,7 @@ int main(int argc, char **argv) {
     }
     TRX_PRINT("PHY ID: %d - PHY transmission thread initialized.\n", phy_id);
     // Keep transmission timer id's address for checking.
-    trx_handle->tx_timer_ids[phy_id] = phy_transmission_get_timer_id(phy_id);
+    trx_handle->tx_timer_ids[phy_id] = phy_transmission_get_timer_id((trx_handle->prog_args.default_phy_id + phy_id));
   }
   TRX_PRINT("All Tx threads were successfully started.\n", 0);
 #endif
@@ -565,41 +737,33 @@ int main(int argc, char **argv) {
   while(!trx_handle->go_exit) {
 
 #if(ENBALE_TX_PROFILLING==1)
-    // Measure the time it takes for environment update.
-    uint64_t env_update_timestamp_start = helpers_get_host_time_now();
+    // Measure the time it takes for a message to be handled.
+    uint64_t msg_timestamp_start = helpers_get_host_time_now();
 #endif
 
+    // Wait for a message in any of the QUEUEs. It returns as soon as a message arrives, always serving environment updates
+    // (high priority QUEUE) before basic controls (low priority QUEUE), and times out so that go_exit is checked.
+    queue = communicator_get_any_queue_wait_for(handle, TRX_QUEUE_WAIT_TIMEOUT, high_msg_struct, (void * const)&basic_ctrl, NULL);
+    // If message is properly retrieved and parsed, then relay it to the correct module.
+    if(!trx_handle->go_exit) {
 #if(ENABLE_ENV_UPDATE==1)
-    // Check for environment update messages.
-    ret = communicator_get_high_queue(handle, (void * const)&env_update, NULL);
-    if(!trx_handle->go_exit && ret) {
-      trx_handle_update_env_messages(&env_update);
-    }
-#endif
-
-#if(ENBALE_TX_PROFILLING==1)
-    uint64_t env_update_timestamp_end = helpers_get_host_time_now();
-    int envu_tdif = (int)(env_update_timestamp_end - env_update_timestamp_start);
-    if(envu_tdif > 1000) {
-      TRX_ERROR("Env. update time diff: %d - ret: %d\n", envu_tdif, ret);
-    }
-    // Measure the time it takes for environment update.
-    uint64_t bc_timestamp_start = helpers_get_host_time_now();
+      // Environment updates requested by MAC or detected by the environment update service. The environment file is
+      // parsed in the service thread, so this only reads its latest snapshot.
+      if(queue == COMM_HIGH_QUEUE || communicator_get_environment_update(&env_update)) {
+        trx_handle_update_env_messages(&env_update);
+      }
 #endif
-
-    // Try to retrieve a message from the QUEUE. It waits for a specified amount of time before timing out.
-    ret = communicator_get_low_queue_wait_for(handle, 500, (void * const)&basic_ctrl, NULL);
-    // If message is properly retrieved and parsed, then relay it to the correct module.
-    if(!trx_handle->go_exit && ret) {
-      // Call FSM function to handle the state.
-      trx_handle_mac_messages(&basic_ctrl);
+      if(queue == COMM_LOW_QUEUE) {
+        // Call FSM function to handle the state.
+        trx_handle_mac_messages(&basic_ctrl);
+      }
     }
 
 #if(ENBALE_TX_PROFILLING==1)
-    uint64_t bc_timestamp_end = helpers_get_host_time_now();
-    int bc_tdif = (int)(bc_timestamp_end - bc_timestamp_start);
-    if(bc_tdif > 1000) {
-      TRX_ERROR("Basic control time diff: %d - ret: %d\n", bc_tdif, ret);
+    uint64_t msg_timestamp_end = helpers_get_host_time_now();
+    int msg_tdif = (int)(msg_timestamp_end - msg_timestamp_start);
+    if(queue != COMM_NO_QUEUE && msg_tdif > 1000) {
+      TRX_ERROR("Message handling time diff: %d - queue: %d\n", msg_tdif, queue);
     }
 #endif
 
@@ -607,6 +771,9 @@ int main(int argc, char **argv) {
   //**************************************** Handle incoming messages - END *****************************************
   TRX_PRINT("Start uninitialization of modules.\n",0);
 
+  // Print depth, counters and how long messages waited in the QUEUEs before being handled.
+  communicator_print_queue_stats(handle);
+
   // After use, communicator handle MUST be freed.
   communicator_uninitialization(&handle);
   TRX_PRINT("Communicator handle freed.\n",0);
@@ -627,6 +794,9 @@ int main(int argc, char **argv) {
     }
     TRX_PRINT("PHY ID: %d - Transmission uninitialization done!\n", (trx_handle->prog_args.default_phy_id + phy_id));
   }
+#if(ENABLE_TX_COMBINER==1)
+  trx_stop_tx_combiner();
+#endif
 #endif
 
 #if(ENABLE_RX==1)
@@ -642,8 +812,14 @@ int main(int argc, char **argv) {
     }
     TRX_PRINT("PHY ID: %d - Reception uninitialization done!\n", (trx_handle->prog_args.default_phy_id + phy_id));
   }
+#if(ENABLE_RX_CHANNELIZER==1)
+  trx_stop_rx_channelizer();
+#endif
 #endif
 
+  // Save the FFTW wisdom, including the FFTs planned for the bandwidths used in this run.
+  trx_save_fftw_wisdom();
+
   // Close RF device.
   trx_close_rf_device();
 
@@ -660,11 +836,13 @@ int main(int argc, char **argv) {
 
 int trx_handle_mac_messages(basic_ctrl_t *basic_ctrl) {
   // Validate PHY ID.
-  if(trx_handle->prog_args.nof_phys < MAX_NUM_CONCURRENT_PHYS) {
-    if(basic_ctrl->phy_id != trx_handle->prog_args.default_phy_id) {
-      TRX_ERROR("PHY ID in MAC basic control: %d does not match default PHY ID: %d - Dropping this control message....\n", basic_ctrl->phy_id, trx_handle->prog_args.default_phy_id);
-      return -1;
+  if(basic_ctrl->phy_id < trx_handle->prog_args.default_phy_id || basic_ctrl->phy_id >= (trx_handle->prog_args.default_phy_id + trx_handle->prog_args.nof_phys)) {
+    TRX_ERROR("PHY ID in MAC basic control: %d is not one of the PHYs created: %d to %d - Dropping this control message....\n", basic_ctrl->phy_id, trx_handle->prog_args.default_phy_id, (trx_handle->prog_args.default_phy_id + trx_handle->prog_args.nof_phys - 1));
+    // Give user data back to the communicator.
+    if(basic_ctrl->trx_flag == PHY_TX_ST) {
+      communicator_release_user_data_buffer(basic_ctrl->data);
     }
+    return -1;
   }
   switch(basic_ctrl->trx_flag) {
     case PHY_TX_ST:
@@ -682,7 +860,7 @@ int trx_handle_mac_messages(basic_ctrl_t *basic_ctrl) {
         TRX_ERROR("0MQ time diff at TRX: %d\n", tdiff);
       }
   #endif
-      // Push basic Tx control into circular buffer.
+      // Push basic Tx control into the deadline ordered queue.
       phy_transmission_push_tx_basic_control_into_container(basic_ctrl);
 #endif
       break;
@@ -751,11 +929,11 @@ static void trx_watchdog_handler(int sig, siginfo_t *info, void *ptr) {
   for(int phy_id = 0; phy_id < trx_handle->prog_args.nof_phys; phy_id++) {
      // Verify if one of the Rx threads actived the watchdog.
      if(info->si_value.sival_ptr == trx_handle->rx_timer_ids[phy_id]) {
-       TRX_PRINT("Watchdog activated in PHY ID: %d Rx thread.\n", phy_id);
+       TRX_PRINT("Watchdog activated in PHY ID: %d Rx thread.\n", (trx_handle->prog_args.default_phy_id + phy_id));
      }
      // Verify if one of the Tx threads actived the watchdog.
      if(info->si_value.sival_ptr == trx_handle->tx_timer_ids[phy_id]) {
-       TRX_PRINT("Watchdog activated in PHY ID: %d Tx thread.\n", phy_id);
+       TRX_PRINT("Watchdog activated in PHY ID: %d Tx thread.\n", (trx_handle->prog_args.default_phy_id + phy_id));
      }
   }
 }
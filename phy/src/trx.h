@@ -104,8 +104,20 @@ void trx_open_rf_device();
 
 void trx_close_rf_device();
 
+void trx_load_fftw_wisdom();
+
+void trx_save_fftw_wisdom();
+
 void trx_set_master_clock_rate();
 
+void trx_start_rx_channelizer();
+
+void trx_stop_rx_channelizer();
+
+void trx_start_tx_combiner();
+
+void trx_stop_tx_combiner();
+
 void trx_handle_update_env_messages(environment_t *env_update);
 
 void trx_verify_environment_update_file_existence(transceiver_args_t* args);
@@ -0,0 +1,367 @@
+#include "tx_combiner.h"
+
+// *********** Global variables ***********
+static tx_combiner_t *tx_combiner = NULL;
+
+// Difference in seconds between two timestamps, without losing the fractional part to the full seconds.
+static inline double tx_combiner_time_diff(srslte_timestamp_t *a, srslte_timestamp_t *b) {
+  return (double)(a->full_secs - b->full_secs) + (a->frac_secs - b->frac_secs);
+}
+
+int tx_combiner_start(void *sink_handle, int (*sink_callback)(void*, void*, int, time_t, double, bool, bool, bool, size_t), size_t sink_channel, double channel_srate, double center_freq) {
+  // Allocate memory for the combiner context.
+  tx_combiner = (tx_combiner_t*)srslte_vec_malloc(sizeof(tx_combiner_t));
+  if(tx_combiner == NULL) {
+    TX_COMBINER_ERROR("Error allocating memory for Tx combiner context.\n",0);
+    return -1;
+  }
+  bzero(tx_combiner, sizeof(tx_combiner_t));
+  tx_combiner->sink_handle           = sink_handle;
+  tx_combiner->sink_callback         = sink_callback;
+  tx_combiner->sink_channel          = sink_channel;
+  tx_combiner->nof_channels          = TX_COMBINER_NOF_CHANNELS;
+  tx_combiner->channel_srate         = channel_srate;
+  tx_combiner->center_freq           = center_freq;
+  tx_combiner->nof_samples_per_chunk = (uint32_t)(channel_srate/1000.0);
+  // Create the polyphase synthesizer and its buffers.
+  if(srslte_synthesizer_init(&tx_combiner->synthesizer, tx_combiner->nof_channels, SRSLTE_CHANNELIZER_DEFAULT_TAPS, tx_combiner->nof_channels*tx_combiner->nof_samples_per_chunk)) {
+    TX_COMBINER_ERROR("Error creating synthesizer with %d channels.\n", tx_combiner->nof_channels);
+    return -1;
+  }
+  tx_combiner->rotated_buffer = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*tx_combiner->nof_samples_per_chunk);
+  tx_combiner->wideband_buffer = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*tx_combiner->nof_channels*tx_combiner->nof_samples_per_chunk);
+  if(tx_combiner->rotated_buffer == NULL || tx_combiner->wideband_buffer == NULL) {
+    TX_COMBINER_ERROR("Error allocating memory for Tx combiner buffers.\n",0);
+    return -1;
+  }
+  for(uint32_t k = 0; k < tx_combiner->nof_channels; k++) {
+    tx_combiner->branch_buffers[k] = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*tx_combiner->nof_samples_per_chunk);
+    if(tx_combiner->branch_buffers[k] == NULL) {
+      TX_COMBINER_ERROR("Error allocating memory for branch buffer %d.\n", k);
+      return -1;
+    }
+  }
+  // The stream of each PHY is created when it configures its channel frequency.
+  for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+    tx_combiner->streams[phy_id].ready = false;
+    tx_combiner->streams[phy_id].branch = -1;
+  }
+  pthread_mutex_init(&tx_combiner->streams_mutex, NULL);
+  pthread_cond_init(&tx_combiner->streams_cv, NULL);
+  // Start the thread combining the PHY streams.
+  tx_combiner->run = true;
+  pthread_attr_init(&tx_combiner->thread_attr);
+  pthread_attr_setdetachstate(&tx_combiner->thread_attr, PTHREAD_CREATE_JOINABLE);
+  int rc = pthread_create(&tx_combiner->thread_id, &tx_combiner->thread_attr, tx_combiner_work, (void *)tx_combiner);
+  if(rc) {
+    TX_COMBINER_ERROR("Return code from Tx combiner pthread_create() is %d\n", rc);
+    return -1;
+  }
+  TX_COMBINER_PRINT("%d channels of %1.2f [MHz] around %1.2f [MHz] started.\n", tx_combiner->nof_channels, channel_srate/1000000.0, center_freq/1000000.0);
+  // Everything went well.
+  return 0;
+}
+
+int tx_combiner_stop() {
+  if(tx_combiner == NULL) {
+    return 0;
+  }
+  // Stop the thread, waking it up and the PHYs waiting on it, and join it.
+  pthread_mutex_lock(&tx_combiner->streams_mutex);
+  tx_combiner->run = false;
+  pthread_cond_broadcast(&tx_combiner->streams_cv);
+  pthread_mutex_unlock(&tx_combiner->streams_mutex);
+  pthread_attr_destroy(&tx_combiner->thread_attr);
+  int rc = pthread_join(tx_combiner->thread_id, NULL);
+  if(rc) {
+    TX_COMBINER_ERROR("Return code from Tx combiner pthread_join() is %d\n", rc);
+    return -1;
+  }
+  // Free the streams and buffers.
+  for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+    if(tx_combiner->streams[phy_id].buffer.capacity > 0) {
+      if(tx_combiner->streams[phy_id].nof_late_bursts > 0) {
+        TX_COMBINER_PRINT("PHY ID: %d - %d bursts started late.\n", phy_id, tx_combiner->streams[phy_id].nof_late_bursts);
+      }
+      srslte_ringbuffer_free(&tx_combiner->streams[phy_id].buffer);
+    }
+    if(tx_combiner->phy_buffers[phy_id]) {
+      free(tx_combiner->phy_buffers[phy_id]);
+    }
+  }
+  for(uint32_t k = 0; k < tx_combiner->nof_channels; k++) {
+    if(tx_combiner->branch_buffers[k]) {
+      free(tx_combiner->branch_buffers[k]);
+    }
+  }
+  if(tx_combiner->rotated_buffer) {
+    free(tx_combiner->rotated_buffer);
+  }
+  if(tx_combiner->wideband_buffer) {
+    free(tx_combiner->wideband_buffer);
+  }
+  srslte_synthesizer_free(&tx_combiner->synthesizer);
+  pthread_cond_destroy(&tx_combiner->streams_cv);
+  pthread_mutex_destroy(&tx_combiner->streams_mutex);
+  free(tx_combiner);
+  tx_combiner = NULL;
+  TX_COMBINER_PRINT("Tx combiner stopped.\n",0);
+  // Everything went well.
+  return 0;
+}
+
+void *tx_combiner_get_handle() {
+  return (void*)tx_combiner;
+}
+
+double tx_combiner_get_channel_srate(void *h) {
+  return ((tx_combiner_t*)h)->channel_srate;
+}
+
+// Map the PHY channel to the closest branch. The residual offset is applied by a phase rotator, so the actual
+// frequency is always the requested one.
+double tx_combiner_set_channel_freq(void *h, uint32_t phy_id, double freq) {
+  tx_combiner_t *q = (tx_combiner_t*)h;
+  double relative_freq = (freq - q->center_freq)/q->channel_srate;
+  int branch = (int)lround(relative_freq);
+  double offset = (relative_freq - branch)*q->channel_srate;
+
+  if(phy_id >= MAX_NUM_CONCURRENT_PHYS) {
+    TX_COMBINER_ERROR("Invalid PHY ID: %d\n", phy_id);
+    return -1.0;
+  }
+  // Only the branches entirely inside the RF channel band are used.
+  if(abs(branch) > (int)(q->nof_channels-1)/2 || fabs(offset) > TX_COMBINER_MAX_FREQ_OFFSET) {
+    TX_COMBINER_ERROR("PHY ID: %d - Freq.: %1.2f [MHz] can not be transmitted around %1.2f [MHz]: closest branch: %d - Offset: %1.2f [kHz]\n", phy_id, freq/1000000.0, q->center_freq/1000000.0, branch, offset/1000.0);
+    return -1.0;
+  }
+  tx_combiner_stream_t *stream = &q->streams[phy_id];
+  if(stream->buffer.capacity == 0) {
+    q->phy_buffers[phy_id] = (cf_t*)srslte_vec_malloc(sizeof(cf_t)*q->nof_samples_per_chunk);
+    if(q->phy_buffers[phy_id] == NULL || srslte_ringbuffer_init(&stream->buffer, sizeof(cf_t)*TX_COMBINER_BUFFER_NOF_SUBFRAMES*q->nof_samples_per_chunk)) {
+      TX_COMBINER_ERROR("PHY ID: %d - Error creating stream.\n", phy_id);
+      return -1.0;
+    }
+  }
+  pthread_mutex_lock(&q->streams_mutex);
+  stream->branch = branch < 0 ? branch + (int)q->nof_channels:branch;
+  stream->freq_offset = (float)(offset/q->channel_srate);
+  stream->phase = 0.0;
+  stream->ready = true;
+  pthread_mutex_unlock(&q->streams_mutex);
+  TX_COMBINER_INFO("PHY ID: %d - Freq.: %1.2f [MHz] - Branch: %d - Offset: %1.2f [kHz]\n", phy_id, freq/1000000.0, stream->branch, offset/1000.0);
+  return freq;
+}
+
+// Same arguments as the RF timed send, the channel being the PHY ID. The samples are queued until the combiner takes
+// them, blocking while the stream of the PHY is full.
+int tx_combiner_send_timed(void *h, void *data, int nsamples, time_t secs, double frac_secs, bool has_time_spec, bool is_start_of_burst, bool is_end_of_burst, size_t channel) {
+  tx_combiner_t *q = (tx_combiner_t*)h;
+  uint8_t *ptr = (uint8_t*)data;
+  int nof_bytes = nsamples*sizeof(cf_t), nof_written;
+
+  if(channel >= MAX_NUM_CONCURRENT_PHYS) {
+    return -1;
+  }
+  tx_combiner_stream_t *stream = &q->streams[channel];
+  pthread_mutex_lock(&q->streams_mutex);
+  if(!stream->ready) {
+    pthread_mutex_unlock(&q->streams_mutex);
+    return -1;
+  }
+  if(is_start_of_burst) {
+    // Wait for the previous burst to be combined.
+    while(q->run && stream->in_burst) {
+      pthread_cond_wait(&q->streams_cv, &q->streams_mutex);
+    }
+    stream->in_burst = true;
+    stream->end_of_burst = false;
+    stream->started = false;
+    stream->has_time_spec = has_time_spec;
+    srslte_timestamp_init(&stream->start, secs, frac_secs);
+    stream->phase = 0.0;
+  }
+  while(q->run && nof_bytes > 0) {
+    while(q->run && srslte_ringbuffer_space(&stream->buffer) == 0) {
+      pthread_cond_wait(&q->streams_cv, &q->streams_mutex);
+    }
+    nof_written = SRSLTE_MIN(nof_bytes, srslte_ringbuffer_space(&stream->buffer));
+    srslte_ringbuffer_write(&stream->buffer, ptr, nof_written);
+    ptr += nof_written;
+    nof_bytes -= nof_written;
+    pthread_cond_broadcast(&q->streams_cv);
+  }
+  if(is_end_of_burst) {
+    stream->end_of_burst = true;
+    pthread_cond_broadcast(&q->streams_cv);
+  }
+  pthread_mutex_unlock(&q->streams_mutex);
+  return q->run ? nsamples:-1;
+}
+
+void *tx_combiner_work(void *h) {
+  tx_combiner_t *q = (tx_combiner_t*)h;
+  tx_combiner_stream_t *stream;
+  uint32_t chunk_len = q->nof_samples_per_chunk;
+  double chunk_duration = chunk_len/q->channel_srate;
+  srslte_timestamp_t burst_time, tx_time;
+  bool burst_active = false, burst_has_time_spec = false, start_of_burst = false, end_of_burst;
+  bool combined[MAX_NUM_CONCURRENT_PHYS];
+  // Branch, offset and rotator phase of every PHY for the current chunk, taken under the lock as they may be changed
+  // by a retune or a new burst while the chunk is combined.
+  int chunk_branch[MAX_NUM_CONCURRENT_PHYS];
+  float chunk_freq_offset[MAX_NUM_CONCURRENT_PHYS], chunk_phase[MAX_NUM_CONCURRENT_PHYS];
+  double next_phase;
+  cf_t *branch_inputs[TX_COMBINER_NOF_CHANNELS];
+  uint32_t offset, nof_samples, nof_late_samples;
+  int nof_channels_used;
+  double diff;
+  // The synthesizer delays the combined signal by half the length of the prototype filter.
+  double filter_delay = ((double)q->nof_channels*q->synthesizer.nof_taps - 1.0)/2.0/(q->nof_channels*q->channel_srate);
+
+  pthread_mutex_lock(&q->streams_mutex);
+  while(q->run) {
+    if(!burst_active) {
+      // The combined burst starts with the earliest of the PHY bursts.
+      int earliest = -1;
+      for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+        stream = &q->streams[phy_id];
+        if(stream->in_burst && (earliest < 0 || !stream->has_time_spec || (q->streams[earliest].has_time_spec && tx_combiner_time_diff(&stream->start, &q->streams[earliest].start) < 0.0))) {
+          earliest = phy_id;
+        }
+      }
+      if(earliest < 0) {
+        pthread_cond_wait(&q->streams_cv, &q->streams_mutex);
+        continue;
+      }
+      burst_time = q->streams[earliest].start;
+      burst_has_time_spec = q->streams[earliest].has_time_spec;
+      burst_active = true;
+      start_of_burst = true;
+      srslte_synthesizer_reset(&q->synthesizer);
+    }
+    // Take one chunk of every PHY burst overlapping it, placed at its own time.
+    for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+      stream = &q->streams[phy_id];
+      combined[phy_id] = false;
+      if(!stream->in_burst) {
+        continue;
+      }
+      offset = 0;
+      if(burst_has_time_spec && stream->has_time_spec) {
+        diff = tx_combiner_time_diff(&stream->start, &burst_time);
+        if(diff >= chunk_duration) {
+          continue;
+        }
+        if(diff > 0.0) {
+          offset = SRSLTE_MIN((uint32_t)round(diff*q->channel_srate), chunk_len);
+        } else if(!stream->started && diff < -0.5/q->channel_srate) {
+          // The combined burst is already past the start of this one, so its first samples are dropped to keep the
+          // rest of it at its time.
+          stream->nof_late_bursts++;
+          TX_COMBINER_INFO("PHY ID: %d - Burst starts %1.1f [us] late.\n", phy_id, -diff*1000000.0);
+          nof_late_samples = (uint32_t)round(-diff*q->channel_srate);
+          while(q->run && nof_late_samples > 0) {
+            while(q->run && srslte_ringbuffer_status(&stream->buffer) == 0 && !stream->end_of_burst) {
+              pthread_cond_wait(&q->streams_cv, &q->streams_mutex);
+            }
+            nof_samples = SRSLTE_MIN(SRSLTE_MIN(nof_late_samples, chunk_len), srslte_ringbuffer_status(&stream->buffer)/sizeof(cf_t));
+            if(nof_samples == 0) {
+              break;
+            }
+            srslte_ringbuffer_read(&stream->buffer, q->phy_buffers[phy_id], nof_samples*sizeof(cf_t));
+            nof_late_samples -= nof_samples;
+            pthread_cond_broadcast(&q->streams_cv);
+          }
+        }
+      }
+      // Wait for the PHY to queue the samples of this chunk, unless its burst ends earlier.
+      while(q->run && srslte_ringbuffer_status(&stream->buffer) < (int)((chunk_len - offset)*sizeof(cf_t)) && !stream->end_of_burst) {
+        pthread_cond_wait(&q->streams_cv, &q->streams_mutex);
+      }
+      nof_samples = SRSLTE_MIN(chunk_len - offset, srslte_ringbuffer_status(&stream->buffer)/sizeof(cf_t));
+      bzero(q->phy_buffers[phy_id], sizeof(cf_t)*chunk_len);
+      srslte_ringbuffer_read(&stream->buffer, &q->phy_buffers[phy_id][offset], nof_samples*sizeof(cf_t));
+      stream->started = true;
+      stream->start = burst_time;
+      srslte_timestamp_add(&stream->start, 0, chunk_duration);
+      if(stream->end_of_burst && srslte_ringbuffer_status(&stream->buffer) == 0) {
+        stream->in_burst = false;
+      }
+      chunk_branch[phy_id] = stream->branch;
+      chunk_freq_offset[phy_id] = stream->freq_offset;
+      chunk_phase[phy_id] = stream->phase;
+      // Advance the phase here rather than after the rotation, so that a reset made meanwhile is kept.
+      next_phase = (double)stream->phase + (double)stream->freq_offset*chunk_len;
+      stream->phase = (float)(next_phase - floor(next_phase));
+      combined[phy_id] = true;
+    }
+    // The combined burst goes on while a PHY burst has started or starts in the next chunk.
+    end_of_burst = true;
+    for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+      stream = &q->streams[phy_id];
+      if(stream->in_burst && (stream->started || !stream->has_time_spec || !burst_has_time_spec || tx_combiner_time_diff(&stream->start, &burst_time) < 2*chunk_duration)) {
+        end_of_burst = false;
+      }
+    }
+    pthread_cond_broadcast(&q->streams_cv);
+    pthread_mutex_unlock(&q->streams_mutex);
+
+    // Move every PHY to its frequency inside its branch and add it to the branch.
+    for(uint32_t k = 0; k < q->nof_channels; k++) {
+      branch_inputs[k] = NULL;
+    }
+    nof_channels_used = 0;
+    for(uint32_t phy_id = 0; phy_id < MAX_NUM_CONCURRENT_PHYS; phy_id++) {
+      if(!combined[phy_id]) {
+        continue;
+      }
+      int branch = chunk_branch[phy_id];
+      cf_t *samples = q->phy_buffers[phy_id];
+      if(chunk_freq_offset[phy_id] != 0.0) {
+        srslte_cfo_correct_rotator(samples, q->rotated_buffer, chunk_freq_offset[phy_id], chunk_phase[phy_id], chunk_len);
+        samples = q->rotated_buffer;
+      }
+      if(branch_inputs[branch] == NULL) {
+        branch_inputs[branch] = q->branch_buffers[branch];
+        srslte_vec_sc_prod_cfc(samples, TX_COMBINER_AMPLITUDE_SCALE, branch_inputs[branch], chunk_len);
+      } else {
+        srslte_vec_sc_prod_cfc(samples, TX_COMBINER_AMPLITUDE_SCALE, q->rotated_buffer, chunk_len);
+        srslte_vec_sum_ccc(branch_inputs[branch], q->rotated_buffer, branch_inputs[branch], chunk_len);
+      }
+      nof_channels_used++;
+    }
+    srslte_synthesizer_execute(&q->synthesizer, branch_inputs, q->wideband_buffer, chunk_len);
+    // The first combined sample goes out earlier so that the samples of the PHYs go out at their time.
+    tx_time = burst_time;
+    srslte_timestamp_sub(&tx_time, 0, filter_delay);
+    if(q->sink_callback(q->sink_handle, q->wideband_buffer, q->nof_channels*chunk_len, tx_time.full_secs, tx_time.frac_secs, (start_of_burst && burst_has_time_spec), start_of_burst, false, q->sink_channel) < 0) {
+      TX_COMBINER_ERROR("Error transmitting %d combined channels.\n", nof_channels_used);
+    }
+    // The last samples of the burst are still in the synthesizer history, push zeros through it to send them.
+    if(end_of_burst) {
+      for(uint32_t k = 0; k < q->nof_channels; k++) {
+        branch_inputs[k] = NULL;
+      }
+      nof_samples = SRSLTE_MIN(q->synthesizer.nof_taps - 1, chunk_len);
+      srslte_synthesizer_execute(&q->synthesizer, branch_inputs, q->wideband_buffer, nof_samples);
+      srslte_timestamp_add(&tx_time, 0, chunk_duration);
+      if(q->sink_callback(q->sink_handle, q->wideband_buffer, q->nof_channels*nof_samples, tx_time.full_secs, tx_time.frac_secs, false, false, true, q->sink_channel) < 0) {
+        TX_COMBINER_ERROR("Error transmitting the end of %d combined channels.\n", nof_channels_used);
+      }
+    }
+
+    pthread_mutex_lock(&q->streams_mutex);
+    srslte_timestamp_add(&burst_time, 0, chunk_duration);
+    start_of_burst = false;
+    if(end_of_burst) {
+      burst_active = false;
+    }
+  }
+  // Wake up the PHYs waiting for space.
+  pthread_cond_broadcast(&q->streams_cv);
+  pthread_mutex_unlock(&q->streams_mutex);
+  TX_COMBINER_PRINT("Leaving Tx combiner thread.\n",0);
+  // Exit thread with result code.
+  pthread_exit(NULL);
+}
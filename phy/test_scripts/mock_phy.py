@@ -15,13 +15,15 @@ from communicator.python.LayerCommunicator import LayerCommunicator
 import communicator.python.interf_pb2 as interf
 
 def help():
-    print("Usage: pyhton3 mock_phy.py -m [TX|RX]")
+    print("Usage: pyhton3 mock_phy.py [-d] [-b batch_size]")
+    print("\t-b: number of PHY stats sent in a single Phy_stat_batch message, 1 disables batching.")
 
 def inputOptions(argv):
     debug = True # by default debug is enabled.
+    batch_size = 1 # by default every PHY stat is sent in its own message.
 
     try:
-        opts, args = getopt.getopt(argv,"hd",["help","debug"])
+        opts, args = getopt.getopt(argv,"hdb:",["help","debug","batch="])
     except getopt.GetoptError:
         help()
         sys.exit(2)
@@ -31,8 +33,16 @@ def inputOptions(argv):
             sys.exit()
         elif opt in ("-d", "--debug"):
             debug = True
+        elif opt in ("-b", "--batch"):
+            batch_size = int(arg)
 
-    return debug
+    return debug, batch_size
+
+def sendPhyStatBatch(lc, module, batch):
+    # The transaction index of a batch is the one of its last entry, as done by the PHY.
+    batch.transaction_index = batch.phy_stat_batch.entries[-1].transaction_index
+    print("Sending batch with", len(batch.phy_stat_batch.entries), "PHY Stats to upper layer.....")
+    lc.send(Message(module, interf.MODULE_MAC, batch))
 
 def printBasicControl(basic_control, seq_num, tx_data):
     print("********************* Basic Control CMD Received ********************")
@@ -85,7 +95,7 @@ def printPhyStats(stats, trx_flag, seq_number, status,rx_data):
 if __name__ == '__main__':
 
     # Parse any input option.
-    debug = inputOptions(sys.argv[1:])
+    debug, batch_size = inputOptions(sys.argv[1:])
 
     # Instantiate the communicator module.
     module = interf.MODULE_PHY
@@ -121,6 +131,10 @@ if __name__ == '__main__':
         print("Error: Invalid TRX Flag.")
         exit(-1)
 
+    # Batch of PHY Statistics, only used when batching is enabled.
+    batch = interf.Internal()
+    batch.owner_module = module
+
     for packet in range(0,length,1):
 
         # Create PHY Statistics object.
@@ -167,9 +181,20 @@ if __name__ == '__main__':
             print("Invalid Flag option.")
             exit(-1)
 
-        # Send PHY Statistics upwards.
-        print("Sending PHY Stats", packet,  "to upper layer.....")
-        lc.send(Message(module, interf.MODULE_MAC, stats))
+        # Send PHY Statistics upwards, one by one or coalesced into batches keeping the per-subframe detail.
+        if(batch_size > 1):
+            entry = batch.phy_stat_batch.entries.add()
+            entry.transaction_index = stats.transaction_index
+            if(trx_flag == 0): # RX
+                entry.receiver.CopyFrom(stats.receiver)
+            else:
+                entry.sendr.CopyFrom(stats.sendr)
+            if(len(batch.phy_stat_batch.entries) >= batch_size or packet == length-1):
+                sendPhyStatBatch(lc, module, batch)
+                batch.phy_stat_batch.Clear()
+        else:
+            print("Sending PHY Stats", packet,  "to upper layer.....")
+            lc.send(Message(module, interf.MODULE_MAC, stats))
 
         # Print PHY Statistics.
         printPhyStats(phy_stats, trx_flag, seq_num, result, rx_data)
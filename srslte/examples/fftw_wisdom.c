@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "srslte/srslte.h"
+#include "transceiver.h"
+
+// Creates the FFTW plans of the PHY (OFDM modulator and demodulator, PSS/SSS synchronization and channel estimation)
+// for all the bandwidths with a high planner effort and saves the resulting wisdom, so that trx can load it at start
+// instead of measuring every transform again.
+
+#define DEFAULT_EFFORT SRSLTE_DFT_PATIENT
+
+static const uint32_t nof_prb_list[] = {6, 15, 25, 50, 75, 100};
+
+static double get_time_now_s() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec/1e9;
+}
+
+// Creates and frees the same DFT plans trx creates for one bandwidth.
+static int plan_bandwidth(uint32_t nof_prb) {
+  srslte_cell_t cell;
+  srslte_ofdm_t ifft;
+  srslte_ue_dl_t ue_dl;
+  srslte_sync_t sfind, strack;
+
+  bzero(&cell, sizeof(srslte_cell_t));
+  cell.nof_prb = nof_prb;
+  cell.nof_ports = 1;
+  cell.cp = SRSLTE_CP_NORM;
+  cell.phich_length = SRSLTE_PHICH_NORM;
+  cell.phich_resources = SRSLTE_PHICH_R_1;
+
+  uint32_t fft_size = srslte_symbol_sz(nof_prb);
+  uint32_t frame_len = SRSLTE_SF_LEN(fft_size);
+
+  if(srslte_ofdm_tx_init(&ifft, cell.cp, nof_prb)) {
+    printf("Error creating OFDM modulator for %d PRB.\n", nof_prb);
+    return -1;
+  }
+  srslte_ofdm_tx_free(&ifft);
+  if(srslte_ue_dl_init_generic(&ue_dl, cell, 0, true)) {
+    printf("Error creating UE DL for %d PRB.\n", nof_prb);
+    return -1;
+  }
+  srslte_ue_dl_free(&ue_dl);
+  if(srslte_sync_init_generic(&sfind, frame_len, frame_len, fft_size, cell.id, 5, false, 0, 0, false, true, 62, false)) {
+    printf("Error creating sync find for %d PRB.\n", nof_prb);
+    return -1;
+  }
+  srslte_sync_free(&sfind);
+  if(srslte_sync_init_generic(&strack, frame_len, SRSLTE_CP_LEN_NORM(1,fft_size), fft_size, cell.id, 5, false, 0, 0, false, true, 62, false)) {
+    printf("Error creating sync track for %d PRB.\n", nof_prb);
+    return -1;
+  }
+  srslte_sync_free(&strack);
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  char *wisdom_filename = DEFAULT_FFTW_WISDOM_FILENAME;
+  srslte_dft_effort_t effort = DEFAULT_EFFORT;
+  int opt;
+
+  while((opt = getopt(argc, argv, "oe")) != -1) {
+    switch(opt) {
+      case 'o':
+        wisdom_filename = argv[optind];
+        break;
+      case 'e':
+        effort = (srslte_dft_effort_t)atoi(argv[optind]);
+        break;
+      default:
+        printf("Usage: %s [-o wisdom_file] [-e effort]\n", argv[0]);
+        printf("\t-o Wisdom file [Default %s]\n", DEFAULT_FFTW_WISDOM_FILENAME);
+        printf("\t-e Planner effort: 0 - estimate, 1 - measure, 2 - patient, 3 - exhaustive [Default %d]\n", DEFAULT_EFFORT);
+        exit(-1);
+    }
+  }
+
+  // Start from the existing wisdom, if any, so that only the missing transforms are planned.
+  if(srslte_dft_load(wisdom_filename) == 0) {
+    printf("Loaded wisdom from %s.\n", wisdom_filename);
+  }
+  srslte_dft_set_effort(effort);
+
+  for(uint32_t i = 0; i < sizeof(nof_prb_list)/sizeof(uint32_t); i++) {
+    double start = get_time_now_s();
+    if(plan_bandwidth(nof_prb_list[i])) {
+      exit(-1);
+    }
+    printf("%d PRB planned in %1.2f s.\n", nof_prb_list[i], get_time_now_s() - start);
+  }
+
+  if(srslte_dft_save(wisdom_filename)) {
+    exit(-1);
+  }
+  printf("Wisdom saved to %s.\n", wisdom_filename);
+  return 0;
+}
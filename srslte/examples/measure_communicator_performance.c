@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "srslte/intf/intf.h"
+#include "../../../../communicator/cpp/communicator_wrapper.h"
+
+// Measures the rate at which PHY RX stats (with data) can be sent to the MAC and
+// the number of heap allocations made by the PHY thread for each one of them,
+// with and without the communicator message pools and with statistics batching.
+// It also measures the cost of a single QUEUE push or pop with and without QUEUE statistics.
+
+#define DEFAULT_NOF_MESSAGES 100000
+
+#define DEFAULT_DATA_LENGTH 2600 // TB size for 5 MHz PHY BW and MCS 31.
+
+#define DEFAULT_BATCH_SIZE 16
+
+#define DEFAULT_BATCH_DELAY 1000 // Given in microseconds.
+
+#define DEFAULT_NOF_QUEUE_OPERATIONS 1000000
+
+// Allocations are only counted for the thread that sends the messages.
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static __thread bool count_allocations = false;
+static __thread uint64_t nof_allocations = 0;
+
+void *malloc(size_t size) {
+  if(count_allocations) {
+    nof_allocations++;
+  }
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+  if(count_allocations) {
+    nof_allocations++;
+  }
+  return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  if(count_allocations) {
+    nof_allocations++;
+  }
+  return __libc_realloc(ptr, size);
+}
+
+typedef struct {
+  LayerCommunicator_handle mac_handle;
+  uint32_t nof_messages;
+  uchar *data;
+  uint64_t end_time;
+} mac_stand_in_t;
+
+static uint64_t get_time_now_ns() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec*1000000000LL + (uint64_t)now.tv_nsec;
+}
+
+// MAC stand-in draining the PHY stats.
+void *mac_stand_in_work(void *arg) {
+  mac_stand_in_t *mac = (mac_stand_in_t*)arg;
+  phy_stat_t phy_rx_stat;
+  uint32_t nof_received = 0;
+  phy_rx_stat.stat.rx_stat.data = mac->data;
+  while(nof_received < mac->nof_messages) {
+    if(communicator_get_high_queue_wait_for(mac->mac_handle, 100000, (void* const)&phy_rx_stat, NULL)) {
+      nof_received++;
+    }
+  }
+  mac->end_time = get_time_now_ns();
+  return NULL;
+}
+
+void run_benchmark(LayerCommunicator_handle phy_handle, LayerCommunicator_handle mac_handle, bool enable_pool, uint32_t batch_size, uint32_t nof_messages, uint32_t data_length) {
+  pthread_t mac_thread;
+  mac_stand_in_t mac;
+  phy_stat_t phy_rx_stat;
+  uchar *tx_data = (uchar*)communicator_vec_malloc(data_length);
+  uchar *rx_data = (uchar*)communicator_vec_malloc(data_length);
+
+  for(uint32_t i = 0; i < data_length; i++) {
+    tx_data[i] = (uchar)i;
+  }
+  bzero(&phy_rx_stat, sizeof(phy_stat_t));
+  phy_rx_stat.status = PHY_SUCCESS;
+  phy_rx_stat.mcs = 31;
+  phy_rx_stat.stat.rx_stat.length = data_length;
+  phy_rx_stat.stat.rx_stat.data = tx_data;
+
+  mac.mac_handle = mac_handle;
+  mac.nof_messages = nof_messages;
+  mac.data = rx_data;
+  pthread_create(&mac_thread, NULL, mac_stand_in_work, (void*)&mac);
+
+  communicator_enable_message_pools(enable_pool);
+  communicator_enable_phy_stat_batching(phy_handle, batch_size, DEFAULT_BATCH_DELAY);
+
+  uint64_t start_time = get_time_now_ns();
+  nof_allocations = 0;
+  count_allocations = true;
+  for(uint32_t i = 0; i < nof_messages; i++) {
+    phy_rx_stat.seq_number = i;
+    phy_rx_stat.host_timestamp = start_time;
+    communicator_send_phy_stat_message(phy_handle, RX_STAT, &phy_rx_stat, NULL);
+  }
+  count_allocations = false;
+  uint64_t send_time = get_time_now_ns() - start_time;
+
+  pthread_join(mac_thread, NULL);
+  uint64_t total_time = mac.end_time - start_time;
+  // Disable batching for the next run.
+  communicator_enable_phy_stat_batching(phy_handle, 1, 0);
+
+  printf("Message pool %s - batch size: %d:\n", enable_pool ? "enabled" : "disabled", batch_size);
+  printf("\tPHY send rate: %1.0f messages/s\n", (double)nof_messages/((double)send_time/1e9));
+  printf("\tPHY to MAC rate: %1.0f messages/s\n", (double)nof_messages/((double)total_time/1e9));
+  printf("\tAllocations per message: %1.2f\n", (double)nof_allocations/(double)nof_messages);
+
+  free(tx_data);
+  free(rx_data);
+}
+
+void run_queue_benchmark(uint32_t nof_operations) {
+  // Warm up caches and the clock before measuring.
+  communicator_measure_queue_operation_time(nof_operations/10, true);
+  double time_without_stats = communicator_measure_queue_operation_time(nof_operations, false);
+  double time_with_stats = communicator_measure_queue_operation_time(nof_operations, true);
+
+  printf("QUEUE push/pop - %d operations:\n", 2*nof_operations);
+  printf("\tWithout statistics: %1.1f ns/operation\n", time_without_stats);
+  printf("\tWith statistics: %1.1f ns/operation\n", time_with_stats);
+  printf("\tStatistics overhead: %1.1f ns/operation\n", time_with_stats - time_without_stats);
+}
+
+int main(int argc, char *argv[]) {
+  LayerCommunicator_handle phy_handle, mac_handle;
+  char phy_module_name[] = "MODULE_PHY";
+  char mac_module_name[] = "MODULE_MAC";
+  uint32_t nof_messages = DEFAULT_NOF_MESSAGES;
+  uint32_t data_length = DEFAULT_DATA_LENGTH;
+  uint32_t batch_size = DEFAULT_BATCH_SIZE;
+  uint32_t nof_queue_operations = DEFAULT_NOF_QUEUE_OPERATIONS;
+  int opt;
+
+  while((opt = getopt(argc, argv, "nlbq")) != -1) {
+    switch(opt) {
+      case 'n':
+        nof_messages = atoi(argv[optind]);
+        break;
+      case 'l':
+        data_length = atoi(argv[optind]);
+        break;
+      case 'b':
+        batch_size = atoi(argv[optind]);
+        break;
+      case 'q':
+        nof_queue_operations = atoi(argv[optind]);
+        break;
+      default:
+        printf("Usage: %s [-n nof_messages] [-l data_length] [-b batch_size] [-q nof_queue_operations]\n", argv[0]);
+        exit(-1);
+    }
+  }
+
+  if(communicator_initialization(phy_module_name, mac_module_name, NULL, &phy_handle, MAX_NUM_CONCURRENT_PHYS, NULL) < 0) {
+    printf("Error initializing PHY communicator.\n");
+    exit(-1);
+  }
+  communicator_make(mac_module_name, phy_module_name, NULL, &mac_handle);
+
+  // Give some time for the sockets to connect.
+  sleep(2);
+
+  printf("Sending %d RX stats with %d bytes of data.\n", nof_messages, data_length);
+  run_benchmark(phy_handle, mac_handle, false, 1, nof_messages, data_length);
+  run_benchmark(phy_handle, mac_handle, true, 1, nof_messages, data_length);
+  run_benchmark(phy_handle, mac_handle, true, batch_size, nof_messages, data_length);
+
+  // Residence time and depth of the queues the stats went through.
+  communicator_print_queue_stats(phy_handle);
+  communicator_print_queue_stats(mac_handle);
+
+  run_queue_benchmark(nof_queue_operations);
+
+  communicator_free(&mac_handle);
+  communicator_uninitialization(&phy_handle);
+
+  return 0;
+}
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "srslte/srslte.h"
+#include "srslte/intf/intf.h"
+
+// Runs the DL-SCH encoder and decoder of several PHYs concurrently, as the PHY threads do, and measures the
+// processing time and the last level cache (LLC) misses. The FEC tables (turbo coder, rate matching) are shared by
+// all the PHYs, running it with different numbers of PHYs shows how the LLC misses per TB grow with them.
+// The LLC counters need access to hardware perf events, without it only the timing is reported.
+
+#define DEFAULT_NOF_PHYS 2
+
+#define DEFAULT_NOF_TBS 2000
+
+#define DEFAULT_MCS 28
+
+#define DEFAULT_NOF_PRB 25
+
+typedef struct {
+  uint32_t phy_id;
+  uint32_t nof_tbs;
+  srslte_pdsch_cfg_t cfg;
+  uint32_t nof_errors;
+} phy_stand_in_t;
+
+typedef struct {
+  int fd_misses;
+  int fd_references;
+} llc_counters_t;
+
+static uint64_t get_time_now_ns() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec*1000000000LL + (uint64_t)now.tv_nsec;
+}
+
+static int open_counter(uint64_t config, int group_fd) {
+  struct perf_event_attr attr;
+  bzero(&attr, sizeof(struct perf_event_attr));
+  attr.size = sizeof(struct perf_event_attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.inherit = 1; // Count the PHY threads created afterwards.
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+static void llc_counters_start(llc_counters_t *c) {
+  c->fd_misses = open_counter(PERF_COUNT_HW_CACHE_MISSES, -1);
+  c->fd_references = open_counter(PERF_COUNT_HW_CACHE_REFERENCES, -1);
+  if(c->fd_misses < 0 || c->fd_references < 0) {
+    printf("LLC counters not available (perf_event_open failed), only timing is measured.\n");
+    return;
+  }
+  ioctl(c->fd_misses, PERF_EVENT_IOC_RESET, 0);
+  ioctl(c->fd_references, PERF_EVENT_IOC_RESET, 0);
+  ioctl(c->fd_misses, PERF_EVENT_IOC_ENABLE, 0);
+  ioctl(c->fd_references, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+static void llc_counters_stop(llc_counters_t *c, uint64_t *misses, uint64_t *references) {
+  *misses = 0;
+  *references = 0;
+  if(c->fd_misses >= 0) {
+    ioctl(c->fd_misses, PERF_EVENT_IOC_DISABLE, 0);
+    if(read(c->fd_misses, misses, sizeof(uint64_t)) != sizeof(uint64_t)) {
+      *misses = 0;
+    }
+    close(c->fd_misses);
+  }
+  if(c->fd_references >= 0) {
+    ioctl(c->fd_references, PERF_EVENT_IOC_DISABLE, 0);
+    if(read(c->fd_references, references, sizeof(uint64_t)) != sizeof(uint64_t)) {
+      *references = 0;
+    }
+    close(c->fd_references);
+  }
+}
+
+// PHY stand-in encoding and decoding TBs with its own SCH and soft buffers.
+void *phy_stand_in_work(void *arg) {
+  phy_stand_in_t *phy = (phy_stand_in_t*)arg;
+  srslte_sch_t sch;
+  srslte_softbuffer_tx_t softbuffer_tx;
+  srslte_softbuffer_rx_t softbuffer_rx;
+  uint32_t tbs = phy->cfg.cb_segm.tbs;
+  uint32_t nof_bits = phy->cfg.nbits.nof_bits;
+  uint8_t *data = srslte_vec_malloc(tbs/8);
+  // The decoder writes whole code blocks, including the TB CRC, so leave room for one more.
+  uint8_t *data_rx = srslte_vec_malloc(tbs/8 + SRSLTE_TCOD_MAX_LEN_CB_BYTES);
+  uint8_t *e_bits = srslte_vec_malloc(nof_bits/8 + 1);
+  int16_t *llr = srslte_vec_malloc(sizeof(int16_t)*nof_bits);
+
+  if(srslte_sch_init_generic(&sch, phy->phy_id) ||
+     srslte_softbuffer_tx_init(&softbuffer_tx, SRSLTE_MAX_PRB) ||
+     srslte_softbuffer_rx_init(&softbuffer_rx, SRSLTE_MAX_PRB)) {
+    printf("Error initializing PHY %d.\n", phy->phy_id);
+    exit(-1);
+  }
+  srslte_sch_set_max_noi(&sch, 4);
+
+  for(uint32_t n = 0; n < phy->nof_tbs; n++) {
+    for(uint32_t i = 0; i < tbs/8; i++) {
+      data[i] = (uint8_t)rand();
+    }
+    srslte_softbuffer_tx_reset(&softbuffer_tx);
+    srslte_dlsch_encode(&sch, &phy->cfg, &softbuffer_tx, data, e_bits);
+    // Noiseless channel.
+    for(uint32_t i = 0; i < nof_bits; i++) {
+      llr[i] = (e_bits[i/8] & (0x80 >> (i%8))) ? 100 : -100;
+    }
+    srslte_softbuffer_rx_reset_tbs(&softbuffer_rx, tbs);
+    if(srslte_dlsch_decode(&sch, &phy->cfg, &softbuffer_rx, llr, data_rx) || memcmp(data, data_rx, tbs/8)) {
+      phy->nof_errors++;
+    }
+  }
+
+  srslte_softbuffer_tx_free(&softbuffer_tx);
+  srslte_softbuffer_rx_free(&softbuffer_rx);
+  srslte_sch_free(&sch);
+  free(data);
+  free(data_rx);
+  free(e_bits);
+  free(llr);
+  return NULL;
+}
+
+void run_benchmark(uint32_t nof_phys, uint32_t nof_tbs, srslte_pdsch_cfg_t *cfg) {
+  pthread_t threads[MAX_NUM_CONCURRENT_PHYS];
+  phy_stand_in_t phys[MAX_NUM_CONCURRENT_PHYS];
+  llc_counters_t counters;
+  uint64_t misses, references;
+  uint32_t nof_errors = 0;
+
+  llc_counters_start(&counters);
+  uint64_t start_time = get_time_now_ns();
+  for(uint32_t i = 0; i < nof_phys; i++) {
+    phys[i].phy_id = i;
+    phys[i].nof_tbs = nof_tbs;
+    phys[i].cfg = *cfg;
+    phys[i].nof_errors = 0;
+    pthread_create(&threads[i], NULL, phy_stand_in_work, (void*)&phys[i]);
+  }
+  for(uint32_t i = 0; i < nof_phys; i++) {
+    pthread_join(threads[i], NULL);
+    nof_errors += phys[i].nof_errors;
+  }
+  uint64_t total_time = get_time_now_ns() - start_time;
+  llc_counters_stop(&counters, &misses, &references);
+
+  printf("%d concurrent PHY(s):\n", nof_phys);
+  printf("\tTime per TB (encode + decode): %1.1f us\n", (double)total_time/1e3/(double)(nof_phys*nof_tbs));
+  if(references > 0) {
+    printf("\tLLC misses per TB: %1.1f (%1.2f%% of LLC references)\n", (double)misses/(double)(nof_phys*nof_tbs),
+           100.0*(double)misses/(double)references);
+  }
+  printf("\tErrors: %d\n", nof_errors);
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t nof_phys = DEFAULT_NOF_PHYS;
+  uint32_t nof_tbs = DEFAULT_NOF_TBS;
+  uint32_t mcs = DEFAULT_MCS;
+  uint32_t nof_prb = DEFAULT_NOF_PRB;
+  srslte_pdsch_cfg_t cfg;
+  int opt;
+
+  while((opt = getopt(argc, argv, "pnmb")) != -1) {
+    switch(opt) {
+      case 'p':
+        nof_phys = atoi(argv[optind]);
+        break;
+      case 'n':
+        nof_tbs = atoi(argv[optind]);
+        break;
+      case 'm':
+        mcs = atoi(argv[optind]);
+        break;
+      case 'b':
+        nof_prb = atoi(argv[optind]);
+        break;
+      default:
+        printf("Usage: %s [-p nof_phys] [-n nof_tbs] [-m mcs] [-b nof_prb]\n", argv[0]);
+        exit(-1);
+    }
+  }
+  if(nof_phys == 0 || nof_phys > MAX_NUM_CONCURRENT_PHYS) {
+    printf("Number of PHYs must be between 1 and %d.\n", MAX_NUM_CONCURRENT_PHYS);
+    exit(-1);
+  }
+
+  // One subframe worth of PDSCH with 2 control symbols and all the PRBs allocated.
+  srslte_ra_dl_dci_t dci;
+  bzero(&dci, sizeof(srslte_ra_dl_dci_t));
+  dci.mcs_idx = mcs;
+  dci.type0_alloc.rbg_bitmask = 0xffffffff;
+  bzero(&cfg, sizeof(srslte_pdsch_cfg_t));
+  if(srslte_ra_dl_dci_to_grant(&dci, nof_prb, SRSLTE_CRNTI_START, &cfg.grant)) {
+    printf("Error computing resource allocation.\n");
+    exit(-1);
+  }
+  cfg.nbits.nof_re = nof_prb*12*12;
+  cfg.nbits.nof_bits = cfg.nbits.nof_re*cfg.grant.Qm;
+  cfg.rv = 0;
+  if(srslte_cbsegm(&cfg.cb_segm, cfg.grant.mcs.tbs)) {
+    printf("Error computing code block segmentation.\n");
+    exit(-1);
+  }
+
+  printf("Encoding and decoding %d TBs of %d bits per PHY (MCS %d, %d PRB).\n", nof_tbs, cfg.grant.mcs.tbs, mcs, nof_prb);
+  run_benchmark(1, nof_tbs, &cfg);
+  run_benchmark(nof_phys, nof_tbs, &cfg);
+
+  return 0;
+}
@@ -231,6 +231,8 @@ void phy_reception_init_last_basic_control(phy_reception_t* const phy_reception_
   phy_reception_ctx->last_rx_basic_control.mcs          = 0;
   phy_reception_ctx->last_rx_basic_control.gain         = phy_reception_ctx->initial_rx_gain;
   phy_reception_ctx->last_rx_basic_control.length       = 1;
+  phy_reception_ctx->last_rx_basic_control.harq_pid     = 0;
+  phy_reception_ctx->last_rx_basic_control.retx_cnt     = 0;
 }
 
 void phy_reception_init_context(phy_reception_t* const phy_reception_ctx, LayerCommunicator_handle handle, srslte_rf_t *rf, transceiver_args_t *args) {
@@ -260,6 +262,10 @@ void phy_reception_init_context(phy_reception_t* const phy_reception_ctx, LayerC
   phy_reception_ctx->node_id                            = args->node_id; // SRN ID, a number from 0 to 255.
   phy_reception_ctx->intf_id                            = args->intf_id; // Radio Interface ID.
   phy_reception_ctx->phy_filtering                      = args->phy_filtering;
+  phy_reception_ctx->mcs_table                          = args->enable_256qam?SRSLTE_RA_DL_MCS_TABLE_256QAM:SRSLTE_RA_DL_MCS_TABLE_64QAM; // Must match the one used by the transmitter.
+  phy_reception_ctx->nof_harq_processes                 = args->nof_harq_processes;
+  phy_reception_ctx->harq_timeout                       = args->harq_timeout;
+  phy_reception_ctx->burst_tracking                     = args->enable_burst_tracking;
   phy_reception_ctx->threshold                          = args->threshold; // PSS detection threshold.
   phy_reception_ctx->use_scatter_sync_seq               = args->use_scatter_sync_seq;
   phy_reception_ctx->pss_len                            = args->pss_len;
@@ -273,30 +279,17 @@ static inline int phy_reception_change_bw(phy_reception_t* const phy_reception_c
   int ret = 0;
   // Lock this section of the code so that PHY Rx threads do not interfere with each other when changing the USRP parameters.
   pthread_mutex_lock(&phy_rx_bw_change_mutex);
-  // Stop synchronization thread before configuring a new bandwidth.
-  if(phy_reception_stop_sync_thread(phy_reception_ctx) < 0) {
-    PHY_RX_ERROR("PHY ID: %d - Error stopping synchronization thread.\n", phy_reception_ctx->phy_id);
-    ret = -1;
-    goto exit_phy_rx_change_bw;
-  }
-  PHY_RX_PRINT("PHY ID: %d - Change BW - Synchronization thread stopped\n", phy_reception_ctx->phy_id);
-  // Stop decoding thread before configuring a new bandwidth.
-  if(phy_reception_stop_decoding_thread(phy_reception_ctx) < 0) {
-    PHY_RX_ERROR("PHY ID: %d - Error stopping decoding thread.\n", phy_reception_ctx->phy_id);
+  // Build the synchronization and decoding structures of the new PHY BW if it was never used before, the threads keep running with the current ones meanwhile.
+  if(phy_reception_ue_init_bw_context(phy_reception_ctx, bc->bw_idx) < 0) {
+    PHY_RX_ERROR("PHY ID: %d - Error initializing synch and decoding structures.\n", phy_reception_ctx->phy_id);
     ret = -1;
     goto exit_phy_rx_change_bw;
   }
-  PHY_RX_PRINT("PHY ID: %d - Change BW - Decoding thread stopped\n", phy_reception_ctx->phy_id);
-  // Set the new number of PRB based on PRB retrieved from BW index.
-  phy_reception_ctx->cell_ue.nof_prb = helpers_get_prb_from_bw_index(bc->bw_idx);
-  // Free all Rx related structures.
-  phy_reception_ue_free(phy_reception_ctx);
   // Set parameters for new PHY BW.
+  phy_reception_ctx->cell_ue.nof_prb                  = helpers_get_prb_from_bw_index(bc->bw_idx);
   phy_reception_ctx->nof_prb                          = phy_reception_ctx->cell_ue.nof_prb;
   phy_reception_ctx->default_rx_bandwidth             = helpers_get_bw_from_nprb(phy_reception_ctx->nof_prb);
   phy_reception_ctx->bw_idx                           = helpers_get_bw_index_from_prb(phy_reception_ctx->nof_prb);
-  phy_reception_ctx->run_rx_decoding_thread           = true;
-  phy_reception_ctx->run_rx_synchronization_thread    = true;
   // Set the new Rx sample rate based on the new PRB sent by the upper layer.
   // Set Rx sample rate according to the number of PRBs.
   if(phy_reception_set_rx_sample_rate(phy_reception_ctx) < 0) {
@@ -304,24 +297,8 @@ static inline int phy_reception_change_bw(phy_reception_t* const phy_reception_c
     ret = -1;
     goto exit_phy_rx_change_bw;
   }
-  // Initialize all Rx related structures.
-  if(phy_reception_ue_init(phy_reception_ctx) < 0) {
-    PHY_RX_ERROR("PHY ID: %d - Error initializing synch and decoding structures.\n", phy_reception_ctx->phy_id);
-    ret = -1;
-    goto exit_phy_rx_change_bw;
-  }
-  // After configuring a new bandwidth the synchronization thread needs to be restarted.
-  if(phy_reception_start_sync_thread(phy_reception_ctx) < 0) {
-    PHY_RX_ERROR("PHY ID: %d - Error starting synchronization thread.\n", phy_reception_ctx->phy_id);
-    ret = -1;
-    goto exit_phy_rx_change_bw;
-  }
-  // After configuring a new bandwidth the decoding thread needs to be restarted.
-  if(phy_reception_start_decoding_thread(phy_reception_ctx) < 0) {
-    PHY_RX_ERROR("PHY ID: %d - Error starting decoding thread.\n", phy_reception_ctx->phy_id);
-    ret = -1;
-    goto exit_phy_rx_change_bw;
-  }
+  // The synchronization thread switches to the structures of the new PHY BW at the next subframe boundary.
+  phy_reception_ctx->requested_bw_idx = bc->bw_idx;
   // Update last tx basic control structure with current BW index.
   set_bw_index(phy_reception_ctx, bc->bw_idx);
 
@@ -332,6 +309,19 @@ exit_phy_rx_change_bw:
   return ret;
 }
 
+// Called by the synchronization thread, between two subframes, to start using the structures of the last requested PHY BW.
+static inline void phy_reception_switch_bw_context(phy_reception_t* const phy_reception_ctx) {
+  uint32_t bw_idx = phy_reception_ctx->requested_bw_idx;
+  phy_reception_ctx->ue_sync = &phy_reception_ctx->ue_sync_bw[bw_idx];
+  // Whatever state it was left in the last time this BW was used, start looking for a new PSS.
+  if(srslte_ue_sync_init_reentry_loop(phy_reception_ctx->ue_sync)) {
+    PHY_RX_ERROR("PHY ID: %d - Error re-initiating ue_sync\n",phy_reception_ctx->phy_id);
+  }
+  srslte_ue_sync_set_cfo(phy_reception_ctx->ue_sync, 0.0);
+  phy_reception_ctx->active_bw_idx = bw_idx;
+  PHY_RX_INFO_TIME("PHY ID: %d - Switched to BW index: %d\n", phy_reception_ctx->phy_id, bw_idx);
+}
+
 int phy_reception_change_parameters(basic_ctrl_t* const bc) {
   phy_reception_t* const phy_reception_ctx = phy_rx_threads[bc->phy_id];
   float rx_bandwidth, rx_gain;
@@ -347,6 +337,14 @@ int phy_reception_change_parameters(basic_ctrl_t* const bc) {
     PHY_RX_ERROR("PHY ID: %d - Invalid number of slots. It MUST be greater than 0. Current value is: %d\n", phy_reception_ctx->phy_id, bc->length);
     return -1;
   }
+#if(ENABLE_RX_CHANNELIZER==1)
+  // The channelizer samples the shared RF channel at a rate fixed by the PHY BW given to trx, so the PHY BW can not be changed.
+  // Reject the command before any parameter or BW related state is touched.
+  if(phy_reception_ctx->last_rx_basic_control.bw_idx != bc->bw_idx) {
+    PHY_RX_ERROR("PHY ID: %d - PHY BW index can not be changed from %d to %d while the Rx channelizer is enabled.\n", phy_reception_ctx->phy_id, phy_reception_ctx->last_rx_basic_control.bw_idx, bc->bw_idx);
+    return -1;
+  }
+#endif
 #if(RX_TIMED_COMMAND_ENABLED==1)
   // Check timestamp.
   if(bc->timestamp == 0) {
@@ -374,7 +372,9 @@ int phy_reception_change_parameters(basic_ctrl_t* const bc) {
   }
   // If AGC is disabled then we set the new gain sent by MAC in a basic control command.
   // If AGC is enabled in command line with "-g -1" parameter, the gain sent by MAC layer is ignored as there is no point in setting a gain when AGC is ON.
-  if(phy_reception_ctx->initial_rx_gain >= 0.0 && bc->gain >= 0) {
+  // The gain of the RF channel shared through the channelizer is not changed by any single PHY.
+  // Likewise, its sampling rate is fixed, so PHY BW changes are rejected at the top of this function.
+  if(phy_reception_ctx->initial_rx_gain >= 0.0 && bc->gain >= 0 && ENABLE_RX_CHANNELIZER == 0) {
     // Checking if last configured gain is different from the current one.
     if(phy_reception_ctx->last_rx_basic_control.gain != bc->gain) {
       // Set new Rx gain.
@@ -391,6 +391,8 @@ int phy_reception_change_parameters(basic_ctrl_t* const bc) {
   }
   // Set sequence number.
   set_sequence_number(phy_reception_ctx, bc->seq_number);
+  // HARQ process and retransmission counter of the next TBs, only used when PDCCH is not decoded as it carries them otherwise.
+  set_harq_info(phy_reception_ctx, bc->harq_pid, bc->retx_cnt);
   // Everything went well.
   return 0;
 }
@@ -405,7 +407,15 @@ int phy_reception_change_timed_parameters(phy_reception_t* const phy_reception_c
     rx_bandwidth = helpers_get_bandwidth_float(bc->bw_idx);
     // Calculate cntral frequency for the channel.
     rx_channel_center_freq = helpers_calculate_channel_center_frequency(phy_reception_ctx->competition_center_freq, phy_reception_ctx->competition_bw, rx_bandwidth, bc->ch);
-#if(ENABLE_HW_RF_MONITOR==1)
+#if(ENABLE_RX_CHANNELIZER==1)
+    // The channel is selected out of the shared RF channel, so the change is applied right away.
+    lo_offset = 0.0;
+    actual_rx_freq = rx_channelizer_set_channel_freq(rx_channelizer_get_handle(), phy_reception_ctx->phy_id, rx_channel_center_freq);
+    if(actual_rx_freq < 0.0) {
+      PHY_RX_ERROR("PHY ID: %d - Error setting Rx channelizer frequency. Returning error: %f\n", phy_reception_ctx->phy_id, actual_rx_freq);
+      return -10;
+    }
+#elif(ENABLE_HW_RF_MONITOR==1)
     // Always apply offset when HW RF Monitor is enabled.
     // Set default offset frequency for reception.
     lo_offset = (double)PHY_RX_LO_OFFSET;
@@ -449,7 +459,15 @@ int phy_reception_change_non_timed_parameters(phy_reception_t* const phy_recepti
     rx_bandwidth = helpers_get_bandwidth_float(bc->bw_idx);
     // Calculate cntral frequency for the channel.
     rx_channel_center_freq = helpers_calculate_channel_center_frequency(phy_reception_ctx->competition_center_freq, phy_reception_ctx->competition_bw, rx_bandwidth, bc->ch);
-#if(ENABLE_HW_RF_MONITOR==1)
+#if(ENABLE_RX_CHANNELIZER==1)
+    // The channel is selected out of the shared RF channel, so the change is applied right away.
+    lo_offset = 0.0;
+    actual_rx_freq = rx_channelizer_set_channel_freq(rx_channelizer_get_handle(), phy_reception_ctx->phy_id, rx_channel_center_freq);
+    if(actual_rx_freq < 0.0) {
+      PHY_RX_ERROR("PHY ID: %d - Error setting Rx channelizer frequency. Returning error: %f\n", phy_reception_ctx->phy_id, actual_rx_freq);
+      return -10;
+    }
+#elif(ENABLE_HW_RF_MONITOR==1)
     // Always apply offset when HW RF Monitor is enabled.
     // Set default offset frequency for reception.
     lo_offset = (double)PHY_RX_LO_OFFSET;
@@ -555,12 +573,30 @@ uint32_t get_rx_gain(phy_reception_t* const phy_reception_ctx) {
   return rx_gain;
 }
 
+void set_harq_info(phy_reception_t* const phy_reception_ctx, uint32_t harq_pid, uint32_t retx_cnt) {
+  // Lock a mutex prior to using the basic control object.
+  pthread_mutex_lock(&phy_reception_ctx->rx_last_basic_control_mutex);
+  phy_reception_ctx->last_rx_basic_control.harq_pid = harq_pid;
+  phy_reception_ctx->last_rx_basic_control.retx_cnt = retx_cnt;
+  // Unlock mutex upon using the basic control object.
+  pthread_mutex_unlock(&phy_reception_ctx->rx_last_basic_control_mutex);
+}
+
+void get_harq_info(phy_reception_t* const phy_reception_ctx, uint32_t *harq_pid, uint32_t *retx_cnt) {
+  // Lock a mutex prior to using the basic control object.
+  pthread_mutex_lock(&phy_reception_ctx->rx_last_basic_control_mutex);
+  *harq_pid = phy_reception_ctx->last_rx_basic_control.harq_pid;
+  *retx_cnt = phy_reception_ctx->last_rx_basic_control.retx_cnt;
+  // Unlock mutex upon using the basic control object.
+  pthread_mutex_unlock(&phy_reception_ctx->rx_last_basic_control_mutex);
+}
+
 void *phy_reception_decoding_work(void *h) {
   phy_reception_t* phy_reception_ctx = (phy_reception_t*)h;
   int decoded_slot_counter = 0, pdsch_num_rxd_bits;
   float rsrp = 0.0, rsrq = 0.0, noise = 0.0, rssi = 0.0, sinr = 0.0;
   double synch_plus_decoding_time = 0.0, decoding_time = 0.0;
-  uint32_t nof_prb = 0, sfn = 0, bw_index = 0;
+  uint32_t nof_prb = 0, sfn = 0, bw_index = 0, harq_pid = 0, retx_cnt = 0;
   uint8_t data[10000];
   phy_stat_t phy_rx_stat;
   short_ue_sync_t short_ue_sync;
@@ -596,8 +632,11 @@ void *phy_reception_decoding_work(void *h) {
 
     //phy_reception_print_ue_sync(&short_ue_sync,"********** decoding thread **********\n");
 
+    // Decode the subframe with the structures of the PHY BW it was synchronized with.
+    phy_reception_ctx->ue_dl = &phy_reception_ctx->ue_dl_bw[short_ue_sync.bw_idx];
+
     // Create an alias to the input buffer containing the synchronized and aligned subframe.
-    subframe_buffer = &phy_reception_ctx->ue_sync.input_buffer[short_ue_sync.buffer_number][short_ue_sync.subframe_start_index];
+    subframe_buffer = &phy_reception_ctx->ue_sync_bw[short_ue_sync.bw_idx].input_buffer[short_ue_sync.buffer_number][short_ue_sync.subframe_start_index];
 
 #if(WRITE_SUBFRAME_SEQUENCE_INTO_FILE==1)
     static unsigned int dump_cnt = 0;
@@ -616,8 +655,8 @@ void *phy_reception_decoding_work(void *h) {
     }
 #endif
 
-    // Retrieve BW index.
-    bw_index = get_bw_index(phy_reception_ctx);
+    // Retrieve BW index the subframe was received with.
+    bw_index = short_ue_sync.bw_idx;
 
     // Change MCS. For PHY BW 1.4 MHz we can not set MCS > 28 for the very first subframe as it carries PSS/SSS and does not have enough "room" for FEC bits.
     if(phy_reception_ctx->decode_pdcch == false && bw_index == BW_IDX_OneDotFour && short_ue_sync.mcs > 28 && short_ue_sync.sf_idx == phy_reception_ctx->initial_subframe_index) {
@@ -629,21 +668,32 @@ void *phy_reception_decoding_work(void *h) {
     if(short_ue_sync.subframe_counter == 1) {
       if(short_ue_sync.mcs >= 25 && phy_reception_ctx->max_turbo_decoder_noi_for_high_mcs > phy_reception_ctx->max_turbo_decoder_noi) {
         // Set the maximum number of turbo decoder iterations to a greater value when MCS is greater than or equal to 25.
-        srslte_ue_dl_set_max_noi(&phy_reception_ctx->ue_dl, phy_reception_ctx->max_turbo_decoder_noi_for_high_mcs);
+        srslte_ue_dl_set_max_noi(phy_reception_ctx->ue_dl, phy_reception_ctx->max_turbo_decoder_noi_for_high_mcs);
       } else {
         // Set the maximum number of turbo decoder iterations to the default one.
-        srslte_ue_dl_set_max_noi(&phy_reception_ctx->ue_dl, phy_reception_ctx->max_turbo_decoder_noi);
+        srslte_ue_dl_set_max_noi(phy_reception_ctx->ue_dl, phy_reception_ctx->max_turbo_decoder_noi);
       }
     }
 
-    pdsch_num_rxd_bits = srslte_ue_dl_decode_scatter(&phy_reception_ctx->ue_dl,
+    // The subframes of a burst come from the same transmitter, so the channel estimates are carried from the first one on.
+    if(short_ue_sync.subframe_counter == 1) {
+      srslte_ue_dl_start_burst(phy_reception_ctx->ue_dl);
+    }
+
+    // Without PDCCH the HARQ information is not signalled, so it is taken from the last Rx basic control. Every subframe carries a TB of its own HARQ process, as done by the transmitter.
+    if(!phy_reception_ctx->decode_pdcch) {
+      get_harq_info(phy_reception_ctx, &harq_pid, &retx_cnt);
+      srslte_ue_dl_set_harq_scatter(phy_reception_ctx->ue_dl, harq_pid + short_ue_sync.subframe_counter - 1, retx_cnt);
+    }
+
+    pdsch_num_rxd_bits = srslte_ue_dl_decode_scatter(phy_reception_ctx->ue_dl,
                                                      subframe_buffer,
                                                      data,
                                                      sfn*10+short_ue_sync.sf_idx,
                                                      short_ue_sync.mcs);
 
     // Calculate time it takes to decode control and data (PDCCH/PCFICH/PDSCH or SCH/PDSCH).
-    decoding_time = helpers_profiling_diff_time(&phy_reception_ctx->ue_dl.decoding_start_timestamp);
+    decoding_time = helpers_profiling_diff_time(&phy_reception_ctx->ue_dl->decoding_start_timestamp);
 
     //PHY_PROFILLING_AVG6("PHY ID: %d - Average decoding time: %f [ms] - min: %f [ms] - max: %f [ms] - max counter %d - diff >= 0.5 [ms]: %d - total counter: %d - perc: %f\n", phy_reception_ctx->phy_id, decoding_time, 0.5, 1000);
 
@@ -659,9 +709,9 @@ void *phy_reception_decoding_work(void *h) {
       nof_prb = helpers_get_prb_from_bw_index(bw_index);
       // Calculate statistics.
       rssi = srslte_vec_avg_power_cf(subframe_buffer, SRSLTE_SF_LEN(srslte_symbol_sz(nof_prb)));
-      rsrq = srslte_chest_dl_get_rsrq(&phy_reception_ctx->ue_dl.chest);
-      rsrp = srslte_chest_dl_get_rsrp(&phy_reception_ctx->ue_dl.chest);
-      noise = srslte_chest_dl_get_noise_estimate(&phy_reception_ctx->ue_dl.chest);
+      rsrq = srslte_chest_dl_get_rsrq(&phy_reception_ctx->ue_dl->chest);
+      rsrp = srslte_chest_dl_get_rsrp(&phy_reception_ctx->ue_dl->chest);
+      noise = srslte_chest_dl_get_noise_estimate(&phy_reception_ctx->ue_dl->chest);
 
       // Check if the values are valid numbers, if not, set them to 0.
       if(isnan(rssi)) {
@@ -686,11 +736,11 @@ void *phy_reception_decoding_work(void *h) {
       phy_rx_stat.seq_number                                          = get_sequence_number(phy_reception_ctx);                                   // Sequence number represents the counter of received slots.
       phy_rx_stat.host_timestamp                                      = helpers_convert_host_timestamp(&short_ue_sync.peak_detection_timestamp);  // Retrieve host's time. Host PC time value when (ch,slot) PHY data are demodulated
       phy_rx_stat.ch                                                  = get_channel_number(phy_reception_ctx);                                    // Set the channel number where the data was received at.
-      phy_rx_stat.mcs                                                 = phy_reception_ctx->ue_dl.pdsch_cfg.grant.mcs.idx;	                        // MCS index is decoded when the DCI is found and correctly decoded. Modulation Scheme. Range: [0, 28]. check TBS table num_byte_per_1ms_mcs[29] in intf.h to know MCS
+      phy_rx_stat.mcs                                                 = phy_reception_ctx->ue_dl->pdsch_cfg.grant.mcs.idx;	                        // MCS index is decoded when the DCI is found and correctly decoded. Modulation Scheme. Range: [0, 28]. check TBS table num_byte_per_1ms_mcs[29] in intf.h to know MCS
       // TODO: centralize error counting!
-      phy_rx_stat.num_cb_total                                        = phy_reception_ctx->ue_dl.nof_detected;	                                  // Number of Code Blocks (CB) received in the (ch, slot)
-      phy_rx_stat.num_cb_err                                          = phy_reception_ctx->ue_dl.pkt_errors;		                                  // How many CBs get CRC error in the (ch, slot)
-      phy_rx_stat.wrong_decoding_counter                              = phy_reception_ctx->ue_dl.wrong_decoding_counter;
+      phy_rx_stat.num_cb_total                                        = phy_reception_ctx->ue_dl->nof_detected;	                                  // Number of Code Blocks (CB) received in the (ch, slot)
+      phy_rx_stat.num_cb_err                                          = phy_reception_ctx->ue_dl->pkt_errors;		                                  // How many CBs get CRC error in the (ch, slot)
+      phy_rx_stat.wrong_decoding_counter                              = phy_reception_ctx->ue_dl->wrong_decoding_counter;
       // Assign the values to Rx Stat structure.
       phy_rx_stat.stat.rx_stat.nof_slots_in_frame                     = short_ue_sync.nof_subframes_to_rx;                                        // This field indicates the number decoded from SSS, indicating the number of subframes part of a MAC frame.
       phy_rx_stat.stat.rx_stat.slot_counter                           = short_ue_sync.subframe_counter;                                           // This field indicates the slot number inside of a MAC frame.
@@ -702,17 +752,17 @@ void *phy_reception_decoding_work(void *h) {
       phy_rx_stat.stat.rx_stat.sinr                                   = sinr; 			                                                              // Signal to Interference plus Noise Ratio. Range: [–2^31, (2^31) - 1]. dB*10. For example, value 256 means 25.6 dB.
       phy_rx_stat.stat.rx_stat.cfo                                    = short_ue_sync.cfo/1000.0;                                                 // CFO value given in KHz
       phy_rx_stat.stat.rx_stat.peak_value                             = short_ue_sync.peak_value;
-      phy_rx_stat.stat.rx_stat.noise                                  = phy_reception_ctx->ue_dl.noise_estimate;
-      phy_rx_stat.stat.rx_stat.last_noi                               = srslte_ue_dl_last_noi(&phy_reception_ctx->ue_dl);
+      phy_rx_stat.stat.rx_stat.noise                                  = phy_reception_ctx->ue_dl->noise_estimate;
+      phy_rx_stat.stat.rx_stat.last_noi                               = srslte_ue_dl_last_noi(phy_reception_ctx->ue_dl);
       phy_rx_stat.stat.rx_stat.decoding_time                          = decoding_time;
-      phy_rx_stat.stat.rx_stat.detection_errors                       = phy_reception_ctx->ue_dl.wrong_decoding_counter;
-      phy_rx_stat.stat.rx_stat.decoding_errors                        = phy_reception_ctx->ue_dl.pkt_errors;                                      // If there was a decoding error, then, check the counters below.
-      phy_rx_stat.stat.rx_stat.filler_bits_error                      = phy_reception_ctx->ue_dl.pdsch.dl_sch.filler_bits_error;
-      phy_rx_stat.stat.rx_stat.nof_cbs_exceeds_softbuffer_size_error  = phy_reception_ctx->ue_dl.pdsch.dl_sch.nof_cbs_exceeds_softbuffer_size_error;
-      phy_rx_stat.stat.rx_stat.rate_matching_error                    = phy_reception_ctx->ue_dl.pdsch.dl_sch.rate_matching_error;
-      phy_rx_stat.stat.rx_stat.cb_crc_error                           = phy_reception_ctx->ue_dl.pdsch.dl_sch.cb_crc_error;
-      phy_rx_stat.stat.rx_stat.tb_crc_error                           = phy_reception_ctx->ue_dl.pdsch.dl_sch.tb_crc_error;
-      phy_rx_stat.stat.rx_stat.total_packets_synchronized             = phy_reception_ctx->ue_dl.pkts_total;                                     // Total number of slots synchronized. It contains correct and wrong slots.
+      phy_rx_stat.stat.rx_stat.detection_errors                       = phy_reception_ctx->ue_dl->wrong_decoding_counter;
+      phy_rx_stat.stat.rx_stat.decoding_errors                        = phy_reception_ctx->ue_dl->pkt_errors;                                      // If there was a decoding error, then, check the counters below.
+      phy_rx_stat.stat.rx_stat.filler_bits_error                      = phy_reception_ctx->ue_dl->pdsch.dl_sch.filler_bits_error;
+      phy_rx_stat.stat.rx_stat.nof_cbs_exceeds_softbuffer_size_error  = phy_reception_ctx->ue_dl->pdsch.dl_sch.nof_cbs_exceeds_softbuffer_size_error;
+      phy_rx_stat.stat.rx_stat.rate_matching_error                    = phy_reception_ctx->ue_dl->pdsch.dl_sch.rate_matching_error;
+      phy_rx_stat.stat.rx_stat.cb_crc_error                           = phy_reception_ctx->ue_dl->pdsch.dl_sch.cb_crc_error;
+      phy_rx_stat.stat.rx_stat.tb_crc_error                           = phy_reception_ctx->ue_dl->pdsch.dl_sch.tb_crc_error;
+      phy_rx_stat.stat.rx_stat.total_packets_synchronized             = phy_reception_ctx->ue_dl->pkts_total;                                     // Total number of slots synchronized. It contains correct and wrong slots.
       phy_rx_stat.stat.rx_stat.length                                 = pdsch_num_rxd_bits/8;				                                             // How many bytes are after this header. It should be equal to current TB size.
       phy_rx_stat.stat.rx_stat.data                                   = data;
       // Calculate decoding time based on peak detection timestamp or start of each iteration of subframe TRACK state.
@@ -728,7 +778,7 @@ void *phy_reception_decoding_work(void *h) {
       //PHY_PROFILLING_AVG3("Avg. read samples + sync + decoding time: %f - min: %f - max: %f - max counter %d - diff >= 2ms: %d - total counter: %d - perc: %f\n", helpers_profiling_diff_time(&short_ue_sync.start_of_rx_sample), 2.0, 1000);
 
       // Information on data decoding process.
-      PHY_RX_INFO_TIME("[Rx STATS]: PHY ID: %d - Rx slots: %d - Channel: %d - Rx bytes: %d - CFO: %+2.2f [kHz] - Peak value: %1.2f - Noise: %1.4f - RSSI: %1.2f [dBm] - SINR: %4.1f [dB] - RSRP: %1.2f - RSRQ: %1.2f [dB] - CQI: %d - MCS: %d - Total: %d - Error: %d - Last NOI: %d - Avg. NOI: %1.2f - Decoding time: %f [ms]\n", phy_reception_ctx->phy_id, decoded_slot_counter, phy_rx_stat.ch, phy_rx_stat.stat.rx_stat.length, short_ue_sync.cfo/1000.0, short_ue_sync.peak_value, phy_reception_ctx->ue_dl.noise_estimate, phy_rx_stat.stat.rx_stat.rssi, phy_rx_stat.stat.rx_stat.sinr, phy_rx_stat.stat.rx_stat.rsrp, phy_rx_stat.stat.rx_stat.rsrq, phy_rx_stat.stat.rx_stat.cqi, phy_rx_stat.mcs, phy_reception_ctx->ue_dl.nof_detected, phy_reception_ctx->ue_dl.pkt_errors, srslte_ue_dl_last_noi(&phy_reception_ctx->ue_dl), srslte_ul_dl_average_noi(&phy_reception_ctx->ue_dl), synch_plus_decoding_time);
+      PHY_RX_INFO_TIME("[Rx STATS]: PHY ID: %d - Rx slots: %d - Channel: %d - Rx bytes: %d - CFO: %+2.2f [kHz] - Peak value: %1.2f - Noise: %1.4f - RSSI: %1.2f [dBm] - SINR: %4.1f [dB] - RSRP: %1.2f - RSRQ: %1.2f [dB] - CQI: %d - MCS: %d - Total: %d - Error: %d - Last NOI: %d - Avg. NOI: %1.2f - Decoding time: %f [ms]\n", phy_reception_ctx->phy_id, decoded_slot_counter, phy_rx_stat.ch, phy_rx_stat.stat.rx_stat.length, short_ue_sync.cfo/1000.0, short_ue_sync.peak_value, phy_reception_ctx->ue_dl->noise_estimate, phy_rx_stat.stat.rx_stat.rssi, phy_rx_stat.stat.rx_stat.sinr, phy_rx_stat.stat.rx_stat.rsrp, phy_rx_stat.stat.rx_stat.rsrq, phy_rx_stat.stat.rx_stat.cqi, phy_rx_stat.mcs, phy_reception_ctx->ue_dl->nof_detected, phy_reception_ctx->ue_dl->pkt_errors, srslte_ue_dl_last_noi(phy_reception_ctx->ue_dl), srslte_ul_dl_average_noi(phy_reception_ctx->ue_dl), synch_plus_decoding_time);
 
       // Uncomment this line to measure the number of packets received in one second.
       //helpers_measure_packets_per_second("Rx");
@@ -747,7 +797,7 @@ void *phy_reception_decoding_work(void *h) {
 
 #if(ENBALE_RX_INFO_PLOT==1)
       if(phy_reception_ctx->plot_rx_info == true) {
-        plot_info(&phy_reception_ctx->ue_dl, &phy_reception_ctx->ue_sync);
+        plot_info(phy_reception_ctx->ue_dl, &phy_reception_ctx->ue_sync_bw[short_ue_sync.bw_idx]);
       }
 #endif
 
@@ -772,8 +822,8 @@ void *phy_reception_decoding_work(void *h) {
       // Calculate statistics even if there was decoding error.
       // There was an error if the code reaches this point: (1) wrong CFI or DCI detected or (2) data was incorrectly decoded.
       rssi = srslte_vec_avg_power_cf(subframe_buffer, short_ue_sync.frame_len);
-      rsrp = srslte_chest_dl_get_rsrp(&phy_reception_ctx->ue_dl.chest);
-      noise = srslte_chest_dl_get_noise_estimate(&phy_reception_ctx->ue_dl.chest);
+      rsrp = srslte_chest_dl_get_rsrp(&phy_reception_ctx->ue_dl->chest);
+      noise = srslte_chest_dl_get_noise_estimate(&phy_reception_ctx->ue_dl->chest);
 
       // Check if the values are valid numbers, if not, set them to 0.
       if(isnan(rssi)) {
@@ -796,30 +846,30 @@ void *phy_reception_decoding_work(void *h) {
       phy_rx_stat.stat.rx_stat.nof_slots_in_frame                     = short_ue_sync.nof_subframes_to_rx;  // This field indicates the number decoded from SSS, indicating the number of subframes part of a MAC frame.
       phy_rx_stat.stat.rx_stat.slot_counter                           = short_ue_sync.subframe_counter;        // This field indicates the slot number inside of a MAC frame.
       // TODO: centralize error counting!
-      phy_rx_stat.num_cb_total                                        = phy_reception_ctx->ue_dl.nof_detected;
-      phy_rx_stat.num_cb_err                                          = phy_reception_ctx->ue_dl.pkt_errors;
-      phy_rx_stat.stat.rx_stat.detection_errors                       = phy_reception_ctx->ue_dl.wrong_decoding_counter;
-      phy_rx_stat.stat.rx_stat.decoding_errors                        = phy_reception_ctx->ue_dl.pkt_errors;
-      phy_rx_stat.stat.rx_stat.filler_bits_error                      = phy_reception_ctx->ue_dl.pdsch.dl_sch.filler_bits_error;
-      phy_rx_stat.stat.rx_stat.nof_cbs_exceeds_softbuffer_size_error  = phy_reception_ctx->ue_dl.pdsch.dl_sch.nof_cbs_exceeds_softbuffer_size_error;
-      phy_rx_stat.stat.rx_stat.rate_matching_error                    = phy_reception_ctx->ue_dl.pdsch.dl_sch.rate_matching_error;
-      phy_rx_stat.stat.rx_stat.cb_crc_error                           = phy_reception_ctx->ue_dl.pdsch.dl_sch.cb_crc_error;
-      phy_rx_stat.stat.rx_stat.tb_crc_error                           = phy_reception_ctx->ue_dl.pdsch.dl_sch.tb_crc_error;
+      phy_rx_stat.num_cb_total                                        = phy_reception_ctx->ue_dl->nof_detected;
+      phy_rx_stat.num_cb_err                                          = phy_reception_ctx->ue_dl->pkt_errors;
+      phy_rx_stat.stat.rx_stat.detection_errors                       = phy_reception_ctx->ue_dl->wrong_decoding_counter;
+      phy_rx_stat.stat.rx_stat.decoding_errors                        = phy_reception_ctx->ue_dl->pkt_errors;
+      phy_rx_stat.stat.rx_stat.filler_bits_error                      = phy_reception_ctx->ue_dl->pdsch.dl_sch.filler_bits_error;
+      phy_rx_stat.stat.rx_stat.nof_cbs_exceeds_softbuffer_size_error  = phy_reception_ctx->ue_dl->pdsch.dl_sch.nof_cbs_exceeds_softbuffer_size_error;
+      phy_rx_stat.stat.rx_stat.rate_matching_error                    = phy_reception_ctx->ue_dl->pdsch.dl_sch.rate_matching_error;
+      phy_rx_stat.stat.rx_stat.cb_crc_error                           = phy_reception_ctx->ue_dl->pdsch.dl_sch.cb_crc_error;
+      phy_rx_stat.stat.rx_stat.tb_crc_error                           = phy_reception_ctx->ue_dl->pdsch.dl_sch.tb_crc_error;
       phy_rx_stat.stat.rx_stat.cqi                                    = srslte_cqi_from_snr(sinr); // Channel Quality Indicator. Range: [1, 15]
       phy_rx_stat.stat.rx_stat.rssi                                   = 10.0*log10f(rssi);	      // Received Signal Strength Indicator. Range: [–2^31, (2^31) - 1]. dBm*10. For example, value -567 means -56.7dBm.
       phy_rx_stat.stat.rx_stat.rsrp                                   = 10.0*log10f(rsrp);				// Reference Signal Received Power. Range: [-1400, -400]. dBm*10. For example, value -567 means -56.7dBm.
       phy_rx_stat.stat.rx_stat.sinr                                   = sinr; 			              // Signal to Interference plus Noise Ratio. Range: [–2^31, (2^31) - 1]. dB*10. For example, value 256 means 25.6 dB.
       phy_rx_stat.stat.rx_stat.cfo                                    = short_ue_sync.cfo/1000.0;  // CFO value given in KHz
       phy_rx_stat.stat.rx_stat.peak_value                             = short_ue_sync.peak_value;
-      phy_rx_stat.stat.rx_stat.noise                                  = phy_reception_ctx->ue_dl.noise_estimate;
-      phy_rx_stat.stat.rx_stat.decoded_cfi                            = phy_reception_ctx->ue_dl.decoded_cfi;
-      phy_rx_stat.stat.rx_stat.found_dci                              = phy_reception_ctx->ue_dl.found_dci;
-      phy_rx_stat.stat.rx_stat.last_noi                               = srslte_ue_dl_last_noi(&phy_reception_ctx->ue_dl);
-      phy_rx_stat.stat.rx_stat.total_packets_synchronized             = phy_reception_ctx->ue_dl.pkts_total;
+      phy_rx_stat.stat.rx_stat.noise                                  = phy_reception_ctx->ue_dl->noise_estimate;
+      phy_rx_stat.stat.rx_stat.decoded_cfi                            = phy_reception_ctx->ue_dl->decoded_cfi;
+      phy_rx_stat.stat.rx_stat.found_dci                              = phy_reception_ctx->ue_dl->found_dci;
+      phy_rx_stat.stat.rx_stat.last_noi                               = srslte_ue_dl_last_noi(phy_reception_ctx->ue_dl);
+      phy_rx_stat.stat.rx_stat.total_packets_synchronized             = phy_reception_ctx->ue_dl->pkts_total;
       // Send phy received (Rx) statistics and TB (data) to upper layers.
       phy_reception_send_rx_statistics(phy_reception_ctx->phy_comm_handle, &phy_rx_stat);
       // Print some wrong decoding information, which is useful for debugging.
-      PHY_RX_INFO_TIME("[Rx STATS]: PHY ID: %d - Detection errors: %d - Channel: %d - # slots: %d - slot number: %d - CFO: %+2.2f [kHz] - Peak value: %1.2f - RSSI: %3.2f [dBm] - Decoded CFI: %d - Found DCI: %d - Last NOI: %d - Avg. NOI: %1.2f - Noise: %1.4f - Decoding errors: %d\n",phy_reception_ctx->phy_id, phy_reception_ctx->ue_dl.wrong_decoding_counter,get_channel_number(phy_reception_ctx),phy_rx_stat.stat.rx_stat.nof_slots_in_frame,phy_rx_stat.stat.rx_stat.slot_counter, short_ue_sync.cfo/1000.0,short_ue_sync.peak_value,phy_rx_stat.stat.rx_stat.rssi,phy_reception_ctx->ue_dl.decoded_cfi,phy_reception_ctx->ue_dl.found_dci,srslte_ue_dl_last_noi(&phy_reception_ctx->ue_dl), srslte_ul_dl_average_noi(&phy_reception_ctx->ue_dl),phy_reception_ctx->ue_dl.noise_estimate,phy_reception_ctx->ue_dl.pkt_errors);
+      PHY_RX_INFO_TIME("[Rx STATS]: PHY ID: %d - Detection errors: %d - Channel: %d - # slots: %d - slot number: %d - CFO: %+2.2f [kHz] - Peak value: %1.2f - RSSI: %3.2f [dBm] - Decoded CFI: %d - Found DCI: %d - Last NOI: %d - Avg. NOI: %1.2f - Noise: %1.4f - Decoding errors: %d\n",phy_reception_ctx->phy_id, phy_reception_ctx->ue_dl->wrong_decoding_counter,get_channel_number(phy_reception_ctx),phy_rx_stat.stat.rx_stat.nof_slots_in_frame,phy_rx_stat.stat.rx_stat.slot_counter, short_ue_sync.cfo/1000.0,short_ue_sync.peak_value,phy_rx_stat.stat.rx_stat.rssi,phy_reception_ctx->ue_dl->decoded_cfi,phy_reception_ctx->ue_dl->found_dci,srslte_ue_dl_last_noi(phy_reception_ctx->ue_dl), srslte_ul_dl_average_noi(phy_reception_ctx->ue_dl),phy_reception_ctx->ue_dl->noise_estimate,phy_reception_ctx->ue_dl->pkt_errors);
 
 #if(WRITE_DECT_DECD_ERROR_SUBFRAME_FILE==1)
       static unsigned int dump_cnt = 0;
@@ -881,58 +931,114 @@ void phy_reception_send_rx_statistics(LayerCommunicator_handle handle, phy_stat_
   }
 }
 
-int phy_reception_ue_init(phy_reception_t* const phy_reception_ctx) {
+// Build the synchronization and decoding structures of one PHY BW, unless they were already built.
+int phy_reception_ue_init_bw_context(phy_reception_t* const phy_reception_ctx, uint32_t bw_idx) {
+  srslte_ue_sync_t* const ue_sync = &phy_reception_ctx->ue_sync_bw[bw_idx];
+  srslte_ue_dl_t* const ue_dl = &phy_reception_ctx->ue_dl_bw[bw_idx];
+  srslte_cell_t cell = phy_reception_ctx->cell_ue;
+
+  if(bw_idx == BW_IDX_UNKNOWN || bw_idx >= PHY_RX_NOF_BW_CONTEXTS) {
+    PHY_RX_ERROR("PHY ID: %d - Undefined BW Index: %d....\n", phy_reception_ctx->phy_id, bw_idx);
+    return -1;
+  }
+  if(phy_reception_ctx->bw_context_ready[bw_idx]) {
+    return 0;
+  }
   // Initialize parameters for UE Cell.
-  PHY_RX_PRINT("PHY ID: %d - Initializing UE Sync.\n", phy_reception_ctx->phy_id);
-  if(srslte_ue_sync_init_generic(&phy_reception_ctx->ue_sync, phy_reception_ctx->cell_ue, srslte_rf_recv_with_time_wrapper, (void*)phy_reception_ctx->rf, phy_reception_ctx->initial_subframe_index, phy_reception_ctx->enable_cfo_correction, phy_reception_ctx->decode_pdcch, phy_reception_ctx->node_id, phy_reception_ctx->phy_id, phy_reception_ctx->phy_filtering, phy_reception_ctx->use_scatter_sync_seq, phy_reception_ctx->pss_len, phy_reception_ctx->enable_second_stage_pss_detection)) {
+  cell.nof_prb = helpers_get_prb_from_bw_index(bw_idx);
+  PHY_RX_PRINT("PHY ID: %d - Initializing UE Sync for %d PRB.\n", phy_reception_ctx->phy_id, cell.nof_prb);
+#if(ENABLE_RX_CHANNELIZER==1)
+  if(srslte_ue_sync_init_generic(ue_sync, cell, rx_channelizer_recv_with_time_wrapper, rx_channelizer_get_handle(), phy_reception_ctx->initial_subframe_index, phy_reception_ctx->enable_cfo_correction, phy_reception_ctx->decode_pdcch, phy_reception_ctx->node_id, phy_reception_ctx->phy_id, phy_reception_ctx->phy_filtering, phy_reception_ctx->use_scatter_sync_seq, phy_reception_ctx->pss_len, phy_reception_ctx->enable_second_stage_pss_detection)) {
+#else
+  if(srslte_ue_sync_init_generic(ue_sync, cell, srslte_rf_recv_with_time_wrapper, (void*)phy_reception_ctx->rf, phy_reception_ctx->initial_subframe_index, phy_reception_ctx->enable_cfo_correction, phy_reception_ctx->decode_pdcch, phy_reception_ctx->node_id, phy_reception_ctx->phy_id, phy_reception_ctx->phy_filtering, phy_reception_ctx->use_scatter_sync_seq, phy_reception_ctx->pss_len, phy_reception_ctx->enable_second_stage_pss_detection)) {
+#endif
     PHY_RX_ERROR("PHY ID: %d - Error initiating ue_sync\n", phy_reception_ctx->phy_id);
     return -1;
   }
   PHY_RX_PRINT("PHY ID: %d - UE Sync initialization successful.\n", phy_reception_ctx->phy_id);
   // Set PSS detection threshold.
-  srslte_ue_set_pss_synch_find_threshold(&phy_reception_ctx->ue_sync, phy_reception_ctx->threshold);
+  srslte_ue_set_pss_synch_find_threshold(ue_sync, phy_reception_ctx->threshold);
   PHY_RX_PRINT("PHY ID: %d - PSS detection threshold set to: %1.2f.\n", phy_reception_ctx->phy_id, phy_reception_ctx->threshold);
   // Set Min/Max PSR averaging.
-  srslte_ue_sync_set_avg_psr_scatter(&phy_reception_ctx->ue_sync, phy_reception_ctx->enable_avg_psr);
+  srslte_ue_sync_set_avg_psr_scatter(ue_sync, phy_reception_ctx->enable_avg_psr);
   PHY_RX_PRINT("PHY ID: %d - Min/Max PSR Avg: %s.\n", phy_reception_ctx->phy_id, phy_reception_ctx->enable_avg_psr?"ENABLED":"DISABLED");
   // If two-stages PSS detection is enabled, then set the two thresholds.
   PHY_RX_PRINT("PHY ID: %d - Two-stage PSS detection: %s.\n", phy_reception_ctx->phy_id, phy_reception_ctx->enable_second_stage_pss_detection?"ENABLED":"DISABLED");
   if(phy_reception_ctx->enable_second_stage_pss_detection) {
-    srslte_ue_sync_set_pss_synch_find_1st_stage_threshold_scatter(&phy_reception_ctx->ue_sync, phy_reception_ctx->pss_first_stage_threshold);
+    srslte_ue_sync_set_pss_synch_find_1st_stage_threshold_scatter(ue_sync, phy_reception_ctx->pss_first_stage_threshold);
     PHY_RX_PRINT("PHY ID: %d - 1st stage threshold: %1.2f.\n", phy_reception_ctx->phy_id, phy_reception_ctx->pss_first_stage_threshold);
-    srslte_ue_sync_set_pss_synch_find_2nd_stage_threshold_scatter(&phy_reception_ctx->ue_sync, phy_reception_ctx->pss_second_stage_threshold);
+    srslte_ue_sync_set_pss_synch_find_2nd_stage_threshold_scatter(ue_sync, phy_reception_ctx->pss_second_stage_threshold);
     PHY_RX_PRINT("PHY ID: %d - 2nd stage threshold: %1.2f.\n", phy_reception_ctx->phy_id, phy_reception_ctx->pss_second_stage_threshold);
   }
   // Initialize UE DL.
-  if(srslte_ue_dl_init_generic(&phy_reception_ctx->ue_dl, phy_reception_ctx->cell_ue, phy_reception_ctx->phy_id, !phy_reception_ctx->phy_filtering)) {
+  if(srslte_ue_dl_init_generic(ue_dl, cell, phy_reception_ctx->phy_id, !phy_reception_ctx->phy_filtering)) {
     PHY_RX_ERROR("PHY ID: %d - Error initiating UE downlink processing module\n", phy_reception_ctx->phy_id);
     return -1;
   }
   PHY_RX_PRINT("PHY ID: %d - UE DL initialization successful.\n", phy_reception_ctx->phy_id);
   // Configure downlink receiver for the SI-RNTI since will be the only one we'll use.
   // This is the User RNTI.
-  srslte_ue_dl_set_rnti(&phy_reception_ctx->ue_dl, phy_reception_ctx->rnti);
+  srslte_ue_dl_set_rnti(ue_dl, phy_reception_ctx->rnti);
   // Set the expected CFI.
-  srslte_ue_dl_set_expected_cfi(&phy_reception_ctx->ue_dl, DEFAULT_CFI);
+  srslte_ue_dl_set_expected_cfi(ue_dl, DEFAULT_CFI);
   // Enable estimation of CFO based on CSR signals.
-  srslte_ue_dl_set_cfo_csr(&phy_reception_ctx->ue_dl, false);
+  srslte_ue_dl_set_cfo_csr(ue_dl, false);
   // Set the maximum number of turbo decoder iterations.
-  srslte_ue_dl_set_max_noi(&phy_reception_ctx->ue_dl, phy_reception_ctx->max_turbo_decoder_noi);
+  srslte_ue_dl_set_max_noi(ue_dl, phy_reception_ctx->max_turbo_decoder_noi);
   // Enable or disable decoding of PDCCH/PCFICH control channels. If true, it decodes PDCCH/PCFICH otherwise, decodes SCH control.
-  srslte_ue_dl_set_decode_pdcch(&phy_reception_ctx->ue_dl, phy_reception_ctx->decode_pdcch);
+  srslte_ue_dl_set_decode_pdcch(ue_dl, phy_reception_ctx->decode_pdcch);
   // Setting EOB PSS sequence length.
-  srslte_ue_dl_set_pss_length(&phy_reception_ctx->ue_dl, phy_reception_ctx->pss_len);
+  srslte_ue_dl_set_pss_length(ue_dl, phy_reception_ctx->pss_len);
+  // Set the MCS table used to interpret the received MCS index.
+  srslte_ue_dl_set_mcs_table(ue_dl, phy_reception_ctx->mcs_table);
+  // Set the number of HARQ processes combining retransmissions.
+  if(srslte_ue_dl_set_harq_processes(ue_dl, phy_reception_ctx->nof_harq_processes, phy_reception_ctx->harq_timeout)) {
+    PHY_RX_ERROR("PHY ID: %d - Error setting %d HARQ processes\n", phy_reception_ctx->phy_id, phy_reception_ctx->nof_harq_processes);
+    return -1;
+  }
+  // Enable or disable the tracking of the channel estimates across the subframes of a burst.
+  srslte_ue_dl_set_burst_tracking(ue_dl, phy_reception_ctx->burst_tracking);
   // Start AGC.
-  if(phy_reception_ctx->initial_rx_gain < 0.0) {
-    srslte_ue_sync_start_agc(&phy_reception_ctx->ue_sync, srslte_rf_set_rx_gain_th_wrapper_, phy_reception_ctx->initial_agc_gain);
+  if(phy_reception_ctx->initial_rx_gain < 0.0 && ENABLE_RX_CHANNELIZER == 0) {
+    srslte_ue_sync_start_agc(ue_sync, srslte_rf_set_rx_gain_th_wrapper_, phy_reception_ctx->initial_agc_gain);
   }
   // Set initial CFO for ue_sync to 0.
-  srslte_ue_sync_set_cfo(&phy_reception_ctx->ue_sync, 0.0);
+  srslte_ue_sync_set_cfo(ue_sync, 0.0);
+  phy_reception_ctx->bw_context_ready[bw_idx] = true;
+  // Everything went well.
+  return 0;
+}
+
+// Build the context of the initial PHY BW, or of all of them, and make it the one used by both threads.
+int phy_reception_ue_init(phy_reception_t* const phy_reception_ctx) {
+  for(uint32_t bw_idx = 0; bw_idx < PHY_RX_NOF_BW_CONTEXTS; bw_idx++) {
+    phy_reception_ctx->bw_context_ready[bw_idx] = false;
+  }
+#if(PHY_RX_PREBUILD_BW_CONTEXTS==1)
+  for(uint32_t bw_idx = BW_IDX_OneDotFour; bw_idx < PHY_RX_NOF_BW_CONTEXTS; bw_idx++) {
+    if(phy_reception_ue_init_bw_context(phy_reception_ctx, bw_idx) < 0) {
+      return -1;
+    }
+  }
+#else
+  if(phy_reception_ue_init_bw_context(phy_reception_ctx, phy_reception_ctx->bw_idx) < 0) {
+    return -1;
+  }
+#endif
+  phy_reception_ctx->ue_sync          = &phy_reception_ctx->ue_sync_bw[phy_reception_ctx->bw_idx];
+  phy_reception_ctx->ue_dl            = &phy_reception_ctx->ue_dl_bw[phy_reception_ctx->bw_idx];
+  phy_reception_ctx->active_bw_idx    = phy_reception_ctx->bw_idx;
+  phy_reception_ctx->requested_bw_idx = phy_reception_ctx->bw_idx;
   // Everything went well.
   return 0;
 }
 
 int phy_reception_stop_rx_stream_and_flush_buffer(phy_reception_t* const phy_reception_ctx) {
+#if(ENABLE_RX_CHANNELIZER==1)
+  // The RF channel keeps streaming for the other PHYs, only the samples of this one are dropped.
+  rx_channelizer_flush_channel(rx_channelizer_get_handle(), phy_reception_ctx->phy_id);
+  PHY_RX_PRINT("PHY ID: %d - Rx channelizer stream flushed.\n", phy_reception_ctx->phy_id);
+#else // ENABLE_RX_CHANNELIZER
   int error;
   if((error = srslte_rf_stop_rx_stream(phy_reception_ctx->rf, phy_reception_ctx->phy_id)) != 0) {
     PHY_RX_ERROR("PHY ID: %d - Error stopping Rx stream: %d....\n", phy_reception_ctx->phy_id, error);
@@ -941,6 +1047,7 @@ int phy_reception_stop_rx_stream_and_flush_buffer(phy_reception_t* const phy_rec
   PHY_RX_PRINT("PHY ID: %d - Rx stream stopped.\n", phy_reception_ctx->phy_id);
   srslte_rf_flush_buffer(phy_reception_ctx->rf, phy_reception_ctx->phy_id);
   PHY_RX_PRINT("PHY ID: %d - Rx buffer flushed.\n", phy_reception_ctx->phy_id);
+#endif // ENABLE_RX_CHANNELIZER
   // Everything went well.
   return 0;
 }
@@ -952,8 +1059,8 @@ int phy_reception_initialize_rx_stream(phy_reception_t* const phy_reception_ctx)
     PHY_RX_ERROR("PHY ID: %d - Error stopping and flushing Rx stream.\n", phy_reception_ctx->phy_id);
     return -1;
   }
-  // Start Rx Stream.
-  if((error = srslte_rf_start_rx_stream(phy_reception_ctx->rf, phy_reception_ctx->phy_id)) != 0) {
+  // Start Rx Stream. With the channelizer it is started along with the RF device.
+  if(ENABLE_RX_CHANNELIZER == 0 && (error = srslte_rf_start_rx_stream(phy_reception_ctx->rf, phy_reception_ctx->phy_id)) != 0) {
     PHY_RX_ERROR("PHY ID: %d - Error starting Rx stream: %d....\n", phy_reception_ctx->phy_id, error);
     return -1;
   }
@@ -964,18 +1071,23 @@ int phy_reception_initialize_rx_stream(phy_reception_t* const phy_reception_ctx)
 // Free all related UE Downlink structures.
 void phy_reception_ue_free(phy_reception_t* const phy_reception_ctx) {
   // Terminate and join AGC thread only if AGC is enabled.
-  if(phy_reception_ctx->initial_rx_gain < 0.0) {
+  if(phy_reception_ctx->initial_rx_gain < 0.0 && ENABLE_RX_CHANNELIZER == 0) {
     if(srslte_rf_finish_gain_thread(phy_reception_ctx->rf) < 0) {
       PHY_RX_ERROR("PHY ID: %d - Error joining gain thread........\n",phy_reception_ctx->phy_id);
     } else {
       PHY_RX_PRINT("PHY ID: %d - Gain thread correctly joined.\n",phy_reception_ctx->phy_id);
     }
   }
-  // Free all UE related structures.
-  srslte_ue_dl_free(&phy_reception_ctx->ue_dl);
-  PHY_RX_INFO("PHY ID: %d - srslte_ue_dl_free done!\n",phy_reception_ctx->phy_id);
-  srslte_ue_sync_free_except_reentry(&phy_reception_ctx->ue_sync);
-  PHY_RX_INFO("PHY ID: %d - srslte_ue_sync_free_except_reentry done!\n",phy_reception_ctx->phy_id);
+  // Free all UE related structures of every PHY BW built so far.
+  for(uint32_t bw_idx = 0; bw_idx < PHY_RX_NOF_BW_CONTEXTS; bw_idx++) {
+    if(phy_reception_ctx->bw_context_ready[bw_idx]) {
+      srslte_ue_dl_free(&phy_reception_ctx->ue_dl_bw[bw_idx]);
+      PHY_RX_INFO("PHY ID: %d - srslte_ue_dl_free done for BW index %d!\n",phy_reception_ctx->phy_id,bw_idx);
+      srslte_ue_sync_free_except_reentry(&phy_reception_ctx->ue_sync_bw[bw_idx]);
+      PHY_RX_INFO("PHY ID: %d - srslte_ue_sync_free_except_reentry done for BW index %d!\n",phy_reception_ctx->phy_id,bw_idx);
+      phy_reception_ctx->bw_context_ready[bw_idx] = false;
+    }
+  }
 }
 
 int phy_reception_set_rx_sample_rate(phy_reception_t* const phy_reception_ctx) {
@@ -988,7 +1100,12 @@ int phy_reception_set_rx_sample_rate(phy_reception_t* const phy_reception_ctx) {
     PHY_RX_PRINT("PHY ID: %d - Setting a non-standard sampling rate: %1.2f [MHz]\n",phy_reception_ctx->phy_id,srate/1000000.0);
   }
   if(srate != -1) {
+#if(ENABLE_RX_CHANNELIZER==1)
+    // The RF channel sampling rate is set once for all PHYs, each channel being sampled at a fraction of it.
+    srate_rf = rx_channelizer_get_channel_srate(rx_channelizer_get_handle());
+#else
     srate_rf = srslte_rf_set_rx_srate(phy_reception_ctx->rf, (double)srate, phy_reception_ctx->phy_id);
+#endif
     if(srate_rf != srate) {
       PHY_RX_ERROR("PHY ID: %d - Could not set Rx sampling rate.\n",phy_reception_ctx->phy_id);
       return -1;
@@ -1004,6 +1121,7 @@ int phy_reception_set_rx_sample_rate(phy_reception_t* const phy_reception_ctx) {
 
 int phy_reception_set_initial_rx_freq_and_gain(phy_reception_t* const phy_reception_ctx) {
   double current_rx_freq, lo_offset, rx_channel_center_freq;
+#if(ENABLE_RX_CHANNELIZER==0)
   // Set receiver gain.
   if(phy_reception_ctx->initial_rx_gain >= 0.0) {
     double gain = srslte_rf_set_rx_gain(phy_reception_ctx->rf, phy_reception_ctx->initial_rx_gain, phy_reception_ctx->phy_id);
@@ -1016,9 +1134,14 @@ int phy_reception_set_initial_rx_freq_and_gain(phy_reception_t* const phy_recept
     }
     srslte_rf_set_rx_gain(phy_reception_ctx->rf, phy_reception_ctx->initial_agc_gain, phy_reception_ctx->phy_id);
   }
+#endif // ENABLE_RX_CHANNELIZER
   // Calculate central frequency for the channel.
   rx_channel_center_freq = helpers_calculate_channel_center_frequency(phy_reception_ctx->competition_center_freq, phy_reception_ctx->competition_bw, phy_reception_ctx->default_rx_bandwidth, (phy_reception_ctx->default_rx_channel + phy_reception_ctx->phy_id));
-#if(ENABLE_HW_RF_MONITOR==1)
+#if(ENABLE_RX_CHANNELIZER==1)
+  // Gain and center frequency of the shared RF channel are set by trx, only the channel of this PHY is selected here.
+  lo_offset = 0.0;
+  current_rx_freq = rx_channelizer_set_channel_freq(rx_channelizer_get_handle(), phy_reception_ctx->phy_id, rx_channel_center_freq);
+#elif(ENABLE_HW_RF_MONITOR==1)
   // Always apply offset when HW RF Monitor is enabled.
   lo_offset = (double)PHY_RX_LO_OFFSET;
   // Set default central frequency for reception.
@@ -1040,7 +1163,9 @@ int phy_reception_set_initial_rx_freq_and_gain(phy_reception_t* const phy_recept
      PHY_RX_ERROR("[Initialization] PHY ID: %d - Requested channel freq.: %1.2f [MHz] - Actual channel freq.: %1.2f [MHz] - Center Frequency: %1.2f [MHz] - Competition BW: %1.2f [MHz] - PHY BW: %1.2f [MHz] - Channel: %d\n", phy_reception_ctx->phy_id, rx_channel_center_freq/1000000.0, current_rx_freq/1000000.0, phy_reception_ctx->competition_center_freq/1000000.0, phy_reception_ctx->competition_bw/1000000.0, phy_reception_ctx->default_rx_bandwidth/1000000.0, (phy_reception_ctx->default_rx_channel + phy_reception_ctx->phy_id));
      return -1;
   }
+#if(ENABLE_RX_CHANNELIZER==0)
   srslte_rf_rx_wait_lo_locked(phy_reception_ctx->rf, phy_reception_ctx->phy_id);
+#endif
   PHY_RX_PRINT("PHY ID: %d - Set initial Rx freq to: %.2f [MHz] with offset of: %.2f [MHz]\n", phy_reception_ctx->phy_id, (current_rx_freq/1000000.0),(lo_offset/1000000.0));
   // Everything went well.
   return 0;
@@ -1060,10 +1185,10 @@ void *phy_reception_sync_work(void *h) {
   uhd_set_thread_priority(1.0, true);
 
   // Set some constant parameters of short_ue_sync structure.
-  short_ue_sync.frame_len = phy_reception_ctx->ue_sync.frame_len;
+  short_ue_sync.frame_len = phy_reception_ctx->ue_sync->frame_len;
 
   // Initialize subframe counter to 0.
-  phy_reception_ctx->ue_sync.subframe_counter = 0;
+  phy_reception_ctx->ue_sync->subframe_counter = 0;
 
   PHY_RX_DEBUG("PHY ID: %d - Entering PHY synchronization thread loop.\n", phy_reception_ctx->phy_id);
   while(phy_reception_ctx->run_rx_synchronization_thread) {
@@ -1084,8 +1209,14 @@ void *phy_reception_sync_work(void *h) {
     }
 #endif
 
+    // Switch to the structures of a new PHY BW, the radio has already been retuned by the BW change.
+    if(phy_reception_ctx->requested_bw_idx != phy_reception_ctx->active_bw_idx) {
+      phy_reception_switch_bw_context(phy_reception_ctx);
+      short_ue_sync.frame_len = phy_reception_ctx->ue_sync->frame_len;
+    }
+
     // synchronize and align subframes.
-    ret = srslte_ue_sync_get_subframe_buffer(&phy_reception_ctx->ue_sync, phy_reception_ctx->phy_id);
+    ret = srslte_ue_sync_get_subframe_buffer(phy_reception_ctx->ue_sync, phy_reception_ctx->phy_id);
 
     // srslte_ue_sync_get_subframe_buffer() returns 1 if it successfully synchronizes to a slot (also known as subframe).
     if(ret == 1) {
@@ -1095,28 +1226,29 @@ void *phy_reception_sync_work(void *h) {
       //clock_gettime(CLOCK_REALTIME, &start_push_queue);
 
       // We increment the subframe counter the first time if we have just found a peak and the subframe data was correctly decoded.
-      if(phy_reception_ctx->ue_sync.last_state == SF_FIND && phy_reception_ctx->ue_sync.state == SF_TRACK && phy_reception_ctx->ue_sync.subframe_counter == 0) {
-        phy_reception_ctx->ue_sync.subframe_counter = 1;
-        PHY_RX_DEBUG("PHY ID: %d - First increment of subframe counter: %d.\n",phy_reception_ctx->phy_id,phy_reception_ctx->ue_sync.subframe_counter);
-      } else if(phy_reception_ctx->ue_sync.last_state == SF_TRACK && phy_reception_ctx->ue_sync.state == SF_TRACK && phy_reception_ctx->ue_sync.subframe_counter > 0) {
+      if(phy_reception_ctx->ue_sync->last_state == SF_FIND && phy_reception_ctx->ue_sync->state == SF_TRACK && phy_reception_ctx->ue_sync->subframe_counter == 0) {
+        phy_reception_ctx->ue_sync->subframe_counter = 1;
+        PHY_RX_DEBUG("PHY ID: %d - First increment of subframe counter: %d.\n",phy_reception_ctx->phy_id,phy_reception_ctx->ue_sync->subframe_counter);
+      } else if(phy_reception_ctx->ue_sync->last_state == SF_TRACK && phy_reception_ctx->ue_sync->state == SF_TRACK && phy_reception_ctx->ue_sync->subframe_counter > 0) {
         // Increment the subframe counter in order to receive the correct number of subframes.
-        phy_reception_ctx->ue_sync.subframe_counter++;
+        phy_reception_ctx->ue_sync->subframe_counter++;
       } else {
         PHY_RX_ERROR("PHY ID: %d - There was something wrong with the subframe_counter.\n", phy_reception_ctx->phy_id);
         continue;
       }
 
       // Update the short ue sync structure with the current subframe counter number and other parameters.
-      short_ue_sync.buffer_number             = phy_reception_ctx->ue_sync.previous_subframe_buffer_counter_value;
-      short_ue_sync.subframe_start_index      = phy_reception_ctx->ue_sync.subframe_start_index;
-      short_ue_sync.sf_idx                    = phy_reception_ctx->ue_sync.sf_idx;
-      short_ue_sync.peak_value                = phy_reception_ctx->ue_sync.sfind.peak_value;
-      short_ue_sync.peak_detection_timestamp  = phy_reception_ctx->ue_sync.sfind.peak_detection_timestamp;
-      short_ue_sync.cfo                       = srslte_ue_sync_get_carrier_freq_offset(&phy_reception_ctx->ue_sync.sfind); // CFO value given in Hz
-      short_ue_sync.nof_subframes_to_rx       = phy_reception_ctx->ue_sync.sfind.nof_subframes_to_rx;
-      short_ue_sync.subframe_counter          = phy_reception_ctx->ue_sync.subframe_counter;
-      short_ue_sync.subframe_track_start      = phy_reception_ctx->ue_sync.subframe_track_start;
-      short_ue_sync.mcs                       = phy_reception_ctx->ue_sync.sfind.mcs;
+      short_ue_sync.buffer_number             = phy_reception_ctx->ue_sync->previous_subframe_buffer_counter_value;
+      short_ue_sync.subframe_start_index      = phy_reception_ctx->ue_sync->subframe_start_index;
+      short_ue_sync.sf_idx                    = phy_reception_ctx->ue_sync->sf_idx;
+      short_ue_sync.peak_value                = phy_reception_ctx->ue_sync->sfind.peak_value;
+      short_ue_sync.peak_detection_timestamp  = phy_reception_ctx->ue_sync->sfind.peak_detection_timestamp;
+      short_ue_sync.cfo                       = srslte_ue_sync_get_carrier_freq_offset(&phy_reception_ctx->ue_sync->sfind); // CFO value given in Hz
+      short_ue_sync.nof_subframes_to_rx       = phy_reception_ctx->ue_sync->sfind.nof_subframes_to_rx;
+      short_ue_sync.subframe_counter          = phy_reception_ctx->ue_sync->subframe_counter;
+      short_ue_sync.subframe_track_start      = phy_reception_ctx->ue_sync->subframe_track_start;
+      short_ue_sync.mcs                       = phy_reception_ctx->ue_sync->sfind.mcs;
+      short_ue_sync.bw_idx                    = phy_reception_ctx->active_bw_idx;
 
 #if(WRITE_RX_SUBFRAME_INTO_FILE==1)
       static unsigned int dump_cnt = 0;
@@ -1125,7 +1257,7 @@ void *phy_reception_sync_work(void *h) {
       if(dump_cnt==0) {
          filesink_init(&file_sink, output_file_name, SRSLTE_COMPLEX_FLOAT_BIN);
          // Write samples into file.
-         filesink_write(&file_sink, &phy_reception_ctx->ue_sync.input_buffer[short_ue_sync.buffer_number][short_ue_sync.subframe_start_index], SRSLTE_SF_LEN(srslte_symbol_sz(helpers_get_prb_from_bw_index(get_bw_index(phy_reception_ctx)))));
+         filesink_write(&file_sink, &phy_reception_ctx->ue_sync->input_buffer[short_ue_sync.buffer_number][short_ue_sync.subframe_start_index], SRSLTE_SF_LEN(srslte_symbol_sz(helpers_get_prb_from_bw_index(get_bw_index(phy_reception_ctx)))));
          // Close file.
          filesink_free(&file_sink);
       }
@@ -1137,14 +1269,14 @@ void *phy_reception_sync_work(void *h) {
       phy_reception_push_ue_sync_to_queue(phy_reception_ctx, &short_ue_sync);
 
       // After pushing the ue synch message into the queue, reset ue_synch object if this was the last subframe of a MAC frame.
-      if(phy_reception_ctx->ue_sync.subframe_counter >= phy_reception_ctx->ue_sync.sfind.nof_subframes_to_rx) {
+      if(phy_reception_ctx->ue_sync->subframe_counter >= phy_reception_ctx->ue_sync->sfind.nof_subframes_to_rx) {
         // Light weight way to reset ue_dl for new reception.
-        if(srslte_ue_sync_init_reentry_loop(&phy_reception_ctx->ue_sync)) {
+        if(srslte_ue_sync_init_reentry_loop(phy_reception_ctx->ue_sync)) {
           PHY_RX_ERROR("PHY ID: %d - Error re-initiating ue_sync\n",phy_reception_ctx->phy_id);
           continue;
         }
         // Reset subframe counter so that it can be used again.
-        phy_reception_ctx->ue_sync.subframe_counter = 0;
+        phy_reception_ctx->ue_sync->subframe_counter = 0;
       }
 
       //double diff_queue = helpers_profiling_diff_time(start_push_queue);
@@ -1333,7 +1465,11 @@ void phy_reception_update_frequency(phy_reception_t* const phy_reception_ctx, bo
 
   // Calculate central frequency for the channel.
   rx_channel_center_freq = helpers_calculate_channel_center_frequency(phy_reception_ctx->competition_center_freq, phy_reception_ctx->competition_bw, phy_reception_ctx->default_rx_bandwidth, phy_reception_ctx->last_rx_basic_control.ch);
-#if(ENABLE_HW_RF_MONITOR==1)
+#if(ENABLE_RX_CHANNELIZER==1)
+  // The RF channel stays where trx tuned it, only the channel of this PHY is moved.
+  lo_offset = 0.0;
+  actual_rx_freq = rx_channelizer_set_channel_freq(rx_channelizer_get_handle(), phy_reception_ctx->phy_id, rx_channel_center_freq);
+#elif(ENABLE_HW_RF_MONITOR==1)
   // Always apply offset when HW RF Monitor is enabled.
   lo_offset = (double)PHY_RX_LO_OFFSET;
   // Set RF Monitor sampling rate.
@@ -1368,15 +1504,21 @@ void phy_reception_update_frequency(phy_reception_t* const phy_reception_ctx, bo
 }
 
 int phy_reception_stop_rx_stream(uint32_t phy_id) {
-  int error;
   phy_reception_t* const phy_reception_ctx = phy_rx_threads[phy_id];
   // Close and reopen Rx stream.
   PHY_RX_PRINT("PHY ID: %d - Trying to stop the Rx stream.\n", phy_reception_ctx->phy_id);
+#if(ENABLE_RX_CHANNELIZER==1)
+  // Wakes up the synchronization thread if it is waiting for samples.
+  rx_channelizer_stop_channel(rx_channelizer_get_handle(), phy_reception_ctx->phy_id);
+  PHY_RX_PRINT("PHY ID: %d - Rx channelizer stream stopped.\n", phy_reception_ctx->phy_id);
+#else // ENABLE_RX_CHANNELIZER
+  int error;
   if((error = srslte_rf_stop_rx_stream(phy_reception_ctx->rf, phy_reception_ctx->phy_id)) != 0) {
     PHY_RX_ERROR("PHY ID: %d - Error stopping Rx stream: %d....\n", phy_reception_ctx->phy_id, error);
     return -1;
   }
   PHY_RX_PRINT("PHY ID: %d - Rx stream stopped.\n", phy_reception_ctx->phy_id);
+#endif // ENABLE_RX_CHANNELIZER
   // Everything went well.
   return 0;
 }
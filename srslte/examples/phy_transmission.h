@@ -18,6 +18,8 @@
 #include "../../../../communicator/cpp/communicator_wrapper.h"
 #include "helpers.h"
 #include "transceiver.h"
+#include "tx_combiner.h"
+#include "tx_lead_time.h"
 
 // ************************** Definition of macros *****************************
 // Set the number of 0 samples padded before the slot so that we don't miss part of it. (This issue only happens with local USRPs)
@@ -38,6 +40,16 @@
 // Do never change this. It is set according to DARPA suggestions.
 #define PHY_TX_LO_OFFSET -42.0e6 // TX local offset.
 
+// Number of encoding contexts, one per PHY BW index.
+#define PHY_TX_NOF_BW_CONTEXTS (BW_IDX_Twenty+1)
+
+// Flag used to build the contexts of all PHY BWs at start up. Otherwise, each one is built the first time its BW is configured.
+#define PHY_TX_PREBUILD_BW_CONTEXTS 0
+
+// Number of threads, including the PHY TX thread, encoding the code blocks of a transport block in parallel. 0 or 1 encodes them serially.
+// Each BW context gets its own team of workers.
+#define PHY_TX_NOF_ENCODE_WORKERS 0
+
 // ****************************** Debugging macros *****************************
 // Enable the writing of samples into a file, this is only for debugging purposes.
 #define WRITE_TX_SUBFRAME_INTO_FILE 0 // Enbale or disable dumping of Tx samples.
@@ -80,6 +92,28 @@
   fprintf(stdout, "[PHY TX ERROR]: %s - " _fmt, date_time_str, __VA_ARGS__); } while(0)
 
 // *************************** Definition of types *****************************
+// Base station structures and buffers whose size depends on the PHY BW.
+typedef struct {
+  bool ready;
+
+  srslte_ofdm_t ifft;
+  srslte_pcfich_t pcfich;
+  srslte_pdcch_t pdcch;
+  srslte_pdsch_t pdsch;
+  srslte_softbuffer_tx_t softbuffer;
+  srslte_regs_t regs;
+  srslte_chest_dl_t est;
+  srslte_dci_location_t locations[SRSLTE_NSUBFRAMES_X_FRAME][30];
+
+  int sf_n_re;
+  int sf_n_samples;
+
+  cf_t *sf_buffer_eb;
+  cf_t *output_buffer;
+  cf_t *subframe_ofdm_symbols;
+  cf_t *sf_symbols[SRSLTE_MAX_PORTS];
+} phy_transmission_bw_context_t;
+
 typedef struct {
   uint32_t phy_id;
   LayerCommunicator_handle phy_comm_handle;
@@ -106,19 +140,21 @@ typedef struct {
   float initial_tx_gain;
   bool phy_filtering;
 
-  srslte_ofdm_t ifft;
-  srslte_pcfich_t pcfich;
-  srslte_pdcch_t pdcch;
-  srslte_pdsch_t pdsch;
+  // Structures of every PHY BW, built once and kept until the PHY is stopped, and the ones currently used.
+  phy_transmission_bw_context_t bw_ctx[PHY_TX_NOF_BW_CONTEXTS];
+  phy_transmission_bw_context_t *bw;
+
   srslte_pdsch_cfg_t pdsch_cfg;
-  srslte_softbuffer_tx_t softbuffer;
-  srslte_regs_t regs;
   srslte_ra_dl_dci_t ra_dl;
   srslte_ra_dl_grant_t grant;
   srslte_cell_t cell_enb;
 
   uint32_t last_nof_subframes_to_tx;
   uint32_t last_mcs;
+  // MCS table configured for this PHY, both ends of the link must use the same one.
+  srslte_ra_dl_mcs_table_t mcs_table;
+  // New data indicator of each HARQ process, toggled every time a process carries a new TB.
+  bool harq_ndi[SRSLTE_RA_NOF_HARQ_PROCESSES_SCATTER];
 
   // Attribute and ID for encoding/transmission thread.
   pthread_attr_t tx_encoding_thread_attr;
@@ -130,13 +166,6 @@ typedef struct {
   basic_ctrl_t last_tx_basic_control;
 
   int number_of_tx_offset_samples;
-  int sf_n_re;
-  int sf_n_samples;
-
-  cf_t *sf_buffer_eb;
-  cf_t *output_buffer;
-  cf_t *subframe_ofdm_symbols;
-  cf_t *sf_symbols[SRSLTE_MAX_PORTS];
 
   cf_t *pss_signal;
   cf_t *pss_signal_end;
@@ -145,9 +174,6 @@ typedef struct {
   float sch_signal1[SRSLTE_SCH_LEN];
   float sss_signal[SRSLTE_SSS_LEN];
 
-  srslte_chest_dl_t est;
-  srslte_dci_location_t locations[SRSLTE_NSUBFRAMES_X_FRAME][30];
-
   // Mutex used to synchronize between main and encoding/transmission thread.
   pthread_mutex_t tx_basic_control_mutex;
   // Condition variable used to synchronize between main and encoding/transmission thread.
@@ -156,8 +182,13 @@ typedef struct {
   // Mutex used to control access to enviroment/scenario parameters.
   pthread_mutex_t tx_env_update_mutex;
 
-  // Circular buffer handle for Tx basic control information.
-  tx_cb_handle tx_basic_control_handle;
+  // Deadline ordered queue for Tx basic control information, the one with the earliest timestamp is served first.
+  tx_pq_handle tx_basic_control_handle;
+  // Time, in microseconds, it takes from popping a basic control until its first subframe is sent.
+  tx_lead_time_t tx_lead_time;
+  // Time, in microseconds, spent reconfiguring the PHY (e.g., building a BW context) for the last popped basic control.
+  // It happens once per configuration, so it is left out of the lead time.
+  uint64_t tx_reconfiguration_time;
 
   // Flag used to inform if there was a change in the environment parameters.
   bool env_update;
@@ -209,19 +240,29 @@ int phy_transmission_base_init(phy_transmission_t* const phy_transmission_ctx);
 
 void phy_transmission_free_base(phy_transmission_t* const phy_transmission_ctx);
 
+int phy_transmission_sync_signals_init(phy_transmission_t* const phy_transmission_ctx);
+
+void phy_transmission_free_sync_signals(phy_transmission_t* const phy_transmission_ctx);
+
+int phy_transmission_select_bw_context(phy_transmission_t* const phy_transmission_ctx, uint32_t bw_idx);
+
+int phy_transmission_init_bw_contexts(phy_transmission_t* const phy_transmission_ctx);
+
 int phy_transmission_set_tx_sample_rate(phy_transmission_t* const phy_transmission_ctx);
 
 int phy_transmission_set_initial_tx_freq_and_gain(phy_transmission_t* const phy_transmission_ctx);
 
 void phy_transmission_send_tx_statistics(phy_transmission_t* const phy_transmission_ctx, phy_stat_t* const phy_tx_stat, int ret);
 
-void phy_transmission_push_tx_basic_control_into_container(basic_ctrl_t* const basic_ctrl);
+int phy_transmission_push_tx_basic_control_into_container(basic_ctrl_t* const basic_ctrl);
+
+bool phy_transmission_can_make_deadline(phy_transmission_t* const phy_transmission_ctx, basic_ctrl_t* const bc, uint64_t now);
 
 void phy_transmission_change_allocation(phy_transmission_t* const phy_transmission_ctx, uint32_t req_mcs, uint32_t req_bw_idx);
 
-uint32_t phy_transmission_calculate_nof_subframes(uint32_t mcs, uint32_t bw_idx, uint32_t length);
+uint32_t phy_transmission_calculate_nof_subframes(srslte_ra_dl_mcs_table_t mcs_table, uint32_t mcs, uint32_t bw_idx, uint32_t length);
 
-uint32_t phy_transmission_get_tb_size(uint32_t bw_idx, uint32_t mcs);
+uint32_t phy_transmission_get_tb_size(srslte_ra_dl_mcs_table_t mcs_table, uint32_t bw_idx, uint32_t mcs);
 
 void phy_transmission_update_environment(uint32_t phy_id, environment_t* const env_update);
 
@@ -239,7 +280,7 @@ bool phy_transmission_get_env_update(phy_transmission_t* const phy_transmission_
 
 double phy_transmission_calculate_channel_center_frequency(phy_transmission_t* const phy_transmission_ctx, float tx_bandwidth, uint32_t tx_channel);
 
-int phy_transmission_validate_tb_size(basic_ctrl_t* const bc, uint32_t bw_idx, uint32_t phy_id);
+int phy_transmission_validate_tb_size(basic_ctrl_t* const bc, srslte_ra_dl_mcs_table_t mcs_table, uint32_t bw_idx, uint32_t phy_id);
 
 timer_t* phy_transmission_get_timer_id(uint32_t phy_id);
 
@@ -253,4 +294,6 @@ bool phy_transmission_get_env_update_comp_freq(phy_transmission_t* const phy_tra
 
 void phy_transmission_set_env_update_comp_freq(phy_transmission_t* const phy_transmission_ctx, bool competition_freq_updated);
 
+int srslte_rf_send_timed_wrapper(void *h, void *data, int nsamples, time_t secs, double frac_secs, bool has_time_spec, bool is_start_of_burst, bool is_end_of_burst, size_t channel);
+
 #endif // _PHY_TRANSMISSION_H_
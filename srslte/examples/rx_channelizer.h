@@ -0,0 +1,99 @@
+#ifndef _RX_CHANNELIZER_H_
+#define _RX_CHANNELIZER_H_
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <string.h>
+#include <signal.h>
+
+#include "srslte/srslte.h"
+#include "srslte/intf/intf.h"
+
+#include "helpers.h"
+
+// ************************** Definition of macros *****************************
+// Flag used to receive all the PHYs from a single RF channel split by the polyphase channelizer instead of one RF channel per PHY.
+// With it enabled all PHYs keep the PHY BW given to trx, as the RF sampling rate is fixed, so basic control BW changes are rejected. The RF gain is not changed by the PHYs either.
+#define ENABLE_RX_CHANNELIZER 0
+
+// Number of channelizer branches. The RF channel is sampled at this number times the PHY sampling rate.
+#define RX_CHANNELIZER_NOF_CHANNELS 4
+
+// RF channel the wideband signal is received from.
+#define RX_CHANNELIZER_RF_CHANNEL 0
+
+// Number of subframes read from the RF channel at once.
+#define RX_CHANNELIZER_NOF_SUBFRAMES_PER_READ 1
+
+// Number of subframes each PHY stream can hold before the oldest ones are dropped.
+#define RX_CHANNELIZER_BUFFER_NOF_SUBFRAMES 20
+
+// Maximum distance in Hz between a PHY channel and the closest channelizer branch, corrected with a phase rotator.
+#define RX_CHANNELIZER_MAX_FREQ_OFFSET 500000.0
+
+// ***************************** INFO/DEBUG MACROS *****************************
+#define ENABLE_RX_CHANNELIZER_PRINTS 1
+
+#define RX_CHANNELIZER_PRINT(_fmt, ...) do { if(ENABLE_RX_CHANNELIZER_PRINTS && scatter_verbose_level >= 0) { \
+  fprintf(stdout, "[RX CHANNELIZER PRINT]: " _fmt, __VA_ARGS__); } } while(0)
+
+#define RX_CHANNELIZER_INFO(_fmt, ...) do { if(ENABLE_RX_CHANNELIZER_PRINTS && scatter_verbose_level >= SRSLTE_VERBOSE_INFO) { \
+  fprintf(stdout, "[RX CHANNELIZER INFO]: " _fmt, __VA_ARGS__); } } while(0)
+
+#define RX_CHANNELIZER_ERROR(_fmt, ...) do { fprintf(stdout, "[RX CHANNELIZER ERROR]: " _fmt, __VA_ARGS__); } while(0)
+
+// *************************** Definition of types *****************************
+typedef struct {
+  srslte_ringbuffer_t buffer;  // Channel samples waiting to be read by the PHY.
+  bool ready;                  // Set once the PHY has configured its channel frequency.
+  int branch;                  // Channelizer branch carrying the PHY channel.
+  float freq_offset;           // Distance between the PHY channel and the branch center, normalized by the channel sampling rate.
+  float phase;                 // Phase of the rotator correcting the offset, in cycles.
+  uint32_t nof_overflows;      // Number of times the PHY did not read its samples in time.
+} rx_channelizer_stream_t;
+
+typedef struct {
+  srslte_channelizer_t channelizer;
+  // Wideband source, with the same prototype as the ue_sync receive callback.
+  void *source_handle;
+  int (*source_callback)(void*, void*, uint32_t, srslte_timestamp_t*, size_t);
+  size_t source_channel;
+  uint32_t nof_channels;
+  double channel_srate;
+  double center_freq;
+  uint32_t nof_samples_per_read;
+  cf_t *wideband_buffer;
+  cf_t *channel_buffers[RX_CHANNELIZER_NOF_CHANNELS];
+  cf_t *rotated_buffer;
+  rx_channelizer_stream_t streams[MAX_NUM_CONCURRENT_PHYS];
+  // Time of the sample following the last one written into the streams.
+  srslte_timestamp_t next_timestamp;
+  pthread_mutex_t streams_mutex;
+  volatile sig_atomic_t run;
+  pthread_attr_t thread_attr;
+  pthread_t thread_id;
+} rx_channelizer_t;
+
+// *************************** Declaration of functions ***************************
+int rx_channelizer_start(void *source_handle, int (*source_callback)(void*, void*, uint32_t, srslte_timestamp_t*, size_t), size_t source_channel, double channel_srate, double center_freq);
+
+int rx_channelizer_stop();
+
+void *rx_channelizer_get_handle();
+
+double rx_channelizer_get_channel_srate(void *h);
+
+double rx_channelizer_set_channel_freq(void *h, uint32_t phy_id, double freq);
+
+void rx_channelizer_flush_channel(void *h, uint32_t phy_id);
+
+void rx_channelizer_stop_channel(void *h, uint32_t phy_id);
+
+int rx_channelizer_recv_with_time_wrapper(void *h, void *data, uint32_t nsamples, srslte_timestamp_t *t, size_t channel);
+
+void *rx_channelizer_work(void *h);
+
+#endif // _RX_CHANNELIZER_H_
@@ -64,8 +64,8 @@ int main(int argc, char *argv[]) {
 
   communicator_free(&handle);
 
-  // It must be done here as malloc was called by the communicator wrapper.
-  free(basic_ctrl.data);
+  // It must be done here as the buffer was leased by the communicator wrapper.
+  communicator_release_user_data_buffer(basic_ctrl.data);
   basic_ctrl.data = NULL;
 
   return 0;
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tx_lead_time.h"
+
+// Checks that one very long measurement does not latch the admission control into rejecting every basic control.
+int main(int argc, char **argv) {
+  tx_lead_time_t lead_time;
+  uint64_t now = 1000000;
+  int nof_attempts;
+
+  tx_lead_time_init(&lead_time);
+  // The first measurement is averaged with the initial estimate instead of replacing it.
+  tx_lead_time_update(&lead_time, 50000);
+  if(tx_lead_time_get(&lead_time) > TX_LEAD_TIME_MAX) {
+    printf("Lead time of %1.0f [us] after the first measurement is above the maximum of %1.0f [us].\n", tx_lead_time_get(&lead_time), TX_LEAD_TIME_MAX);
+    exit(-1);
+  }
+  // Steady state: encoding takes 300 us.
+  for(int i = 0; i < 100; i++) {
+    tx_lead_time_update(&lead_time, 300);
+  }
+  if(!tx_lead_time_can_make_deadline(&lead_time, now + 400, now)) {
+    printf("Basic control 400 [us] ahead of its deadline rejected with a lead time of %1.0f [us].\n", tx_lead_time_get(&lead_time));
+    exit(-1);
+  }
+  // One outlier, e.g., the thread was preempted.
+  tx_lead_time_update(&lead_time, 50000);
+  printf("Lead time after the outlier: %1.0f [us]\n", tx_lead_time_get(&lead_time));
+  // Basic controls 400 us ahead of their deadline must be admitted again after a few rejections.
+  for(nof_attempts = 1; nof_attempts <= 10; nof_attempts++) {
+    if(tx_lead_time_can_make_deadline(&lead_time, now + 400, now)) {
+      break;
+    }
+  }
+  if(nof_attempts > 10) {
+    printf("Admission did not recover: lead time: %1.0f [us]\n", tx_lead_time_get(&lead_time));
+    exit(-1);
+  }
+  printf("Admitted again after %d attempts - Rejections: %d - Lead time: %1.0f [us]\n", nof_attempts, (int)tx_lead_time_get_nof_rejections(&lead_time), tx_lead_time_get(&lead_time));
+  // Basic controls without deadline are always admitted.
+  if(!tx_lead_time_can_make_deadline(&lead_time, 0, now)) {
+    printf("Basic control without deadline rejected.\n");
+    exit(-1);
+  }
+  tx_lead_time_free(&lead_time);
+  printf("Ok\n");
+  exit(0);
+}
@@ -61,11 +61,20 @@ typedef struct {
     float pss_first_stage_threshold;
     float pss_second_stage_threshold;
     bool enable_eob_pss;
+    uint32_t phy_stat_batch_size;
+    uint32_t phy_stat_batch_delay;
+    uint32_t queue_stats_period;
+    bool enable_256qam;
+    uint32_t nof_harq_processes;
+    uint32_t harq_timeout;
+    bool enable_burst_tracking;
     char env_pathname[200];
 } transceiver_args_t;
 
 #define DEFAULT_CFI 1 // We use only one OFDM symbol for control.
 
+#define DEFAULT_FFTW_WISDOM_FILENAME "/root/radio_api/fftw_wisdom" // Created by the fftw_wisdom tool and updated by trx at exit.
+
 #define DEVNAME_B200 "uhd_b200"
 
 #define DEVNAME_X300 "uhd_x300"
@@ -0,0 +1,100 @@
+#ifndef _TX_COMBINER_H_
+#define _TX_COMBINER_H_
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <string.h>
+#include <signal.h>
+
+#include "srslte/srslte.h"
+#include "srslte/intf/intf.h"
+
+#include "helpers.h"
+
+// ************************** Definition of macros *****************************
+// Flag used to transmit all the PHYs through a single RF channel combined by the polyphase synthesizer instead of one RF channel per PHY.
+// With it enabled all PHYs keep the PHY BW given to trx, as the RF sampling rate is fixed, so basic control BW changes are rejected. The RF gain is not changed by the PHYs either.
+#define ENABLE_TX_COMBINER 0
+
+// Number of synthesizer branches. The RF channel is sampled at this number times the PHY sampling rate.
+#define TX_COMBINER_NOF_CHANNELS 4
+
+// RF channel the wideband signal is transmitted through.
+#define TX_COMBINER_RF_CHANNEL 0
+
+// Number of subframes each PHY can queue before its transmission blocks.
+#define TX_COMBINER_BUFFER_NOF_SUBFRAMES 4
+
+// Maximum distance in Hz between a PHY channel and the closest synthesizer branch, applied with a phase rotator.
+#define TX_COMBINER_MAX_FREQ_OFFSET 500000.0
+
+// Amplitude scale applied to every PHY so that all the usable channels at full scale can be transmitted together.
+#define TX_COMBINER_AMPLITUDE_SCALE (1.0/(TX_COMBINER_NOF_CHANNELS-1))
+
+// ***************************** INFO/DEBUG MACROS *****************************
+#define ENABLE_TX_COMBINER_PRINTS 1
+
+#define TX_COMBINER_PRINT(_fmt, ...) do { if(ENABLE_TX_COMBINER_PRINTS && scatter_verbose_level >= 0) { \
+  fprintf(stdout, "[TX COMBINER PRINT]: " _fmt, __VA_ARGS__); } } while(0)
+
+#define TX_COMBINER_INFO(_fmt, ...) do { if(ENABLE_TX_COMBINER_PRINTS && scatter_verbose_level >= SRSLTE_VERBOSE_INFO) { \
+  fprintf(stdout, "[TX COMBINER INFO]: " _fmt, __VA_ARGS__); } } while(0)
+
+#define TX_COMBINER_ERROR(_fmt, ...) do { fprintf(stdout, "[TX COMBINER ERROR]: " _fmt, __VA_ARGS__); } while(0)
+
+// *************************** Definition of types *****************************
+typedef struct {
+  srslte_ringbuffer_t buffer;  // Samples of the current burst waiting to be combined.
+  bool ready;                  // Set once the PHY has configured its channel frequency.
+  int branch;                  // Synthesizer branch carrying the PHY channel.
+  float freq_offset;           // Distance between the PHY channel and the branch center, normalized by the channel sampling rate.
+  float phase;                 // Phase of the rotator applying the offset, in cycles.
+  bool in_burst;               // Set from the start of a burst until its last sample is combined.
+  bool end_of_burst;           // Set once the last samples of the burst are queued.
+  bool started;                // Set once the burst has been placed in a combined burst.
+  bool has_time_spec;
+  srslte_timestamp_t start;    // Time of the next sample of the burst.
+  uint32_t nof_late_bursts;    // Number of bursts that started after their time.
+} tx_combiner_stream_t;
+
+typedef struct {
+  srslte_synthesizer_t synthesizer;
+  // Wideband sink, transmitting one chunk of samples.
+  void *sink_handle;
+  int (*sink_callback)(void*, void*, int, time_t, double, bool, bool, bool, size_t);
+  size_t sink_channel;
+  uint32_t nof_channels;
+  double channel_srate;
+  double center_freq;
+  uint32_t nof_samples_per_chunk;
+  cf_t *phy_buffers[MAX_NUM_CONCURRENT_PHYS];
+  cf_t *branch_buffers[TX_COMBINER_NOF_CHANNELS];
+  cf_t *rotated_buffer;
+  cf_t *wideband_buffer;
+  tx_combiner_stream_t streams[MAX_NUM_CONCURRENT_PHYS];
+  pthread_mutex_t streams_mutex;
+  pthread_cond_t streams_cv;
+  volatile sig_atomic_t run;
+  pthread_attr_t thread_attr;
+  pthread_t thread_id;
+} tx_combiner_t;
+
+// *************************** Declaration of functions ***************************
+int tx_combiner_start(void *sink_handle, int (*sink_callback)(void*, void*, int, time_t, double, bool, bool, bool, size_t), size_t sink_channel, double channel_srate, double center_freq);
+
+int tx_combiner_stop();
+
+void *tx_combiner_get_handle();
+
+double tx_combiner_get_channel_srate(void *h);
+
+double tx_combiner_set_channel_freq(void *h, uint32_t phy_id, double freq);
+
+int tx_combiner_send_timed(void *h, void *data, int nsamples, time_t secs, double frac_secs, bool has_time_spec, bool is_start_of_burst, bool is_end_of_burst, size_t channel);
+
+void *tx_combiner_work(void *h);
+
+#endif // _TX_COMBINER_H_
@@ -0,0 +1,49 @@
+#include "tx_lead_time.h"
+
+void tx_lead_time_init(tx_lead_time_t* const q) {
+  q->avg = TX_LEAD_TIME_INITIAL;
+  q->nof_rejections = 0;
+  pthread_mutex_init(&q->mutex, NULL);
+}
+
+void tx_lead_time_free(tx_lead_time_t* const q) {
+  pthread_mutex_destroy(&q->mutex);
+}
+
+// Add a measured lead time, in microseconds, to the moving average.
+void tx_lead_time_update(tx_lead_time_t* const q, uint64_t lead_time) {
+  double sample = (double)lead_time < TX_LEAD_TIME_MAX ? (double)lead_time:TX_LEAD_TIME_MAX;
+  pthread_mutex_lock(&q->mutex);
+  q->avg = (1.0 - TX_LEAD_TIME_AVG_WEIGHT)*q->avg + TX_LEAD_TIME_AVG_WEIGHT*sample;
+  pthread_mutex_unlock(&q->mutex);
+}
+
+// A timed basic control, i.e., with a deadline different from 0, is only admitted if it can still be encoded before its
+// deadline. A rejected one lowers the estimate as it can not be measured.
+bool tx_lead_time_can_make_deadline(tx_lead_time_t* const q, uint64_t deadline, uint64_t now) {
+  bool admitted = true;
+  pthread_mutex_lock(&q->mutex);
+  if(deadline != 0 && (int64_t)(deadline - now) <= (int64_t)q->avg) {
+    q->avg = (1.0 - TX_LEAD_TIME_AVG_WEIGHT)*q->avg;
+    q->nof_rejections++;
+    admitted = false;
+  }
+  pthread_mutex_unlock(&q->mutex);
+  return admitted;
+}
+
+double tx_lead_time_get(tx_lead_time_t* const q) {
+  double avg;
+  pthread_mutex_lock(&q->mutex);
+  avg = q->avg;
+  pthread_mutex_unlock(&q->mutex);
+  return avg;
+}
+
+uint64_t tx_lead_time_get_nof_rejections(tx_lead_time_t* const q) {
+  uint64_t nof_rejections;
+  pthread_mutex_lock(&q->mutex);
+  nof_rejections = q->nof_rejections;
+  pthread_mutex_unlock(&q->mutex);
+  return nof_rejections;
+}
@@ -0,0 +1,41 @@
+#ifndef _TX_LEAD_TIME_H_
+#define _TX_LEAD_TIME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+// ************************** Definition of macros *****************************
+// Weight given to the most recent measurement of the TX lead time (i.e., encoding time) in its moving average.
+#define TX_LEAD_TIME_AVG_WEIGHT 0.1
+
+// Lead time in microseconds assumed until it is measured, instead of trusting the very first measurement.
+#define TX_LEAD_TIME_INITIAL 500.0
+
+// Maximum lead time in microseconds. Longer measurements (e.g., a burst delayed by the OS) are clamped to it.
+#define TX_LEAD_TIME_MAX 2000.0
+
+// *************************** Definition of types *****************************
+// Moving average of the time from popping a basic control until its first subframe is sent, used to reject the basic
+// controls that can not make their deadline. Every rejection lowers the estimate, so that an estimate that grew too
+// large lets basic controls in again and gets measured.
+typedef struct {
+  double avg;
+  uint64_t nof_rejections;
+  pthread_mutex_t mutex;
+} tx_lead_time_t;
+
+// *************************** Declaration of functions ***************************
+void tx_lead_time_init(tx_lead_time_t* const q);
+
+void tx_lead_time_free(tx_lead_time_t* const q);
+
+void tx_lead_time_update(tx_lead_time_t* const q, uint64_t lead_time);
+
+bool tx_lead_time_can_make_deadline(tx_lead_time_t* const q, uint64_t deadline, uint64_t now);
+
+double tx_lead_time_get(tx_lead_time_t* const q);
+
+uint64_t tx_lead_time_get_nof_rejections(tx_lead_time_t* const q);
+
+#endif // _TX_LEAD_TIME_H_
@@ -67,6 +67,10 @@
 
 #define CHEST_DL_ERROR(_fmt, ...) do { fprintf(stdout, "[CHEST DL ERROR]: " _fmt, __VA_ARGS__); } while(0)
 
+#define SRSLTE_CHEST_DL_DEFAULT_TRACK_MIN_GAIN 0.25
+
+#define SRSLTE_CHEST_DL_DEFAULT_TRACK_MAX_RESIDUAL 2.0
+
 typedef enum {
   SRSLTE_NOISE_ALG_REFS,
   SRSLTE_NOISE_ALG_PSS,
@@ -102,6 +106,17 @@ typedef struct {
 
   srslte_chest_dl_noise_alg_t noise_alg;
 
+  bool fused;
+
+  /* Burst-level tracking of the estimates, see srslte_chest_dl_set_burst_tracking() */
+  bool burst_tracking;
+  float track_min_gain;
+  float track_max_residual;
+  cf_t *track_pilots[SRSLTE_MAX_PORTS];
+  float track_noise[SRSLTE_MAX_PORTS];
+  cf_t *track_ce[SRSLTE_MAX_PORTS];
+  uint32_t track_count[SRSLTE_MAX_PORTS];
+
   bool cfo_estimate_from_csr_enable;
   cf_t *tmp_cfo_estimate;
   float cfo_csr;
@@ -131,6 +146,25 @@ SRSLTE_API void srslte_chest_dl_set_smooth_filter3_coeff(srslte_chest_dl_t* q,
 SRSLTE_API void srslte_chest_dl_set_noise_alg(srslte_chest_dl_t *q,
                                               srslte_chest_dl_noise_alg_t noise_estimation_alg);
 
+/* Selects whether the estimates of ports 0 and 1 are computed in a single pass (LS estimation, smoothing, noise
+ * estimation and frequency interpolation per pilot symbol, then time interpolation in one sweep) or in separate steps
+ * (default is single pass). The single pass is only available in AVX2 builds, for normal CP and the 3 tap smoothing
+ * filter; otherwise the separate steps are used. */
+SRSLTE_API void srslte_chest_dl_set_fused(srslte_chest_dl_t *q,
+                                          bool enable);
+
+/* Enables the tracking of the estimates across the subframes of a burst. The first subframe after
+ * srslte_chest_dl_start_burst() is fully estimated. The next ones only compute the LS estimates and average them with
+ * the tracked ones (with gain 1/(n+1), floored to min_gain) before interpolating, unless their residual power exceeds
+ * max_residual times the tracked noise, in which case the subframe is fully estimated again. The same ce buffers
+ * must be passed for the whole burst. */
+SRSLTE_API void srslte_chest_dl_set_burst_tracking(srslte_chest_dl_t *q,
+                                                   bool enable,
+                                                   float min_gain,
+                                                   float max_residual);
+
+SRSLTE_API void srslte_chest_dl_start_burst(srslte_chest_dl_t *q);
+
 SRSLTE_API int srslte_chest_dl_estimate(srslte_chest_dl_t *q,
                                         cf_t *input,
                                         cf_t *ce[SRSLTE_MAX_PORTS],
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <strings.h>
 #include <math.h>
+#include <pthread.h>
 
 #include "srslte/config.h"
 #include "srslte/channel/ch_awgn.h"
@@ -29,7 +30,8 @@
 
 #define ENABLE_CH_EMULATOR_PRINTS 1
 
-#define CH_EMULATOR_NOF_CHANNELS 2
+// One channel per PHY, its named pipe is only created when the PHY first uses it.
+#define CH_EMULATOR_MAX_NOF_CHANNELS MAX_NUM_CONCURRENT_PHYS
 
 #define CH_EMULATOR_NP_FILENAME_CH "/tmp/channel_emulator_np_ch"
 
@@ -62,7 +64,6 @@
 // *********** Definition of types ***********
 typedef struct {
   channel_cccf impairments;
-  srslte_cfo_t cfocorr;
   float cfo_freq;
   uint32_t fft_size;
   float noise_variance; // noise variance used with srsLTE library AWGN channel.
@@ -80,13 +81,17 @@ typedef struct {
 } channel_impairments_t;
 
 typedef struct {
+  bool is_open; // Set with release semantics once the pipes are open, send/recv read it without the lock.
   int wr_fd;
   int rd_fd;
   int nof_reads;
+  float cfo_phase; // Phase of the CFO at the next received sample, in cycles.
+  float last_snr; // SNR used to calculate the noise variance of this channel.
 } channel_t;
 
 typedef struct {
-  channel_t channels[CH_EMULATOR_NOF_CHANNELS];
+  channel_t channels[CH_EMULATOR_MAX_NOF_CHANNELS];
+  pthread_mutex_t channels_mutex;
   bool enable_channel_impairments;
   bool use_simple_awgn_channel;
   void (*set_channel_impairments_func_ptr)(void* h, bool flag);
@@ -108,6 +113,8 @@ SRSLTE_API int channel_emulator_initialization(channel_emulator_t* chann_emulato
 
 SRSLTE_API int channel_emulator_uninitialization(channel_emulator_t* chann_emulator);
 
+SRSLTE_API int channel_emulator_open_channel(channel_emulator_t* chann_emulator, uint32_t channel_id);
+
 SRSLTE_API int channel_emulator_create_named_pipe(uint32_t channel_id);
 
 SRSLTE_API int channel_emulator_get_named_pipe_for_writing(uint32_t channel_id);
@@ -47,6 +47,22 @@ typedef struct SRSLTE_API {
   uint32_t len;
 } srslte_sequence_t;
 
+/* LRU cache of sequences, so switching back and forth between a few RNTIs or bit lengths does not regenerate them.
+ * Not thread safe. */
+typedef struct SRSLTE_API {
+  srslte_sequence_t seq;
+  uint32_t seed;
+  uint64_t last_used;
+  bool valid;
+} srslte_sequence_cache_entry_t;
+
+typedef struct SRSLTE_API {
+  srslte_sequence_cache_entry_t *entries;
+  uint32_t nof_entries;
+  uint64_t nof_lookups;
+  uint64_t nof_hits;
+} srslte_sequence_cache_t;
+
 SRSLTE_API int srslte_sequence_init(srslte_sequence_t *q, uint32_t len);
 
 SRSLTE_API void srslte_sequence_free(srslte_sequence_t *q);
@@ -58,6 +74,17 @@ SRSLTE_API int srslte_sequence_LTE_pr(srslte_sequence_t *q,
 SRSLTE_API void srslte_sequence_set_LTE_pr(srslte_sequence_t *q,
                                            uint32_t seed);
 
+SRSLTE_API int srslte_sequence_cache_init(srslte_sequence_cache_t *q,
+                                          uint32_t nof_entries);
+
+SRSLTE_API void srslte_sequence_cache_free(srslte_sequence_cache_t *q);
+
+/* Returns a sequence of at least len bits for seed, generating it in place of the least recently used one if it is
+ * not in the cache. The pointer is valid until the next call. */
+SRSLTE_API srslte_sequence_t *srslte_sequence_cache_get(srslte_sequence_cache_t *q,
+                                                       uint32_t seed,
+                                                       uint32_t len);
+
 SRSLTE_API int srslte_sequence_pbch(srslte_sequence_t *seq,
                                     srslte_cp_t cp,
                                     uint32_t cell_id);
@@ -82,6 +109,13 @@ SRSLTE_API int srslte_sequence_pdsch(srslte_sequence_t *seq,
                                      uint32_t cell_id,
                                      uint32_t len);
 
+SRSLTE_API srslte_sequence_t *srslte_sequence_cache_pdsch(srslte_sequence_cache_t *cache,
+                                                         uint16_t rnti,
+                                                         int q,
+                                                         uint32_t nslot,
+                                                         uint32_t cell_id,
+                                                         uint32_t len);
+
 SRSLTE_API int srslte_sequence_pusch(srslte_sequence_t *seq,
                                      uint16_t rnti,
                                      uint32_t nslot,
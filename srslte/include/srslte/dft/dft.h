@@ -57,6 +57,27 @@ typedef enum {
   SRSLTE_DFT_FORWARD, SRSLTE_DFT_BACKWARD
 } srslte_dft_dir_t;
 
+/* Planner effort, from quickest planning to fastest plans (FFTW_ESTIMATE to FFTW_EXHAUSTIVE) */
+typedef enum {
+  SRSLTE_DFT_ESTIMATE, SRSLTE_DFT_MEASURE, SRSLTE_DFT_PATIENT, SRSLTE_DFT_EXHAUSTIVE
+} srslte_dft_effort_t;
+
+/* Layout of a batch of transforms: nof_blocks blocks of howmany transforms each. Transform j of block i reads
+ * dft_points samples from in[in_offset + i*in_block_dist + j*in_dist] and writes them to out[out_offset +
+ * i*out_block_dist + j*out_dist]. in_len and out_len are the lengths of the whole input and output buffers. */
+typedef struct SRSLTE_API {
+  int howmany;
+  int nof_blocks;
+  int in_offset;
+  int in_dist;
+  int in_block_dist;
+  int in_len;
+  int out_offset;
+  int out_dist;
+  int out_block_dist;
+  int out_len;
+} srslte_dft_batch_t;
+
 typedef struct SRSLTE_API {
   int size;           // DFT length
   void *in;           // Input buffer
@@ -69,6 +90,7 @@ typedef struct SRSLTE_API {
   bool dc;            // Handle insertion/removal of null DC carrier internally?
   srslte_dft_dir_t dir;     // Forward/Backward
   srslte_dft_mode_t mode;   // Complex/Real
+  srslte_dft_batch_t batch; // Layout of batched plans
 } srslte_dft_plan_t;
 
 /* Create DFT plans */
@@ -86,8 +108,26 @@ SRSLTE_API int srslte_dft_plan_r(srslte_dft_plan_t* const plan,
                                  int dft_points,
                                  srslte_dft_dir_t dir);
 
+/* Plans all the transforms of a batch as a single FFTW plan. The in and out buffers of the plan are allocated with
+ * the batch lengths. The mirror, db, norm and dc options do not apply to batched plans. */
+SRSLTE_API int srslte_dft_plan_batch_c(srslte_dft_plan_t* const plan,
+                                       int dft_points,
+                                       const srslte_dft_batch_t *batch,
+                                       srslte_dft_dir_t dir);
+
 SRSLTE_API void srslte_dft_plan_free(srslte_dft_plan_t* const plan);
 
+/* FFTW wisdom, shared by all the plans of the process. Plans whose transform is in the wisdom are created without
+ * measuring it again, so loading the wisdom saved by a previous run (or by the fftw_wisdom tool) speeds up the
+ * initialization and the bandwidth changes. Both return 0 on success. */
+
+SRSLTE_API int srslte_dft_load(const char *wisdom_filename);
+
+SRSLTE_API int srslte_dft_save(const char *wisdom_filename);
+
+/* Planner effort of the plans created afterwards (default is SRSLTE_DFT_MEASURE) */
+SRSLTE_API void srslte_dft_set_effort(srslte_dft_effort_t effort);
+
 /* Set options */
 
 SRSLTE_API void srslte_dft_plan_set_mirror(srslte_dft_plan_t* const plan,
@@ -116,6 +156,12 @@ SRSLTE_API void srslte_dft_run_c(srslte_dft_plan_t* const plan,
                                  cf_t *in,
                                  cf_t *out);
 
+/* Runs a batched plan. Buffers with the same alignment as the plan buffers are transformed in place, otherwise they
+ * are staged through the plan buffers. */
+SRSLTE_API void srslte_dft_run_batch_c(srslte_dft_plan_t* const plan,
+                                       cf_t *in,
+                                       cf_t *out);
+
 SRSLTE_API void srslte_dft_run_r(srslte_dft_plan_t* const plan,
                                  float *in,
                                  float *out);
@@ -56,6 +56,9 @@ typedef struct SRSLTE_API{
 
   bool freq_shift;
   cf_t *shift_buffer;
+
+  bool batch;
+  srslte_dft_plan_t batch_plan; // All the symbols of a subframe in one plan
 }srslte_ofdm_t;
 
 SRSLTE_API int srslte_ofdm_init_(srslte_ofdm_t *q,
@@ -98,4 +101,10 @@ SRSLTE_API int srslte_ofdm_set_freq_shift(srslte_ofdm_t *q,
 SRSLTE_API void srslte_ofdm_set_normalize(srslte_ofdm_t *q,
                                          bool normalize_enable);
 
+/* Selects how srslte_ofdm_rx_sf() and srslte_ofdm_tx_sf() transform the subframe: with one batched plan for all its
+ * symbols, which skips the CPs with the plan strides and applies the frequency shift and the normalization while
+ * mapping the subcarriers (default), or symbol by symbol. */
+SRSLTE_API void srslte_ofdm_set_batch(srslte_ofdm_t *q,
+                                      bool batch_enable);
+
 #endif
@@ -39,9 +39,24 @@
 
 #include "srslte/config.h"
 #include <stdint.h>
+#include <stdbool.h>
+
+/* Engines used by srslte_crc_checksum_byte() and srslte_crc_checksum(). The streaming functions
+ * (srslte_crc_checksum_put_byte) always use the byte-wise table. */
+typedef enum SRSLTE_API {
+  SRSLTE_CRC_ENGINE_AUTO = 0,  // Fastest one supported by the CPU
+  SRSLTE_CRC_ENGINE_TABLE,     // Byte-wise table (reference)
+  SRSLTE_CRC_ENGINE_SLICE8,    // Slicing-by-8 tables
+  SRSLTE_CRC_ENGINE_PCLMUL,    // Carry-less multiplication folding, falls back to slicing-by-8 for short inputs
+} srslte_crc_engine_type_t;
+
+// Tables and constants of a polynomial, built once and shared (read only) by all the CRC instances.
+struct srslte_crc_engine;
 
 typedef struct SRSLTE_API {
   uint64_t table[256];
+  const struct srslte_crc_engine *engine;
+  srslte_crc_engine_type_t engine_type;
   int polynom;
   int order;
   uint64_t crcinit; 
@@ -54,6 +69,11 @@ SRSLTE_API int srslte_crc_init(srslte_crc_t *h,
                                uint32_t srslte_crc_poly, 
                                int srslte_crc_order);
 
+SRSLTE_API int srslte_crc_set_engine(srslte_crc_t *h,
+                                     srslte_crc_engine_type_t engine_type);
+
+SRSLTE_API bool srslte_crc_engine_supported(srslte_crc_engine_type_t engine_type);
+
 SRSLTE_API int srslte_crc_set_init(srslte_crc_t *h, 
                                    uint64_t init_value);
 
@@ -56,12 +56,18 @@ SRSLTE_API int srslte_rm_turbo_tx(uint8_t *w_buff,
                                   uint32_t out_len,
                                   uint32_t rv_idx);
 
-SRSLTE_API void srslte_rm_turbo_gentables(uint32_t phy_idx);
+/* The LUT tables are shared by all the users (PHYs) in the process. Every srslte_rm_turbo_gentables() call must be
+ * matched by a srslte_rm_turbo_free_tables() call, the tables are released with the last one. */
+SRSLTE_API void srslte_rm_turbo_gentables();
 
-SRSLTE_API void srslte_rm_turbo_free_tables(uint32_t phy_idx);
+SRSLTE_API void srslte_rm_turbo_free_tables();
 
-SRSLTE_API int srslte_rm_turbo_tx_lut(uint32_t phy_idx,
-                                      uint8_t *w_buff,
+SRSLTE_API int srslte_rm_turbo_tx_interleave_lut(uint8_t *w_buff,
+                                                 uint8_t *systematic,
+                                                 uint8_t *parity,
+                                                 uint32_t cb_idx);
+
+SRSLTE_API int srslte_rm_turbo_tx_lut(uint8_t *w_buff,
                                       uint8_t *systematic,
                                       uint8_t *parity,
                                       uint8_t *output,
@@ -79,23 +85,20 @@ SRSLTE_API int srslte_rm_turbo_rx(float *w_buff,
                                   uint32_t rv_idx,
                                   uint32_t nof_filler_bits);
 
-SRSLTE_API int srslte_rm_turbo_rx_lut(uint32_t phy_idx,
-                                      int16_t *input,
+SRSLTE_API int srslte_rm_turbo_rx_lut(int16_t *input,
                                       int16_t *output,
                                       uint32_t in_len,
                                       uint32_t cb_idx,
                                       uint32_t rv_idx);
 
-SRSLTE_API int srslte_rm_turbo_rx_lut_(uint32_t phy_idx,
-                                       int16_t *input,
+SRSLTE_API int srslte_rm_turbo_rx_lut_(int16_t *input,
                                        int16_t *output,
                                        uint32_t in_len,
                                        uint32_t cb_idx,
                                        uint32_t rv_idx,
                                        bool enable_input_tdec);
 
-SRSLTE_API int srslte_rm_turbo_rx_lut_8bit(uint32_t phy_idx,
-                                           int8_t *input,
+SRSLTE_API int srslte_rm_turbo_rx_lut_8bit(int8_t *input,
                                            int8_t *output,
                                            uint32_t in_len,
                                            uint32_t cb_idx,
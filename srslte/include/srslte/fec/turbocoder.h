@@ -49,7 +49,6 @@
 #endif
 
 typedef struct SRSLTE_API {
-  uint32_t phy_idx;
   uint32_t max_long_cb;
   uint8_t *temp;
 } srslte_tcod_t;
@@ -61,10 +60,6 @@ typedef struct SRSLTE_API {
  */
 
 
- SRSLTE_API int srslte_tcod_init_generic(srslte_tcod_t *h,
-                                         uint32_t max_long_cb,
-                                         uint32_t phy_idx);
-
 SRSLTE_API int srslte_tcod_init(srslte_tcod_t *h,
                                 uint32_t max_long_cb);
 
@@ -83,6 +78,7 @@ SRSLTE_API int srslte_tcod_encode_lut(srslte_tcod_t *h,
                                       uint32_t cblen_idx,
                                       bool last_cb);
 
-SRSLTE_API void srslte_tcod_gentable(uint32_t phy_idx);
+/* Builds the shared tables, called by the first srslte_tcod_init() */
+SRSLTE_API void srslte_tcod_gentable();
 
 #endif
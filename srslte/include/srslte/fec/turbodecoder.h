@@ -60,8 +60,17 @@
 #include "srslte/fec/turbodecoder_impl.h"
 #undef LLR_IS_16BIT
 
-#define SRSLTE_TDEC_NOF_AUTO_MODES_8  2
-#define SRSLTE_TDEC_NOF_AUTO_MODES_16 3
+// The AVX-512BW window decoder is built whenever the compiler can target it and is selected at runtime,
+// only on CPUs that support AVX-512BW.
+#if defined(LV_HAVE_AVX512) || (defined(LV_HAVE_AVX2) && defined(__GNUC__) && !defined(__clang__))
+#define SRSLTE_TDEC_HAVE_AVX512
+#endif
+
+#define SRSLTE_TDEC_NOF_AUTO_MODES_8  3
+#define SRSLTE_TDEC_NOF_AUTO_MODES_16 4
+
+// One interleaver for each possible nof_subblocks (1, 8, 16, 32 or 64)
+#define SRSLTE_TDEC_NOF_INTERLEAVERS  5
 
 typedef enum {SRSLTE_TDEC_8, SRSLTE_TDEC_16} srslte_tdec_llr_type_t;
 
@@ -95,7 +104,7 @@ typedef struct SRSLTE_API {
   uint32_t current_long_cb;
   uint32_t current_inter_idx;
   int current_cbidx;
-  srslte_tc_interl_t interleaver[4][SRSLTE_NOF_TC_CB_SIZES];
+  srslte_tc_interl_t interleaver[SRSLTE_TDEC_NOF_INTERLEAVERS][SRSLTE_NOF_TC_CB_SIZES];
   int n_iter;
 } srslte_tdec_t;
 
@@ -119,6 +128,8 @@ SRSLTE_API uint32_t srslte_tdec_autoimp_get_subblocks(uint32_t long_cb);
 
 SRSLTE_API uint32_t srslte_tdec_autoimp_get_subblocks_8bit(uint32_t long_cb);
 
+SRSLTE_API bool srslte_tdec_avx512_supported();
+
 SRSLTE_API void srslte_tdec_iteration(srslte_tdec_t * h, 
                                       int16_t* input, 
                                       uint8_t *output);
@@ -39,6 +39,8 @@ typedef enum SRSLTE_API {
   SRSLTE_TDEC_AVX_WINDOW,
   SRSLTE_TDEC_SSE8_WINDOW,
   SRSLTE_TDEC_AVX8_WINDOW,
+  SRSLTE_TDEC_AVX512_WINDOW,
+  SRSLTE_TDEC_AVX512_8_WINDOW,
   SRSLTE_TDEC_NOF_IMP
 } srslte_tdec_impl_type_t;
 
@@ -178,6 +178,74 @@
   }
 
 
+#else
+#ifdef WINIMP_IS_AVX512_16
+
+  #ifndef SRSLTE_TDEC_HAVE_AVX512
+  #error "Selected AVX-512 window decoder but instruction set not supported"
+  #endif
+
+  #include <immintrin.h>
+
+  #define WINIMP avx512_16
+  #define nof_blocks 32
+
+  #define llr_t int16_t
+
+  #define simd_type_t  __m512i
+  #define simd_load    _mm512_loadu_si512
+  #define simd_store   _mm512_storeu_si512
+  #define simd_add     _mm512_adds_epi16
+  #define simd_sub     _mm512_subs_epi16
+  #define simd_max     _mm512_max_epi16
+  #define simd_set1    _mm512_set1_epi16
+  #define simd_insert(v, x, pos) _mm512_mask_set1_epi16(v, ((__mmask32) 1) << (pos), x)
+  #define extract_input_scalar
+
+  #define normalize_period 2
+  #define win_overlap_len  40
+
+  #define INF 10000
+
+#else
+#ifdef WINIMP_IS_AVX512_8
+
+  #ifndef SRSLTE_TDEC_HAVE_AVX512
+  #error "Selected AVX-512 window decoder but instruction set not supported"
+  #endif
+
+  #include <immintrin.h>
+
+  #define WINIMP avx512_8
+  #define nof_blocks 64
+
+  #define llr_t int8_t
+
+  #define simd_type_t  __m512i
+  #define simd_load    _mm512_loadu_si512
+  #define simd_store   _mm512_storeu_si512
+  #define simd_add     _mm512_adds_epi8
+  #define simd_sub     _mm512_subs_epi8
+  #define simd_max     _mm512_max_epi8
+  #define simd_set1    _mm512_set1_epi8
+  #define simd_insert(v, x, pos) _mm512_mask_set1_epi8(v, ((__mmask64) 1) << (pos), x)
+  #define extract_input_scalar
+  #define simd_rb_shift simd_rb_shift_512
+
+  #define INF 0
+
+  #define normalize_max
+  #define normalize_period 1
+  #define win_overlap_len  40
+  #define use_saturated_add
+  #define divide_output 1
+
+  inline static simd_type_t simd_rb_shift_512(simd_type_t v, const int l) {
+    __m512i low = _mm512_srai_epi16(_mm512_slli_epi16(v,8), l+8);
+    __m512i hi  = _mm512_srai_epi16(v,l);
+    return _mm512_mask_blend_epi8(0x5555555555555555ULL, hi, low);
+  }
+
 #else
 #ifdef WINIMP_IS_NEON16
   #include <arm_neon.h>
@@ -277,6 +345,27 @@ inline static uint8x16_t v_load_s8(int i15, int i14, int i13, int i12, int i11,
 #endif
 #endif
 #endif
+#endif
+#endif
+
+#if defined(WINIMP_IS_AVX512_16) || defined(WINIMP_IS_AVX512_8)
+  /* Sub-block shifts cross the 128-bit lanes, so they are done with alignr instead of a byte shuffle */
+  inline static simd_type_t MAKE_FUNC(move_right)(simd_type_t v) {
+    __m512i next = _mm512_alignr_epi32(_mm512_setzero_si512(), v, 4);
+    return _mm512_alignr_epi8(next, v, sizeof(llr_t));
+  }
+
+  inline static simd_type_t MAKE_FUNC(move_left)(simd_type_t v) {
+    __m512i prev = _mm512_alignr_epi32(v, _mm512_setzero_si512(), 12);
+    return _mm512_alignr_epi8(v, prev, 16 - sizeof(llr_t));
+  }
+
+  #define simd_move_right(v) MAKE_FUNC(move_right)(v)
+  #define simd_move_left(v)  MAKE_FUNC(move_left)(v)
+#else
+  #define simd_move_right(v) simd_shuffle(v, move_right)
+  #define simd_move_left(v)  simd_shuffle(v, move_left)
+#endif
 
 typedef struct SRSLTE_API {
   uint32_t max_long_cb;
@@ -410,6 +499,11 @@ static void MAKE_FUNC(beta)(MAKE_TYPE * s, llr_t *input, llr_t *app, llr_t *pari
   simd_type_t *parityPtr;
   simd_type_t *betaPtr   = (simd_type_t*) s->beta;
 
+  // When estimating states (first run), all states are unknown
+  for (int i = 0; i < 8; i++) {
+    old[i] = simd_set1(-INF);
+  }
+
   uint32_t loop_len;
   for (int j=0;j<2;j++) {
 
@@ -438,7 +532,7 @@ static void MAKE_FUNC(beta)(MAKE_TYPE * s, llr_t *input, llr_t *app, llr_t *pari
 #endif
 
       for (int i = 0; i < 8; i++) {
-        old[i] = simd_shuffle(old[i], move_right);
+        old[i] = simd_move_right(old[i]);
       }
       // last sub-block state is calculated from the trellis
       llr_t trellis_old[8];
@@ -467,10 +561,6 @@ static void MAKE_FUNC(beta)(MAKE_TYPE * s, llr_t *input, llr_t *app, llr_t *pari
       }
 
     } else {
-      // when estimating states, just set all to unknown
-      for (int i = 0; i < 8; i++) {
-        old[i] = simd_set1(-INF);
-      }
       inputPtr  = (simd_type_t*) &input[nof_blocks*(loop_len-1)];
       appPtr    = (simd_type_t*) &app[nof_blocks*(loop_len-1)];
       parityPtr = (simd_type_t*) &parity[nof_blocks*(loop_len-1)];
@@ -547,6 +637,11 @@ static void MAKE_FUNC(alpha)(MAKE_TYPE * s, llr_t *input, llr_t *app, llr_t *par
   // Skip state 0
   betaPtr+=8;
 
+  // When estimating states (first run), all states are unknown
+  for (int i = 0; i < 8; i++) {
+    old[i] = simd_set1(-INF);
+  }
+
   uint32_t loop_len;
 
   for (int j=0;j<2;j++) {
@@ -574,7 +669,7 @@ static void MAKE_FUNC(alpha)(MAKE_TYPE * s, llr_t *input, llr_t *app, llr_t *par
       }
 #endif
       for (int i = 0; i < 8; i++) {
-        old[i] = simd_shuffle(old[i], move_left);
+        old[i] = simd_move_left(old[i]);
       }
 #ifdef WINIMP_IS_AVX16
       for (int i=0;i<8;i++) {
@@ -591,11 +686,6 @@ static void MAKE_FUNC(alpha)(MAKE_TYPE * s, llr_t *input, llr_t *app, llr_t *par
       for (int i = 1; i < 8; i++) {
         old[i] = simd_insert(old[i], -INF, 0);
       }
-    } else {
-      // when estimating states, just set all to unknown
-      for (int i = 0; i < 8; i++) {
-        old[i] = simd_set1(-INF);
-      }
     }
 
     inputPtr  = (simd_type_t*) &input[nof_blocks*(long_sb-loop_len)];
@@ -726,11 +816,22 @@ void MAKE_FUNC(dec)(void *hh, llr_t *input, llr_t *app, llr_t *parity, llr_t *ou
 
 void MAKE_FUNC(extract_input)(llr_t *input, llr_t *systematic, llr_t *app2, llr_t *parity_0, llr_t *parity_1, uint32_t long_cb)
 {
+#ifdef extract_input_scalar
+  // Inserting one lane at a time in a 512-bit register is slower than plain scalar copies
+  for (int b=0;b<nof_blocks;b++) {
+    for (int i=0;i<long_sb;i++) {
+      systematic[i*nof_blocks+b] = input[3*(i+b*long_sb)+0];
+      parity_0[i*nof_blocks+b]   = input[3*(i+b*long_sb)+1];
+      parity_1[i*nof_blocks+b]   = input[3*(i+b*long_sb)+2];
+    }
+  }
+#else
   simd_type_t *systPtr    = (simd_type_t*) systematic;
   simd_type_t *parity0Ptr = (simd_type_t*) parity_0;
   simd_type_t *parity1Ptr = (simd_type_t*) parity_1;
 
-  simd_type_t syst, parity0, parity1;
+  // All lanes are inserted below, zeroing only tells the compiler the registers are initialized
+  simd_type_t syst = simd_set1(0), parity0 = simd_set1(0), parity1 = simd_set1(0);
 
   for (int i=0;i<long_sb;i++) {
     INSERT8_INPUT(syst,    0, 0);
@@ -756,6 +857,7 @@ void MAKE_FUNC(extract_input)(llr_t *input, llr_t *systematic, llr_t *app2, llr_
     simd_store(parity0Ptr++, parity0);
     simd_store(parity1Ptr++, parity1);
   }
+#endif
 
   for (int i = long_cb; i < long_cb + 3; i++) {
     systematic[i] = input[3*long_cb + 2*(i - long_cb)];
@@ -819,10 +921,10 @@ void MAKE_FUNC(decision_byte)(llr_t *app1, uint8_t *output, uint32_t long_cb)
 #ifdef WINIMP_IS_NEON16
   int8_t z = 0;
   int8x16_t zeros =  vld1q_dup_s8(&z);
-  int16x8_t ap;
+  int16x8_t ap = vdupq_n_s16(0);
 #else
   __m128i zeros = _mm_setzero_si128();
-  __m128i ap;
+  __m128i ap = _mm_setzero_si128();
 #endif
   if ((long_cb%(nof_blocks*8)) == 0) {
     decide_for(8);
@@ -850,10 +952,21 @@ void MAKE_FUNC(decision_byte)(llr_t *app1, uint8_t *output, uint32_t long_cb)
 #undef simd_max
 #undef simd_set1
 #undef simd_insert
+#undef simd_move_right
+#undef simd_move_left
+#undef debug_enabled_win
+
+#ifdef simd_shuffle
 #undef simd_shuffle
+#endif
+
+#ifdef move_right
 #undef move_right
+#endif
+
+#ifdef move_left
 #undef move_left
-#undef debug_enabled_win
+#endif
 
 #ifdef normalize_max
 #undef normalize_max
@@ -869,4 +982,8 @@ void MAKE_FUNC(decision_byte)(llr_t *app1, uint8_t *output, uint32_t long_cb)
 
 #ifdef divide_output
 #undef divide_output
+#endif
+
+#ifdef extract_input_scalar
+#undef extract_input_scalar
 #endif
\ No newline at end of file
@@ -24,8 +24,9 @@
 #define ENABLE_CTRL_RES_HARVESTING 1
 #define ENABLE_GUARD_BAND_HARVESTING 1
 
-// Maximum alowed number of Physical Radios that can be used to create PHYS.
-#define MAX_NUM_CONCURRENT_PHYS 2
+// Maximum alowed number of PHYs. The number of PHYs actually created is set at run time (trx -E) and their
+// resources are only allocated for the PHYs in use, so this only bounds the PHY IDs.
+#define MAX_NUM_CONCURRENT_PHYS 8
 
 typedef enum {PHY_UNKNOWN_ST=0, PHY_RX_ST=1, PHY_TX_ST=2} trx_flag_e;
 
@@ -57,6 +58,8 @@ typedef struct {
   int32_t gain; 		                  // tx or rx gain. dB. For rx, -1 means AGC mode.
   double rf_boost;                    // RF boost amplification
   uint32_t length;                    // During TX state, it indicates number of bytes after this header. It must be an integer times the TB size. During RX indicates number of expected slots to be received.
+  uint32_t harq_pid;                  // HARQ process of the first TB, the following TBs use the next processes. Retransmissions of a TB must use the same process.
+  uint32_t retx_cnt;                  // Retransmission counter of the TBs, 0 means new data. It selects the redundancy version. During RX it is only used when PDCCH is not decoded.
   uchar *data;                        // Data to be transmitted.
 } basic_ctrl_t;
 
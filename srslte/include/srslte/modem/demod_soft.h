@@ -28,7 +28,7 @@
  *  File:         demod_soft.h
  *
  *  Description:  Soft demodulator.
- *                Supports BPSK, QPSK, 16QAM and 64QAM.
+ *                Supports BPSK, QPSK, 16QAM, 64QAM and 256QAM.
  *
  *  Reference:    3GPP TS 36.211 version 10.0.0 Release 10 Sec. 7.1
  *****************************************************************************/
@@ -42,6 +42,11 @@
 #include "srslte/config.h"
 #include "modem_table.h"
 
+// Scaling of the 16-bit LLRs. Also used by the fused PDSCH receiver, which must compute the same LLRs.
+#define SCALE_SHORT_CONV_QPSK  100
+#define SCALE_SHORT_CONV_QAM16 400
+#define SCALE_SHORT_CONV_QAM64 700
+#define SCALE_SHORT_CONV_QAM256 1000
 
 SRSLTE_API int srslte_demod_soft_demodulate(srslte_mod_t modulation, 
                                             const cf_t* symbols, 
@@ -28,7 +28,7 @@
  *  File:         modem_table.h
  *
  *  Description:  Modem tables used for modulation/demodulation.
- *                Supports BPSK, QPSK, 16QAM and 64QAM.
+ *                Supports BPSK, QPSK, 16QAM, 64QAM and 256QAM.
  *
  *  Reference:    3GPP TS 36.211 version 10.0.0 Release 10 Sec. 7.1
  *****************************************************************************/
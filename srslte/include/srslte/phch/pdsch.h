@@ -60,6 +60,8 @@
 #include "srslte/phch/sch.h"
 #include "srslte/phch/pdsch_cfg.h"
 
+#define SRSLTE_PDSCH_SEQ_CACHE_LEN 8
+
 /* PDSCH object */
 typedef struct SRSLTE_API {
   srslte_cell_t cell;
@@ -82,7 +84,7 @@ typedef struct SRSLTE_API {
    float *csi;             /* Channel Strengh Indicator */
 
   /* tx & rx objects */
-  srslte_modem_table_t mod[4];
+  srslte_modem_table_t mod[5];
 
   srslte_sequence_t seq[SRSLTE_NSUBFRAMES_X_FRAME];
 
@@ -91,10 +93,19 @@ typedef struct SRSLTE_API {
   srslte_sequence_t *seq_multi[SRSLTE_NSUBFRAMES_X_FRAME];
   uint16_t *rnti_multi;
 
+  // Sequences for RNTIs other than the one set with srslte_pdsch_set_rnti().
+  srslte_sequence_cache_t seq_cache;
+
   srslte_sch_t dl_sch;
 
   bool add_sch_to_front;
 
+  // Fused receiver: grid positions of the PDSCH REs for the last grant received in each subframe.
+  bool fused_rx;
+  uint32_t *re_map[SRSLTE_NSUBFRAMES_X_FRAME];
+  uint32_t re_map_len[SRSLTE_NSUBFRAMES_X_FRAME];
+  bool re_map_prb_idx[SRSLTE_NSUBFRAMES_X_FRAME][2][SRSLTE_MAX_PRB];
+
 } srslte_pdsch_t;
 
 SRSLTE_API int srslte_pdsch_init_generic(srslte_pdsch_t *q,
@@ -205,6 +216,11 @@ SRSLTE_API int srslte_pdsch_decode_rnti_scatter(srslte_pdsch_t *q,
                                                 cf_t *sf_symbols, cf_t *ce[SRSLTE_MAX_PORTS], float noise_estimate,
                                                 uint16_t rnti, uint8_t *data);
 
+/* Selects whether srslte_pdsch_decode_rnti_scatter() equalizes, demodulates and descrambles the REs in a single pass
+ * over the resource grid (default) or in separate steps. Both compute the same LLRs. The single pass is only available
+ * in AVX2 builds and for one antenna port. */
+SRSLTE_API void srslte_pdsch_set_fused_rx(srslte_pdsch_t *q, bool enable);
+
 SRSLTE_API int srslte_pdsch_get_scatter(srslte_pdsch_t *q, cf_t *sf_symbols, cf_t *symbols, srslte_ra_dl_grant_t *grant, uint32_t subframe, bool add_sch_to_front);
 
 
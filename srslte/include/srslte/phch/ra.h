@@ -108,6 +108,13 @@ typedef struct SRSLTE_API {
   srslte_ra_mcs_t mcs2;
 } srslte_ra_dl_grant_t;
 
+/** MCS table used to map the MCS index into modulation and TBS. It is configured
+ * by higher layers and is not signalled in the DCI. */
+typedef enum SRSLTE_API {
+  SRSLTE_RA_DL_MCS_TABLE_64QAM = 0,
+  SRSLTE_RA_DL_MCS_TABLE_256QAM
+} srslte_ra_dl_mcs_table_t;
+
 /** Unpacked DCI message for DL grant */
 typedef struct SRSLTE_API {
 
@@ -136,6 +143,8 @@ typedef struct SRSLTE_API {
 
   bool     dci_is_1a;
   bool     dci_is_1c;
+
+  srslte_ra_dl_mcs_table_t mcs_table;
 } srslte_ra_dl_dci_t;
 
 
@@ -284,8 +293,16 @@ SRSLTE_API int dl_dci_to_grant_mcs_scatter(srslte_ra_dl_dci_t *dci, srslte_ra_dl
 
 SRSLTE_API int dl_fill_ra_mcs_scatter(srslte_ra_mcs_t *mcs, uint32_t nprb);
 
+SRSLTE_API int dl_fill_ra_mcs_256qam_scatter(srslte_ra_mcs_t *mcs, uint32_t nprb);
+
 SRSLTE_API int srslte_ra_tbs_from_idx_scatter(uint32_t tbs_idx, uint32_t n_prb);
 
+SRSLTE_API int srslte_ra_tbs_from_idx_256qam_scatter(uint32_t mcs_idx, uint32_t n_prb);
+
+SRSLTE_API int srslte_ra_max_tbs_scatter(uint32_t n_prb);
+
+SRSLTE_API uint32_t srslte_ra_max_mcs_scatter(srslte_ra_dl_mcs_table_t mcs_table);
+
 SRSLTE_API void srslte_ra_dl_grant_to_nbits_scatter(srslte_ra_dl_grant_t *grant, bool add_sch_to_front, uint32_t eob_pss_len, srslte_cell_t cell, uint32_t sf_idx, srslte_ra_nbits_t *nbits);
 
 SRSLTE_API uint32_t srslte_ra_dl_grant_nof_re_scatter(srslte_ra_dl_grant_t *grant, bool add_sch_to_front, uint32_t eob_pss_len, srslte_cell_t cell, uint32_t sf_idx);
@@ -294,4 +311,11 @@ SRSLTE_API uint32_t ra_re_x_prb_scatter(uint32_t subframe, uint32_t slot, uint32
 
 SRSLTE_API uint32_t srslte_ra_get_tb_size_scatter(uint32_t prb, uint32_t mcs);
 
+SRSLTE_API uint32_t srslte_ra_get_tb_size_mcs_table_scatter(srslte_ra_dl_mcs_table_t mcs_table, uint32_t prb, uint32_t mcs);
+
+// The DCI carries a 3-bit HARQ process number.
+#define SRSLTE_RA_NOF_HARQ_PROCESSES_SCATTER 8
+
+SRSLTE_API uint32_t srslte_ra_rvidx_scatter(uint32_t retx_cnt);
+
 #endif /* RB_ALLOC_H_ */
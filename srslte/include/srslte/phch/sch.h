@@ -44,6 +44,7 @@
 #include "srslte/phch/pdsch_cfg.h"
 #include "srslte/phch/pusch_cfg.h"
 #include "srslte/phch/uci.h"
+#include "srslte/utils/worker_team.h"
 
 #define ENABLE_SCH_PRINTS 0
 
@@ -66,6 +67,15 @@
 #define SRSLTE_TX_NULL 100
 #endif
 
+/* Scratch memory of one code block encoding worker */
+typedef struct SRSLTE_API {
+  srslte_tcod_t encoder;
+  srslte_crc_t crc_tb;
+  srslte_crc_t crc_cb;
+  uint8_t *cb_in;
+  uint8_t *parity_bits;
+} srslte_sch_encode_worker_t;
+
 /* DL-SCH AND UL-SCH common functions */
 typedef struct SRSLTE_API {
 
@@ -91,6 +101,15 @@ typedef struct SRSLTE_API {
 
   srslte_uci_cqi_pusch_t uci_cqi;
 
+  // Code block parallel encoding, disabled (NULL) unless srslte_sch_set_encode_workers() is called.
+  srslte_worker_team_t *encode_team;
+  srslte_sch_encode_worker_t *encode_workers;
+  uint32_t nof_encode_workers;
+  uint8_t *encode_stage;
+
+  // Set while this instance holds a reference to the shared rate matching tables.
+  bool rm_tables_acquired;
+
   // Some error counters.
   uint64_t filler_bits_error;
   uint64_t nof_cbs_exceeds_softbuffer_size_error;
@@ -114,6 +133,11 @@ SRSLTE_API void srslte_sch_set_max_noi(srslte_sch_t *q,
 
 SRSLTE_API float srslte_sch_average_noi(srslte_sch_t *q);
 
+/* Encode the code blocks of a transport block concurrently on nof_workers threads (including the caller).
+ * 0 or 1 goes back to serial encoding. The output is bit exact with the serial encoder. */
+SRSLTE_API int srslte_sch_set_encode_workers(srslte_sch_t *q,
+                                             uint32_t nof_workers);
+
 SRSLTE_API uint32_t srslte_sch_last_noi(srslte_sch_t *q);
 
 SRSLTE_API int srslte_dlsch_encode(srslte_sch_t *q,
@@ -0,0 +1,109 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         channelizer.h
+ *
+ *  Description:  Critically sampled polyphase filter banks. The channelizer
+ *                splits a wideband stream sampled at Fs into nof_channels
+ *                streams sampled at Fs/nof_channels, channel k being centered
+ *                at k*Fs/nof_channels (k > nof_channels/2 are the negative
+ *                frequencies). The synthesizer does the opposite, combining
+ *                nof_channels streams into one wideband stream.
+ *
+ *  Reference:    Multirate Signal Processing for Communication Systems
+ *                fredric j. harris
+ *****************************************************************************/
+
+#ifndef CHANNELIZER_
+#define CHANNELIZER_
+
+#include <stdint.h>
+#include <complex.h>
+
+#include "srslte/config.h"
+#include "srslte/dft/dft.h"
+
+#define SRSLTE_CHANNELIZER_DEFAULT_TAPS 16 // Taps per polyphase branch
+
+typedef struct SRSLTE_API {
+  uint32_t nof_channels;      // Number of channels, also the decimation factor
+  uint32_t nof_taps;          // Taps per polyphase branch
+  uint32_t max_nof_blocks;    // Maximum number of output samples per channel and call
+  float *taps;                // Prototype filter, row p holds h[p*nof_channels+m] twice (real and imaginary parts)
+  cf_t *branches;             // Commutated input: nof_taps-1 rows of history followed by max_nof_blocks new rows
+  srslte_dft_plan_t fft;      // Batched IFFT over the filtered branches of every block
+  srslte_dft_plan_t fft_block; // IFFT of a single block, used by calls with fewer than max_nof_blocks blocks
+} srslte_channelizer_t;
+
+/* Creates a channelizer with a Kaiser windowed prototype filter of nof_channels*nof_taps taps. The prototype cuts off
+ * at half the channel spacing, so each channel keeps clean the band where less than the spacing minus its bandwidth
+ * is used, e.g. a 4.5 MHz LTE signal sampled at 7.68 MHz. */
+SRSLTE_API int srslte_channelizer_init(srslte_channelizer_t *q,
+                                       uint32_t nof_channels,
+                                       uint32_t nof_taps,
+                                       uint32_t max_nof_samples);
+
+SRSLTE_API void srslte_channelizer_free(srslte_channelizer_t *q);
+
+SRSLTE_API void srslte_channelizer_reset(srslte_channelizer_t *q);
+
+/* Channelizes nof_samples wideband samples, which must be a multiple of nof_channels. output[k] receives the
+ * nof_samples/nof_channels samples of channel k. Returns the number of samples written to each channel. */
+SRSLTE_API int srslte_channelizer_execute(srslte_channelizer_t *q,
+                                          const cf_t *input,
+                                          cf_t **output,
+                                          uint32_t nof_samples);
+
+typedef struct SRSLTE_API {
+  uint32_t nof_channels;      // Number of channels, also the interpolation factor
+  uint32_t nof_taps;          // Taps per polyphase branch
+  uint32_t max_nof_blocks;    // Maximum number of input samples per channel and call
+  float *taps;                // Prototype filter scaled by nof_channels, duplicated as in the channelizer
+  cf_t *branches;             // IFFT outputs: nof_taps-1 rows of history followed by max_nof_blocks new rows
+  srslte_dft_plan_t fft;      // Batched IFFT over the channel samples of every block
+  srslte_dft_plan_t fft_block; // IFFT of a single block, used by calls with fewer than max_nof_blocks blocks
+} srslte_synthesizer_t;
+
+/* Creates a synthesizer with the same prototype filter as the channelizer. max_nof_samples is the maximum number of
+ * wideband output samples per call. */
+SRSLTE_API int srslte_synthesizer_init(srslte_synthesizer_t *q,
+                                       uint32_t nof_channels,
+                                       uint32_t nof_taps,
+                                       uint32_t max_nof_samples);
+
+SRSLTE_API void srslte_synthesizer_free(srslte_synthesizer_t *q);
+
+SRSLTE_API void srslte_synthesizer_reset(srslte_synthesizer_t *q);
+
+/* Combines nof_samples samples of every channel into nof_samples*nof_channels wideband samples, each channel keeping
+ * its amplitude. input[k] may be NULL for a channel with nothing to send. Returns the number of samples written. */
+SRSLTE_API int srslte_synthesizer_execute(srslte_synthesizer_t *q,
+                                          cf_t **input,
+                                          cf_t *output,
+                                          uint32_t nof_samples);
+
+#endif //CHANNELIZER_
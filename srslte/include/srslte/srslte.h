@@ -45,6 +45,7 @@
 #include "srslte/utils/vector.h"
 #include "srslte/utils/cpp_wrappers.h"
 #include "srslte/utils/timer.h"
+#include "srslte/utils/worker_team.h"
 
 #include "srslte/common/timestamp.h"
 #include "srslte/common/sequence.h"
@@ -59,6 +60,7 @@
 #include "srslte/resampling/interp.h"
 #include "srslte/resampling/decim.h"
 #include "srslte/resampling/resample_arb.h"
+#include "srslte/resampling/channelizer.h"
 
 #include "srslte/channel/ch_awgn.h"
 #include "srslte/channel/channel_emulator.h"
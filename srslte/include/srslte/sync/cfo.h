@@ -45,6 +45,9 @@
 
 #define SRSLTE_CFO_CEXPTAB_SIZE 4096
 
+/** Number of samples the phase rotator advances before it restarts from the exact phase */
+#define SRSLTE_CFO_ROTATOR_BLOCK 1024
+
 typedef struct SRSLTE_API {
   float last_freq;
   float tol;
@@ -70,6 +73,16 @@ SRSLTE_API void srslte_cfo_correct(srslte_cfo_t *h,
                                    cf_t *output,
                                    float freq);
 
+/* Corrects the CFO with a recursive phase rotator instead of a table of complex exponentials, so it is exact for
+ * any frequency and there is no table to regenerate when the frequency changes nor to keep in cache. The rotation
+ * starts at phase (in cycles) and the phase of the sample following the last one is returned, so that consecutive
+ * calls can be phase continuous. srslte_cfo_correct() is equivalent to starting at phase 0. */
+SRSLTE_API float srslte_cfo_correct_rotator(cf_t *input,
+                                            cf_t *output,
+                                            float freq,
+                                            float phase,
+                                            uint32_t nsamples);
+
 SRSLTE_API int srslte_cfo_init_finer(srslte_cfo_t *h, uint32_t nsamples);
 
 SRSLTE_API void srslte_cfo_free_finer(srslte_cfo_t *h);
@@ -88,6 +88,9 @@
 
 #define USE_FINE_GRAINED_CFO 1
 
+// Correct the CFO with the table-free phase rotator instead of the table based correctors.
+#define USE_ROTATOR_CFO 1
+
 typedef enum {SSS_DIFF=0, SSS_PARTIAL_3=2, SSS_FULL=1} sss_alg_t;
 
 typedef enum SRSLTE_API {CFO_CORRECTION_PSS=0, CFO_CORRECTION_CP}  srslte_sync_cfo_correction_type_t;
@@ -78,12 +78,36 @@
 #define MAX_CANDIDATES_COM 6 // From 36.213 Table 9.1.1-1
 #define MAX_CANDIDATES (MAX_CANDIDATES_UE + MAX_CANDIDATES_COM)
 
+#define SRSLTE_UE_DL_DEFAULT_HARQ_PROCESSES 1 // With a single process soft bits are combined only when retransmissions are back to back.
+
+#define SRSLTE_UE_DL_DEFAULT_HARQ_TIMEOUT 100 // Soft bits older than this are discarded. Given in milliseconds.
+
+#define SRSLTE_UE_DL_DEFAULT_LAST_DCI_MAX_AGE 10 // Last DCI older than this is not reused. Given in milliseconds.
+
 typedef struct {
   srslte_dci_format_t format;
   srslte_dci_location_t loc[MAX_CANDIDATES];
   uint32_t nof_locations;
 } dci_blind_search_t;
 
+// Soft combining state of a DL HARQ process.
+typedef struct SRSLTE_API {
+  srslte_softbuffer_rx_t softbuffer;
+  bool active;                // The soft buffer holds soft bits of a TB not decoded yet.
+  bool ndi;                   // New data indicator of the TB being combined.
+  uint32_t tbs;
+  uint32_t nof_tx;            // Number of transmissions combined so far.
+  struct timespec last_rx;
+} srslte_ue_dl_harq_t;
+
+// Last DCI correctly decoded, reused to decode subframes of the same RNTI whose DCI was not found.
+typedef struct SRSLTE_API {
+  srslte_dci_msg_t dci_msg;
+  uint16_t rnti;
+  bool valid;
+  struct timespec timestamp;
+} srslte_ue_dl_last_dci_t;
+
 typedef struct SRSLTE_API {
   srslte_pcfich_t pcfich;
   srslte_pdcch_t pdcch;
@@ -134,6 +158,19 @@ typedef struct SRSLTE_API {
   bool add_sch_to_front;
 
   uint32_t pss_len;
+
+  srslte_ra_dl_mcs_table_t mcs_table; // MCS table configured by higher layers, it is not signalled in the DCI.
+
+  srslte_ue_dl_harq_t harq[SRSLTE_RA_NOF_HARQ_PROCESSES_SCATTER];
+  uint32_t nof_harq_processes;        // Number of HARQ processes, the process number in the DCI is taken modulo this value.
+  uint32_t harq_timeout;              // Given in milliseconds, 0 disables the timeout.
+  uint32_t harq_pid;                  // HARQ process and retransmission counter of the next TB when PDCCH is not decoded.
+  uint32_t harq_retx_cnt;
+  uint64_t harq_combined;             // Counts the TBs decoded out of more than one transmission.
+
+  srslte_ue_dl_last_dci_t last_dci;   // Kept per object so that several objects can decode concurrently.
+  bool use_last_dci;
+  uint32_t last_dci_max_age;          // Given in milliseconds, 0 disables the age check.
 } srslte_ue_dl_t;
 
 /* This function shall be called just after the initial synchronization */
@@ -226,6 +263,12 @@ SRSLTE_API void srslte_ue_dl_set_expected_cfi(srslte_ue_dl_t *q, uint32_t expect
 
 SRSLTE_API void srslte_ue_dl_set_cfo_csr(srslte_ue_dl_t *q, bool flag);
 
+/* Carries the channel and noise estimates across the subframes of a burst, see srslte_chest_dl_set_burst_tracking().
+ * srslte_ue_dl_start_burst() must be called before decoding the first subframe of every burst. */
+SRSLTE_API void srslte_ue_dl_set_burst_tracking(srslte_ue_dl_t *q, bool enable);
+
+SRSLTE_API void srslte_ue_dl_start_burst(srslte_ue_dl_t *q);
+
 //******************************************************************************
 //***************** Scatter system customized implementations ******************
 //******************************************************************************
@@ -239,4 +282,14 @@ SRSLTE_API int srslte_ue_dl_cfg_grant_scatter(srslte_ue_dl_t *q, srslte_ra_dl_gr
 
 SRSLTE_API void srslte_ue_dl_set_pss_length(srslte_ue_dl_t *q, uint32_t pss_len);
 
+SRSLTE_API void srslte_ue_dl_set_mcs_table(srslte_ue_dl_t *q, srslte_ra_dl_mcs_table_t mcs_table);
+
+SRSLTE_API int srslte_ue_dl_set_harq_processes(srslte_ue_dl_t *q, uint32_t nof_processes, uint32_t timeout_ms);
+
+SRSLTE_API void srslte_ue_dl_set_harq_scatter(srslte_ue_dl_t *q, uint32_t harq_pid, uint32_t retx_cnt);
+
+SRSLTE_API void srslte_ue_dl_set_last_dci_reuse(srslte_ue_dl_t *q, bool enable, uint32_t max_age_ms);
+
+SRSLTE_API void srslte_ue_dl_reset_harq(srslte_ue_dl_t *q);
+
 #endif
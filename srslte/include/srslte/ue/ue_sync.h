@@ -183,6 +183,7 @@ typedef struct SRSLTE_API {
   uint32_t subframe_counter;
   struct timespec subframe_track_start;
   uint32_t mcs;
+  uint32_t bw_idx;
 } short_ue_sync_t;
 
 SRSLTE_API int srslte_ue_sync_init_reentry(srslte_ue_sync_t *q,
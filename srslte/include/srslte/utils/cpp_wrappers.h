@@ -14,6 +14,7 @@
 
 #include "srslte/ue/ue_sync.h"
 #include "../intf/intf.h"
+#include "../../../../communicator/cpp/PriorityQueue.h"
 
 struct sync_vector_t {
   std::vector<short_ue_sync_t>* sync_vector_ptr;
@@ -31,12 +32,25 @@ struct rx_param_cb_t {
   boost::circular_buffer<basic_ctrl_t>* rx_param_cb_ptr;
 };
 
+// Orders TX basic controls by deadline: the earliest timestamp is on top. Equal timestamps keep the MAC order.
+struct tx_deadline_later {
+  bool operator()(const basic_ctrl_t& a, const basic_ctrl_t& b) const {
+    return (a.timestamp != b.timestamp) ? (a.timestamp > b.timestamp) : (a.seq_number > b.seq_number);
+  }
+};
+
+struct tx_pq_t {
+  PriorityQueue<basic_ctrl_t, std::vector<basic_ctrl_t>, tx_deadline_later>* tx_pq_ptr;
+  uint64_t capacity;
+};
+
 extern "C" {
 #else
 struct sync_vector_t;
 struct sync_cb_t;
 struct tx_cb_t;
 struct rx_param_cb_t;
+struct tx_pq_t;
 #endif
 
 #include <inttypes.h>
@@ -52,6 +66,8 @@ typedef struct tx_cb_t* tx_cb_handle;
 
 typedef struct rx_param_cb_t* rx_param_cb_handle;
 
+typedef struct tx_pq_t* tx_pq_handle;
+
 //******************************************************************************
 SRSLTE_API void sync_cb_make(sync_cb_handle* handle, uint64_t size);
 
@@ -104,6 +120,26 @@ SRSLTE_API void tx_cb_pop_front(tx_cb_handle handle);
 SRSLTE_API bool tx_cb_empty(tx_cb_handle handle);
 
 SRSLTE_API int tx_cb_size(tx_cb_handle handle);
+
+SRSLTE_API bool tx_cb_full(tx_cb_handle handle);
+//******************************************************************************
+
+//******************************************************************************
+SRSLTE_API void tx_pq_make(tx_pq_handle* handle, uint64_t size);
+
+SRSLTE_API void tx_pq_free(tx_pq_handle* handle);
+
+SRSLTE_API bool tx_pq_push(tx_pq_handle handle, basic_ctrl_t* const basic_ctrl);
+
+SRSLTE_API void tx_pq_top(tx_pq_handle handle, basic_ctrl_t* const basic_ctrl);
+
+SRSLTE_API void tx_pq_pop(tx_pq_handle handle);
+
+SRSLTE_API bool tx_pq_empty(tx_pq_handle handle);
+
+SRSLTE_API int tx_pq_size(tx_pq_handle handle);
+
+SRSLTE_API bool tx_pq_full(tx_pq_handle handle);
 //******************************************************************************
 
 //******************************************************************************
@@ -0,0 +1,79 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         worker_team.h
+ *
+ *  Description:  Small team of worker threads running a set of independent
+ *                tasks in parallel. The calling thread takes part in the work
+ *                and srslte_worker_team_run() returns once all the tasks are
+ *                done, so it can be used as a parallel for loop.
+ *****************************************************************************/
+
+#ifndef SRSLTE_WORKER_TEAM_H
+#define SRSLTE_WORKER_TEAM_H
+
+#include "srslte/config.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SRSLTE_WORKER_TEAM_MAX_WORKERS 16
+
+/* Runs task number task_idx. worker_idx identifies the thread running it (0 is the calling thread) and can be used
+ * to select per-worker scratch memory. */
+typedef void (*srslte_worker_team_fn_t)(void *arg, uint32_t task_idx, uint32_t worker_idx);
+
+typedef struct {
+  pthread_t threads[SRSLTE_WORKER_TEAM_MAX_WORKERS];
+  uint32_t nof_workers;
+  uint32_t nof_threads;
+  bool running;
+  uint64_t generation;
+  srslte_worker_team_fn_t fn;
+  void *arg;
+  uint32_t nof_tasks;
+  uint32_t next_task;
+  uint32_t nof_done;
+  pthread_mutex_t mutex;
+  pthread_cond_t start_cvar;
+  pthread_cond_t done_cvar;
+} srslte_worker_team_t;
+
+/* nof_workers includes the calling thread, so nof_workers-1 threads are created. */
+SRSLTE_API int srslte_worker_team_init(srslte_worker_team_t *q,
+                                       uint32_t nof_workers);
+
+SRSLTE_API void srslte_worker_team_free(srslte_worker_team_t *q);
+
+/* Runs fn for every task in [0, nof_tasks) and waits for all of them. Not reentrant: only one thread may call it at a
+ * time for the same team. */
+SRSLTE_API void srslte_worker_team_run(srslte_worker_team_t *q,
+                                       srslte_worker_team_fn_t fn,
+                                       void *arg,
+                                       uint32_t nof_tasks);
+
+#endif // SRSLTE_WORKER_TEAM_H
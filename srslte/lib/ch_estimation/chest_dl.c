@@ -37,6 +37,10 @@
 #include "srslte/utils/vector.h"
 #include "srslte/utils/convolution.h"
 
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+#endif /* LV_HAVE_AVX2 */
+
 //#define DEFAULT_FILTER_LEN 3
 
 #define CE_CURRENT_SFLEN_RE(nof_prb,cp) SRSLTE_SF_LEN_RE(nof_prb,cp)
@@ -107,6 +111,13 @@ int srslte_chest_dl_init(srslte_chest_dl_t *q, srslte_cell_t cell)
       perror("malloc");
       goto clean_exit;
     }
+    for (int i = 0; i < cell.nof_ports; i++) {
+      q->track_pilots[i] = srslte_vec_malloc(sizeof(cf_t) * SRSLTE_REFSIGNAL_MAX_NUM_SF(cell.nof_prb));
+      if (!q->track_pilots[i]) {
+        perror("malloc");
+        goto clean_exit;
+      }
+    }
 
     q->tmp_cfo_estimate = srslte_vec_malloc(sizeof(cf_t) * SRSLTE_REFSIGNAL_MAX_NUM_SF(cell.nof_prb));
     if (!q->tmp_cfo_estimate) {
@@ -149,6 +160,12 @@ int srslte_chest_dl_init(srslte_chest_dl_t *q, srslte_cell_t cell)
     q->smooth_filter_len = 3;
     srslte_chest_dl_set_smooth_filter3_coeff(q, 0.1);
 
+    q->fused = true;
+
+    q->burst_tracking = false;
+    q->track_min_gain = SRSLTE_CHEST_DL_DEFAULT_TRACK_MIN_GAIN;
+    q->track_max_residual = SRSLTE_CHEST_DL_DEFAULT_TRACK_MAX_RESIDUAL;
+
     q->cell = cell;
   }
 
@@ -187,9 +204,27 @@ void srslte_chest_dl_free(srslte_chest_dl_t *q)
   if (q->pilot_recv_signal) {
     free(q->pilot_recv_signal);
   }
+  for (int i = 0; i < SRSLTE_MAX_PORTS; i++) {
+    if (q->track_pilots[i]) {
+      free(q->track_pilots[i]);
+    }
+  }
   bzero(q, sizeof(srslte_chest_dl_t));
 }
 
+/* Normalization of the power of the difference between averaged and non-averaged pilots. Computed for filter len 3
+ * using matlab */
+static float noise_pilots_norm(srslte_chest_dl_t *q)
+{
+  float norm  = 1;
+  if (q->smooth_filter_len == 3) {
+    float a = q->smooth_filter[0];
+    float norm3 = 6.143*a*a+0.04859*a-0.002774;
+    norm /= norm3;
+  }
+  return norm;
+}
+
 /* Uses the difference between the averaged and non-averaged pilot estimates */
 static float estimate_noise_pilots(srslte_chest_dl_t *q, uint32_t port_id)
 {
@@ -206,14 +241,7 @@ static float estimate_noise_pilots(srslte_chest_dl_t *q, uint32_t port_id)
   srslte_vec_fprint_f(stdout, q->snr_vector, nref);
 #endif
 
-  /* Compute average power. Normalized for filter len 3 using matlab */
-  float norm  = 1;
-  if (q->smooth_filter_len == 3) {
-    float a = q->smooth_filter[0];
-    float norm3 = 6.143*a*a+0.04859*a-0.002774;
-    norm /= norm3;
-  }
-  float power = norm*q->cell.nof_ports*srslte_vec_avg_power_cf(q->tmp_noise, nref);
+  float power = noise_pilots_norm(q)*q->cell.nof_ports*srslte_vec_avg_power_cf(q->tmp_noise, nref);
   return power;
 }
 
@@ -249,6 +277,17 @@ static float estimate_noise_empty_sc(srslte_chest_dl_t *q, cf_t *input) {
   return noise_power;
 }
 
+/* Noise estimation algorithms using the synchronization signals, only available in subframes 0 and 5 */
+static void estimate_noise_sync(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id) {
+  if (sf_idx == 0 || sf_idx == 5) {
+    if (q->noise_alg == SRSLTE_NOISE_ALG_PSS) {
+      q->noise_estimate[port_id] = estimate_noise_pss(q, input, ce);
+    } else {
+      q->noise_estimate[port_id] = estimate_noise_empty_sc(q, input);
+    }
+  }
+}
+
 #define cesymb(i) ce[SRSLTE_RE_IDX(q->cell.nof_prb,i,0)]
 
 static void interpolate_pilots(srslte_chest_dl_t *q, cf_t *pilot_estimates, cf_t *ce, uint32_t port_id)
@@ -309,6 +348,21 @@ void srslte_chest_dl_set_noise_alg(srslte_chest_dl_t *q, srslte_chest_dl_noise_a
   q->noise_alg = noise_estimation_alg;
 }
 
+void srslte_chest_dl_set_fused(srslte_chest_dl_t *q, bool enable) {
+  q->fused = enable;
+}
+
+void srslte_chest_dl_set_burst_tracking(srslte_chest_dl_t *q, bool enable, float min_gain, float max_residual) {
+  q->burst_tracking = enable;
+  q->track_min_gain = min_gain;
+  q->track_max_residual = max_residual;
+  srslte_chest_dl_start_burst(q);
+}
+
+void srslte_chest_dl_start_burst(srslte_chest_dl_t *q) {
+  bzero(q->track_ce, sizeof(q->track_ce));
+}
+
 void srslte_chest_dl_set_smooth_filter3_coeff(srslte_chest_dl_t* q, float w)
 {
   q->smooth_filter_len = 3;
@@ -339,8 +393,355 @@ float srslte_chest_dl_rssi(srslte_chest_dl_t *q, cf_t *input, uint32_t port_id)
   return rssi/nsymbols;
 }
 
-int srslte_chest_dl_estimate_port(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id)
+#ifdef LV_HAVE_AVX2
+
+#define PROD_AVX(a,b) _mm256_addsub_ps(_mm256_mul_ps(a,_mm256_moveldup_ps(b)),_mm256_mul_ps(_mm256_shuffle_ps(a,a,0xB1),_mm256_movehdup_ps(b)))
+
+#define BROADCAST_CF(x) _mm256_castpd_ps(_mm256_broadcast_sd((const double*) (x)))
+
+// Sum of the 8 floats of a register.
+static inline float chest_dl_hsum_avx(__m256 x) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+  return _mm_cvtss_f32(s);
+}
+
+// The single pass estimator covers the default configuration: ports 0 and 1 (4 pilot symbols), normal CP and a 3 tap
+// smoothing filter.
+static bool chest_dl_fused_supported(srslte_chest_dl_t *q, uint32_t port_id) {
+  return q->fused && port_id < 2 && SRSLTE_CP_ISNORM(q->cell.cp) &&
+         q->smooth_filter_len == 3 && q->smooth_filter[0] != 0;
+}
+
+// Gets the pilots of one symbol from the grid and computes the LS estimates, returns the power of the received pilots.
+// If ref is given, the power of the difference between the LS estimates and ref is added to residual.
+static float chest_dl_ls_symbol_avx2(cf_t *input, cf_t *csr, cf_t *recv, cf_t *est, uint32_t fidx, uint32_t nref,
+                                     cf_t *ref, float *residual) {
+  const __m128i gather_idx = _mm_setr_epi32(0, 6, 12, 18);
+  const __m256 conjugator = _mm256_setr_ps(0, -0.f, 0, -0.f, 0, -0.f, 0, -0.f);
+  __m256 power = _mm256_setzero_ps();
+  __m256 res = _mm256_setzero_ps();
+  float power_tail = 0, res_tail = 0;
+  cf_t d;
+  uint32_t i = 0;
+
+  for (; i + 4 <= nref; i += 4) {
+    __m256 y = _mm256_castpd_ps(_mm256_i32gather_pd((const double*) &input[fidx + 6*i], gather_idx, 8));
+    __m256 x = _mm256_xor_ps(_mm256_loadu_ps((float*) &csr[i]), conjugator);
+    __m256 e = PROD_AVX(y, x);
+    _mm256_storeu_ps((float*) &recv[i], y);
+    _mm256_storeu_ps((float*) &est[i], e);
+    power = _mm256_add_ps(power, _mm256_mul_ps(y, y));
+    if (ref) {
+      __m256 diff = _mm256_sub_ps(e, _mm256_loadu_ps((float*) &ref[i]));
+      res = _mm256_add_ps(res, _mm256_mul_ps(diff, diff));
+    }
+  }
+  for (; i < nref; i++) {
+    recv[i] = input[fidx + 6*i];
+    est[i] = recv[i] * conjf(csr[i]);
+    power_tail += __real__ recv[i] * __real__ recv[i] + __imag__ recv[i] * __imag__ recv[i];
+    if (ref) {
+      d = est[i] - ref[i];
+      res_tail += __real__ d * __real__ d + __imag__ d * __imag__ d;
+    }
+  }
+  if (ref) {
+    *residual += chest_dl_hsum_avx(res) + res_tail;
+  }
+  return chest_dl_hsum_avx(power) + power_tail;
+}
+
+// Smooths the estimates of one symbol with the 3 tap filter, extrapolating the edges like srslte_conv_same_cf().
+// Returns the power of the difference between the smoothed and the raw estimates.
+static float chest_dl_smooth_symbol_avx2(float *filter, cf_t *est, cf_t *avg, uint32_t nref) {
+  const __m256 f0 = _mm256_set1_ps(filter[0]);
+  const __m256 f1 = _mm256_set1_ps(filter[1]);
+  const __m256 f2 = _mm256_set1_ps(filter[2]);
+  __m256 noise = _mm256_setzero_ps();
+  float noise_edges = 0;
+  cf_t d;
+  uint32_t k = 1;
+
+  avg[0] = filter[0]*(3*est[1]-2*est[0]) + filter[1]*est[0] + filter[2]*est[1];
+  avg[nref-1] = filter[0]*est[nref-2] + filter[1]*est[nref-1] + filter[2]*(3*est[nref-1]-2*est[nref-2]);
+
+  for (; k + 4 <= nref - 1; k += 4) {
+    __m256 e = _mm256_loadu_ps((float*) &est[k]);
+    __m256 a = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(f0, _mm256_loadu_ps((float*) &est[k-1])),
+                                           _mm256_mul_ps(f1, e)),
+                             _mm256_mul_ps(f2, _mm256_loadu_ps((float*) &est[k+1])));
+    _mm256_storeu_ps((float*) &avg[k], a);
+    __m256 diff = _mm256_sub_ps(a, e);
+    noise = _mm256_add_ps(noise, _mm256_mul_ps(diff, diff));
+  }
+  for (; k < nref - 1; k++) {
+    avg[k] = filter[0]*est[k-1] + filter[1]*est[k] + filter[2]*est[k+1];
+    d = avg[k] - est[k];
+    noise_edges += __real__ d * __real__ d + __imag__ d * __imag__ d;
+  }
+  d = avg[0] - est[0];
+  noise_edges += __real__ d * __real__ d + __imag__ d * __imag__ d;
+  d = avg[nref-1] - est[nref-1];
+  noise_edges += __real__ d * __real__ d + __imag__ d * __imag__ d;
+
+  return chest_dl_hsum_avx(noise) + noise_edges;
+}
+
+// Interpolates the smoothed estimates of one symbol in frequency, like srslte_interp_linear_offset() with one pilot
+// every 6 subcarriers. Two pilot intervals (12 subcarriers) are written per iteration.
+static void chest_dl_interp_freq_avx2(cf_t *avg, cf_t *out, uint32_t off, uint32_t nref) {
+  const __m256 sixth = _mm256_set1_ps((float) 1/6);
+  const __m256 ramp0 = _mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3);
+  const __m256 ramp1 = _mm256_setr_ps(4, 4, 5, 5, 0, 0, 1, 1);
+  const __m256 ramp2 = _mm256_setr_ps(2, 2, 3, 3, 4, 4, 5, 5);
+  cf_t diff;
+  uint32_t i = 0, j;
+
+  for (j = 0; j < off; j++) {
+    out[off-j-1] = avg[0] - (j+1) * (avg[1]-avg[0]) / 6;
+  }
+  for (; i + 2 < nref; i += 2) {
+    __m256 a0 = BROADCAST_CF(&avg[i]);
+    __m256 a1 = BROADCAST_CF(&avg[i+1]);
+    __m256 d0 = _mm256_mul_ps(_mm256_sub_ps(a1, a0), sixth);
+    __m256 d1 = _mm256_mul_ps(_mm256_sub_ps(BROADCAST_CF(&avg[i+2]), a1), sixth);
+    __m256 a01 = _mm256_blend_ps(a0, a1, 0xF0);
+    __m256 d01 = _mm256_blend_ps(d0, d1, 0xF0);
+    _mm256_storeu_ps((float*) &out[off+6*i],   _mm256_add_ps(a0,  _mm256_mul_ps(ramp0, d0)));
+    _mm256_storeu_ps((float*) &out[off+6*i+4], _mm256_add_ps(a01, _mm256_mul_ps(ramp1, d01)));
+    _mm256_storeu_ps((float*) &out[off+6*i+8], _mm256_add_ps(a1,  _mm256_mul_ps(ramp2, d1)));
+  }
+  for (; i < nref - 1; i++) {
+    diff = (avg[i+1]-avg[i]) * ((float) 1/6);
+    for (j = 0; j < 6; j++) {
+      out[off+6*i+j] = avg[i] + j * diff;
+    }
+  }
+  diff = avg[nref-1]-avg[nref-2];
+  for (j = 0; j < 6-off; j++) {
+    out[off+6*i+j] = avg[i] + j * diff / 6;
+  }
+}
+
+// Interpolates in time the symbols between (and after) the pilot symbols 0, 4, 7 and 11 in a single sweep over the
+// subcarriers, like interpolate_pilots() does one symbol pair at a time. Returns the RSSI of the pilot symbols of the
+// input when requested.
+static float chest_dl_interp_time_avx2(cf_t *ce, cf_t *input, uint32_t nre, bool rssi) {
+  const __m256 quarter = _mm256_set1_ps(0.25f);
+  const __m256 third = _mm256_set1_ps((float) 1/3);
+  __m256 power = _mm256_setzero_ps();
+
+#define CE_ROW(l) ((float*) &ce[(l)*nre + k])
+
+  for (uint32_t k = 0; k < nre; k += 4) {
+    __m256 r0 = _mm256_loadu_ps(CE_ROW(0));
+    __m256 r4 = _mm256_loadu_ps(CE_ROW(4));
+    __m256 r7 = _mm256_loadu_ps(CE_ROW(7));
+    __m256 r11 = _mm256_loadu_ps(CE_ROW(11));
+    __m256 d, r;
+
+    d = _mm256_mul_ps(_mm256_sub_ps(r4, r0), quarter);
+    r = _mm256_add_ps(r0, d);
+    _mm256_storeu_ps(CE_ROW(1), r);
+    r = _mm256_add_ps(r, d);
+    _mm256_storeu_ps(CE_ROW(2), r);
+    r = _mm256_add_ps(r, d);
+    _mm256_storeu_ps(CE_ROW(3), r);
+
+    d = _mm256_mul_ps(_mm256_sub_ps(r7, r4), third);
+    r = _mm256_add_ps(r4, d);
+    _mm256_storeu_ps(CE_ROW(5), r);
+    r = _mm256_add_ps(r, d);
+    _mm256_storeu_ps(CE_ROW(6), r);
+
+    d = _mm256_mul_ps(_mm256_sub_ps(r11, r7), quarter);
+    r = _mm256_add_ps(r7, d);
+    _mm256_storeu_ps(CE_ROW(8), r);
+    r = _mm256_add_ps(r, d);
+    _mm256_storeu_ps(CE_ROW(9), r);
+    r = _mm256_add_ps(r, d);
+    _mm256_storeu_ps(CE_ROW(10), r);
+    r = _mm256_add_ps(r11, d);
+    _mm256_storeu_ps(CE_ROW(12), r);
+    r = _mm256_add_ps(r, d);
+    _mm256_storeu_ps(CE_ROW(13), r);
+
+    if (rssi) {
+      __m256 x0 = _mm256_loadu_ps((float*) &input[k]);
+      __m256 x4 = _mm256_loadu_ps((float*) &input[4*nre + k]);
+      __m256 x7 = _mm256_loadu_ps((float*) &input[7*nre + k]);
+      __m256 x11 = _mm256_loadu_ps((float*) &input[11*nre + k]);
+      power = _mm256_add_ps(power, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x0, x0), _mm256_mul_ps(x4, x4)),
+                                                 _mm256_add_ps(_mm256_mul_ps(x7, x7), _mm256_mul_ps(x11, x11))));
+    }
+  }
+
+#undef CE_ROW
+
+  return chest_dl_hsum_avx(power)/4;
+}
+
+// Computes the LS estimates, smooths them, estimates the noise and interpolates them in frequency one pilot symbol at a
+// time, while the symbol is still in cache, and then interpolates all the symbols in time in one sweep.
+static void chest_dl_estimate_port_fused(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id)
+{
+  uint32_t nref = 2*q->cell.nof_prb;
+  uint32_t nre = SRSLTE_NRE*q->cell.nof_prb;
+  cf_t *csr = q->csr_signal.pilots[port_id/2][sf_idx];
+  float rsrp = 0, noise = 0;
+  uint32_t l;
+
+  for (l = 0; l < 4; l++) {
+    rsrp += chest_dl_ls_symbol_avx2(&input[srslte_refsignal_cs_nsymbol(l, q->cell.cp, port_id)*nre],
+                                    &csr[l*nref], &q->pilot_recv_signal[l*nref], &q->pilot_estimates[l*nref],
+                                    srslte_refsignal_cs_fidx(q->cell, l, port_id, 0), nref, NULL, NULL);
+  }
+
+  // The CFO is estimated from the raw LS estimates of all the symbols.
+  if(q->cfo_estimate_from_csr_enable) {
+    q->cfo_csr = chest_estimate_cfo(q);
+    CHEST_DL_INFO("CSR cfo before: %f [Hz]\n", q->cfo_csr*15000); // Value given in Hz after multiplying by 15000.
+  }
+
+  for (l = 0; l < 4; l++) {
+    noise += chest_dl_smooth_symbol_avx2(q->smooth_filter, &q->pilot_estimates[l*nref],
+                                         &q->pilot_estimates_average[l*nref], nref);
+    chest_dl_interp_freq_avx2(&q->pilot_estimates_average[l*nref],
+                              &ce[srslte_refsignal_cs_nsymbol(l, q->cell.cp, port_id)*nre],
+                              srslte_refsignal_cs_fidx(q->cell, l, port_id, 0), nref);
+  }
+
+  float rssi = chest_dl_interp_time_avx2(ce, input, nre, port_id == 0);
+
+  if (q->noise_alg == SRSLTE_NOISE_ALG_REFS) {
+    q->noise_estimate[port_id] = noise_pilots_norm(q)*q->cell.nof_ports*noise/(4*nref);
+  } else {
+    estimate_noise_sync(q, input, ce, sf_idx, port_id);
+  }
+
+  q->rsrp[port_id] = rsrp/(4*nref);
+  if (port_id == 0) {
+    q->rssi[port_id] = rssi;
+  }
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+/* Gets the LS estimates. Returns the power of the received pilots and the power of the difference between the LS
+ * estimates and the tracked ones */
+static float chest_dl_track_ls(srslte_chest_dl_t *q, cf_t *input, uint32_t sf_idx, uint32_t port_id, float *residual)
 {
+  uint32_t nref = SRSLTE_REFSIGNAL_NUM_SF(q->cell.nof_prb, port_id);
+  cf_t *csr = q->csr_signal.pilots[port_id/2][sf_idx];
+
+#ifdef LV_HAVE_AVX2
+  if (chest_dl_fused_supported(q, port_id)) {
+    uint32_t nref_symbol = 2*q->cell.nof_prb;
+    uint32_t nre = SRSLTE_NRE*q->cell.nof_prb;
+    float power = 0;
+    *residual = 0;
+    for (uint32_t l = 0; l < 4; l++) {
+      power += chest_dl_ls_symbol_avx2(&input[srslte_refsignal_cs_nsymbol(l, q->cell.cp, port_id)*nre],
+                                       &csr[l*nref_symbol], &q->pilot_recv_signal[l*nref_symbol],
+                                       &q->pilot_estimates[l*nref_symbol], srslte_refsignal_cs_fidx(q->cell, l, port_id, 0),
+                                       nref_symbol, &q->track_pilots[port_id][l*nref_symbol], residual);
+    }
+    *residual /= nref;
+    return power/nref;
+  }
+#endif /* LV_HAVE_AVX2 */
+
+  srslte_refsignal_cs_get_sf(q->cell, port_id, input, q->pilot_recv_signal);
+  srslte_vec_prod_conj_ccc(q->pilot_recv_signal, csr, q->pilot_estimates, nref);
+  srslte_vec_sub_ccc(q->pilot_estimates, q->track_pilots[port_id], q->tmp_noise, nref);
+  *residual = srslte_vec_avg_power_cf(q->tmp_noise, nref);
+  return srslte_vec_avg_power_cf(q->pilot_recv_signal, nref);
+}
+
+/* Interpolates the pilot estimates into the grid, computes the RSSI for port 0 */
+static void chest_dl_interpolate(srslte_chest_dl_t *q, cf_t *pilots, cf_t *input, cf_t *ce, uint32_t port_id)
+{
+#ifdef LV_HAVE_AVX2
+  if (chest_dl_fused_supported(q, port_id)) {
+    uint32_t nref = 2*q->cell.nof_prb;
+    uint32_t nre = SRSLTE_NRE*q->cell.nof_prb;
+    for (uint32_t l = 0; l < 4; l++) {
+      chest_dl_interp_freq_avx2(&pilots[l*nref], &ce[srslte_refsignal_cs_nsymbol(l, q->cell.cp, port_id)*nre],
+                                srslte_refsignal_cs_fidx(q->cell, l, port_id, 0), nref);
+    }
+    float rssi = chest_dl_interp_time_avx2(ce, input, nre, port_id == 0);
+    if (port_id == 0) {
+      q->rssi[port_id] = rssi;
+    }
+    return;
+  }
+#endif /* LV_HAVE_AVX2 */
+  interpolate_pilots(q, pilots, ce, port_id);
+  if (port_id == 0) {
+    q->rssi[port_id] = srslte_chest_dl_rssi(q, input, port_id);
+  }
+}
+
+/* Updates the estimates kept from the previous subframes of the burst with the LS estimates of this subframe. The
+ * difference between both gives the noise power as long as the channel does not change, so when it grows beyond
+ * track_max_residual times the tracked noise the update is rejected and false is returned. */
+static bool chest_dl_track_port(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id)
+{
+  uint32_t nref = SRSLTE_REFSIGNAL_NUM_SF(q->cell.nof_prb, port_id);
+  float residual;
+
+  float rsrp = chest_dl_track_ls(q, input, sf_idx, port_id, &residual);
+  residual *= q->cell.nof_ports;
+  if (!(residual <= q->track_max_residual*q->track_noise[port_id])) {
+    return false;
+  }
+
+  if(q->cfo_estimate_from_csr_enable) {
+    q->cfo_csr = chest_estimate_cfo(q);
+    CHEST_DL_INFO("CSR cfo before: %f [Hz]\n", q->cfo_csr*15000); // Value given in Hz after multiplying by 15000.
+  }
+
+  /* Running average of a static channel, floored to follow slow changes */
+  q->track_count[port_id]++;
+  float gain = 1.0/(q->track_count[port_id]+1);
+  if (gain < q->track_min_gain) {
+    gain = q->track_min_gain;
+  }
+  srslte_vec_sc_prod_cfc(q->track_pilots[port_id], 1-gain, q->track_pilots[port_id], nref);
+  srslte_vec_sc_prod_cfc(q->pilot_estimates, gain, q->tmp_noise, nref);
+  srslte_vec_sum_ccc(q->track_pilots[port_id], q->tmp_noise, q->track_pilots[port_id], nref);
+  q->track_noise[port_id] += gain*(residual-q->track_noise[port_id]);
+
+  chest_dl_interpolate(q, q->track_pilots[port_id], input, ce, port_id);
+
+  q->noise_estimate[port_id] = q->track_noise[port_id];
+  q->rsrp[port_id] = rsrp;
+  return true;
+}
+
+/* Keeps the estimates just computed as the starting point for the next subframes of the burst */
+static void chest_dl_track_start(srslte_chest_dl_t *q, cf_t *ce, uint32_t port_id)
+{
+  uint32_t nref = SRSLTE_REFSIGNAL_NUM_SF(q->cell.nof_prb, port_id);
+  bool averaged = !(q->smooth_filter_len == 0 || (q->smooth_filter_len == 3 && q->smooth_filter[0] == 0));
+
+  memcpy(q->track_pilots[port_id], averaged?q->pilot_estimates_average:q->pilot_estimates, sizeof(cf_t)*nref);
+  q->track_noise[port_id] = q->noise_estimate[port_id];
+  q->track_ce[port_id] = ce;
+  q->track_count[port_id] = 0;
+}
+
+static int estimate_port_full(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id)
+{
+#ifdef LV_HAVE_AVX2
+  if (ce != NULL && chest_dl_fused_supported(q, port_id)) {
+    chest_dl_estimate_port_fused(q, input, ce, sf_idx, port_id);
+    return 0;
+  }
+#endif /* LV_HAVE_AVX2 */
+
   /* Get references from the input signal */
   srslte_refsignal_cs_get_sf(q->cell, port_id, input, q->pilot_recv_signal);
 
@@ -367,14 +768,8 @@ int srslte_chest_dl_estimate_port(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, u
     /* Estimate noise power */
     if (q->noise_alg == SRSLTE_NOISE_ALG_REFS && q->smooth_filter_len > 0) {
       q->noise_estimate[port_id] = estimate_noise_pilots(q, port_id);
-    } else if (q->noise_alg == SRSLTE_NOISE_ALG_PSS) {
-      if (sf_idx == 0 || sf_idx == 5) {
-        q->noise_estimate[port_id] = estimate_noise_pss(q, input, ce);
-      }
     } else {
-      if (sf_idx == 0 || sf_idx == 5) {
-        q->noise_estimate[port_id] = estimate_noise_empty_sc(q, input);
-      }
+      estimate_noise_sync(q, input, ce, sf_idx, port_id);
     }
 
   }
@@ -389,6 +784,21 @@ int srslte_chest_dl_estimate_port(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, u
   return 0;
 }
 
+int srslte_chest_dl_estimate_port(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id)
+{
+  if (ce == NULL || !q->burst_tracking) {
+    return estimate_port_full(q, input, ce, sf_idx, port_id);
+  }
+
+  /* The tracked estimates are only valid for the grid they were interpolated into */
+  if (q->track_ce[port_id] == ce && chest_dl_track_port(q, input, ce, sf_idx, port_id)) {
+    return 0;
+  }
+  estimate_port_full(q, input, ce, sf_idx, port_id);
+  chest_dl_track_start(q, ce, port_id);
+  return 0;
+}
+
 int srslte_chest_dl_estimate(srslte_chest_dl_t *q, cf_t *input, cf_t *ce[SRSLTE_MAX_PORTS], uint32_t sf_idx)
 {
   uint32_t port_id;
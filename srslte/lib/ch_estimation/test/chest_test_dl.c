@@ -43,6 +43,12 @@ srslte_cell_t cell = {
 
 char *output_matlab = NULL;
 
+bool compare_fused = false;
+
+int burst_len = 0;
+
+float burst_snr_db = 5.0;
+
 void usage(char *prog) {
   printf("Usage: %s [recov]\n", prog);
 
@@ -52,12 +58,14 @@ void usage(char *prog) {
   printf("\t-c cell_id (1000 tests all). [Default %d]\n", cell.id);
 
   printf("\t-o output matlab file [Default %s]\n",output_matlab?output_matlab:"None");
+  printf("\t-f compare the single pass estimator with the separate steps [Default %s]\n",compare_fused?"Yes":"No");
+  printf("\t-b test burst tracking over a burst of this many subframes at %.1f dB SNR [Default %d]\n",burst_snr_db,burst_len);
   printf("\t-v increase verbosity\n");
 }
 
 void parse_args(int argc, char **argv) {
   int opt;
-  while ((opt = getopt(argc, argv, "recov")) != -1) {
+  while ((opt = getopt(argc, argv, "recofbv")) != -1) {
     switch(opt) {
     case 'r':
       cell.nof_prb = atoi(argv[optind]);
@@ -71,6 +79,12 @@ void parse_args(int argc, char **argv) {
     case 'o':
       output_matlab = argv[optind];
       break;
+    case 'f':
+      compare_fused = true;
+      break;
+    case 'b':
+      burst_len = atoi(argv[optind]);
+      break;
     case 'v':
       srslte_verbose++;
       break;
@@ -81,10 +95,97 @@ void parse_args(int argc, char **argv) {
   }
 }
 
+static float ce_mse(cf_t *ce, cf_t *h, int num_re) {
+  float mse = 0;
+  for (int i=0;i<num_re;i++) {
+    mse += crealf((ce[i]-h[i])*conjf(ce[i]-h[i]));
+  }
+  return mse/num_re;
+}
+
+/* Estimates a burst of subframes going through the same channel with and without burst tracking. The tracked estimates
+ * must be better, and a channel change in the last subframe must trigger a full estimation. */
+static int burst_tracking_test(void) {
+  srslte_chest_dl_t est, est_track;
+  int num_re = SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp);
+  cf_t *input = srslte_vec_malloc(num_re * sizeof(cf_t));
+  cf_t *h = srslte_vec_malloc(num_re * sizeof(cf_t));
+  cf_t *ce = srslte_vec_malloc(num_re * sizeof(cf_t));
+  cf_t *ce_track = srslte_vec_malloc(num_re * sizeof(cf_t));
+  float mse = 0, mse_track = 0;
+  uint32_t nof_tracked = 0;
+  int ret = -1;
+
+  if (!input || !h || !ce || !ce_track) {
+    perror("srslte_vec_malloc");
+    exit(-1);
+  }
+  if (srslte_chest_dl_init(&est, cell) || srslte_chest_dl_init(&est_track, cell)) {
+    fprintf(stderr, "Error initializing equalizer\n");
+    exit(-1);
+  }
+  srslte_chest_dl_set_burst_tracking(&est_track, true, SRSLTE_CHEST_DL_DEFAULT_TRACK_MIN_GAIN,
+                                     SRSLTE_CHEST_DL_DEFAULT_TRACK_MAX_RESIDUAL);
+  srslte_chest_dl_start_burst(&est_track);
+
+  for (int i=0;i<SRSLTE_CP_NSYMB(cell.cp)*2;i++) {
+    for (int j=0;j<cell.nof_prb * SRSLTE_NRE;j++) {
+      float x = -1+(float) i/SRSLTE_CP_NSYMB(cell.cp) + cosf(2 * M_PI * (float) j/cell.nof_prb/SRSLTE_NRE);
+      h[i*cell.nof_prb * SRSLTE_NRE+j] = (3+x) * cexpf(I * x)/4;
+    }
+  }
+
+  for (int n=0;n<burst_len;n++) {
+    uint32_t sf_idx = n%SRSLTE_NSUBFRAMES_X_FRAME;
+    if (n == burst_len-1) {
+      /* The transmitter changes */
+      srslte_vec_sc_prod_cfc(h, 0.5, h, num_re);
+      srslte_vec_sc_prod_ccc(h, cexpf(I * M_PI/2), h, num_re);
+    }
+    for (int i=0;i<num_re;i++) {
+      input[i] = ((rand()%2)?1:-1)*M_SQRT1_2 + I*((rand()%2)?1:-1)*M_SQRT1_2;
+    }
+    srslte_refsignal_cs_put_sf(cell, 0, est.csr_signal.pilots[0][sf_idx], input);
+    srslte_vec_prod_ccc(input, h, input, num_re);
+    srslte_ch_awgn_c(input, input, sqrtf(powf(10, -burst_snr_db/10)/2), num_re);
+
+    srslte_chest_dl_estimate_port(&est, input, ce, sf_idx, 0);
+    srslte_chest_dl_estimate_port(&est_track, input, ce_track, sf_idx, 0);
+
+    if (n > 0 && n < burst_len-1) {
+      mse += ce_mse(ce, h, num_re);
+      mse_track += ce_mse(ce_track, h, num_re);
+      nof_tracked = est_track.track_count[0];
+    }
+    INFO("sf=%d, tracked=%d, mse=%f, mse_track=%f, noise=%f, noise_track=%f\n", n, est_track.track_count[0],
+         ce_mse(ce, h, num_re), ce_mse(ce_track, h, num_re),
+         srslte_chest_dl_get_noise_estimate(&est), srslte_chest_dl_get_noise_estimate(&est_track));
+  }
+
+  printf("Burst of %d subframes: MSE %f without tracking, %f with tracking, %d subframes tracked\n", burst_len,
+         mse/(burst_len-2), mse_track/(burst_len-2), nof_tracked);
+  printf("Channel change: MSE %f without tracking, %f with tracking\n", ce_mse(ce, h, num_re),
+         ce_mse(ce_track, h, num_re));
+
+  if (mse_track < mse &&
+      nof_tracked == burst_len-2 &&
+      est_track.track_count[0] == 0 &&
+      ce_mse(ce_track, h, num_re) < 1.5*ce_mse(ce, h, num_re)) {
+    ret = 0;
+  }
+
+  srslte_chest_dl_free(&est);
+  srslte_chest_dl_free(&est_track);
+  free(input);
+  free(h);
+  free(ce);
+  free(ce_track);
+  return ret;
+}
 
 int main(int argc, char **argv) {
   srslte_chest_dl_t est;
-  cf_t *input = NULL, *ce = NULL, *h = NULL, *output = NULL;
+  cf_t *input = NULL, *ce = NULL, *h = NULL, *output = NULL, *ce_steps = NULL;
   int i, j, n_port=0, sf_idx=0, cid=0, num_re;
   int ret = -1;
   int max_cid;
@@ -92,6 +193,14 @@ int main(int argc, char **argv) {
   
   parse_args(argc,argv);
 
+  if (burst_len > 2) {
+    if (cell.id == 1000) {
+      cell.id = 0;
+    }
+    ret = burst_tracking_test();
+    goto do_exit;
+  }
+
   if (output_matlab) {
     fmatlab=fopen(output_matlab, "w");
     if (!fmatlab) {
@@ -123,6 +232,12 @@ int main(int argc, char **argv) {
     goto do_exit;
   }
 
+  ce_steps = srslte_vec_malloc(num_re * sizeof(cf_t));
+  if (!ce_steps) {
+    perror("srslte_vec_malloc");
+    goto do_exit;
+  }
+
   if (cell.id == 1000) {
     cid = 0;
     max_cid = 504;
@@ -168,7 +283,40 @@ int main(int argc, char **argv) {
         gettimeofday(&t[2], NULL);
         get_time_interval(t);
         printf("CHEST: %f us\n", (float) t[0].tv_usec/100);
-        
+
+        if (compare_fused) {
+          float noise = srslte_chest_dl_get_noise_estimate(&est);
+          float rsrp = srslte_chest_dl_get_rsrp(&est);
+          float rssi = srslte_chest_dl_get_rssi(&est);
+
+          bzero(ce_steps, sizeof(cf_t) * num_re);
+          srslte_chest_dl_set_fused(&est, false);
+          gettimeofday(&t[1], NULL);
+          for (int j=0;j<100;j++) {
+            srslte_chest_dl_estimate_port(&est, input, ce_steps, sf_idx, n_port);
+          }
+          gettimeofday(&t[2], NULL);
+          get_time_interval(t);
+          printf("CHEST separate steps: %f us\n", (float) t[0].tv_usec/100);
+          srslte_chest_dl_set_fused(&est, true);
+
+          float max_err = 0;
+          for (i=0;i<num_re;i++) {
+            float err = cabsf(ce[i]-ce_steps[i]);
+            if (err > max_err) {
+              max_err = err;
+            }
+          }
+          printf("Max CE difference: %e\n", max_err);
+          if (max_err > 1e-4 ||
+              fabsf(noise-srslte_chest_dl_get_noise_estimate(&est)) > 1e-4*fabsf(noise) + 1e-9 ||
+              fabsf(rsrp-srslte_chest_dl_get_rsrp(&est)) > 1e-4*rsrp ||
+              fabsf(rssi-srslte_chest_dl_get_rssi(&est)) > 1e-4*rssi) {
+            fprintf(stderr, "Single pass and separate steps estimates differ\n");
+            goto do_exit;
+          }
+        }
+
         gettimeofday(&t[1], NULL);
         for (int j=0;j<100;j++) {
           srslte_predecoding_single(input, ce, output, num_re, 0);
@@ -232,6 +380,9 @@ do_exit:
   if (ce) {
     free(ce);
   }
+  if (ce_steps) {
+    free(ce_steps);
+  }
   if (input) {
     free(input);
   }
@@ -1,28 +1,21 @@
 #include "srslte/channel/channel_emulator.h"
 #include "gauss.h"
 
+// Send and receive check if the channel is open without taking the channels mutex, so the flag is set with release
+// semantics once the channel is created and read with acquire semantics.
+static inline bool channel_emulator_is_channel_open(channel_emulator_t* chann_emulator, uint32_t channel_id) {
+  return __atomic_load_n(&chann_emulator->channels[channel_id].is_open, __ATOMIC_ACQUIRE);
+}
+
 int channel_emulator_initialization(channel_emulator_t* chann_emulator) {
-  // Create channel related structures.
-  for(uint32_t channel_id = 0; channel_id < CH_EMULATOR_NOF_CHANNELS; channel_id++) {
-    // Create named pipe.
-    if(channel_emulator_create_named_pipe(channel_id) < 0) {
-      CH_EMULATOR_ERROR("Error creating named pipe.\n",0);
-      return -1;
-    }
-    // Get reading named pipe.
-    chann_emulator->channels[channel_id].rd_fd = channel_emulator_get_named_pipe_for_reading(channel_id);
-    if(chann_emulator->channels[channel_id].rd_fd < 0) {
-      CH_EMULATOR_ERROR("Error opening channel emulator writer.\n",0);
-      return -1;
-    }
-    // Get writing named pipe.
-    chann_emulator->channels[channel_id].wr_fd = channel_emulator_get_named_pipe_for_writing(channel_id);
-    if(chann_emulator->channels[channel_id].wr_fd < 0) {
-      CH_EMULATOR_ERROR("Error opening channel emulator writer.\n",0);
-      return -1;
-    }
-    // Initialize counters.
-    chann_emulator->channels[channel_id].nof_reads = 0;
+  // Channels are opened on demand, the first time a PHY sends or receives through them.
+  for(uint32_t channel_id = 0; channel_id < CH_EMULATOR_MAX_NOF_CHANNELS; channel_id++) {
+    chann_emulator->channels[channel_id].is_open = false;
+  }
+  // Initialize mutex used to open the channels.
+  if(pthread_mutex_init(&chann_emulator->channels_mutex, NULL) != 0) {
+    CH_EMULATOR_ERROR("Error initializing channels mutex.\n",0);
+    return -1;
   }
   // Initialize subframe length.
   chann_emulator->subframe_length = DEFAULT_SUBFRAME_LEN;
@@ -50,14 +43,8 @@ int channel_emulator_initialization(channel_emulator_t* chann_emulator) {
   chann_emulator->channel_impairments.estimate_psd_func_ptr = &channel_emulator_estimate_psd;
   chann_emulator->channel_impairments.create_psd_script_func_ptr = &channel_emulator_create_psd_script;
   chann_emulator->channel_impairments.set_cfo_freq_func_ptr = &channel_emulator_set_cfo_freq;
-  // Create CFO generator.
-  if(srslte_cfo_init_finer(&chann_emulator->channel_impairments.cfocorr, DEFAULT_SUBFRAME_LEN)) {
-    fprintf(stderr, "Error initiating CFO\n");
-    return -1;
-  }
   // Set the number of FFT bins used.
   chann_emulator->channel_impairments.fft_size = srslte_symbol_sz(DEFAULT_NOF_PRB);
-  srslte_cfo_set_fft_size_finer(&chann_emulator->channel_impairments.cfocorr, chann_emulator->channel_impairments.fft_size);
   // Set default value for CFO frequency.
   chann_emulator->channel_impairments.cfo_freq = 0.0;
   // Allocate and initialize memory for random transmission delay.
@@ -152,7 +139,11 @@ int channel_emulator_uninitialization(channel_emulator_t* chann_emulator) {
   }
   CH_EMULATOR_PRINT("Channel emulator configuration thread stopped successfully\n", 0);
   // Close channel related objects.
-  for(uint32_t channel_id = 0; channel_id < CH_EMULATOR_NOF_CHANNELS; channel_id++) {
+  for(uint32_t channel_id = 0; channel_id < CH_EMULATOR_MAX_NOF_CHANNELS; channel_id++) {
+    // Skip channels that were never used.
+    if(!chann_emulator->channels[channel_id].is_open) {
+      continue;
+    }
     // Close channel emulator writing pipe.
     if(channel_emulator_close_writing_pipe(chann_emulator->channels[channel_id].wr_fd, channel_id) < 0) {
       return -1;
@@ -161,11 +152,12 @@ int channel_emulator_uninitialization(channel_emulator_t* chann_emulator) {
     if(channel_emulator_close_reading_pipe(chann_emulator->channels[channel_id].rd_fd, channel_id) < 0) {
       return -1;
     }
+    chann_emulator->channels[channel_id].is_open = false;
   }
+  // Destroy mutex used to open the channels.
+  pthread_mutex_destroy(&chann_emulator->channels_mutex);
   // Destroy channel impairments object.
   channel_cccf_destroy(chann_emulator->channel_impairments.impairments);
-  // Destroy all CFO related structures.
-  srslte_cfo_free_finer(&chann_emulator->channel_impairments.cfocorr);
   // Free memory used to store Application context object.
 #if(ENABLE_WRITING_RANDOM_ZEROS_SUFFIX==1 || ENABLE_WRITING_RANDOM_ZEROS_PREFIX==1)
   if(chann_emulator->null_sample_vector) {
@@ -281,6 +273,53 @@ void channel_emulator_set_cfo_freq(void* h, float freq) {
   chann_emulator->channel_impairments.cfo_freq = freq;
 }
 
+// Create and open the named pipes of a channel.
+static int channel_emulator_create_channel(channel_t *channel, uint32_t channel_id) {
+  // Create named pipe.
+  if(channel_emulator_create_named_pipe(channel_id) < 0) {
+    CH_EMULATOR_ERROR("Error creating named pipe.\n",0);
+    return -1;
+  }
+  // Get reading named pipe.
+  channel->rd_fd = channel_emulator_get_named_pipe_for_reading(channel_id);
+  if(channel->rd_fd < 0) {
+    CH_EMULATOR_ERROR("Error opening channel emulator reader.\n",0);
+    return -1;
+  }
+  // Get writing named pipe.
+  channel->wr_fd = channel_emulator_get_named_pipe_for_writing(channel_id);
+  if(channel->wr_fd < 0) {
+    CH_EMULATOR_ERROR("Error opening channel emulator writer.\n",0);
+    channel_emulator_close_reading_pipe(channel->rd_fd, channel_id);
+    return -1;
+  }
+  // Initialize counters and per channel impairment state.
+  channel->nof_reads = 0;
+  channel->cfo_phase = 0.0;
+  channel->last_snr = 1000.0;
+  return 0;
+}
+
+// Open the channel if this is the first time one of the PHYs uses it.
+int channel_emulator_open_channel(channel_emulator_t* chann_emulator, uint32_t channel_id) {
+  int ret = 0;
+  if(channel_id >= CH_EMULATOR_MAX_NOF_CHANNELS) {
+    CH_EMULATOR_ERROR("Invalid channel: %d, it must be less than %d.\n", channel_id, CH_EMULATOR_MAX_NOF_CHANNELS);
+    return -1;
+  }
+  // Tx and Rx threads of the same PHY may try to open the channel at the same time.
+  pthread_mutex_lock(&chann_emulator->channels_mutex);
+  if(!chann_emulator->channels[channel_id].is_open) {
+    ret = channel_emulator_create_channel(&chann_emulator->channels[channel_id], channel_id);
+    if(ret == 0) {
+      __atomic_store_n(&chann_emulator->channels[channel_id].is_open, true, __ATOMIC_RELEASE);
+      CH_EMULATOR_PRINT("Channel %d opened.\n", channel_id);
+    }
+  }
+  pthread_mutex_unlock(&chann_emulator->channels_mutex);
+  return ret;
+}
+
 int channel_emulator_create_named_pipe(uint32_t channel_id) {
   int ret = 0;
   char path[100];
@@ -365,10 +404,14 @@ int channel_emulator_send(void* h, void *data, int nof_samples, bool blocking, b
 #if(ENABLE_WRITING_ZEROS==1)
   uint32_t additional_samples = 0;
 #endif
-  static float last_snr[CH_EMULATOR_NOF_CHANNELS] = {1000.0, 1000.0};
+
+  // Open the channel if this PHY has not used it yet.
+  if((channel_id >= CH_EMULATOR_MAX_NOF_CHANNELS || !channel_emulator_is_channel_open(ch_emulator, channel_id)) && channel_emulator_open_channel(ch_emulator, channel_id) < 0) {
+    return -1;
+  }
 
   // Calculate SNR.
-  if(ch_emulator->use_simple_awgn_channel && ch_emulator->channel_impairments.snr != last_snr[channel_id] && is_start_of_burst) {
+  if(ch_emulator->use_simple_awgn_channel && ch_emulator->channel_impairments.snr != ch_emulator->channels[channel_id].last_snr && is_start_of_burst) {
     // Calculate signal power in dBW.
     float tx_rssi = 10*log10(srslte_vec_avg_power_cf((cf_t*)data, nof_samples));
     // Calculate noise power in dBW.
@@ -378,7 +421,7 @@ int channel_emulator_send(void* h, void *data, int nof_samples, bool blocking, b
     // Print calculated values.
     printf("[Channel Emulator] PHY ID: %d - SNR: %1.2f [dB] - Signal power: %1.2f [dBW] - Noise power: %1.2f [dBW] - Noise variance: %1.2e\n", channel_id, (tx_rssi-noise_power), tx_rssi, noise_power, ch_emulator->channel_impairments.noise_variance);
     // Update last noise variance variable.
-    last_snr[channel_id] = ch_emulator->channel_impairments.snr;
+    ch_emulator->channels[channel_id].last_snr = ch_emulator->channel_impairments.snr;
   }
 
   // Write a random number of zeros before the subframe in order to emulate real-world transmission.
@@ -460,6 +503,11 @@ int channel_emulator_recv(void *h, void *data, uint32_t nof_samples, bool blocki
 
   channel_emulator_t *ch_emulator = (channel_emulator_t*)h;
 
+  // Open the channel if this PHY has not used it yet.
+  if((channel_id >= CH_EMULATOR_MAX_NOF_CHANNELS || !channel_emulator_is_channel_open(ch_emulator, channel_id)) && channel_emulator_open_channel(ch_emulator, channel_id) < 0) {
+    return -1;
+  }
+
   // Receive data.
   int ret = recv_samples(h, data, nof_samples, channel_id);
 
@@ -478,7 +526,10 @@ int channel_emulator_recv(void *h, void *data, uint32_t nof_samples, bool blocki
     }
     // Apply CFO to the signal.
     if(ch_emulator->channel_impairments.cfo_freq > 0.0) {
-      srslte_cfo_correct_finer(&ch_emulator->channel_impairments.cfocorr, data, data, ch_emulator->channel_impairments.cfo_freq/((float)ch_emulator->channel_impairments.fft_size));
+      // The CFO is applied by a phase rotator that continues from the last sample of the previous read.
+      ch_emulator->channels[channel_id].cfo_phase = srslte_cfo_correct_rotator((cf_t*)data, (cf_t*)data,
+          ch_emulator->channel_impairments.cfo_freq/((float)ch_emulator->channel_impairments.fft_size),
+          ch_emulator->channels[channel_id].cfo_phase, (uint32_t)ret);
       CH_EMULATOR_INFO("Applying CFO of %f [Hz] to the subframe.\n", ch_emulator->channel_impairments.cfo_freq*15000.0);
     }
   }
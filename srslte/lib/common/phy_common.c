@@ -134,6 +134,8 @@ char *srslte_mod_string(srslte_mod_t mod) {
     return "16QAM";
   case SRSLTE_MOD_64QAM:
     return "64QAM";
+  case SRSLTE_MOD_256QAM:
+    return "256QAM";
   default:
     return "N/A";
   }
@@ -149,6 +151,8 @@ uint32_t srslte_mod_bits_x_symbol(srslte_mod_t mod) {
     return 4;
   case SRSLTE_MOD_64QAM:
     return 6;
+  case SRSLTE_MOD_256QAM:
+    return 8;
   default:
     return 0;
   }
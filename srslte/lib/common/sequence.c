@@ -26,6 +26,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <strings.h>
 #include <assert.h>
 
@@ -35,43 +36,80 @@
 
 #define Nc 1600
 
+/* State of the LFSRs after the first Nc shifts, bit k holding x(Nc + k). x1 always starts from 1. x2 starts from
+ * c_init and the LFSR is linear, so its state is the XOR of the states reached from each bit set in c_init. */
+static const uint32_t sequence_x1_Nc = 0x5E485840;
+static const uint32_t sequence_x2_Nc[31] = {
+  0x70889900, 0x1199AB01, 0x53BBCF03, 0x57FF0707, 0x2FFE0E0E, 0x5FFC1C1C, 0x3FF83838, 0x7FF07070,
+  0x7FE0E0E1, 0x7FC1C1C2, 0x7F838384, 0x7F070708, 0x7E0E0E11, 0x7C1C1C22, 0x78383844, 0x70707088,
+  0x60E0E111, 0x41C1C222, 0x03838444, 0x07070889, 0x0E0E1113, 0x1C1C2226, 0x3838444C, 0x70708899,
+  0x60E11132, 0x41C22264, 0x038444C8, 0x07088990, 0x0E111320, 0x1C222640, 0x38444C80};
+
+/* The feedback taps of both LFSRs are at least 28 bits apart, so each shift of the 31-bit state words computes this
+ * many new bits at once. */
+#define SEQUENCE_PAR_BITS 16
+#define SEQUENCE_PAR_MASK 0xFFFF
+
+// Spreads the bits of b to one byte each, first bit in the first byte.
+static inline uint64_t sequence_unpack_byte(uint64_t b) {
+  uint64_t x = (b * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+  return ((x + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+}
+
 /*
  * Pseudo Random Sequence generation.
  * It follows the 3GPP Release 8 (LTE) 36.211
  * Section 7.2
+ * Writes q->len bits to all the outputs (unpacked, packed, float and short) without allocating memory.
  */
 void srslte_sequence_set_LTE_pr(srslte_sequence_t *q, uint32_t seed) {
-  int n;
-  uint32_t *x1, *x2;
+  uint32_t len = q->len;
+  uint8_t *c = q->c;
+  uint8_t *c_bytes = q->c_bytes;
+  uint32_t x1 = sequence_x1_Nc;
+  uint32_t x2 = 0;
 
-  x1 = calloc(Nc + q->len + 31, sizeof(uint32_t));
-  if (!x1) {
-    perror("calloc");
-    return;
-  }
-  x2 = calloc(Nc + q->len + 31, sizeof(uint32_t));
-  if (!x2) {
-    free(x1);
-    perror("calloc");
-    return;
+  for (int i = 0; i < 31; i++) {
+    if ((seed >> i) & 0x1) {
+      x2 ^= sequence_x2_Nc[i];
+    }
   }
 
-  for (n = 0; n < 31; n++) {
-    x2[n] = (seed >> n) & 0x1;
-  }
-  x1[0] = 1;
+  for (uint32_t n = 0; n < len; n += SEQUENCE_PAR_BITS) {
+    uint32_t w = (x1 ^ x2) & SEQUENCE_PAR_MASK;
+    uint32_t nof_bits = SRSLTE_MIN(SEQUENCE_PAR_BITS, len - n);
 
-  for (n = 0; n < Nc + q->len; n++) {
-    x1[n + 31] = (x1[n + 3] + x1[n]) & 0x1;
-    x2[n + 31] = (x2[n + 3] + x2[n + 2] + +x2[n+1] + x2[n]) & 0x1;
-  }
+    if (nof_bits == SEQUENCE_PAR_BITS) {
+      uint64_t lo = sequence_unpack_byte(w & 0xFF);
+      uint64_t hi = sequence_unpack_byte(w >> 8);
+      memcpy(&c[n], &lo, sizeof(uint64_t));
+      memcpy(&c[n + 8], &hi, sizeof(uint64_t));
+    } else {
+      for (uint32_t k = 0; k < nof_bits; k++) {
+        c[n + k] = (w >> k) & 0x1;
+      }
+      w &= (1 << nof_bits) - 1;
+    }
+
+    // Packed with the first bit in the MSB of each byte, as srslte_bit_pack_vector() does.
+    w = ((w & 0xF0F0) >> 4) | ((w & 0x0F0F) << 4);
+    w = ((w & 0xCCCC) >> 2) | ((w & 0x3333) << 2);
+    w = ((w & 0xAAAA) >> 1) | ((w & 0x5555) << 1);
+    c_bytes[n / 8] = w & 0xFF;
+    if (nof_bits > 8) {
+      c_bytes[n / 8 + 1] = w >> 8;
+    }
 
-  for (n = 0; n < q->len; n++) {
-    q->c[n] = (x1[n + Nc] + x2[n + Nc]) & 0x1;
+    x1 = (x1 >> SEQUENCE_PAR_BITS) | ((((x1 >> 3) ^ x1) & SEQUENCE_PAR_MASK) << (31 - SEQUENCE_PAR_BITS));
+    x2 = (x2 >> SEQUENCE_PAR_BITS) | ((((x2 >> 3) ^ (x2 >> 2) ^ (x2 >> 1) ^ x2) & SEQUENCE_PAR_MASK) << (31 - SEQUENCE_PAR_BITS));
   }
 
-  free(x1);
-  free(x2);
+  float *c_float = q->c_float;
+  short *c_short = q->c_short;
+  for (uint32_t i = 0; i < len; i++) {
+    c_float[i] = 1 - 2 * c[i];
+    c_short[i] = 1 - 2 * c[i];
+  }
 }
 
 int srslte_sequence_LTE_pr(srslte_sequence_t *q, uint32_t len, uint32_t seed) {
@@ -80,26 +118,12 @@ int srslte_sequence_LTE_pr(srslte_sequence_t *q, uint32_t len, uint32_t seed) {
   }
   q->len = len;
   srslte_sequence_set_LTE_pr(q, seed);
-  srslte_bit_pack_vector(q->c, q->c_bytes, len);
-  for (int i=0;i<len;i++) {
-    q->c_float[i] = (1-2*q->c[i]);
-    q->c_short[i] = (int16_t) q->c_float[i];
-  }
   return SRSLTE_SUCCESS;
 }
 
 int srslte_sequence_init(srslte_sequence_t *q, uint32_t len) {
   if (q->c && (q->len != len)) {
-    free(q->c);
-    if (q->c_bytes) {
-      free(q->c_bytes);
-    }
-    if (q->c_float) {
-      free(q->c_float);
-    }
-    if (q->c_short) {
-      free(q->c_short);
-    }
+    srslte_sequence_free(q);
   }
   if (!q->c) {
     q->c = srslte_vec_malloc(len * sizeof(uint8_t));
@@ -138,3 +162,54 @@ void srslte_sequence_free(srslte_sequence_t *q) {
   }
   bzero(q, sizeof(srslte_sequence_t));
 }
+
+int srslte_sequence_cache_init(srslte_sequence_cache_t *q, uint32_t nof_entries) {
+  bzero(q, sizeof(srslte_sequence_cache_t));
+  q->entries = calloc(nof_entries, sizeof(srslte_sequence_cache_entry_t));
+  if (!q->entries) {
+    perror("calloc");
+    return SRSLTE_ERROR;
+  }
+  q->nof_entries = nof_entries;
+  return SRSLTE_SUCCESS;
+}
+
+void srslte_sequence_cache_free(srslte_sequence_cache_t *q) {
+  if (q->entries) {
+    for (uint32_t i = 0; i < q->nof_entries; i++) {
+      srslte_sequence_free(&q->entries[i].seq);
+    }
+    free(q->entries);
+  }
+  bzero(q, sizeof(srslte_sequence_cache_t));
+}
+
+srslte_sequence_t *srslte_sequence_cache_get(srslte_sequence_cache_t *q, uint32_t seed, uint32_t len) {
+  srslte_sequence_cache_entry_t *lru = NULL;
+
+  if (!q->entries) {
+    return NULL;
+  }
+  q->nof_lookups++;
+  for (uint32_t i = 0; i < q->nof_entries; i++) {
+    srslte_sequence_cache_entry_t *e = &q->entries[i];
+    // A longer sequence with the same seed starts with the same bits.
+    if (e->valid && e->seed == seed && e->seq.len >= len) {
+      e->last_used = q->nof_lookups;
+      q->nof_hits++;
+      return &e->seq;
+    }
+    if (!lru || !e->valid || (lru->valid && e->last_used < lru->last_used)) {
+      lru = e;
+    }
+  }
+
+  lru->valid = false;
+  if (srslte_sequence_LTE_pr(&lru->seq, len, seed)) {
+    return NULL;
+  }
+  lru->seed = seed;
+  lru->last_used = q->nof_lookups;
+  lru->valid = true;
+  return &lru->seq;
+}
@@ -0,0 +1,191 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "srslte/srslte.h"
+
+// Checks the Gold sequence generator against the bit-serial definition of 36.211 7.2 and the LRU sequence cache.
+
+#define Nc 1600
+
+uint32_t max_len = 6000;
+uint32_t nof_seeds = 200;
+
+void usage(char *prog) {
+  printf("Usage: %s [ln]\n", prog);
+  printf("\t-l maximum sequence length [Default %d]\n", max_len);
+  printf("\t-n number of random seeds [Default %d]\n", nof_seeds);
+}
+
+void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "ln")) != -1) {
+    switch (opt) {
+    case 'l':
+      max_len = atoi(argv[optind]);
+      break;
+    case 'n':
+      nof_seeds = atoi(argv[optind]);
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+// One LFSR shift per bit, as written in the standard.
+void sequence_reference(uint8_t *c, uint32_t len, uint32_t seed) {
+  uint8_t *x1 = calloc(Nc + len + 31, 1);
+  uint8_t *x2 = calloc(Nc + len + 31, 1);
+  x1[0] = 1;
+  for (uint32_t n = 0; n < 31; n++) {
+    x2[n] = (seed >> n) & 0x1;
+  }
+  for (uint32_t n = 0; n < Nc + len; n++) {
+    x1[n + 31] = (x1[n + 3] + x1[n]) & 0x1;
+    x2[n + 31] = (x2[n + 3] + x2[n + 2] + x2[n + 1] + x2[n]) & 0x1;
+  }
+  for (uint32_t n = 0; n < len; n++) {
+    c[n] = (x1[n + Nc] + x2[n + Nc]) & 0x1;
+  }
+  free(x1);
+  free(x2);
+}
+
+int check_sequence(srslte_sequence_t *seq, uint8_t *c_ref, uint8_t *bytes_ref, uint32_t len, uint32_t seed) {
+  if (memcmp(seq->c, c_ref, len)) {
+    printf("Error seed 0x%x len %d: bits differ\n", seed, len);
+    return -1;
+  }
+  srslte_bit_pack_vector(c_ref, bytes_ref, len);
+  if (memcmp(seq->c_bytes, bytes_ref, (len + 7) / 8)) {
+    printf("Error seed 0x%x len %d: packed bits differ\n", seed, len);
+    return -1;
+  }
+  for (uint32_t i = 0; i < len; i++) {
+    if (seq->c_float[i] != 1 - 2 * c_ref[i] || seq->c_short[i] != 1 - 2 * c_ref[i]) {
+      printf("Error seed 0x%x len %d: float or short value %d differs\n", seed, len, i);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  srslte_sequence_t seq;
+  srslte_sequence_cache_t cache;
+  struct timeval t[3];
+  int ret = -1;
+
+  parse_args(argc, argv);
+
+  uint8_t *c_ref = malloc(max_len);
+  uint8_t *bytes_ref = malloc(max_len / 8 + 1);
+  if (!c_ref || !bytes_ref) {
+    perror("malloc");
+    exit(-1);
+  }
+  bzero(&seq, sizeof(srslte_sequence_t));
+  bzero(&cache, sizeof(srslte_sequence_cache_t));
+
+  // All the seed bits and lengths that are not multiple of the word and byte sizes.
+  uint64_t time_us = 0;
+  for (uint32_t i = 0; i < 31 + nof_seeds; i++) {
+    uint32_t seed = i < 31 ? (1 << i) : (uint32_t) rand() & 0x7FFFFFFF;
+    uint32_t len = 1 + (uint32_t) rand() % max_len;
+    if (i == 0) {
+      len = max_len;
+    }
+    sequence_reference(c_ref, len, seed);
+    gettimeofday(&t[1], NULL);
+    if (srslte_sequence_LTE_pr(&seq, len, seed)) {
+      printf("Error generating sequence\n");
+      goto quit;
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    time_us += t[0].tv_sec * 1000000 + t[0].tv_usec;
+    if (check_sequence(&seq, c_ref, bytes_ref, len, seed)) {
+      goto quit;
+    }
+  }
+  printf("Generated %d sequences in %ld us\n", 31 + nof_seeds, (long) time_us);
+
+  // The cache returns the same sequences, keeps the most recently used ones and serves shorter lengths.
+  if (srslte_sequence_cache_init(&cache, 2)) {
+    printf("Error initializing cache\n");
+    goto quit;
+  }
+  uint32_t seeds[3] = {0x1234, 0x5678, 0x9ABC};
+  uint32_t len = max_len;
+  for (uint32_t i = 0; i < 3; i++) {
+    srslte_sequence_t *s = srslte_sequence_cache_get(&cache, seeds[i], len);
+    sequence_reference(c_ref, len, seeds[i]);
+    if (!s || check_sequence(s, c_ref, bytes_ref, len, seeds[i])) {
+      printf("Error getting sequence from cache\n");
+      goto quit;
+    }
+  }
+  // seeds[0] was evicted, seeds[2] is cached and serves a shorter length.
+  srslte_sequence_cache_get(&cache, seeds[2], len / 2);
+  srslte_sequence_cache_get(&cache, seeds[1], len);
+  if (cache.nof_hits != 2) {
+    printf("Error expected 2 cache hits, got %d\n", (int) cache.nof_hits);
+    goto quit;
+  }
+  srslte_sequence_cache_get(&cache, seeds[0], len);
+  if (cache.nof_hits != 2) {
+    printf("Error evicted sequence still in cache\n");
+    goto quit;
+  }
+  // seeds[2] was the least recently used one.
+  srslte_sequence_cache_get(&cache, seeds[1], len);
+  srslte_sequence_cache_get(&cache, seeds[0], len);
+  if (cache.nof_hits != 4) {
+    printf("Error expected 4 cache hits, got %d\n", (int) cache.nof_hits);
+    goto quit;
+  }
+
+  ret = 0;
+quit:
+  srslte_sequence_free(&seq);
+  srslte_sequence_cache_free(&cache);
+  free(c_ref);
+  free(bytes_ref);
+  if (ret) {
+    printf("Error\n");
+  } else {
+    printf("Ok\n");
+  }
+  exit(ret);
+}
@@ -38,6 +38,47 @@
 
 pthread_mutex_t dft_fftw_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+static unsigned dft_fftw_flags = FFTW_MEASURE;
+
+int srslte_dft_load(const char *wisdom_filename) {
+  int ret = 0;
+  pthread_mutex_lock(&dft_fftw_mutex);
+  if(!fftwf_import_wisdom_from_filename(wisdom_filename)) {
+    ret = -1;
+  }
+  pthread_mutex_unlock(&dft_fftw_mutex);
+  return ret;
+}
+
+int srslte_dft_save(const char *wisdom_filename) {
+  int ret = 0;
+  pthread_mutex_lock(&dft_fftw_mutex);
+  if(!fftwf_export_wisdom_to_filename(wisdom_filename)) {
+    fprintf(stderr, "[DFT Error] Error saving FFTW wisdom to %s.\n", wisdom_filename);
+    ret = -1;
+  }
+  pthread_mutex_unlock(&dft_fftw_mutex);
+  return ret;
+}
+
+void srslte_dft_set_effort(srslte_dft_effort_t effort) {
+  pthread_mutex_lock(&dft_fftw_mutex);
+  switch(effort) {
+    case SRSLTE_DFT_ESTIMATE:
+      dft_fftw_flags = FFTW_ESTIMATE;
+      break;
+    case SRSLTE_DFT_PATIENT:
+      dft_fftw_flags = FFTW_PATIENT;
+      break;
+    case SRSLTE_DFT_EXHAUSTIVE:
+      dft_fftw_flags = FFTW_EXHAUSTIVE;
+      break;
+    default:
+      dft_fftw_flags = FFTW_MEASURE;
+  }
+  pthread_mutex_unlock(&dft_fftw_mutex);
+}
+
 int srslte_dft_plan(srslte_dft_plan_t* const plan, const int dft_points, srslte_dft_dir_t dir, srslte_dft_mode_t mode) {
   if(mode == SRSLTE_DFT_COMPLEX){
     return srslte_dft_plan_c(plan,dft_points,dir);
@@ -58,7 +99,7 @@ int srslte_dft_plan_c(srslte_dft_plan_t* const plan, const int dft_points, srslt
   pthread_mutex_lock(&dft_fftw_mutex);
   allocate(plan, sizeof(fftwf_complex), sizeof(fftwf_complex), dft_points);
   int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
-  plan->p = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, 0U);
+  plan->p = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, dft_fftw_flags);
   if(!plan->p) {
     fprintf(stderr, "[DFT Error] Error creating FFTW Complex plan.\n");
     ret = -1;
@@ -84,12 +125,49 @@ exit_dft_plan_c:
   return ret;
 }
 
+int srslte_dft_plan_batch_c(srslte_dft_plan_t* const plan, const int dft_points, const srslte_dft_batch_t *batch, srslte_dft_dir_t dir) {
+  int ret = 0;
+  pthread_mutex_lock(&dft_fftw_mutex);
+  if(dft_points <= 0 || batch->howmany <= 0 || batch->nof_blocks <= 0) {
+    fprintf(stderr, "[DFT Error] Invalid DFT batch: %d points, %d blocks of %d transforms.\n", dft_points, batch->nof_blocks, batch->howmany);
+    ret = -1;
+    goto exit_dft_plan_batch_c;
+  }
+  plan->in = fftwf_malloc(sizeof(fftwf_complex)*batch->in_len);
+  plan->out = fftwf_malloc(sizeof(fftwf_complex)*batch->out_len);
+  fftwf_iodim dims = {dft_points, 1, 1};
+  fftwf_iodim howmany_dims[2] = {{batch->nof_blocks, batch->in_block_dist, batch->out_block_dist},
+                                 {batch->howmany, batch->in_dist, batch->out_dist}};
+  int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+  plan->p = fftwf_plan_guru_dft(1, &dims, 2, howmany_dims, &((fftwf_complex*)plan->in)[batch->in_offset],
+                                &((fftwf_complex*)plan->out)[batch->out_offset], sign, dft_fftw_flags);
+  if(!plan->p) {
+    fprintf(stderr, "[DFT Error] Error creating FFTW batched Complex plan.\n");
+    ret = -1;
+    goto exit_dft_plan_batch_c;
+  }
+  plan->size = dft_points;
+  plan->mode = SRSLTE_DFT_COMPLEX;
+  plan->dir = dir;
+  plan->forward = (dir==SRSLTE_DFT_FORWARD)?true:false;
+  plan->mirror = false;
+  plan->db = false;
+  plan->norm = false;
+  plan->dc = false;
+  plan->batch = *batch;
+
+exit_dft_plan_batch_c:
+  pthread_mutex_unlock(&dft_fftw_mutex);
+
+  return ret;
+}
+
 int srslte_dft_plan_r(srslte_dft_plan_t* const plan, const int dft_points, srslte_dft_dir_t dir) {
   int ret = 0;
   pthread_mutex_lock(&dft_fftw_mutex);
   allocate(plan,sizeof(float),sizeof(float), dft_points);
   int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
-  plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, 0U);
+  plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, dft_fftw_flags);
   if(!plan->p) {
     fprintf(stderr, "[DFT Error] Error creating FFTW Real plan.\n");
     ret = -1;
@@ -195,6 +273,24 @@ void srslte_dft_run_c(srslte_dft_plan_t* const plan, cf_t *in, cf_t *out) {
   copy_post((uint8_t*)out, (uint8_t*)plan->out, sizeof(cf_t), plan->size, plan->forward, plan->mirror, plan->dc);
 }
 
+void srslte_dft_run_batch_c(srslte_dft_plan_t* const plan, cf_t *in, cf_t *out) {
+  srslte_dft_batch_t *batch = &plan->batch;
+  cf_t *f_in = in;
+  cf_t *f_out = out;
+  // FFTW plans may use SIMD loads and stores that need the alignment the plan was created with.
+  if(fftwf_alignment_of((float*)in) != fftwf_alignment_of((float*)plan->in)) {
+    memcpy(plan->in, in, sizeof(cf_t)*batch->in_len);
+    f_in = plan->in;
+  }
+  if(fftwf_alignment_of((float*)out) != fftwf_alignment_of((float*)plan->out)) {
+    f_out = plan->out;
+  }
+  fftwf_execute_dft(plan->p, &f_in[batch->in_offset], &f_out[batch->out_offset]);
+  if(f_out != out) {
+    memcpy(out, f_out, sizeof(cf_t)*batch->out_len);
+  }
+}
+
 void srslte_dft_run_r(srslte_dft_plan_t* const plan, float *in, float *out) {
   float norm;
   int i;
@@ -59,6 +59,44 @@ int srslte_ofdm_init_(srslte_ofdm_t *q, srslte_cp_t cp, int symbol_sz, int nof_p
   q->nof_guards = ((symbol_sz - q->nof_re) / 2);
   q->slot_sz = SRSLTE_SLOT_LEN(symbol_sz);
 
+  // Within a slot the symbols after the first one have the same CP, so the start of the symbol i is at
+  // cp_len(0) + i*(symbol_sz + cp_len(1)) and the subframe is 2 blocks of nof_symbols transforms.
+  uint32_t cp_first = SRSLTE_CP_ISNORM(cp)?SRSLTE_CP_LEN_NORM(0, symbol_sz):SRSLTE_CP_LEN_EXT(symbol_sz);
+  uint32_t cp_next = SRSLTE_CP_ISNORM(cp)?SRSLTE_CP_LEN_NORM(1, symbol_sz):SRSLTE_CP_LEN_EXT(symbol_sz);
+  uint32_t samples_offset = cp_first, samples_dist = symbol_sz + cp_next, samples_len = 2*q->slot_sz;
+  uint32_t symbols_offset = 0, symbols_dist = symbol_sz, symbols_len = 2*q->nof_symbols*symbol_sz;
+  srslte_dft_batch_t batch;
+  batch.howmany = q->nof_symbols;
+  batch.nof_blocks = 2;
+  if(dir == SRSLTE_DFT_FORWARD) {
+    batch.in_offset = samples_offset;
+    batch.in_dist = samples_dist;
+    batch.in_block_dist = q->slot_sz;
+    batch.in_len = samples_len;
+    batch.out_offset = symbols_offset;
+    batch.out_dist = symbols_dist;
+    batch.out_block_dist = q->nof_symbols*symbol_sz;
+    batch.out_len = symbols_len;
+  } else {
+    batch.in_offset = symbols_offset;
+    batch.in_dist = symbols_dist;
+    batch.in_block_dist = q->nof_symbols*symbol_sz;
+    batch.in_len = symbols_len;
+    batch.out_offset = samples_offset;
+    batch.out_dist = samples_dist;
+    batch.out_block_dist = q->slot_sz;
+    batch.out_len = samples_len;
+  }
+  if(srslte_dft_plan_batch_c(&q->batch_plan, symbol_sz, &batch, dir)) {
+    fprintf(stderr, "Error: Creating batched DFT plan\n");
+    return -1;
+  }
+  // The subcarriers out of the grid are never written.
+  if(dir == SRSLTE_DFT_BACKWARD) {
+    bzero(q->batch_plan.in, sizeof(cf_t)*batch.in_len);
+  }
+  q->batch = true;
+
   DEBUG("Init %s symbol_sz=%d, nof_symbols=%d, cp=%s, nof_re=%d, nof_guards=%d, slot_sz=%d\n",
       dir==SRSLTE_DFT_FORWARD?"FFT":"iFFT", q->symbol_sz, q->nof_symbols,
           q->cp==SRSLTE_CP_NORM?"Normal":"Extended", q->nof_re, q->nof_guards,q->slot_sz);
@@ -68,6 +106,7 @@ int srslte_ofdm_init_(srslte_ofdm_t *q, srslte_cp_t cp, int symbol_sz, int nof_p
 
 void srslte_ofdm_free_(srslte_ofdm_t *q) {
   srslte_dft_plan_free(&q->fft_plan);
+  srslte_dft_plan_free(&q->batch_plan);
   if(q->tmp) {
     free(q->tmp);
   }
@@ -137,6 +176,10 @@ int srslte_ofdm_set_freq_shift(srslte_ofdm_t *q, float freq_shift) {
 
   /* Disable DC carrier addition */
   srslte_dft_plan_set_dc(&q->fft_plan, false);
+  if(!q->fft_plan.forward) {
+    // The subcarrier mapping moves one subcarrier, clear the one it leaves.
+    bzero(q->batch_plan.in, sizeof(cf_t)*q->batch_plan.batch.in_len);
+  }
 
   q->freq_shift = true;
 
@@ -173,8 +216,41 @@ void srslte_ofdm_rx_slot_zerocopy(srslte_ofdm_t *q, cf_t *input, cf_t *output) {
   }
 }
 
+/* Transforms all the symbols of the subframe with the batched plan, the frequency shift is applied while staging
+ * the input into the plan buffer and the normalization while removing the guards.
+ */
+static void ofdm_rx_sf_batch(srslte_ofdm_t *q, cf_t *input, cf_t *output) {
+  uint32_t i;
+  uint32_t half = q->nof_re/2;
+  uint32_t dc = q->fft_plan.dc?1:0;
+  float norm = 1.0/sqrtf(q->symbol_sz);
+  cf_t *symbol = q->batch_plan.out;
+
+  if (q->freq_shift) {
+    srslte_vec_prod_ccc(input, q->shift_buffer, q->batch_plan.in, 2*q->slot_sz);
+    input = q->batch_plan.in;
+  }
+  srslte_dft_run_batch_c(&q->batch_plan, input, q->batch_plan.out);
+  // Negative frequencies are at the end of the symbol and positive ones after the DC.
+  for (i=0;i<2*q->nof_symbols;i++) {
+    if (q->fft_plan.norm) {
+      srslte_vec_sc_prod_cfc(&symbol[q->symbol_sz-half], norm, output, half);
+      srslte_vec_sc_prod_cfc(&symbol[dc], norm, &output[half], half);
+    } else {
+      memcpy(output, &symbol[q->symbol_sz-half], half*sizeof(cf_t));
+      memcpy(&output[half], &symbol[dc], half*sizeof(cf_t));
+    }
+    symbol += q->symbol_sz;
+    output += q->nof_re;
+  }
+}
+
 void srslte_ofdm_rx_sf(srslte_ofdm_t *q, cf_t *input, cf_t *output) {
   uint32_t n;
+  if (q->batch) {
+    ofdm_rx_sf_batch(q, input, output);
+    return;
+  }
   if (q->freq_shift) {
     srslte_vec_prod_ccc(input, q->shift_buffer, input, 2*q->slot_sz);
   }
@@ -204,8 +280,51 @@ void srslte_ofdm_set_normalize(srslte_ofdm_t *q, bool normalize_enable) {
   srslte_dft_plan_set_norm(&q->fft_plan, normalize_enable);
 }
 
+void srslte_ofdm_set_batch(srslte_ofdm_t *q, bool batch_enable) {
+  q->batch = batch_enable;
+}
+
+/* Maps the grid of the subframe to the batched plan buffer, normalizing it, transforms all the symbols directly to
+ * their place after the CP and then adds the CPs.
+ */
+static void ofdm_tx_sf_batch(srslte_ofdm_t *q, cf_t *input, cf_t *output) {
+  uint32_t i, n, cp_len;
+  uint32_t half = q->nof_re/2;
+  uint32_t dc = q->fft_plan.dc?1:0;
+  float norm = 1.0/sqrtf(q->symbol_sz);
+  cf_t *symbol = q->batch_plan.in;
+
+  for (i=0;i<2*q->nof_symbols;i++) {
+    if (q->fft_plan.norm) {
+      srslte_vec_sc_prod_cfc(&input[half], norm, &symbol[dc], half);
+      srslte_vec_sc_prod_cfc(input, norm, &symbol[q->symbol_sz-half], half);
+    } else {
+      memcpy(&symbol[dc], &input[half], half*sizeof(cf_t));
+      memcpy(&symbol[q->symbol_sz-half], input, half*sizeof(cf_t));
+    }
+    symbol += q->symbol_sz;
+    input += q->nof_re;
+  }
+  srslte_dft_run_batch_c(&q->batch_plan, q->batch_plan.in, output);
+  cf_t *ptr = output;
+  for (n=0;n<2;n++) {
+    for (i=0;i<q->nof_symbols;i++) {
+      cp_len = SRSLTE_CP_ISNORM(q->cp)?SRSLTE_CP_LEN_NORM(i, q->symbol_sz):SRSLTE_CP_LEN_EXT(q->symbol_sz);
+      memcpy(ptr, &ptr[q->symbol_sz], cp_len * sizeof(cf_t));
+      ptr += q->symbol_sz + cp_len;
+    }
+  }
+  if (q->freq_shift) {
+    srslte_vec_prod_ccc(output, q->shift_buffer, output, 2*q->slot_sz);
+  }
+}
+
 void srslte_ofdm_tx_sf(srslte_ofdm_t *q, cf_t *input, cf_t *output) {
   uint32_t n;
+  if (q->batch) {
+    ofdm_tx_sf_batch(q, input, output);
+    return;
+  }
   for (n=0;n<2;n++) {
     srslte_ofdm_tx_slot(q, &input[n*q->nof_re*q->nof_symbols], &output[n*q->slot_sz]);
   }
@@ -30,21 +30,26 @@
 #include <strings.h>
 #include <unistd.h>
 #include <math.h>
+#include <sys/time.h>
 
 #include "srslte/srslte.h"
 
 int nof_prb = -1;
 srslte_cp_t cp = SRSLTE_CP_NORM;
+bool freq_shift = false;
+int nof_repetitions = 0;
 
 void usage(char *prog) {
   printf("Usage: %s\n", prog);
   printf("\t-n nof_prb [Default All]\n");
   printf("\t-e extended cyclic prefix [Default Normal]\n");
+  printf("\t-s shift by half a subcarrier [Default no]\n");
+  printf("\t-b nof_repetitions to time the batched and per symbol subframe transforms [Default %d]\n", nof_repetitions);
 }
 
 void parse_args(int argc, char **argv) {
   int opt;
-  while ((opt = getopt(argc, argv, "ne")) != -1) {
+  while ((opt = getopt(argc, argv, "nesb")) != -1) {
     switch (opt) {
     case 'n':
       nof_prb = atoi(argv[optind]);
@@ -52,6 +57,12 @@ void parse_args(int argc, char **argv) {
     case 'e':
       cp = SRSLTE_CP_EXT;
       break;
+    case 's':
+      freq_shift = true;
+      break;
+    case 'b':
+      nof_repetitions = atoi(argv[optind]);
+      break;
     default:
       usage(argv[0]);
       exit(-1);
@@ -59,6 +70,70 @@ void parse_args(int argc, char **argv) {
   }
 }
 
+/* Runs the subframe transforms batched and symbol by symbol, checks that both give the same samples and symbols and
+ * times them if requested. */
+int compare_batch(srslte_ofdm_t *fft, srslte_ofdm_t *ifft, cf_t *input, int n_re) {
+  int sf_len = SRSLTE_SF_LEN(fft->symbol_sz);
+  cf_t *samples = malloc(sizeof(cf_t) * sf_len);
+  cf_t *samples_batch = malloc(sizeof(cf_t) * sf_len);
+  cf_t *symbols = malloc(sizeof(cf_t) * 2 * n_re);
+  cf_t *symbols_batch = malloc(sizeof(cf_t) * 2 * n_re);
+  struct timeval t[3];
+  float err_samples = 0, err_symbols = 0, power = 0;
+  int i;
+
+  if (!samples || !samples_batch || !symbols || !symbols_batch) {
+    perror("malloc");
+    exit(-1);
+  }
+  srslte_ofdm_set_batch(ifft, true);
+  srslte_ofdm_tx_sf(ifft, input, samples_batch);
+  srslte_ofdm_set_batch(ifft, false);
+  srslte_ofdm_tx_sf(ifft, input, samples);
+  for (i=0;i<sf_len;i++) {
+    err_samples = fmaxf(err_samples, cabsf(samples[i] - samples_batch[i]));
+    power = fmaxf(power, cabsf(samples[i]));
+  }
+  // The per symbol receiver shifts its input in place.
+  srslte_ofdm_set_batch(fft, true);
+  srslte_ofdm_rx_sf(fft, samples, symbols_batch);
+  srslte_ofdm_set_batch(fft, false);
+  srslte_ofdm_rx_sf(fft, samples, symbols);
+  for (i=0;i<2*n_re;i++) {
+    err_symbols = fmaxf(err_symbols, cabsf(symbols[i] - symbols_batch[i]));
+  }
+  printf("batch error: samples=%f, symbols=%f... ", err_samples/power, err_symbols);
+
+  for (i=0;i<2;i++) {
+    srslte_ofdm_set_batch(fft, i==0);
+    srslte_ofdm_set_batch(ifft, i==0);
+    if (nof_repetitions > 0) {
+      gettimeofday(&t[1], NULL);
+      for (int n=0;n<nof_repetitions;n++) {
+        srslte_ofdm_tx_sf(ifft, input, samples);
+      }
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      printf("\n\t%s tx_sf: %.2f us", i==0?"batched":"per symbol", (float) (t[0].tv_sec*1e6 + t[0].tv_usec)/nof_repetitions);
+      gettimeofday(&t[1], NULL);
+      for (int n=0;n<nof_repetitions;n++) {
+        srslte_ofdm_rx_sf(fft, samples, symbols);
+      }
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      printf(", rx_sf: %.2f us", (float) (t[0].tv_sec*1e6 + t[0].tv_usec)/nof_repetitions);
+    }
+  }
+  if (nof_repetitions > 0) {
+    printf("\n");
+  }
+
+  free(samples);
+  free(samples_batch);
+  free(symbols);
+  free(symbols_batch);
+  return (err_samples/power > 1e-4 || err_symbols > 1e-3)?-1:0;
+}
 
 int main(int argc, char **argv) {
   srslte_ofdm_t fft, ifft;
@@ -81,7 +156,7 @@ int main(int argc, char **argv) {
 
     printf("Running test for %d PRB, %d RE... ", n_prb, n_re);fflush(stdout);
 
-    input = malloc(sizeof(cf_t) * n_re);
+    input = malloc(sizeof(cf_t) * 2 * n_re);
     if (!input) {
       perror("malloc");
       exit(-1);
@@ -109,7 +184,14 @@ int main(int argc, char **argv) {
     }
     srslte_dft_plan_set_norm(&ifft.fft_plan, true);
 
-    for (i=0;i<n_re;i++) {
+    if (freq_shift) {
+      if (srslte_ofdm_set_freq_shift(&ifft, 0.5) || srslte_ofdm_set_freq_shift(&fft, -0.5)) {
+        fprintf(stderr, "Error setting frequency shift\n");
+        exit(-1);
+      }
+    }
+
+    for (i=0;i<2*n_re;i++) {
       input[i] = 100 * ((float) rand()/RAND_MAX + (float) I*rand()/RAND_MAX);
     }
 
@@ -122,13 +204,19 @@ int main(int argc, char **argv) {
     for (i=0;i<n_re;i++) {
       mse += cabsf(input[i] - outifft[i]);
     }
-    printf("MSE=%f\n", mse);
+    printf("MSE=%f, ", mse);
 
     if (mse >= 0.07) {
       printf("MSE too large\n");
       exit(-1);
     }
 
+    if (compare_batch(&fft, &ifft, input, n_re)) {
+      printf("Batched subframe transforms differ\n");
+      exit(-1);
+    }
+    printf("\n");
+
     srslte_ofdm_rx_free(&fft);
     srslte_ofdm_tx_free(&ifft);
 
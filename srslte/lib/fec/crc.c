@@ -27,10 +27,254 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "srslte/utils/bit.h"
 #include "srslte/fec/crc.h"
 
+#if defined(LV_HAVE_SSE) && defined(__GNUC__) && defined(__x86_64__)
+#define CRC_HAVE_PCLMUL
+#include <immintrin.h>
+#endif
+
+/* The fast engines work on a 32 bit register with the CRC left aligned (MSB first), so the same code serves every
+ * order. poly32 is the polynomial shifted to the top without its x^32 term.
+ */
+struct srslte_crc_engine {
+  uint32_t polynom;
+  int order;
+  uint32_t poly32;
+  uint32_t slice[8][256];
+#ifdef CRC_HAVE_PCLMUL
+  // x^n mod P' for the folding distances, with P' = x^32 + poly32.
+  uint64_t k_fold[5][2];  // k_fold[m] = {x^(128*m) mod P', x^(128*m+64) mod P'}
+  uint64_t k96;
+  uint64_t k64;
+  uint64_t mu;            // floor(x^64 / P')
+  uint64_t p33;
+#endif
+};
+
+// LTE uses 4 polynomials, some room is left for others.
+#define CRC_MAX_ENGINES 8
+
+static struct srslte_crc_engine crc_engines[CRC_MAX_ENGINES];
+static int crc_nof_engines = 0;
+static pthread_mutex_t crc_engines_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void gen_engine(struct srslte_crc_engine *e, uint32_t polynom, int order) {
+  e->polynom = polynom;
+  e->order = order;
+  e->poly32 = (uint32_t) (((uint64_t) polynom) << (32 - order));
+
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i << 24;
+    for (int j = 0; j < 8; j++) {
+      crc = (crc & 0x80000000) ? (crc << 1) ^ e->poly32 : (crc << 1);
+    }
+    e->slice[0][i] = crc;
+  }
+  for (int k = 1; k < 8; k++) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t prev = e->slice[k - 1][i];
+      e->slice[k][i] = (prev << 8) ^ e->slice[0][prev >> 24];
+    }
+  }
+
+#ifdef CRC_HAVE_PCLMUL
+  e->p33 = (1ULL << 32) | e->poly32;
+
+  // x^n mod P' for n = 0..128*4+64, keeping the ones needed.
+  uint64_t v = 1;
+  for (int n = 0; n <= 128*4 + 64; n++) {
+    if (n >= 128 && n % 64 == 0) {
+      e->k_fold[n/128][(n % 128) ? 1 : 0] = v;
+    }
+    if (n == 96) {
+      e->k96 = v;
+    }
+    if (n == 64) {
+      e->k64 = v;
+    }
+    v <<= 1;
+    if (v & (1ULL << 32)) {
+      v ^= e->p33;
+    }
+  }
+
+  // Polynomial long division of x^64 by P'.
+  unsigned __int128 r = ((unsigned __int128) 1) << 64;
+  uint64_t q = 0;
+  for (int i = 64; i >= 32; i--) {
+    if ((r >> i) & 1) {
+      q |= 1ULL << (i - 32);
+      r ^= ((unsigned __int128) e->p33) << (i - 32);
+    }
+  }
+  e->mu = q;
+#endif
+}
+
+static const struct srslte_crc_engine *get_engine(uint32_t polynom, int order) {
+  const struct srslte_crc_engine *e = NULL;
+  pthread_mutex_lock(&crc_engines_mutex);
+  for (int i = 0; i < crc_nof_engines && !e; i++) {
+    if (crc_engines[i].polynom == polynom && crc_engines[i].order == order) {
+      e = &crc_engines[i];
+    }
+  }
+  if (!e && crc_nof_engines < CRC_MAX_ENGINES) {
+    gen_engine(&crc_engines[crc_nof_engines], polynom, order);
+    e = &crc_engines[crc_nof_engines++];
+  }
+  pthread_mutex_unlock(&crc_engines_mutex);
+  return e;
+}
+
+static uint32_t crc_slice8(const struct srslte_crc_engine *e, uint32_t crc, const uint8_t *data, uint32_t nof_bytes) {
+  while (nof_bytes >= 8) {
+    uint32_t w = crc ^ (((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3]);
+    crc = e->slice[7][w >> 24] ^ e->slice[6][(w >> 16) & 0xff] ^ e->slice[5][(w >> 8) & 0xff] ^ e->slice[4][w & 0xff] ^
+          e->slice[3][data[4]] ^ e->slice[2][data[5]] ^ e->slice[1][data[6]] ^ e->slice[0][data[7]];
+    data += 8;
+    nof_bytes -= 8;
+  }
+  while (nof_bytes--) {
+    crc = (crc << 8) ^ e->slice[0][(crc >> 24) ^ *data++];
+  }
+  return crc;
+}
+
+#ifdef CRC_HAVE_PCLMUL
+
+static bool pclmul_supported() {
+  static int supported = -1;
+  if (supported < 0) {
+    __builtin_cpu_init();
+    supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+  }
+  return supported;
+}
+
+#define CRC_PCLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+
+// Loads 16 bytes so that the first bit of data is the x^127 coefficient.
+CRC_PCLMUL_TARGET
+static inline __m128i load_msb_first(const uint8_t *data) {
+  const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) data), reverse);
+}
+
+// x*x^(128*m) mod P', up to 95 bits.
+CRC_PCLMUL_TARGET
+static inline __m128i fold(__m128i x, __m128i k) {
+  return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11));
+}
+
+/* Processes nof_bytes (a multiple of 16, at least 16) with the register crc as initial state. Four blocks are folded
+ * in parallel to hide the multiplication latency.
+ */
+CRC_PCLMUL_TARGET
+static uint32_t crc_pclmul(const struct srslte_crc_engine *e, uint32_t crc, const uint8_t *data, uint32_t nof_bytes) {
+  uint32_t nof_blocks = nof_bytes / 16;
+  __m128i x0 = _mm_xor_si128(load_msb_first(data), _mm_set_epi32(crc, 0, 0, 0));
+  data += 16;
+  nof_blocks--;
+
+  if (nof_blocks >= 3) {
+    __m128i x1 = load_msb_first(data);
+    __m128i x2 = load_msb_first(data + 16);
+    __m128i x3 = load_msb_first(data + 32);
+    data += 48;
+    nof_blocks -= 3;
+
+    const __m128i k4 = _mm_set_epi64x(e->k_fold[4][1], e->k_fold[4][0]);
+    while (nof_blocks >= 4) {
+      x0 = _mm_xor_si128(fold(x0, k4), load_msb_first(data));
+      x1 = _mm_xor_si128(fold(x1, k4), load_msb_first(data + 16));
+      x2 = _mm_xor_si128(fold(x2, k4), load_msb_first(data + 32));
+      x3 = _mm_xor_si128(fold(x3, k4), load_msb_first(data + 48));
+      data += 64;
+      nof_blocks -= 4;
+    }
+
+    const __m128i k3 = _mm_set_epi64x(e->k_fold[3][1], e->k_fold[3][0]);
+    const __m128i k2 = _mm_set_epi64x(e->k_fold[2][1], e->k_fold[2][0]);
+    const __m128i k1 = _mm_set_epi64x(e->k_fold[1][1], e->k_fold[1][0]);
+    x0 = _mm_xor_si128(_mm_xor_si128(fold(x0, k3), fold(x1, k2)), _mm_xor_si128(fold(x2, k1), x3));
+  }
+
+  const __m128i k1 = _mm_set_epi64x(e->k_fold[1][1], e->k_fold[1][0]);
+  while (nof_blocks--) {
+    x0 = _mm_xor_si128(fold(x0, k1), load_msb_first(data));
+    data += 16;
+  }
+
+  // x0*x^32 mod P': 128 -> 96 -> 64 bits, then Barrett reduction.
+  const __m128i k = _mm_set_epi64x(e->k64, e->k96);
+  __m128i y = _mm_xor_si128(_mm_clmulepi64_si128(x0, k, 0x01), _mm_slli_si128(_mm_move_epi64(x0), 4));
+  __m128i z = _mm_xor_si128(_mm_clmulepi64_si128(_mm_srli_si128(y, 8), k, 0x10), _mm_move_epi64(y));
+  const __m128i barrett = _mm_set_epi64x(e->p33, e->mu);
+  __m128i t = _mm_clmulepi64_si128(_mm_srli_epi64(z, 32), barrett, 0x00);
+  t = _mm_clmulepi64_si128(_mm_srli_epi64(t, 32), barrett, 0x10);
+  return (uint32_t) _mm_cvtsi128_si32(_mm_xor_si128(z, t));
+}
+
+#else
+
+static bool pclmul_supported() {
+  return false;
+}
+
+#endif /* CRC_HAVE_PCLMUL */
+
+// Shorter inputs are not worth the folding setup.
+#define CRC_PCLMUL_MIN_BYTES 64
+
+static inline bool use_engine(srslte_crc_t *h) {
+  return h->engine != NULL && h->engine_type != SRSLTE_CRC_ENGINE_TABLE;
+}
+
+/* Runs the engine selected in h over nof_bytes, starting from the (left aligned) register crc. */
+static uint32_t crc_run(srslte_crc_t *h, uint32_t crc, const uint8_t *data, uint32_t nof_bytes) {
+#ifdef CRC_HAVE_PCLMUL
+  if (h->engine_type == SRSLTE_CRC_ENGINE_PCLMUL && nof_bytes >= CRC_PCLMUL_MIN_BYTES) {
+    uint32_t fold_bytes = nof_bytes & ~15U;
+    crc = crc_pclmul(h->engine, crc, data, fold_bytes);
+    data += fold_bytes;
+    nof_bytes -= fold_bytes;
+  }
+#endif
+  return crc_slice8(h->engine, crc, data, nof_bytes);
+}
+
+bool srslte_crc_engine_supported(srslte_crc_engine_type_t engine_type) {
+  switch (engine_type) {
+    case SRSLTE_CRC_ENGINE_AUTO:
+    case SRSLTE_CRC_ENGINE_TABLE:
+    case SRSLTE_CRC_ENGINE_SLICE8:
+      return true;
+    case SRSLTE_CRC_ENGINE_PCLMUL:
+      return pclmul_supported();
+    default:
+      return false;
+  }
+}
+
+int srslte_crc_set_engine(srslte_crc_t *h, srslte_crc_engine_type_t engine_type) {
+  if (!srslte_crc_engine_supported(engine_type)) {
+    return -1;
+  }
+  if (engine_type == SRSLTE_CRC_ENGINE_AUTO) {
+    engine_type = pclmul_supported() ? SRSLTE_CRC_ENGINE_PCLMUL : SRSLTE_CRC_ENGINE_SLICE8;
+  }
+  if (!h->engine && engine_type != SRSLTE_CRC_ENGINE_TABLE) {
+    engine_type = SRSLTE_CRC_ENGINE_TABLE;
+  }
+  h->engine_type = engine_type;
+  return 0;
+}
+
 void gen_crc_table(srslte_crc_t *h) {
 
   int i, j, ord = (h->order - 8);
@@ -97,6 +341,10 @@ int srslte_crc_init(srslte_crc_t *h, uint32_t crc_poly, int crc_order) {
   // generate lookup table
   gen_crc_table(h);
 
+  // Shared tables of the fast engines
+  h->engine = get_engine(crc_poly, crc_order);
+  srslte_crc_set_engine(h, SRSLTE_CRC_ENGINE_AUTO);
+
   return 0;
 }
 
@@ -115,7 +363,23 @@ uint32_t srslte_crc_checksum(srslte_crc_t *h, uint8_t *data, int len) {
   }
 
   // Calculate CRC
-  for (i = 0; i < len8 + a; i++) {
+  if (use_engine(h)) {
+    // Whole bytes are packed in chunks and given to the fast engine.
+    uint8_t packed[256];
+    uint32_t reg = 0;
+    pter = data;
+    for (i = 0; i < len8; i += sizeof(packed)) {
+      int n = (len8 - i < (int) sizeof(packed)) ? len8 - i : (int) sizeof(packed);
+      srslte_bit_pack_vector(pter, packed, 8 * n);
+      pter += 8 * n;
+      reg = crc_run(h, reg, packed, n);
+    }
+    h->crcinit = reg >> (32 - h->order);
+    i = len8;
+  } else {
+    i = 0;
+  }
+  for (; i < len8 + a; i++) {
     pter = (uint8_t *) (data + 8 * i);
     uint8_t byte;
     if (i == len8) {
@@ -148,6 +412,11 @@ uint32_t srslte_crc_checksum_byte(srslte_crc_t *h, uint8_t *data, int len) {
   srslte_crc_set_init(h, 0);
 
   // Calculate CRC
+  if (use_engine(h)) {
+    crc = crc_run(h, 0, data, len/8) >> (32 - h->order);
+    h->crcinit = crc;
+    return crc;
+  }
   for (i = 0; i < len/8; i++) {
     srslte_crc_checksum_put_byte(h, data[i]);
   }
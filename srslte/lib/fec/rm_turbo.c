@@ -30,6 +30,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <pthread.h>
 
 #include "srslte/fec/rm_turbo.h"
 #include "srslte/utils/bit.h"
@@ -60,22 +61,25 @@ int srslte_rm_turbo_rx_lut_avx_8bit(int8_t *input, int8_t *output, uint16_t *dei
 static uint8_t RM_PERM_TC[NCOLS] = { 0, 16, 8, 24, 4, 20, 12, 28, 2, 18, 10, 26,
     6, 22, 14, 30, 1, 17, 9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31 };
 
-/* Align tables to 16-byte boundary */
+/* The tables only depend on the CB size, so a single copy is shared (read only) by all the PHYs. It is built by the
+ * first srslte_rm_turbo_gentables() call and released when the last user calls srslte_rm_turbo_free_tables().
+ */
 
-static uint16_t interleaver_systematic_bits[2][192][6160]; // 4 tail bits
-static srslte_bit_interleaver_t bit_interleavers_systematic_bits[2][192];
-static uint16_t interleaver_parity_bits[2][192][2*6160];
-static srslte_bit_interleaver_t bit_interleavers_parity_bits[2][192];
-static uint16_t deinterleaver[2][192][4][18448];
-static int k0_vec[2][SRSLTE_NOF_TC_CB_SIZES][4][2];
-static bool rm_turbo_tables_generated[2] = {false, false};
+static uint16_t interleaver_systematic_bits[192][6160]; // 4 tail bits
+static srslte_bit_interleaver_t bit_interleavers_systematic_bits[192];
+static uint16_t interleaver_parity_bits[192][2*6160];
+static srslte_bit_interleaver_t bit_interleavers_parity_bits[192];
+static uint16_t deinterleaver[192][4][18448];
+static int k0_vec[SRSLTE_NOF_TC_CB_SIZES][4][2];
+static uint32_t rm_turbo_tables_users = 0;
+static pthread_mutex_t rm_turbo_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 
 // Store deinterleaver version for sub-block turbo decoder
 #if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
 // Prepare bit for sub-block decoder processing. These are the nof subblock sizes
-#define NOF_DEINTER_TABLE_SB_IDX 3
-const static int deinter_table_sb_idx[NOF_DEINTER_TABLE_SB_IDX] = {8, 16, 32};
+#define NOF_DEINTER_TABLE_SB_IDX 4
+const static int deinter_table_sb_idx[NOF_DEINTER_TABLE_SB_IDX] = {8, 16, 32, 64};
 int deinter_table_idx_from_sb_len(uint32_t nof_subblocks) {
   for (int i=0;i<NOF_DEINTER_TABLE_SB_IDX;i++) {
     if (deinter_table_sb_idx[i] == nof_subblocks) {
@@ -87,10 +91,11 @@ int deinter_table_idx_from_sb_len(uint32_t nof_subblocks) {
   }
   return -1;
 }
-static uint16_t deinterleaver_sb[2][NOF_DEINTER_TABLE_SB_IDX][192][4][18448];
+static uint16_t deinterleaver_sb[NOF_DEINTER_TABLE_SB_IDX][192][4][18448];
 #endif
 
-static uint16_t temp_table1[2][3*6176], temp_table2[2][3*6176];
+// Only used while generating the tables, which is done with rm_turbo_tables_mutex locked.
+static uint16_t temp_table1[3*6176], temp_table2[3*6176];
 
 static void srslte_rm_turbo_gentable_systematic(uint16_t *table_bits, int k0_vec[4][2], uint32_t nrows, int ndummy) {
 
@@ -161,7 +166,7 @@ static void srslte_rm_turbo_gentable_parity(uint16_t *table_parity, int k0_vec[4
   }
 }
 
-static void srslte_rm_turbo_gentable_receive(uint32_t phy_idx, uint16_t *table, uint32_t cb_len, uint32_t rv_idx)
+static void srslte_rm_turbo_gentable_receive(uint16_t *table, uint32_t cb_len, uint32_t rv_idx)
 {
 
   int nrows = (uint32_t) (cb_len / 3 - 1) / NCOLS + 1;
@@ -210,7 +215,7 @@ static void srslte_rm_turbo_gentable_receive(uint32_t phy_idx, uint16_t *table,
     }
 
     if (!isdummy) {
-      temp_table1[phy_idx][k] = jp%(3*nrows*NCOLS);
+      temp_table1[k] = jp%(3*nrows*NCOLS);
       k++;
     }
     j++;
@@ -229,11 +234,11 @@ static void srslte_rm_turbo_gentable_receive(uint32_t phy_idx, uint16_t *table,
         kidx = (k / NCOLS + nrows * RM_PERM_TC[k % NCOLS]) % K_p;
         kidx = 2 * kidx + K_p + 1;
       }
-      temp_table2[phy_idx][kidx] = 3*i+j;
+      temp_table2[kidx] = 3*i+j;
     }
   }
   for (int i=0;i<cb_len;i++) {
-    table[i] = temp_table2[phy_idx][temp_table1[phy_idx][i]];
+    table[i] = temp_table2[temp_table1[i]];
   }
 }
 #if SRSLTE_TDEC_EXPECT_INPUT_SB==1
@@ -264,9 +269,9 @@ static void interleave_table_sb(uint16_t *in, uint16_t *out, uint32_t cb_idx, ui
 }
 #endif
 
-void srslte_rm_turbo_gentables(uint32_t phy_idx) {
-  if (!rm_turbo_tables_generated[phy_idx]) {
-    rm_turbo_tables_generated[phy_idx] = true;
+void srslte_rm_turbo_gentables() {
+  pthread_mutex_lock(&rm_turbo_tables_mutex);
+  if (rm_turbo_tables_users++ == 0) {
     for (int cb_idx=0;cb_idx<SRSLTE_NOF_TC_CB_SIZES;cb_idx++) {
       int cb_len=srslte_cbsegm_cbsize(cb_idx);
       int in_len=3*cb_len+12;
@@ -279,40 +284,75 @@ void srslte_rm_turbo_gentables(uint32_t phy_idx) {
       }
 
       for (int i=0;i<4;i++) {
-        k0_vec[phy_idx][cb_idx][i][0] = nrows * (2 * (uint16_t) ceilf((float) (3*K_p) / (float) (8 * nrows)) * i + 2);
-        k0_vec[phy_idx][cb_idx][i][1] = -1;
+        k0_vec[cb_idx][i][0] = nrows * (2 * (uint16_t) ceilf((float) (3*K_p) / (float) (8 * nrows)) * i + 2);
+        k0_vec[cb_idx][i][1] = -1;
       }
-      srslte_rm_turbo_gentable_systematic(interleaver_systematic_bits[phy_idx][cb_idx], k0_vec[phy_idx][cb_idx], nrows, ndummy);
-      srslte_bit_interleaver_init(&bit_interleavers_systematic_bits[phy_idx][cb_idx], interleaver_systematic_bits[phy_idx][cb_idx],
+      srslte_rm_turbo_gentable_systematic(interleaver_systematic_bits[cb_idx], k0_vec[cb_idx], nrows, ndummy);
+      srslte_bit_interleaver_init(&bit_interleavers_systematic_bits[cb_idx], interleaver_systematic_bits[cb_idx],
                                   (uint32_t) srslte_cbsegm_cbsize(cb_idx) + 4);
 
-      srslte_rm_turbo_gentable_parity(interleaver_parity_bits[phy_idx][cb_idx], k0_vec[phy_idx][cb_idx], in_len/3, nrows, ndummy);
-      srslte_bit_interleaver_init(&bit_interleavers_parity_bits[phy_idx][cb_idx], interleaver_parity_bits[phy_idx][cb_idx],
+      srslte_rm_turbo_gentable_parity(interleaver_parity_bits[cb_idx], k0_vec[cb_idx], in_len/3, nrows, ndummy);
+      srslte_bit_interleaver_init(&bit_interleavers_parity_bits[cb_idx], interleaver_parity_bits[cb_idx],
                                   (uint32_t) (srslte_cbsegm_cbsize(cb_idx) + 4) * 2);
 
       for (int i=0;i<4;i++) {
-        srslte_rm_turbo_gentable_receive(phy_idx, deinterleaver[phy_idx][cb_idx][i], in_len, i);
+        srslte_rm_turbo_gentable_receive(deinterleaver[cb_idx][i], in_len, i);
 
 #if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
         for (uint32_t s = 0; s < NOF_DEINTER_TABLE_SB_IDX; s++) {
-          interleave_table_sb(deinterleaver[phy_idx][cb_idx][i], deinterleaver_sb[phy_idx][s][cb_idx][i], cb_idx,
+          // 64 sub-blocks are only used by the AVX-512 decoder, do not touch its table otherwise.
+          // CBs shorter than the number of sub-blocks are never decoded by a window decoder.
+          if ((deinter_table_sb_idx[s] == 64 && !srslte_tdec_avx512_supported()) || deinter_table_sb_idx[s] > cb_len) {
+            continue;
+          }
+          interleave_table_sb(deinterleaver[cb_idx][i], deinterleaver_sb[s][cb_idx][i], cb_idx,
                               deinter_table_sb_idx[s]);
         }
 #endif
       }
     }
   }
+  pthread_mutex_unlock(&rm_turbo_tables_mutex);
 }
 
-void srslte_rm_turbo_free_tables(uint32_t phy_idx) {
-  if (rm_turbo_tables_generated[phy_idx]) {
+void srslte_rm_turbo_free_tables() {
+  pthread_mutex_lock(&rm_turbo_tables_mutex);
+  if (rm_turbo_tables_users > 0 && --rm_turbo_tables_users == 0) {
     for (int i = 0; i < SRSLTE_NOF_TC_CB_SIZES; i++) {
-      srslte_bit_interleaver_free(&bit_interleavers_systematic_bits[phy_idx][i]);
-      srslte_bit_interleaver_free(&bit_interleavers_parity_bits[phy_idx][i]);
+      srslte_bit_interleaver_free(&bit_interleavers_systematic_bits[i]);
+      srslte_bit_interleaver_free(&bit_interleavers_parity_bits[i]);
     }
-    rm_turbo_tables_generated[phy_idx] = false;
   }
-  rm_turbo_tables_generated[phy_idx] = false;
+  pthread_mutex_unlock(&rm_turbo_tables_mutex);
+}
+
+/**
+ * Sub-block interleaving and bit collection into the circular buffer. srslte_rm_turbo_tx_lut() only does it for
+ * RV 0, the other RVs read the buffer filled by it, so this has to be called when a retransmission is encoded from
+ * the data instead of reusing the soft buffer of its first transmission.
+ *
+ * @param[out] w_buff Preallocated softbuffer
+ * @param[in] systematic Input code block in a byte array
+ * @param[in] parity Input code turbo coder parity bits in a byte array
+ * @param cb_idx Code block index. Used to lookup interleaver parameters
+ *
+ * @return Error code
+ */
+int srslte_rm_turbo_tx_interleave_lut(uint8_t *w_buff, uint8_t *systematic, uint8_t *parity, uint32_t cb_idx)
+{
+  if (cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
+    int in_len=3*srslte_cbsegm_cbsize(cb_idx)+12;
+
+    // Systematic bits
+    srslte_bit_interleaver_run(&bit_interleavers_systematic_bits[cb_idx], systematic, w_buff, 0);
+
+    // Parity bits
+    srslte_bit_interleaver_run(&bit_interleavers_parity_bits[cb_idx], parity, &w_buff[in_len/24], 4);
+
+    return 0;
+  } else {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
 }
 
 /**
@@ -329,7 +369,7 @@ void srslte_rm_turbo_free_tables(uint32_t phy_idx) {
  *
  * @return Error code
  */
-int srslte_rm_turbo_tx_lut(uint32_t phy_idx, uint8_t *w_buff, uint8_t *systematic, uint8_t *parity, uint8_t *output,
+int srslte_rm_turbo_tx_lut(uint8_t *w_buff, uint8_t *systematic, uint8_t *parity, uint8_t *output,
                            uint32_t cb_idx, uint32_t out_len,
                            uint32_t w_offset, uint32_t rv_idx)
 {
@@ -342,20 +382,12 @@ int srslte_rm_turbo_tx_lut(uint32_t phy_idx, uint8_t *w_buff, uint8_t *systemati
 
     /* Sub-block interleaver (5.1.4.1.1) and bit collection */
     if (rv_idx == 0) {
-
-      // Systematic bits
-      //srslte_bit_interleave(systematic, w_buff, interleaver_systematic_bits[phy_idx][cb_idx], in_len/3);
-      srslte_bit_interleaver_run(&bit_interleavers_systematic_bits[phy_idx][cb_idx], systematic, w_buff, 0);
-
-
-      // Parity bits
-      //srslte_bit_interleave_w_offset(parity, &w_buff[in_len/24], interleaver_parity_bits[phy_idx][cb_idx], 2*in_len/3, 4);
-      srslte_bit_interleaver_run(&bit_interleavers_parity_bits[phy_idx][cb_idx], parity, &w_buff[in_len/24], 4);
+      srslte_rm_turbo_tx_interleave_lut(w_buff, systematic, parity, cb_idx);
     }
 
     /* Bit selection and transmission 5.1.4.1.2 */
     int w_len = 0;
-    int r_ptr = k0_vec[phy_idx][cb_idx][rv_idx][1];
+    int r_ptr = k0_vec[cb_idx][rv_idx][1];
     while (w_len < out_len) {
       int cp_len = out_len - w_len;
       if (cp_len + r_ptr >= in_len) {
@@ -375,9 +407,9 @@ int srslte_rm_turbo_tx_lut(uint32_t phy_idx, uint8_t *w_buff, uint8_t *systemati
   }
 }
 
-int srslte_rm_turbo_rx_lut(uint32_t phy_idx, int16_t *input, int16_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
+int srslte_rm_turbo_rx_lut(int16_t *input, int16_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
 {
-  return srslte_rm_turbo_rx_lut_(phy_idx, input, output, in_len, cb_idx, rv_idx, true);
+  return srslte_rm_turbo_rx_lut_(input, output, in_len, cb_idx, rv_idx, true);
 }
 /**
  * Undoes rate matching for LTE Turbo Coder. Expands rate matched buffer to full size buffer.
@@ -388,7 +420,7 @@ int srslte_rm_turbo_rx_lut(uint32_t phy_idx, int16_t *input, int16_t *output, ui
  * @param[in] rv_idx Redundancy Version from DCI control message
  * @return Error code
  */
-int srslte_rm_turbo_rx_lut_(uint32_t phy_idx, int16_t *input, int16_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx, bool enable_input_tdec)
+int srslte_rm_turbo_rx_lut_(int16_t *input, int16_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx, bool enable_input_tdec)
 {
 
   if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
@@ -398,15 +430,15 @@ int srslte_rm_turbo_rx_lut_(uint32_t phy_idx, int16_t *input, int16_t *output, u
   int idx = deinter_table_idx_from_sb_len(srslte_tdec_autoimp_get_subblocks(cb_len));
   uint16_t *deinter = NULL;
   if (idx < 0 || !enable_input_tdec) {
-    deinter = deinterleaver[phy_idx][cb_idx][rv_idx];
+    deinter = deinterleaver[cb_idx][rv_idx];
   } else if (idx < NOF_DEINTER_TABLE_SB_IDX) {
-    deinter = deinterleaver_sb[phy_idx][idx][cb_idx][rv_idx];
+    deinter = deinterleaver_sb[idx][cb_idx][rv_idx];
   } else {
     fprintf(stderr, "Sub-block size index %d not supported in srslte_rm_turbo_rx_lut()\n", idx);
     return -1;
   }
 #else
-  uint16_t *deinter = deinterleaver[phy_idx][cb_idx][rv_idx];
+  uint16_t *deinter = deinterleaver[cb_idx][rv_idx];
 #endif
 
 #ifdef LV_HAVE_AVX
@@ -429,7 +461,7 @@ int srslte_rm_turbo_rx_lut_(uint32_t phy_idx, int16_t *input, int16_t *output, u
     }
 }
 
-int srslte_rm_turbo_rx_lut_8bit(uint32_t phy_idx, int8_t *input, int8_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
+int srslte_rm_turbo_rx_lut_8bit(int8_t *input, int8_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
 {
   if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
 
@@ -438,15 +470,15 @@ int srslte_rm_turbo_rx_lut_8bit(uint32_t phy_idx, int8_t *input, int8_t *output,
     int idx = deinter_table_idx_from_sb_len(srslte_tdec_autoimp_get_subblocks_8bit(cb_len));
     uint16_t *deinter = NULL;
     if (idx < 0) {
-      deinter = deinterleaver[phy_idx][cb_idx][rv_idx];
+      deinter = deinterleaver[cb_idx][rv_idx];
     } else if (idx < NOF_DEINTER_TABLE_SB_IDX) {
-      deinter = deinterleaver_sb[phy_idx][idx][cb_idx][rv_idx];
+      deinter = deinterleaver_sb[idx][cb_idx][rv_idx];
     } else {
       fprintf(stderr, "Sub-block size index %d not supported in srslte_rm_turbo_rx_lut()\n", idx);
       return -1;
     }
 #else
-    uint16_t *deinter = deinterleaver[phy_idx][cb_idx][rv_idx];
+    uint16_t *deinter = deinterleaver[cb_idx][rv_idx];
   #endif
 
     // FIXME: AVX version of rm_turbo_rx_lut not working
@@ -224,8 +224,6 @@ void srslte_softbuffer_tx_reset_cb(srslte_softbuffer_tx_t *q, uint32_t nof_cb) {
 //******************************************************************************
 // ******************** Customized scatter system functions ********************
 //******************************************************************************
-// Change this value for higher MCS values, i.e., 29 <= MCS <= 31
-#define MAX_TBS_INDEX 31
 
 int srslte_softbuffer_tx_init_scatter(srslte_softbuffer_tx_t *q, uint32_t nof_prb) {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
@@ -235,7 +233,7 @@ int srslte_softbuffer_tx_init_scatter(srslte_softbuffer_tx_t *q, uint32_t nof_pr
 
     bzero(q, sizeof(srslte_softbuffer_tx_t));
 
-    ret = srslte_ra_tbs_from_idx_scatter(MAX_TBS_INDEX, nof_prb);
+    ret = srslte_ra_max_tbs_scatter(nof_prb);
     if(ret != SRSLTE_ERROR) {
       q->max_cb = (uint32_t) ret / (SRSLTE_TCOD_MAX_LEN_CB - 24) + 1;
 
@@ -280,7 +278,7 @@ int srslte_softbuffer_rx_init_scatter(srslte_softbuffer_rx_t *q, uint32_t nof_pr
   if(q != NULL) {
     bzero(q, sizeof(srslte_softbuffer_rx_t));
 
-    ret = srslte_ra_tbs_from_idx_scatter(MAX_TBS_INDEX, nof_prb);
+    ret = srslte_ra_max_tbs_scatter(nof_prb);
     if(ret != SRSLTE_ERROR) {
       q->max_cb =  (uint32_t) ret / (SRSLTE_TCOD_MAX_LEN_CB - 24) + 1;
       ret = SRSLTE_ERROR;
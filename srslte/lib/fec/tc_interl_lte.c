@@ -101,7 +101,8 @@ int srslte_tc_interl_LTE_gen_interl(srslte_tc_interl_t *h, uint32_t long_cb, uin
     h->forward[i] = (uint32_t) j;
     h->reverse[j] = (uint32_t) i;
   }
-  if (interl_win != 1) {
+  // CBs shorter than the number of sub-blocks are never decoded by a window decoder
+  if (interl_win != 1 && long_cb >= interl_win) {
     uint16_t *f = malloc(long_cb*sizeof(uint16_t));
     uint16_t *r = malloc(long_cb*sizeof(uint16_t));
     memcpy(f, h->forward, long_cb*sizeof(uint16_t));
@@ -70,6 +70,60 @@ void parse_args(int argc, char **argv) {
   }
 }
 
+/* Every engine must match the byte-wise table for all the lengths up to nof_bytes and for unaligned data. */
+int check_engines(srslte_crc_t *crc_p, int nof_bytes) {
+  srslte_crc_engine_type_t engines[] = {SRSLTE_CRC_ENGINE_SLICE8, SRSLTE_CRC_ENGINE_PCLMUL};
+  uint8_t *bytes = malloc(nof_bytes + 1);
+  uint8_t *bits = malloc(8 * nof_bytes);
+  int nof_errors = 0;
+
+  if (!bytes || !bits) {
+    perror("malloc");
+    exit(-1);
+  }
+  for (int i = 0; i < nof_bytes + 1; i++) {
+    bytes[i] = rand() % 256;
+  }
+  for (int i = 0; i < 8 * nof_bytes; i++) {
+    bits[i] = rand() % 2;
+  }
+
+  for (int e = 0; e < sizeof(engines)/sizeof(engines[0]); e++) {
+    if (!srslte_crc_engine_supported(engines[e])) {
+      printf("CRC engine %d not supported, skipping\n", engines[e]);
+      continue;
+    }
+    for (int len = 0; len <= nof_bytes; len++) {
+      for (int offset = 0; offset < 2 && len + offset <= nof_bytes; offset++) {
+        srslte_crc_set_engine(crc_p, SRSLTE_CRC_ENGINE_TABLE);
+        uint32_t expected = srslte_crc_checksum_byte(crc_p, &bytes[offset], 8 * len);
+        srslte_crc_set_engine(crc_p, engines[e]);
+        uint32_t word = srslte_crc_checksum_byte(crc_p, &bytes[offset], 8 * len);
+        if (word != expected) {
+          fprintf(stderr, "CRC engine %d: bytes=%d offset=%d got 0x%x expected 0x%x\n",
+                  engines[e], len, offset, word, expected);
+          nof_errors++;
+        }
+      }
+      // Unpacked bits, with and without a partial last byte.
+      for (int res = 0; res < 8 && 8 * len + res <= 8 * nof_bytes; res += 3) {
+        srslte_crc_set_engine(crc_p, SRSLTE_CRC_ENGINE_TABLE);
+        uint32_t expected = srslte_crc_checksum(crc_p, bits, 8 * len + res);
+        srslte_crc_set_engine(crc_p, engines[e]);
+        uint32_t word = srslte_crc_checksum(crc_p, bits, 8 * len + res);
+        if (word != expected) {
+          fprintf(stderr, "CRC engine %d: bits=%d got 0x%x expected 0x%x\n", engines[e], 8 * len + res, word, expected);
+          nof_errors++;
+        }
+      }
+    }
+  }
+  srslte_crc_set_engine(crc_p, SRSLTE_CRC_ENGINE_AUTO);
+  free(bytes);
+  free(bits);
+  return nof_errors;
+}
+
 int main(int argc, char **argv) {
   int i;
   uint8_t *data;
@@ -104,6 +158,11 @@ int main(int argc, char **argv) {
 
   free(data);
 
+  if (check_engines(&crc_p, num_bits/8)) {
+    fprintf(stderr, "CRC engines are not bit exact\n");
+    exit(-1);
+  }
+
   // check if generated word is as expected
   if (get_expected_word(num_bits, crc_length, crc_poly, seed,
       &expected_word)) {
@@ -85,11 +85,10 @@ int main(int argc, char **argv) {
   uint8_t *rm_bits, *rm_bits2, *rm_bits2_bytes;
   short *rm_bits_s;
   float *rm_bits_f;
-  uint32_t phy_id = 0;
 
   parse_args(argc, argv);
 
-  srslte_rm_turbo_gentables(phy_id);
+  srslte_rm_turbo_gentables();
 
   rm_bits_s = srslte_vec_malloc(sizeof(short) * nof_e_bits);
   if (!rm_bits_s) {
@@ -158,10 +157,10 @@ int main(int argc, char **argv) {
       bzero(buff_b, BUFFSZ * sizeof(uint8_t));
 
       bzero(rm_bits2_bytes, nof_e_bits/8);
-      srslte_rm_turbo_tx_lut(phy_id, buff_b, systematic_bytes, parity_bytes, rm_bits2_bytes, cb_idx, nof_e_bits, 0, 0);
+      srslte_rm_turbo_tx_lut(buff_b, systematic_bytes, parity_bytes, rm_bits2_bytes, cb_idx, nof_e_bits, 0, 0);
       if (rv_idx > 0) {
         bzero(rm_bits2_bytes, nof_e_bits/8);
-        srslte_rm_turbo_tx_lut(phy_id, buff_b, systematic_bytes, parity_bytes, rm_bits2_bytes, cb_idx, nof_e_bits, 0, rv_idx);
+        srslte_rm_turbo_tx_lut(buff_b, systematic_bytes, parity_bytes, rm_bits2_bytes, cb_idx, nof_e_bits, 0, rv_idx);
       }
 
       srslte_bit_unpack_vector(rm_bits2_bytes, rm_bits2, nof_e_bits);
@@ -184,7 +183,7 @@ int main(int argc, char **argv) {
       srslte_rm_turbo_rx(buff_f, BUFFSZ, rm_bits_f, nof_e_bits, bits_f, long_cb_enc, rv_idx, 0);
 
       bzero(bits2_s, long_cb_enc*sizeof(short));
-      srslte_rm_turbo_rx_lut_(phy_id, rm_bits_s, bits2_s, nof_e_bits, cb_idx, rv_idx, false);
+      srslte_rm_turbo_rx_lut_(rm_bits_s, bits2_s, nof_e_bits, cb_idx, rv_idx, false);
 
       for (int i=0;i<long_cb_enc;i++) {
         if (bits_f[i] != bits2_s[i]) {
@@ -198,7 +197,7 @@ int main(int argc, char **argv) {
     }
   }
 
-  srslte_rm_turbo_free_tables(phy_id);
+  srslte_rm_turbo_free_tables();
   free(rm_bits_s);
   free(rm_bits_f);
   free(rm_bits);
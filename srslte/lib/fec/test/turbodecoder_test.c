@@ -49,6 +49,9 @@ int nof_iterations = MAX_ITERATIONS;
 int test_known_data = 0;
 int test_errors = 0;
 int nof_repetitions = 1;
+int test_8bit = 0;
+int tdec_ref_type = -1;
+float max_ref_diff = 0.0;
 
 srslte_tdec_impl_type_t tdec_type;
 
@@ -57,7 +60,7 @@ srslte_tdec_impl_type_t tdec_type;
 #define SNR_MAX         8.0
 
 void usage(char *prog) {
-  printf("Usage: %s [kcinNledts]\n", prog);
+  printf("Usage: %s [kcinNledtsrbm]\n", prog);
   printf("\t-k Test with known data (ignores frame_length) [Default disabled]\n");
   printf("\t-c nof_cb in parallel [Default %d]\n", nof_cb);
   printf("\t-i nof_iterations [Default %d]\n", nof_iterations);
@@ -68,11 +71,14 @@ void usage(char *prog) {
   printf("\t-d Decoder implementation type: 0: Generic, 1: SSE, 2: SSE-window\n");
   printf("\t-t test: check errors on exit [Default disabled]\n");
   printf("\t-s seed [Default 0=time]\n");
+  printf("\t-r Reference decoder implementation type, decoded bits must be identical unless -m is set [Default disabled]\n");
+  printf("\t-b Use 8-bit LLRs [Default 16-bit]\n");
+  printf("\t-m Maximum ratio of decoded bits that may differ from the reference decoder [Default %.2f]\n", max_ref_diff);
 }
 
 void parse_args(int argc, char **argv) {
   int opt;
-  while ((opt = getopt(argc, argv, "kcinNledts")) != -1) {
+  while ((opt = getopt(argc, argv, "kcinNledtsrbm")) != -1) {
     switch (opt) {
     case 'c':
       nof_cb = atoi(argv[optind]);
@@ -107,6 +113,15 @@ void parse_args(int argc, char **argv) {
     case 'v':
       srslte_verbose++;
       break;
+    case 'r':
+      tdec_ref_type = atoi(argv[optind]);
+      break;
+    case 'b':
+      test_8bit = 1;
+      break;
+    case 'm':
+      max_ref_diff = atof(argv[optind]);
+      break;
     default:
       usage(argv[0]);
       exit(-1);
@@ -120,15 +135,18 @@ int main(int argc, char **argv) {
   float *llr;
   short *llr_s;
   uint8_t *llr_c;
-  uint8_t *data_tx, *data_rx, *data_rx_bytes, *symbols;
+  uint8_t *data_tx, *data_rx, *data_rx_bytes, *data_ref, *data_ref_bytes, *symbols;
   uint32_t i, j;
   float var[SNR_POINTS];
   uint32_t snr_points;
   uint32_t errors;
+  uint32_t ref_errors = 0;
+  uint64_t ref_bit_errors = 0, ref_bits = 0;
   uint32_t coded_length;
   struct timeval tdata[3];
   float mean_usec;
   srslte_tdec_t tdec;
+  srslte_tdec_t tdec_ref;
   srslte_tcod_t tcod;
 
   parse_args(argc, argv);
@@ -167,6 +185,16 @@ int main(int argc, char **argv) {
     perror("malloc");
     exit(-1);
   }
+  data_ref = srslte_vec_malloc(frame_length * sizeof(uint8_t));
+  if (!data_ref) {
+    perror("malloc");
+    exit(-1);
+  }
+  data_ref_bytes = srslte_vec_malloc(frame_length * sizeof(uint8_t));
+  if (!data_ref_bytes) {
+    perror("malloc");
+    exit(-1);
+  }
 
   symbols = srslte_vec_malloc(coded_length * sizeof(uint8_t));
   if (!symbols) {
@@ -206,6 +234,14 @@ int main(int argc, char **argv) {
 
   srslte_tdec_force_not_sb(&tdec);
 
+  if (tdec_ref_type >= 0) {
+    if (srslte_tdec_init_manual(&tdec_ref, frame_length, (srslte_tdec_impl_type_t) tdec_ref_type)) {
+      fprintf(stderr, "Error initiating reference Turbo decoder\n");
+      exit(-1);
+    }
+    srslte_tdec_force_not_sb(&tdec_ref);
+  }
+
   float ebno_inc, esno_db;
   ebno_inc = (SNR_MAX - SNR_MIN) / SNR_POINTS;
   if (ebno_db == 100.0) {
@@ -252,6 +288,12 @@ int main(int argc, char **argv) {
       for (j=0;j<coded_length;j++) {
         llr_s[j] = (int16_t) (100*llr[j]);
       }
+      if (test_8bit) {
+        for (j=0;j<coded_length;j++) {
+          float v = 10*llr[j];
+          llr_c[j] = (uint8_t) (int8_t) (v > 127 ? 127 : (v < -127 ? -127 : v));
+        }
+      }
 
       /* decoder */
       srslte_tdec_new_cb(&tdec, frame_length);
@@ -265,12 +307,33 @@ int main(int argc, char **argv) {
 
       gettimeofday(&tdata[1], NULL);
       for (int k=0;k<nof_repetitions;k++) {
-        srslte_tdec_run_all(&tdec, llr_s, data_rx_bytes, t, frame_length);
+        if (test_8bit) {
+          srslte_tdec_run_all_8bit(&tdec, (int8_t*) llr_c, data_rx_bytes, t, frame_length);
+        } else {
+          srslte_tdec_run_all(&tdec, llr_s, data_rx_bytes, t, frame_length);
+        }
       }
       gettimeofday(&tdata[2], NULL);
       get_time_interval(tdata);
       mean_usec = (tdata[0].tv_sec*1e6+tdata[0].tv_usec)/nof_repetitions;
 
+      // Decode the same LLRs with the reference implementation and compare the decoded bits
+      if (tdec_ref_type >= 0) {
+        if (test_8bit) {
+          srslte_tdec_run_all_8bit(&tdec_ref, (int8_t*) llr_c, data_ref_bytes, t, frame_length);
+        } else {
+          srslte_tdec_run_all(&tdec_ref, llr_s, data_ref_bytes, t, frame_length);
+        }
+        if (memcmp(data_rx_bytes, data_ref_bytes, frame_length/8)) {
+          ref_errors++;
+          // Windowed decoders of different widths do not match bit by bit at low SNR, count how many bits differ
+          srslte_bit_unpack_vector(data_rx_bytes, data_rx, frame_length);
+          srslte_bit_unpack_vector(data_ref_bytes, data_ref, frame_length);
+          ref_bit_errors += srslte_bit_diff(data_ref, data_rx, frame_length);
+        }
+        ref_bits += frame_length;
+      }
+
       frame_cnt++;
       uint32_t errors_this = 0;
       srslte_bit_unpack_vector(data_rx_bytes, data_rx, frame_length);
@@ -294,6 +357,10 @@ int main(int argc, char **argv) {
     }
   }
 
+  if (tdec_ref_type >= 0) {
+    printf("%d frames differ from reference decoder, %.2e of the bits\n", ref_errors, ref_bits ? (float) ref_bit_errors / ref_bits : 0.0);
+  }
+
   if (data_rx_bytes) {
     free(data_rx_bytes);
   }
@@ -303,11 +370,19 @@ int main(int argc, char **argv) {
   free(llr_c);
   free(llr_s);
   free(data_rx);
+  free(data_ref);
+  free(data_ref_bytes);
 
   srslte_tdec_free(&tdec);
+  if (tdec_ref_type >= 0) {
+    srslte_tdec_free(&tdec_ref);
+  }
   srslte_tcod_free(&tcod);
 
   printf("\n");
   printf("Done\n");
+  if (test_errors && ref_bits && (float) ref_bit_errors / ref_bits > max_ref_diff) {
+    exit(-1);
+  }
   exit(0);
 }
@@ -29,6 +29,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <pthread.h>
 #include <srslte/fec/crc.h>
 
 #include "srslte/fec/cbsegm.h"
@@ -46,41 +47,51 @@ typedef struct {
   uint8_t output;
 } tcod_lut_t;
 
-static tcod_lut_t tcod_lut[2][8][256];
-static uint16_t tcod_per_fw[2][188][6144];
-static srslte_bit_interleaver_t tcod_interleavers[2][188];
+/* The tables are the same for every encoder, so a single copy is shared (read only) by all of them. It is built by
+ * the first srslte_tcod_init() and released by the last srslte_tcod_free(). Only h->temp is per encoder.
+ */
+static tcod_lut_t tcod_lut[8][256];
+static uint16_t tcod_per_fw[188][6144];
+static srslte_bit_interleaver_t tcod_interleavers[188];
 
-static bool table_initiated[2] = {false, false};
+static uint32_t tcod_tables_users = 0;
+static pthread_mutex_t tcod_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 int srslte_tcod_init(srslte_tcod_t *h, uint32_t max_long_cb) {
-  return srslte_tcod_init_generic(h, max_long_cb, 0);
-}
-
-int srslte_tcod_init_generic(srslte_tcod_t *h, uint32_t max_long_cb, uint32_t phy_idx) {
 
-  h->max_long_cb = max_long_cb;
+  /* srslte_tcod_free() only releases the shared tables once max_long_cb is set, i.e. after they are acquired */
+  h->max_long_cb = 0;
   h->temp = srslte_vec_malloc(max_long_cb/8);
-  h->phy_idx = phy_idx;
+  if (!h->temp) {
+    return -1;
+  }
 
-  if (!table_initiated[h->phy_idx]) {
-    table_initiated[h->phy_idx] = true;
-    srslte_tcod_gentable(h->phy_idx);
+  pthread_mutex_lock(&tcod_tables_mutex);
+  if (tcod_tables_users++ == 0) {
+    srslte_tcod_gentable();
   }
+  pthread_mutex_unlock(&tcod_tables_mutex);
+  h->max_long_cb = max_long_cb;
   return 0;
 }
 
 void srslte_tcod_free(srslte_tcod_t *h) {
+  if (h->max_long_cb == 0) {
+    return;
+  }
   h->max_long_cb = 0;
   if (h->temp) {
     free(h->temp);
+    h->temp = NULL;
   }
 
-  if (table_initiated[h->phy_idx]) {
+  pthread_mutex_lock(&tcod_tables_mutex);
+  if (tcod_tables_users > 0 && --tcod_tables_users == 0) {
     for (int i = 0; i < 188; i++) {
-      srslte_bit_interleaver_free(&tcod_interleavers[h->phy_idx][i]);
+      srslte_bit_interleaver_free(&tcod_interleavers[i]);
     }
-    table_initiated[h->phy_idx] = false;
   }
+  pthread_mutex_unlock(&tcod_tables_mutex);
 }
 
 /* Expects bits (1 byte = 1 bit) and produces bits. The systematic and parity bits are interlaced in the output */
@@ -105,7 +116,7 @@ int srslte_tcod_encode(srslte_tcod_t *h, uint8_t *input, uint8_t *output, uint32
     return -1;
   }
 
-  per = tcod_per_fw[h->phy_idx][longcb_idx];
+  per = tcod_per_fw[longcb_idx];
 
   reg1_0 = 0;
   reg1_1 = 0;
@@ -235,7 +246,7 @@ int srslte_tcod_encode_lut(srslte_tcod_t *h,
         srslte_crc_checksum_put_byte(crc_cb, in);
 
         /* Run actual encoder */
-        tcod_lut_t l = tcod_lut[h->phy_idx][state0][in];
+        tcod_lut_t l = tcod_lut[state0][in];
         parity[i] = l.output;
         state0 = l.next_state;
       }
@@ -251,7 +262,7 @@ int srslte_tcod_encode_lut(srslte_tcod_t *h,
           srslte_crc_checksum_put_byte(crc_cb, in);
 
           input[idx] = in;
-          tcod_lut_t l = tcod_lut[h->phy_idx][state0][in];
+          tcod_lut_t l = tcod_lut[state0][in];
           parity[idx] = l.output;
           state0 = l.next_state;
         }
@@ -264,7 +275,7 @@ int srslte_tcod_encode_lut(srslte_tcod_t *h,
         uint8_t in = (uint8_t) ((checksum >> mask_shift) & 0xff);
 
         input[idx] = in;
-        tcod_lut_t l = tcod_lut[h->phy_idx][state0][in];
+        tcod_lut_t l = tcod_lut[state0][in];
         parity[idx] = l.output;
         state0 = l.next_state;
       }
@@ -278,7 +289,7 @@ int srslte_tcod_encode_lut(srslte_tcod_t *h,
 
         srslte_crc_checksum_put_byte(crc_tb, in);
 
-        tcod_lut_t l = tcod_lut[h->phy_idx][state0][in];
+        tcod_lut_t l = tcod_lut[state0][in];
         parity[i] = l.output;
         state0 = l.next_state;
       }
@@ -291,7 +302,7 @@ int srslte_tcod_encode_lut(srslte_tcod_t *h,
           uint8_t in = (uint8_t) ((checksum >> mask_shift) & 0xff);
 
           input[idx] = in;
-          tcod_lut_t l = tcod_lut[h->phy_idx][state0][in];
+          tcod_lut_t l = tcod_lut[state0][in];
           parity[idx] = l.output;
           state0 = l.next_state;
         }
@@ -300,13 +311,13 @@ int srslte_tcod_encode_lut(srslte_tcod_t *h,
     parity[long_cb/8] = 0;  // will put tail here later
 
     /* Interleave input */
-    srslte_bit_interleaver_run(&tcod_interleavers[h->phy_idx][cblen_idx], input, h->temp, 0);
-    //srslte_bit_interleave(input, h->temp, tcod_per_fw[h->phy_idx][cblen_idx], long_cb);
+    srslte_bit_interleaver_run(&tcod_interleavers[cblen_idx], input, h->temp, 0);
+    //srslte_bit_interleave(input, h->temp, tcod_per_fw[cblen_idx], long_cb);
 
     /* Parity bits for the 2nd constituent encoders */
     uint8_t state1 = 0;
     for (uint32_t i=0;i<long_cb/8;i++) {
-      tcod_lut_t l = tcod_lut[h->phy_idx][state1][h->temp[i]];
+      tcod_lut_t l = tcod_lut[state1][h->temp[i]];
       uint8_t out = l.output;
       parity[long_cb/8+i] |= (out&0xf0)>>4;
       parity[long_cb/8+i+1] = (out&0xf)<<4;
@@ -382,7 +393,7 @@ int srslte_tcod_encode_lut(srslte_tcod_t *h,
   }
 }
 
-void srslte_tcod_gentable(uint32_t phy_idx) {
+void srslte_tcod_gentable() {
   srslte_tc_interl_t interl;
 
   if (srslte_tc_interl_init(&interl, 6144)) {
@@ -398,11 +409,11 @@ void srslte_tcod_gentable(uint32_t phy_idx) {
     }
     // Save fw/bw permutation tables
     for (uint32_t i=0;i<long_cb;i++) {
-      tcod_per_fw[phy_idx][len][i] = interl.forward[i];
+      tcod_per_fw[len][i] = interl.forward[i];
     }
-    srslte_bit_interleaver_init(&tcod_interleavers[phy_idx][len], tcod_per_fw[phy_idx][len], long_cb);
+    srslte_bit_interleaver_init(&tcod_interleavers[len], tcod_per_fw[len], long_cb);
     for (uint32_t i=long_cb;i<6144;i++) {
-      tcod_per_fw[phy_idx][len][i] = 0;
+      tcod_per_fw[len][i] = 0;
     }
   }
     // Compute state transitions
@@ -414,7 +425,7 @@ void srslte_tcod_gentable(uint32_t phy_idx) {
         reg_1 = (state&2)>>1;
         reg_2 = state&1;
 
-      tcod_lut[phy_idx][state][data].output = 0;
+      tcod_lut[state][data].output = 0;
         uint8_t bit, in, out;
         for (uint32_t i = 0; i < 8; i++) {
           bit = (data&(1<<(7-i)))?1:0;
@@ -426,10 +437,10 @@ void srslte_tcod_gentable(uint32_t phy_idx) {
           reg_1 = reg_0;
           reg_0 = in;
 
-        tcod_lut[phy_idx][state][data].output |= out<<(7-i);
+        tcod_lut[state][data].output |= out<<(7-i);
 
         }
-      tcod_lut[phy_idx][state][data].next_state = (uint8_t) ((reg_0 << 2 | reg_1 << 1 | reg_2) % 8);
+      tcod_lut[state][data].next_state = (uint8_t) ((reg_0 << 2 | reg_1 << 1 | reg_2) % 8);
     }
   }
 
@@ -114,6 +114,42 @@ srslte_tdec_8bit_impl_t avx8_win_impl = {
 };
 #endif
 
+/* AVX-512BW window implementation. Built with AVX-512BW code generation for these functions only, so the rest of
+ * the library still runs on CPUs without it. They are only called when srslte_tdec_avx512_supported() */
+#ifdef SRSLTE_TDEC_HAVE_AVX512
+#ifndef __AVX512BW__
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw")
+#endif
+
+#define WINIMP_IS_AVX512_16
+#include "srslte/fec/turbodecoder_win.h"
+#undef WINIMP_IS_AVX512_16
+
+#define WINIMP_IS_AVX512_8
+#include "srslte/fec/turbodecoder_win.h"
+#undef WINIMP_IS_AVX512_8
+
+#ifndef __AVX512BW__
+#pragma GCC pop_options
+#endif
+
+srslte_tdec_16bit_impl_t avx512_16_win_impl = {
+    tdec_winavx512_16_init,
+    tdec_winavx512_16_free,
+    tdec_winavx512_16_dec,
+    tdec_winavx512_16_extract_input,
+    tdec_winavx512_16_decision_byte
+};
+
+srslte_tdec_8bit_impl_t avx512_8_win_impl = {
+    tdec_winavx512_8_init,
+    tdec_winavx512_8_free,
+    tdec_winavx512_8_dec,
+    tdec_winavx512_8_extract_input,
+    tdec_winavx512_8_decision_byte
+};
+#endif
 
 #ifdef HAVE_NEON
 #define WINIMP_IS_NEON16
@@ -132,8 +168,10 @@ srslte_tdec_16bit_impl_t arm16_win_impl = {
 #define AUTO_16_SSE    0
 #define AUTO_16_SSEWIN 1
 #define AUTO_16_AVXWIN 2
+#define AUTO_16_AVX512WIN 3
 #define AUTO_8_SSEWIN  0
 #define AUTO_8_AVXWIN  1
+#define AUTO_8_AVX512WIN 2
 #define AUTO_16_GEN    0
 #define AUTO_16_NEONWIN 1
 
@@ -148,12 +186,28 @@ srslte_tdec_16bit_impl_t arm16_win_impl = {
 #undef LLR_IS_16BIT
 
 
+/* Returns true if the CPU can run the AVX-512BW decoders. Checked once, the result never changes */
+bool srslte_tdec_avx512_supported() {
+#ifdef SRSLTE_TDEC_HAVE_AVX512
+  static int supported = -1;
+  if (supported < 0) {
+    __builtin_cpu_init();
+    supported = __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512f");
+  }
+  return supported > 0;
+#else
+  return false;
+#endif
+}
+
 int srslte_tdec_init(srslte_tdec_t * h, uint32_t max_long_cb) {
   return srslte_tdec_init_manual(h, max_long_cb, SRSLTE_TDEC_AUTO);
 }
 
 uint32_t interleaver_idx(uint32_t nof_subblocks) {
   switch (nof_subblocks) {
+    case 64:
+      return 4;
     case 32:
       return 3;
     case 16:
@@ -214,6 +268,22 @@ int srslte_tdec_init_manual(srslte_tdec_t * h, uint32_t max_long_cb, srslte_tdec
       h->dec8[0] = &avx8_win_impl;
       h->current_llr_type = SRSLTE_TDEC_8;
       break;
+#endif
+#ifdef SRSLTE_TDEC_HAVE_AVX512
+    case SRSLTE_TDEC_AVX512_WINDOW:
+    case SRSLTE_TDEC_AVX512_8_WINDOW:
+      if (!srslte_tdec_avx512_supported()) {
+        fprintf(stderr, "Error decoder %d not supported by this CPU\n", dec_type);
+        goto clean_and_exit;
+      }
+      if (dec_type == SRSLTE_TDEC_AVX512_WINDOW) {
+        h->dec16[0] = &avx512_16_win_impl;
+        h->current_llr_type = SRSLTE_TDEC_16;
+      } else {
+        h->dec8[0] = &avx512_8_win_impl;
+        h->current_llr_type = SRSLTE_TDEC_8;
+      }
+      break;
 #endif
     default:
       fprintf(stderr, "Error decoder %d not supported\n", dec_type);
@@ -275,6 +345,12 @@ int srslte_tdec_init_manual(srslte_tdec_t * h, uint32_t max_long_cb, srslte_tdec
     h->dec16[AUTO_16_AVXWIN] = &avx16_win_impl;
     h->dec8[AUTO_8_AVXWIN]  = &avx8_win_impl;
 #endif
+#ifdef SRSLTE_TDEC_HAVE_AVX512
+    if (srslte_tdec_avx512_supported()) {
+      h->dec16[AUTO_16_AVX512WIN] = &avx512_16_win_impl;
+      h->dec8[AUTO_8_AVX512WIN]   = &avx512_8_win_impl;
+    }
+#endif
 #else
     h->dec16[AUTO_16_SSE] = &gen_impl;
     h->dec16[AUTO_16_SSEWIN] = &gen_impl;
@@ -295,8 +371,11 @@ int srslte_tdec_init_manual(srslte_tdec_t * h, uint32_t max_long_cb, srslte_tdec
       }
 }
 
-    // Compute 1 interleaver for each possible nof_subblocks (1, 8, 16 or 32)
-    for (int s=0;s<4;s++) {
+    // Compute 1 interleaver for each possible nof_subblocks (1, 8, 16, 32 or 64)
+    for (int s=0;s<SRSLTE_TDEC_NOF_INTERLEAVERS;s++) {
+      if (s == interleaver_idx(64) && !srslte_tdec_avx512_supported()) {
+        continue;
+      }
       for (int i=0;i<SRSLTE_NOF_TC_CB_SIZES;i++) {
         if (srslte_tc_interl_init(&h->interleaver[s][i], srslte_cbsegm_cbsize(i)) < 0) {
           goto clean_and_exit;
@@ -306,7 +385,7 @@ int srslte_tdec_init_manual(srslte_tdec_t * h, uint32_t max_long_cb, srslte_tdec
     }
   } else {
     uint32_t nof_subblocks;
-    if (dec_type < SRSLTE_TDEC_SSE8_WINDOW) {
+    if (h->current_llr_type == SRSLTE_TDEC_16) {
       if ((h->nof_blocks16[0] = h->dec16[0]->tdec_init(&h->dec16_hdlr[0], h->max_long_cb))<0) {
         goto clean_and_exit;
       }
@@ -372,7 +451,7 @@ void srslte_tdec_free(srslte_tdec_t * h)
       h->dec16[td]->tdec_free(h->dec16_hdlr[td]);
     }
   }
-  for (int s=0;s<4;s++) {
+  for (int s=0;s<SRSLTE_TDEC_NOF_INTERLEAVERS;s++) {
     for (int i=0;i<SRSLTE_NOF_TC_CB_SIZES;i++) {
       srslte_tc_interl_free(&h->interleaver[s][i]);
     }
@@ -398,6 +477,9 @@ static void tdec_decision_byte(srslte_tdec_t * h, uint8_t *output)
 /* Returns number of subblocks in automatic mode for this long_cb */
 uint32_t srslte_tdec_autoimp_get_subblocks(uint32_t long_cb)
 {
+  if (!(long_cb%32) && long_cb > 2048 && srslte_tdec_avx512_supported()) {
+    return 32;
+  }
 #ifdef LV_HAVE_AVX2
   if (!(long_cb%16) && long_cb > 800) {
     return 16;
@@ -413,6 +495,8 @@ uint32_t srslte_tdec_autoimp_get_subblocks(uint32_t long_cb)
 static int tdec_sb_idx(uint32_t long_cb) {
   uint32_t nof_sb = srslte_tdec_autoimp_get_subblocks(long_cb);
   switch(nof_sb) {
+    case 32:
+      return AUTO_16_AVX512WIN;
     case 16:
       return AUTO_16_AVXWIN;
     case 8:
@@ -426,6 +510,9 @@ static int tdec_sb_idx(uint32_t long_cb) {
 
 uint32_t srslte_tdec_autoimp_get_subblocks_8bit(uint32_t long_cb)
 {
+  if (!(long_cb%64) && long_cb > 4096 && srslte_tdec_avx512_supported()) {
+    return 64;
+  }
 #ifdef LV_HAVE_AVX2
   if (!(long_cb%32) && long_cb > 2048) {
     return 32;
@@ -443,6 +530,8 @@ uint32_t srslte_tdec_autoimp_get_subblocks_8bit(uint32_t long_cb)
 static int tdec_sb_idx_8(uint32_t long_cb) {
   uint32_t nof_sb = srslte_tdec_autoimp_get_subblocks_8bit(long_cb);
   switch(nof_sb) {
+    case 64:
+      return AUTO_8_AVX512WIN;
     case 32:
       return AUTO_8_AVXWIN;
     case 16:
@@ -487,6 +576,11 @@ static void tdec_iteration_8(srslte_tdec_t * h, int8_t * input)
     }
   } else {
     h->current_dec = 0;
+    if (h->current_llr_type == SRSLTE_TDEC_16) {
+      h->current_inter_idx = interleaver_idx(h->nof_blocks16[0]);
+    } else {
+      h->current_inter_idx = interleaver_idx(h->nof_blocks8[0]);
+    }
   }
 
   if (h->current_llr_type == SRSLTE_TDEC_16) {
@@ -37,13 +37,14 @@
 void demod_16qam_lte_s_sse(const cf_t *symbols, short *llr, int nsymbols);
 #endif
 
-#define SCALE_SHORT_CONV_QPSK  100
-#define SCALE_SHORT_CONV_QAM16 400
-#define SCALE_SHORT_CONV_QAM64 700
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+#endif
 
 #define SCALE_BYTE_CONV_QPSK  20
 #define SCALE_BYTE_CONV_QAM16 30
 #define SCALE_BYTE_CONV_QAM64 40
+#define SCALE_BYTE_CONV_QAM256 60
 
 void demod_bpsk_lte_b(const cf_t *symbols, int8_t *llr, int nsymbols) {
   for (int i=0;i<nsymbols;i++) {
@@ -410,6 +411,259 @@ void demod_64qam_lte_b(const cf_t *symbols, int8_t *llr, int nsymbols)
 #endif
 }
 
+void demod_256qam_lte(const cf_t *symbols, float *llr, int nsymbols)
+{
+  for (int i=0;i<nsymbols;i++) {
+    float yre = crealf(symbols[i]);
+    float yim = cimagf(symbols[i]);
+
+    llr[8*i+0] = -yre;
+    llr[8*i+1] = -yim;
+    llr[8*i+2] = fabsf(yre)-8/sqrt(170);
+    llr[8*i+3] = fabsf(yim)-8/sqrt(170);
+    llr[8*i+4] = fabsf(llr[8*i+2])-4/sqrt(170);
+    llr[8*i+5] = fabsf(llr[8*i+3])-4/sqrt(170);
+    llr[8*i+6] = fabsf(llr[8*i+4])-2/sqrt(170);
+    llr[8*i+7] = fabsf(llr[8*i+5])-2/sqrt(170);
+  }
+}
+
+/* The vector versions compute the negated components and the three folded amplitudes for a group of symbols and then
+ * interleave them back into 8 LLRs per symbol. Each (re, im) pair is one 32-bit word in the 16-bit LLR case and one
+ * 16-bit word in the 8-bit LLR case, so the interleaving is done with unpack instructions. */
+
+#ifdef LV_HAVE_SSE
+
+void demod_256qam_lte_s_sse(const cf_t *symbols, short *llr, int nsymbols)
+{
+  float *symbolsPtr = (float*) symbols;
+  __m128i *resultPtr = (__m128i*) llr;
+  __m128i offset1 = _mm_set1_epi16(8*SCALE_SHORT_CONV_QAM256/sqrt(170));
+  __m128i offset2 = _mm_set1_epi16(4*SCALE_SHORT_CONV_QAM256/sqrt(170));
+  __m128i offset3 = _mm_set1_epi16(2*SCALE_SHORT_CONV_QAM256/sqrt(170));
+  __m128 scale_v = _mm_set1_ps(-SCALE_SHORT_CONV_QAM256);
+
+  for (int i=0;i<nsymbols/4;i++) {
+    __m128 symbol1 = _mm_loadu_ps(symbolsPtr); symbolsPtr+=4;
+    __m128 symbol2 = _mm_loadu_ps(symbolsPtr); symbolsPtr+=4;
+    __m128i symbol_i = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(symbol1, scale_v)),
+                                       _mm_cvtps_epi32(_mm_mul_ps(symbol2, scale_v)));
+
+    __m128i symbol_abs1 = _mm_sub_epi16(_mm_abs_epi16(symbol_i), offset1);
+    __m128i symbol_abs2 = _mm_sub_epi16(_mm_abs_epi16(symbol_abs1), offset2);
+    __m128i symbol_abs3 = _mm_sub_epi16(_mm_abs_epi16(symbol_abs2), offset3);
+
+    __m128i t0 = _mm_unpacklo_epi32(symbol_i, symbol_abs1);
+    __m128i t1 = _mm_unpacklo_epi32(symbol_abs2, symbol_abs3);
+    __m128i t2 = _mm_unpackhi_epi32(symbol_i, symbol_abs1);
+    __m128i t3 = _mm_unpackhi_epi32(symbol_abs2, symbol_abs3);
+
+    _mm_storeu_si128(resultPtr, _mm_unpacklo_epi64(t0, t1)); resultPtr++;
+    _mm_storeu_si128(resultPtr, _mm_unpackhi_epi64(t0, t1)); resultPtr++;
+    _mm_storeu_si128(resultPtr, _mm_unpacklo_epi64(t2, t3)); resultPtr++;
+    _mm_storeu_si128(resultPtr, _mm_unpackhi_epi64(t2, t3)); resultPtr++;
+  }
+  for (int i=4*(nsymbols/4);i<nsymbols;i++) {
+    short yre = (short) (SCALE_SHORT_CONV_QAM256*crealf(symbols[i]));
+    short yim = (short) (SCALE_SHORT_CONV_QAM256*cimagf(symbols[i]));
+
+    llr[8*i+0] = -yre;
+    llr[8*i+1] = -yim;
+    llr[8*i+2] = abs(yre)-8*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+3] = abs(yim)-8*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+4] = abs(llr[8*i+2])-4*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+5] = abs(llr[8*i+3])-4*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+6] = abs(llr[8*i+4])-2*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+7] = abs(llr[8*i+5])-2*SCALE_SHORT_CONV_QAM256/sqrt(170);
+  }
+}
+
+void demod_256qam_lte_b_sse(const cf_t *symbols, int8_t *llr, int nsymbols)
+{
+  float *symbolsPtr = (float*) symbols;
+  __m128i *resultPtr = (__m128i*) llr;
+  __m128i offset1 = _mm_set1_epi8(8*SCALE_BYTE_CONV_QAM256/sqrt(170));
+  __m128i offset2 = _mm_set1_epi8(4*SCALE_BYTE_CONV_QAM256/sqrt(170));
+  __m128i offset3 = _mm_set1_epi8(2*SCALE_BYTE_CONV_QAM256/sqrt(170));
+  __m128 scale_v = _mm_set1_ps(-SCALE_BYTE_CONV_QAM256);
+
+  for (int i=0;i<nsymbols/8;i++) {
+    __m128 symbol1 = _mm_loadu_ps(symbolsPtr); symbolsPtr+=4;
+    __m128 symbol2 = _mm_loadu_ps(symbolsPtr); symbolsPtr+=4;
+    __m128 symbol3 = _mm_loadu_ps(symbolsPtr); symbolsPtr+=4;
+    __m128 symbol4 = _mm_loadu_ps(symbolsPtr); symbolsPtr+=4;
+    __m128i symbol_12 = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(symbol1, scale_v)),
+                                        _mm_cvtps_epi32(_mm_mul_ps(symbol2, scale_v)));
+    __m128i symbol_34 = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(symbol3, scale_v)),
+                                        _mm_cvtps_epi32(_mm_mul_ps(symbol4, scale_v)));
+    __m128i symbol_i = _mm_packs_epi16(symbol_12, symbol_34);
+
+    __m128i symbol_abs1 = _mm_sub_epi8(_mm_abs_epi8(symbol_i), offset1);
+    __m128i symbol_abs2 = _mm_sub_epi8(_mm_abs_epi8(symbol_abs1), offset2);
+    __m128i symbol_abs3 = _mm_sub_epi8(_mm_abs_epi8(symbol_abs2), offset3);
+
+    __m128i t0 = _mm_unpacklo_epi16(symbol_i, symbol_abs1);
+    __m128i t1 = _mm_unpacklo_epi16(symbol_abs2, symbol_abs3);
+    __m128i t2 = _mm_unpackhi_epi16(symbol_i, symbol_abs1);
+    __m128i t3 = _mm_unpackhi_epi16(symbol_abs2, symbol_abs3);
+
+    _mm_storeu_si128(resultPtr, _mm_unpacklo_epi32(t0, t1)); resultPtr++;
+    _mm_storeu_si128(resultPtr, _mm_unpackhi_epi32(t0, t1)); resultPtr++;
+    _mm_storeu_si128(resultPtr, _mm_unpacklo_epi32(t2, t3)); resultPtr++;
+    _mm_storeu_si128(resultPtr, _mm_unpackhi_epi32(t2, t3)); resultPtr++;
+  }
+  for (int i=8*(nsymbols/8);i<nsymbols;i++) {
+    int8_t yre = (int8_t) (SCALE_BYTE_CONV_QAM256*crealf(symbols[i]));
+    int8_t yim = (int8_t) (SCALE_BYTE_CONV_QAM256*cimagf(symbols[i]));
+
+    llr[8*i+0] = -yre;
+    llr[8*i+1] = -yim;
+    llr[8*i+2] = abs(yre)-8*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+3] = abs(yim)-8*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+4] = abs(llr[8*i+2])-4*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+5] = abs(llr[8*i+3])-4*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+6] = abs(llr[8*i+4])-2*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+7] = abs(llr[8*i+5])-2*SCALE_BYTE_CONV_QAM256/sqrt(170);
+  }
+}
+
+#endif
+
+#ifdef LV_HAVE_AVX2
+
+void demod_256qam_lte_s_avx2(const cf_t *symbols, short *llr, int nsymbols)
+{
+  float *symbolsPtr = (float*) symbols;
+  __m256i *resultPtr = (__m256i*) llr;
+  __m256i offset1 = _mm256_set1_epi16(8*SCALE_SHORT_CONV_QAM256/sqrt(170));
+  __m256i offset2 = _mm256_set1_epi16(4*SCALE_SHORT_CONV_QAM256/sqrt(170));
+  __m256i offset3 = _mm256_set1_epi16(2*SCALE_SHORT_CONV_QAM256/sqrt(170));
+  __m256 scale_v = _mm256_set1_ps(-SCALE_SHORT_CONV_QAM256);
+
+  for (int i=0;i<nsymbols/8;i++) {
+    __m256 symbol1 = _mm256_loadu_ps(symbolsPtr); symbolsPtr+=8;
+    __m256 symbol2 = _mm256_loadu_ps(symbolsPtr); symbolsPtr+=8;
+    // packs works within each lane, restore the symbol order.
+    __m256i symbol_i = _mm256_packs_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(symbol1, scale_v)),
+                                          _mm256_cvtps_epi32(_mm256_mul_ps(symbol2, scale_v)));
+    symbol_i = _mm256_permute4x64_epi64(symbol_i, 0xD8);
+
+    __m256i symbol_abs1 = _mm256_sub_epi16(_mm256_abs_epi16(symbol_i), offset1);
+    __m256i symbol_abs2 = _mm256_sub_epi16(_mm256_abs_epi16(symbol_abs1), offset2);
+    __m256i symbol_abs3 = _mm256_sub_epi16(_mm256_abs_epi16(symbol_abs2), offset3);
+
+    // Lane 0 holds symbols 0 to 3 and lane 1 symbols 4 to 7.
+    __m256i t0 = _mm256_unpacklo_epi32(symbol_i, symbol_abs1);
+    __m256i t1 = _mm256_unpacklo_epi32(symbol_abs2, symbol_abs3);
+    __m256i t2 = _mm256_unpackhi_epi32(symbol_i, symbol_abs1);
+    __m256i t3 = _mm256_unpackhi_epi32(symbol_abs2, symbol_abs3);
+    __m256i out0 = _mm256_unpacklo_epi64(t0, t1); // Symbols 0 and 4.
+    __m256i out1 = _mm256_unpackhi_epi64(t0, t1); // Symbols 1 and 5.
+    __m256i out2 = _mm256_unpacklo_epi64(t2, t3); // Symbols 2 and 6.
+    __m256i out3 = _mm256_unpackhi_epi64(t2, t3); // Symbols 3 and 7.
+
+    _mm256_storeu_si256(resultPtr, _mm256_permute2x128_si256(out0, out1, 0x20)); resultPtr++;
+    _mm256_storeu_si256(resultPtr, _mm256_permute2x128_si256(out2, out3, 0x20)); resultPtr++;
+    _mm256_storeu_si256(resultPtr, _mm256_permute2x128_si256(out0, out1, 0x31)); resultPtr++;
+    _mm256_storeu_si256(resultPtr, _mm256_permute2x128_si256(out2, out3, 0x31)); resultPtr++;
+  }
+  int first = 8*(nsymbols/8);
+  demod_256qam_lte_s_sse(&symbols[first], &llr[8*first], nsymbols-first);
+}
+
+void demod_256qam_lte_b_avx2(const cf_t *symbols, int8_t *llr, int nsymbols)
+{
+  float *symbolsPtr = (float*) symbols;
+  __m256i *resultPtr = (__m256i*) llr;
+  __m256i offset1 = _mm256_set1_epi8(8*SCALE_BYTE_CONV_QAM256/sqrt(170));
+  __m256i offset2 = _mm256_set1_epi8(4*SCALE_BYTE_CONV_QAM256/sqrt(170));
+  __m256i offset3 = _mm256_set1_epi8(2*SCALE_BYTE_CONV_QAM256/sqrt(170));
+  __m256 scale_v = _mm256_set1_ps(-SCALE_BYTE_CONV_QAM256);
+  __m256i reorder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+  for (int i=0;i<nsymbols/16;i++) {
+    __m256 symbol1 = _mm256_loadu_ps(symbolsPtr); symbolsPtr+=8;
+    __m256 symbol2 = _mm256_loadu_ps(symbolsPtr); symbolsPtr+=8;
+    __m256 symbol3 = _mm256_loadu_ps(symbolsPtr); symbolsPtr+=8;
+    __m256 symbol4 = _mm256_loadu_ps(symbolsPtr); symbolsPtr+=8;
+    __m256i symbol_12 = _mm256_packs_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(symbol1, scale_v)),
+                                           _mm256_cvtps_epi32(_mm256_mul_ps(symbol2, scale_v)));
+    __m256i symbol_34 = _mm256_packs_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(symbol3, scale_v)),
+                                           _mm256_cvtps_epi32(_mm256_mul_ps(symbol4, scale_v)));
+    // packs works within each lane, restore the symbol order.
+    __m256i symbol_i = _mm256_permutevar8x32_epi32(_mm256_packs_epi16(symbol_12, symbol_34), reorder);
+
+    __m256i symbol_abs1 = _mm256_sub_epi8(_mm256_abs_epi8(symbol_i), offset1);
+    __m256i symbol_abs2 = _mm256_sub_epi8(_mm256_abs_epi8(symbol_abs1), offset2);
+    __m256i symbol_abs3 = _mm256_sub_epi8(_mm256_abs_epi8(symbol_abs2), offset3);
+
+    // Lane 0 holds symbols 0 to 7 and lane 1 symbols 8 to 15.
+    __m256i t0 = _mm256_unpacklo_epi16(symbol_i, symbol_abs1);
+    __m256i t1 = _mm256_unpacklo_epi16(symbol_abs2, symbol_abs3);
+    __m256i t2 = _mm256_unpackhi_epi16(symbol_i, symbol_abs1);
+    __m256i t3 = _mm256_unpackhi_epi16(symbol_abs2, symbol_abs3);
+    __m256i out0 = _mm256_unpacklo_epi32(t0, t1); // Symbols 0, 1 and 8, 9.
+    __m256i out1 = _mm256_unpackhi_epi32(t0, t1); // Symbols 2, 3 and 10, 11.
+    __m256i out2 = _mm256_unpacklo_epi32(t2, t3); // Symbols 4, 5 and 12, 13.
+    __m256i out3 = _mm256_unpackhi_epi32(t2, t3); // Symbols 6, 7 and 14, 15.
+
+    _mm256_storeu_si256(resultPtr, _mm256_permute2x128_si256(out0, out1, 0x20)); resultPtr++;
+    _mm256_storeu_si256(resultPtr, _mm256_permute2x128_si256(out2, out3, 0x20)); resultPtr++;
+    _mm256_storeu_si256(resultPtr, _mm256_permute2x128_si256(out0, out1, 0x31)); resultPtr++;
+    _mm256_storeu_si256(resultPtr, _mm256_permute2x128_si256(out2, out3, 0x31)); resultPtr++;
+  }
+  int first = 16*(nsymbols/16);
+  demod_256qam_lte_b_sse(&symbols[first], &llr[8*first], nsymbols-first);
+}
+
+#endif
+
+void demod_256qam_lte_s(const cf_t *symbols, short *llr, int nsymbols)
+{
+#if defined(LV_HAVE_AVX2)
+  demod_256qam_lte_s_avx2(symbols, llr, nsymbols);
+#elif defined(LV_HAVE_SSE)
+  demod_256qam_lte_s_sse(symbols, llr, nsymbols);
+#else
+  for (int i=0;i<nsymbols;i++) {
+    short yre = (short) (SCALE_SHORT_CONV_QAM256*crealf(symbols[i]));
+    short yim = (short) (SCALE_SHORT_CONV_QAM256*cimagf(symbols[i]));
+
+    llr[8*i+0] = -yre;
+    llr[8*i+1] = -yim;
+    llr[8*i+2] = abs(yre)-8*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+3] = abs(yim)-8*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+4] = abs(llr[8*i+2])-4*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+5] = abs(llr[8*i+3])-4*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+6] = abs(llr[8*i+4])-2*SCALE_SHORT_CONV_QAM256/sqrt(170);
+    llr[8*i+7] = abs(llr[8*i+5])-2*SCALE_SHORT_CONV_QAM256/sqrt(170);
+  }
+#endif
+}
+
+void demod_256qam_lte_b(const cf_t *symbols, int8_t *llr, int nsymbols)
+{
+#if defined(LV_HAVE_AVX2)
+  demod_256qam_lte_b_avx2(symbols, llr, nsymbols);
+#elif defined(LV_HAVE_SSE)
+  demod_256qam_lte_b_sse(symbols, llr, nsymbols);
+#else
+  for (int i=0;i<nsymbols;i++) {
+    int8_t yre = (int8_t) (SCALE_BYTE_CONV_QAM256*crealf(symbols[i]));
+    int8_t yim = (int8_t) (SCALE_BYTE_CONV_QAM256*cimagf(symbols[i]));
+
+    llr[8*i+0] = -yre;
+    llr[8*i+1] = -yim;
+    llr[8*i+2] = abs(yre)-8*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+3] = abs(yim)-8*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+4] = abs(llr[8*i+2])-4*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+5] = abs(llr[8*i+3])-4*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+6] = abs(llr[8*i+4])-2*SCALE_BYTE_CONV_QAM256/sqrt(170);
+    llr[8*i+7] = abs(llr[8*i+5])-2*SCALE_BYTE_CONV_QAM256/sqrt(170);
+  }
+#endif
+}
+
 int srslte_demod_soft_demodulate(srslte_mod_t modulation, const cf_t* symbols, float* llr, int nsymbols) {
   switch(modulation) {
     case SRSLTE_MOD_BPSK:
@@ -424,6 +678,9 @@ int srslte_demod_soft_demodulate(srslte_mod_t modulation, const cf_t* symbols, f
     case SRSLTE_MOD_64QAM:
       demod_64qam_lte(symbols, llr, nsymbols);
       break;
+    case SRSLTE_MOD_256QAM:
+      demod_256qam_lte(symbols, llr, nsymbols);
+      break;
     default: 
       fprintf(stderr, "Invalid modulation %d\n", modulation);
       return -1; 
@@ -445,6 +702,9 @@ int srslte_demod_soft_demodulate_s(srslte_mod_t modulation, const cf_t* symbols,
     case SRSLTE_MOD_64QAM:
       demod_64qam_lte_s(symbols, llr, nsymbols);
       break;
+    case SRSLTE_MOD_256QAM:
+      demod_256qam_lte_s(symbols, llr, nsymbols);
+      break;
     default: 
       fprintf(stderr, "Invalid modulation %d\n", modulation);
       return -1; 
@@ -466,6 +726,9 @@ int srslte_demod_soft_demodulate_b(srslte_mod_t modulation, const cf_t* symbols,
     case SRSLTE_MOD_64QAM:
       demod_64qam_lte_b(symbols, llr, nsymbols);
       break;
+    case SRSLTE_MOD_256QAM:
+      demod_256qam_lte_b(symbols, llr, nsymbols);
+      break;
     default: 
       fprintf(stderr, "Invalid modulation %d\n", modulation);
       return -1; 
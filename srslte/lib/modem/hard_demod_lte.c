@@ -203,3 +203,43 @@ inline void hard_qam64_demod(const cf_t* in, uint8_t* out, uint32_t N)
     }
   }
 }
+
+/**
+ * @ingroup Hard 256QAM demodulator
+ *
+ * LTE-256QAM constellation:
+ * see [3GPP TS 36.211 version 12.4.0 Release 12, Section 7.1.5]
+ *
+ * The amplitude bits are found by folding the component around the thresholds:
+ * b2 is set outside +-8, b4 outside 8+-4 and b6 outside 8+-4+-2 (in units of 1/sqrt(170)).
+ *
+ * \param in input symbols (_Complex float)
+ * \param out output symbols (uint8_ts)
+ * \param N Number of input symbols
+ * \param modulation Modulation type
+ */
+inline void hard_qam256_demod(const cf_t* in, uint8_t* out, uint32_t N)
+{
+  uint32_t s;
+  float x;
+
+  for (s=0; s<N; s++) {
+    /* bits associated with/obtained from in-phase component: b0, b2, b4, b6 */
+    out[8*s] = (__real__ in[s] > 0) ? 0x0 : 0x1;
+    x = fabsf(__real__ in[s]) - QAM256_THRESHOLD_1;
+    out[8*s+2] = (x > 0) ? 0x1 : 0x0;
+    x = fabsf(x) - QAM256_THRESHOLD_2;
+    out[8*s+4] = (x > 0) ? 0x1 : 0x0;
+    x = fabsf(x) - QAM256_THRESHOLD_3;
+    out[8*s+6] = (x > 0) ? 0x1 : 0x0;
+
+    /* bits associated with/obtained from quadrature component: b1, b3, b5, b7 */
+    out[8*s+1] = (__imag__ in[s] > 0) ? 0x0 : 0x1;
+    x = fabsf(__imag__ in[s]) - QAM256_THRESHOLD_1;
+    out[8*s+3] = (x > 0) ? 0x1 : 0x0;
+    x = fabsf(x) - QAM256_THRESHOLD_2;
+    out[8*s+5] = (x > 0) ? 0x1 : 0x0;
+    x = fabsf(x) - QAM256_THRESHOLD_3;
+    out[8*s+7] = (x > 0) ? 0x1 : 0x0;
+  }
+}
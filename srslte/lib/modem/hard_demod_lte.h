@@ -32,6 +32,9 @@
 #define QAM64_THRESHOLD_1  2/sqrt(42)
 #define QAM64_THRESHOLD_2  4/sqrt(42)
 #define QAM64_THRESHOLD_3  6/sqrt(42)
+#define QAM256_THRESHOLD_1 8/sqrt(170)
+#define QAM256_THRESHOLD_2 4/sqrt(170)
+#define QAM256_THRESHOLD_3 2/sqrt(170)
 
 void hard_bpsk_demod(const cf_t* in, 
                      uint8_t* out, 
@@ -48,3 +51,7 @@ void hard_qam16_demod(const cf_t* in,
 void hard_qam64_demod(const cf_t* in, 
                                  uint8_t* out, 
                                  uint32_t N);
+
+void hard_qam256_demod(const cf_t* in, 
+                                 uint8_t* out, 
+                                 uint32_t N);
@@ -164,3 +164,20 @@ void set_64QAMtable(cf_t* table)
   table[63] = -QAM64_LEVEL_4 - QAM64_LEVEL_4*_Complex_I;
 }
 
+/**
+ * Set the 256QAM modulation table */
+void set_256QAMtable(cf_t* table)
+{
+  // LTE-256QAM constellation:
+  // see [3GPP TS 36.211 version 12.4.0 Release 12, Section 7.1.5]
+  // I = (1-2b0)[8-(1-2b2)[4-(1-2b4)[2-(1-2b6)]]], Q = same with b1, b3, b5 and b7.
+  for (uint32_t i = 0; i < 256; i++) {
+    int b[8];
+    for (uint32_t j = 0; j < 8; j++) {
+      b[j] = 1 - 2*((i >> (7 - j)) & 1);
+    }
+    float re = b[0]*(8 - b[2]*(4 - b[4]*(2 - b[6])));
+    float im = b[1]*(8 - b[3]*(4 - b[5]*(2 - b[7])));
+    table[i] = (re + im*_Complex_I)*QAM256_LEVEL;
+  }
+}
@@ -37,6 +37,8 @@
 #define QAM64_LEVEL_3  5/sqrt(42)
 #define QAM64_LEVEL_4  7/sqrt(42)
 
+#define QAM256_LEVEL   1/sqrt(170)
+
 /* HARD DEMODULATION Thresholds, necessary for obtaining the zone of received symbol for optimized LLR approx implementation */
 #define QAM16_THRESHOLD         2/sqrt(10)
 #define QAM64_THRESHOLD_1       2/sqrt(42)
@@ -58,3 +60,5 @@ void set_QPSKtable(cf_t* table);
 void set_16QAMtable(cf_t* table);
 
 void set_64QAMtable(cf_t* table);
+
+void set_256QAMtable(cf_t* table);
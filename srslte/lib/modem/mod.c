@@ -124,6 +124,12 @@ void mod_64qam_bytes(srslte_modem_table_t* q, uint8_t *bits, cf_t* symbols, uint
   }
 }
 
+void mod_256qam_bytes(srslte_modem_table_t* q, uint8_t *bits, cf_t* symbols, uint32_t nbits) {
+  for (int i=0;i<nbits/8;i++) {
+    symbols[i] = q->symbol_table[bits[i]];
+  }
+}
+
 /* Assumes packet bits as input */
 int srslte_mod_modulate_bytes(srslte_modem_table_t* q, uint8_t *bits, cf_t* symbols, uint32_t nbits) 
 {
@@ -149,8 +155,11 @@ int srslte_mod_modulate_bytes(srslte_modem_table_t* q, uint8_t *bits, cf_t* symb
     case 6:
       mod_64qam_bytes(q, bits, symbols, nbits);
       break;      
+    case 8:
+      mod_256qam_bytes(q, bits, symbols, nbits);
+      break;
     default:
-      fprintf(stderr, "srslte_mod_modulate_bytes() accepts QPSK/16QAM/64QAM modulations only\n");
+      fprintf(stderr, "srslte_mod_modulate_bytes() accepts QPSK/16QAM/64QAM/256QAM modulations only\n");
       return -1; 
   }
   return nbits/q->nbits_x_symbol;
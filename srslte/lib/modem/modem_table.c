@@ -114,6 +114,14 @@ int srslte_modem_table_lte(srslte_modem_table_t* q, srslte_mod_t modulation) {
     }
     set_64QAMtable(q->symbol_table);
     break;
+  case SRSLTE_MOD_256QAM:
+    q->nbits_x_symbol = 8;
+    q->nsymbols = 256;
+    if (table_create(q)) {
+      return SRSLTE_ERROR;
+    }
+    set_256QAMtable(q->symbol_table);
+    break;
   }
   return SRSLTE_SUCCESS;
 }
@@ -153,6 +161,10 @@ void srslte_modem_table_bytes(srslte_modem_table_t* q) {
     case 6:
       q->byte_tables_init = true; 
       break;
+    case 8:
+      // One symbol per byte, the symbol table is indexed directly.
+      q->byte_tables_init = true;
+      break;
   }
 }
 
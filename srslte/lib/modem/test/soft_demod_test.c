@@ -40,7 +40,7 @@ int num_bits = 1000;
 srslte_mod_t modulation = 10;
 
 void usage(char *prog) {
-  printf("Usage: %s [nfv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64)\n", prog);
+  printf("Usage: %s [nfv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64, 8: QAM256)\n", prog);
   printf("\t-n num_bits [Default %d]\n", num_bits);
   printf("\t-f nof_frames [Default %d]\n", nof_frames);
   printf("\t-v srslte_verbose [Default None]\n");
@@ -73,9 +73,12 @@ void parse_args(int argc, char **argv) {
       case 6:
         modulation = SRSLTE_MOD_64QAM;
         break;
+      case 8:
+        modulation = SRSLTE_MOD_256QAM;
+        break;
       default:
         fprintf(stderr, "Invalid modulation %d. Possible values: "
-            "(1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64)\n", atoi(argv[optind]));
+            "(1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64, 8: QAM256)\n", atoi(argv[optind]));
         break;
       }
       break;
@@ -100,6 +103,8 @@ float mse_threshold() {
       return 0.11; 
     case SRSLTE_MOD_64QAM:
       return 0.19;
+    case SRSLTE_MOD_256QAM:
+      return 0.25;
     default:
       return -1.0;
   }
@@ -228,6 +233,14 @@ int main(int argc, char **argv) {
           printf("Error in bit %d\n", i);
           goto clean_exit;
       }
+      if (input[i] != (llr_s[i]>0?1:0)) {
+          printf("Error in bit %d (short LLR)\n", i);
+          goto clean_exit;
+      }
+      if (input[i] != (llr_b[i]>0?1:0)) {
+          printf("Error in bit %d (byte LLR)\n", i);
+          goto clean_exit;
+      }
     }
   }
   ret = 0; 
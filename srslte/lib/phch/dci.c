@@ -1249,8 +1249,11 @@ int srslte_dci_msg_to_dl_grant_scatter(srslte_dci_msg_t *msg, uint16_t msg_rnti,
   if(msg != NULL && grant != NULL) {
     ret = SRSLTE_ERROR;
 
+    // The MCS table is not signalled, keep the one set by the caller.
+    srslte_ra_dl_mcs_table_t mcs_table = dl_dci->mcs_table;
     bzero(dl_dci, sizeof(srslte_ra_dl_dci_t));
     bzero(grant, sizeof(srslte_ra_dl_grant_t));
+    dl_dci->mcs_table = mcs_table;
 
     bool crc_is_crnti = false;
     if(msg_rnti >= SRSLTE_CRNTI_START && msg_rnti <= SRSLTE_CRNTI_END) {
@@ -49,7 +49,7 @@
 
 #define MAX_PDSCH_RE(cp) (2 * SRSLTE_CP_NSYMB(cp) * 12)
 
-const static srslte_mod_t modulations[4] = { SRSLTE_MOD_BPSK, SRSLTE_MOD_QPSK, SRSLTE_MOD_16QAM, SRSLTE_MOD_64QAM };
+const static srslte_mod_t modulations[5] = { SRSLTE_MOD_BPSK, SRSLTE_MOD_QPSK, SRSLTE_MOD_16QAM, SRSLTE_MOD_64QAM, SRSLTE_MOD_256QAM };
 
 #ifdef DEBUG_IDX
 cf_t *offset_original=NULL;
@@ -215,10 +215,11 @@ int srslte_pdsch_init_generic(srslte_pdsch_t *q, srslte_cell_t cell, uint32_t ph
     q->phy_id           = phy_id;
     q->add_sch_to_front = add_sch_to_front;
     q->llr_is_8bit      = false;
+    q->fused_rx         = true;
 
     INFO("Init PDSCH: %d ports %d PRBs, max_symbols: %d\n", q->cell.nof_ports, q->cell.nof_prb, q->max_re);
 
-    for(i = 0; i < 4; i++) {
+    for(i = 0; i < 5; i++) {
       if(srslte_modem_table_lte(&q->mod[i], modulations[i])) {
         goto clean;
       }
@@ -230,7 +231,7 @@ int srslte_pdsch_init_generic(srslte_pdsch_t *q, srslte_cell_t cell, uint32_t ph
     q->rnti_is_set = false;
 
     // Allocate int16_t for reception (LLRs)
-    q->e = srslte_vec_malloc(sizeof(int16_t) * q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM));
+    q->e = srslte_vec_malloc(sizeof(int16_t) * q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_256QAM));
     if(!q->e) {
       goto clean;
     }
@@ -260,6 +261,15 @@ int srslte_pdsch_init_generic(srslte_pdsch_t *q, srslte_cell_t cell, uint32_t ph
         return SRSLTE_ERROR;
       }
     }
+    if(srslte_sequence_cache_init(&q->seq_cache, SRSLTE_PDSCH_SEQ_CACHE_LEN)) {
+      goto clean;
+    }
+    for(i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
+      q->re_map[i] = srslte_vec_malloc(sizeof(uint32_t) * q->max_re);
+      if(!q->re_map[i]) {
+        goto clean;
+      }
+    }
     ret = SRSLTE_SUCCESS;
   }
   clean:
@@ -295,6 +305,9 @@ void srslte_pdsch_free(srslte_pdsch_t *q) {
 
   for (i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
     srslte_sequence_free(&q->seq[i]);
+    if (q->re_map[i]) {
+      free(q->re_map[i]);
+    }
   }
 
   for (i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
@@ -310,7 +323,9 @@ void srslte_pdsch_free(srslte_pdsch_t *q) {
     free(q->rnti_multi);
   }
 
-  for (i = 0; i < 4; i++) {
+  srslte_sequence_cache_free(&q->seq_cache);
+
+  for (i = 0; i < 5; i++) {
     srslte_modem_table_free(&q->mod[i]);
   }
 
@@ -350,7 +365,7 @@ int srslte_pdsch_set_rnti(srslte_pdsch_t *q, uint16_t rnti) {
   uint32_t i;
   for (i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
     if (srslte_sequence_pdsch(&q->seq[i], rnti, 0, 2 * i, q->cell.id,
-        q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM))) {
+        q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_256QAM))) {
       return SRSLTE_ERROR;
     }
   }
@@ -395,7 +410,7 @@ int srslte_pdsch_set_rnti_multi(srslte_pdsch_t *q, uint32_t idx, uint16_t rnti)
     q->rnti_is_set = true;
     for (uint32_t i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
       if (srslte_sequence_pdsch(&q->seq_multi[i][idx], rnti, 0, 2 * i, q->cell.id,
-          q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM))) {
+          q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_256QAM))) {
         return SRSLTE_ERROR;
       }
     }
@@ -498,13 +513,12 @@ int srslte_pdsch_decode_rnti(srslte_pdsch_t *q,
 
     /* descramble */
     if(rnti != q->rnti) {
-      srslte_sequence_t seq;
-      if(srslte_sequence_pdsch(&seq, rnti, 0, 2 * cfg->sf_idx, q->cell.id, cfg->nbits.nof_bits)) {
+      srslte_sequence_t *seq = srslte_sequence_cache_pdsch(&q->seq_cache, rnti, 0, 2 * cfg->sf_idx, q->cell.id, cfg->nbits.nof_bits);
+      if(!seq) {
         PDSCH_DEBUG("Error descrambling.\n",0);
         return SRSLTE_ERROR;
       }
-      srslte_scrambling_s_offset(&seq, q->e, 0, cfg->nbits.nof_bits);
-      srslte_sequence_free(&seq);
+      srslte_scrambling_s_offset(seq, q->e, 0, cfg->nbits.nof_bits);
     } else {
       srslte_scrambling_s_offset(&q->seq[cfg->sf_idx], q->e, 0, cfg->nbits.nof_bits);
     }
@@ -627,13 +641,11 @@ int srslte_pdsch_encode_rnti(srslte_pdsch_t *q,
                              uint8_t *data, uint16_t rnti, cf_t *sf_symbols[SRSLTE_MAX_PORTS])
 {
   if (rnti != q->rnti) {
-    srslte_sequence_t seq;
-    if (srslte_sequence_pdsch(&seq, rnti, 0, 2 * cfg->sf_idx, q->cell.id, cfg->nbits.nof_bits)) {
+    srslte_sequence_t *seq = srslte_sequence_cache_pdsch(&q->seq_cache, rnti, 0, 2 * cfg->sf_idx, q->cell.id, cfg->nbits.nof_bits);
+    if (!seq) {
       return SRSLTE_ERROR;
     }
-    int r = srslte_pdsch_encode_seq(q, cfg, softbuffer, data, &seq, sf_symbols);
-    srslte_sequence_free(&seq);
-    return r;
+    return srslte_pdsch_encode_seq(q, cfg, softbuffer, data, seq, sf_symbols);
   } else {
     return srslte_pdsch_encode_seq(q, cfg, softbuffer, data, &q->seq[cfg->sf_idx], sf_symbols);
   }
@@ -707,7 +719,14 @@ int srslte_pdsch_encode_rnti_scatter(srslte_pdsch_t *q,
                                      uint16_t rnti,
                                      cf_t *sf_symbols[SRSLTE_MAX_PORTS]) {
 
-  return srslte_pdsch_encode_seq_scatter(q, cfg, softbuffer, data, &q->seq[cfg->sf_idx], sf_symbols);
+  srslte_sequence_t *seq = &q->seq[cfg->sf_idx];
+  if(rnti != q->rnti) {
+    seq = srslte_sequence_cache_pdsch(&q->seq_cache, rnti, 0, 2 * cfg->sf_idx, q->cell.id, cfg->nbits.nof_bits);
+    if(!seq) {
+      return SRSLTE_ERROR;
+    }
+  }
+  return srslte_pdsch_encode_seq_scatter(q, cfg, softbuffer, data, seq, sf_symbols);
 }
 
 int srslte_pdsch_encode_seq_scatter(srslte_pdsch_t *q,
@@ -916,6 +935,9 @@ static void csi_correction(srslte_pdsch_t *q, srslte_pdsch_cfg_t *cfg, uint32_t
     case SRSLTE_MOD_64QAM:
       qm = 6;
       break;
+    case SRSLTE_MOD_256QAM:
+      qm = 8;
+      break;
     default:
       ERROR("No modulation.");
   }
@@ -981,6 +1003,17 @@ static void csi_correction(srslte_pdsch_t *q, srslte_pdsch_cfg_t *cfg, uint32_t
           _e += 3;
         }
         break;
+      case SRSLTE_MOD_256QAM:
+        for (; i < cfg->nbits.nof_bits - 7; i += 8) {
+          __m128 _csi = _mm_set1_ps(*(csi_v++));
+
+          _csi = _mm_mul_ps(_csi, _csi_scale);
+
+          _e[0] = _mm_mulhi_pi16(_e[0], _mm_cvtps_pi16(_csi));
+          _e[1] = _mm_mulhi_pi16(_e[1], _mm_cvtps_pi16(_csi));
+          _e += 2;
+        }
+        break;
       case SRSLTE_MOD_BPSK:
         break;
     }
@@ -997,6 +1030,183 @@ static void csi_correction(srslte_pdsch_t *q, srslte_pdsch_cfg_t *cfg, uint32_t
   }
 }
 
+void srslte_pdsch_set_fused_rx(srslte_pdsch_t *q, bool enable) {
+  q->fused_rx = enable;
+}
+
+#ifdef LV_HAVE_AVX2
+
+#define PROD_AVX(a,b) _mm256_addsub_ps(_mm256_mul_ps(a,_mm256_moveldup_ps(b)),_mm256_mul_ps(_mm256_shuffle_ps(a,a,0xB1),_mm256_movehdup_ps(b)))
+
+// Finds the grid positions of the PDSCH REs by extracting them from a grid holding the position of each RE, so they
+// are in the order given by srslte_pdsch_get_scatter(). The map is only rebuilt when the allocated PRBs change.
+static int pdsch_re_map_scatter(srslte_pdsch_t *q, srslte_ra_dl_grant_t *grant, uint32_t sf_idx) {
+  if(q->re_map_len[sf_idx] > 0 && !memcmp(q->re_map_prb_idx[sf_idx], grant->prb_idx, sizeof(grant->prb_idx))) {
+    return q->re_map_len[sf_idx];
+  }
+
+  uint32_t grid_len = SRSLTE_SF_LEN_RE(q->cell.nof_prb, q->cell.cp);
+  cf_t *grid = srslte_vec_malloc(sizeof(cf_t) * grid_len);
+  if(!grid) {
+    return SRSLTE_ERROR;
+  }
+  for(uint32_t i = 0; i < grid_len; i++) {
+    grid[i] = (float) i;
+  }
+  // q->d is not used by the fused receiver until the map is built.
+  int n = srslte_pdsch_get_scatter(q, grid, q->d, grant, sf_idx, q->add_sch_to_front);
+  free(grid);
+
+  for(int i = 0; i < n; i++) {
+    q->re_map[sf_idx][i] = (uint32_t) crealf(q->d[i]);
+  }
+  memcpy(q->re_map_prb_idx[sf_idx], grant->prb_idx, sizeof(grant->prb_idx));
+  q->re_map_len[sf_idx] = n;
+  return n;
+}
+
+// Gathers 4 REs from the grid and equalizes them exactly as srslte_predecoding_single_avx() does.
+static inline __m256 pdsch_equalize_avx2(const cf_t *sf_symbols, const cf_t *ce, const uint32_t *re_map,
+                                         float noise_estimate) {
+  const __m256 conjugator = _mm256_setr_ps(0, -0.f, 0, -0.f, 0, -0.f, 0, -0.f);
+  __m128i idx = _mm_loadu_si128((__m128i*) re_map);
+  __m256 y = _mm256_castpd_ps(_mm256_i32gather_pd((const double*) sf_symbols, idx, 8));
+  __m256 h = _mm256_castpd_ps(_mm256_i32gather_pd((const double*) ce, idx, 8));
+
+  __m256 t = _mm256_mul_ps(h, h);
+  __m256 hsquare = _mm256_hadd_ps(t, t);
+  if(noise_estimate > 0) {
+    hsquare = _mm256_add_ps(hsquare, _mm256_set1_ps(noise_estimate));
+  }
+  hsquare = _mm256_permute_ps(hsquare, _MM_SHUFFLE(1, 1, 0, 0));
+
+  return _mm256_div_ps(PROD_AVX(y, _mm256_xor_ps(h, conjugator)), hsquare);
+}
+
+// Converts 8 equalized symbols to 16-bit integers rounding to nearest, symbols in order.
+static inline __m256i pdsch_convert_avx2(__m256 x0, __m256 x1, __m256 scale) {
+  __m256i x = _mm256_packs_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(x0, scale)),
+                                 _mm256_cvtps_epi32(_mm256_mul_ps(x1, scale)));
+  return _mm256_permute4x64_epi64(x, 0xD8);
+}
+
+#define QAM64_PICK(s, a1, a2, idx, mask1, mask2) _mm256_blend_epi32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(s, idx), \
+  _mm256_permutevar8x32_epi32(a1, idx), mask1), _mm256_permutevar8x32_epi32(a2, idx), mask2)
+
+// Equalizes, demodulates and descrambles nof_re REs (a multiple of 8) in a single pass over the resource grid. The
+// LLRs are the ones computed by srslte_predecoding_single(), srslte_demod_soft_demodulate_s() and
+// srslte_scrambling_s_offset() for the same REs, since the same operations are done in registers.
+static void pdsch_fused_rx_avx2(const cf_t *sf_symbols, const cf_t *ce, const uint32_t *re_map, uint32_t nof_re,
+                                float noise_estimate, srslte_mod_t mod, const int16_t *c, int16_t *llr) {
+  uint32_t qm = srslte_mod_bits_x_symbol(mod);
+  __m256i out[4];
+
+  for(uint32_t i = 0; i < nof_re; i += 8) {
+    __m256 x0 = pdsch_equalize_avx2(sf_symbols, ce, &re_map[i], noise_estimate);
+    __m256 x1 = pdsch_equalize_avx2(sf_symbols, ce, &re_map[i + 4], noise_estimate);
+
+    switch(mod) {
+      case SRSLTE_MOD_QPSK: {
+        // Truncated as in srslte_vec_convert_fi().
+        __m256 scale = _mm256_set1_ps(-SCALE_SHORT_CONV_QPSK*sqrt(2));
+        __m256 a = _mm256_mul_ps(x0, scale);
+        __m256 b = _mm256_mul_ps(x1, scale);
+        out[0] = _mm256_packs_epi32(_mm256_cvttps_epi32(_mm256_permute2f128_ps(a, b, 0x20)),
+                                    _mm256_cvttps_epi32(_mm256_permute2f128_ps(a, b, 0x31)));
+        break;
+      }
+      case SRSLTE_MOD_16QAM: {
+        __m256i symbol_i = pdsch_convert_avx2(x0, x1, _mm256_set1_ps(-SCALE_SHORT_CONV_QAM16));
+        __m256i symbol_abs = _mm256_sub_epi16(_mm256_abs_epi16(symbol_i),
+                                              _mm256_set1_epi16(2*SCALE_SHORT_CONV_QAM16/sqrt(10)));
+        __m256i lo = _mm256_unpacklo_epi32(symbol_i, symbol_abs); // Symbols 0, 1, 4 and 5.
+        __m256i hi = _mm256_unpackhi_epi32(symbol_i, symbol_abs); // Symbols 2, 3, 6 and 7.
+        out[0] = _mm256_permute2x128_si256(lo, hi, 0x20);
+        out[1] = _mm256_permute2x128_si256(lo, hi, 0x31);
+        break;
+      }
+      case SRSLTE_MOD_64QAM: {
+        __m256i symbol_i = pdsch_convert_avx2(x0, x1, _mm256_set1_ps(-SCALE_SHORT_CONV_QAM64));
+        __m256i symbol_abs1 = _mm256_sub_epi16(_mm256_abs_epi16(symbol_i),
+                                               _mm256_set1_epi16(4*SCALE_SHORT_CONV_QAM64/sqrt(42)));
+        __m256i symbol_abs2 = _mm256_sub_epi16(_mm256_abs_epi16(symbol_abs1),
+                                               _mm256_set1_epi16(2*SCALE_SHORT_CONV_QAM64/sqrt(42)));
+        // Each symbol takes 3 consecutive dwords: pick the symbol of each output dword, then its LLR pair.
+        __m256i idx0 = _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2);
+        __m256i idx1 = _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5);
+        __m256i idx2 = _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7);
+        out[0] = QAM64_PICK(symbol_i, symbol_abs1, symbol_abs2, idx0, 0x92, 0x24);
+        out[1] = QAM64_PICK(symbol_i, symbol_abs1, symbol_abs2, idx1, 0x24, 0x49);
+        out[2] = QAM64_PICK(symbol_i, symbol_abs1, symbol_abs2, idx2, 0x49, 0x92);
+        break;
+      }
+      case SRSLTE_MOD_256QAM: {
+        __m256i symbol_i = pdsch_convert_avx2(x0, x1, _mm256_set1_ps(-SCALE_SHORT_CONV_QAM256));
+        __m256i symbol_abs1 = _mm256_sub_epi16(_mm256_abs_epi16(symbol_i),
+                                               _mm256_set1_epi16(8*SCALE_SHORT_CONV_QAM256/sqrt(170)));
+        __m256i symbol_abs2 = _mm256_sub_epi16(_mm256_abs_epi16(symbol_abs1),
+                                               _mm256_set1_epi16(4*SCALE_SHORT_CONV_QAM256/sqrt(170)));
+        __m256i symbol_abs3 = _mm256_sub_epi16(_mm256_abs_epi16(symbol_abs2),
+                                               _mm256_set1_epi16(2*SCALE_SHORT_CONV_QAM256/sqrt(170)));
+        __m256i t0 = _mm256_unpacklo_epi32(symbol_i, symbol_abs1);
+        __m256i t1 = _mm256_unpacklo_epi32(symbol_abs2, symbol_abs3);
+        __m256i t2 = _mm256_unpackhi_epi32(symbol_i, symbol_abs1);
+        __m256i t3 = _mm256_unpackhi_epi32(symbol_abs2, symbol_abs3);
+        __m256i s04 = _mm256_unpacklo_epi64(t0, t1);
+        __m256i s15 = _mm256_unpackhi_epi64(t0, t1);
+        __m256i s26 = _mm256_unpacklo_epi64(t2, t3);
+        __m256i s37 = _mm256_unpackhi_epi64(t2, t3);
+        out[0] = _mm256_permute2x128_si256(s04, s15, 0x20);
+        out[1] = _mm256_permute2x128_si256(s26, s37, 0x20);
+        out[2] = _mm256_permute2x128_si256(s04, s15, 0x31);
+        out[3] = _mm256_permute2x128_si256(s26, s37, 0x31);
+        break;
+      }
+      default:
+        return;
+    }
+
+    // Descramble, the sequence holds +1/-1.
+    for(uint32_t k = 0; k < qm/2; k++) {
+      __m256i seq = _mm256_loadu_si256((__m256i*) &c[qm*i + 16*k]);
+      _mm256_storeu_si256((__m256i*) &llr[qm*i + 16*k], _mm256_mullo_epi16(out[k], seq));
+    }
+  }
+}
+
+// Single pass receiver for one antenna port. The REs left over by the AVX2 kernel go through the separate steps, so
+// the LLRs do not depend on the receiver used.
+static int pdsch_fused_rx_scatter(srslte_pdsch_t *q, srslte_pdsch_cfg_t *cfg, cf_t *sf_symbols, cf_t *ce,
+                                  float noise_estimate, srslte_sequence_t *seq) {
+  int n = pdsch_re_map_scatter(q, &cfg->grant, cfg->sf_idx);
+  if(n != cfg->nbits.nof_re) {
+    PDSCH_ERROR("Error extracting symbols - Error expecting %d symbols but got %d\n", cfg->nbits.nof_re, n);
+    return SRSLTE_ERROR;
+  }
+
+  uint32_t qm = srslte_mod_bits_x_symbol(cfg->grant.mcs.mod);
+  const uint32_t *re_map = q->re_map[cfg->sf_idx];
+  int16_t *e = q->e;
+
+  // srslte_predecoding_single() equalizes the last n%16 REs, or all of them when there are 32 or less, in scalar code.
+  uint32_t nof_re_avx = n > 32 ? 16*(n/16) : 0;
+  pdsch_fused_rx_avx2(sf_symbols, ce, re_map, nof_re_avx, noise_estimate, cfg->grant.mcs.mod, seq->c_short, e);
+
+  uint32_t nof_re_left = n - nof_re_avx;
+  if(nof_re_left > 0) {
+    for(uint32_t i = 0; i < nof_re_left; i++) {
+      q->symbols[0][i] = sf_symbols[re_map[nof_re_avx + i]];
+      q->ce[0][i] = ce[re_map[nof_re_avx + i]];
+    }
+    srslte_predecoding_single(q->symbols[0], q->ce[0], q->d, nof_re_left, noise_estimate);
+    srslte_demod_soft_demodulate_s(cfg->grant.mcs.mod, q->d, &e[qm*nof_re_avx], nof_re_left);
+    srslte_scrambling_s_offset(seq, &e[qm*nof_re_avx], qm*nof_re_avx, qm*nof_re_left);
+  }
+  return SRSLTE_SUCCESS;
+}
+
+#endif /* LV_HAVE_AVX2 */
+
 // Decodes the PDSCH from the received symbols.
 int srslte_pdsch_decode_rnti_scatter(srslte_pdsch_t *q,
                                      srslte_pdsch_cfg_t *cfg, srslte_softbuffer_rx_t *softbuffer,
@@ -1025,6 +1235,25 @@ int srslte_pdsch_decode_rnti_scatter(srslte_pdsch_t *q,
     }
     memset(&x[q->cell.nof_ports], 0, sizeof(cf_t*) * (SRSLTE_MAX_LAYERS - q->cell.nof_ports));
 
+    // Scrambling sequence.
+    srslte_sequence_t *seq = &q->seq[cfg->sf_idx];
+    if(rnti != q->rnti) {
+      seq = srslte_sequence_cache_pdsch(&q->seq_cache, rnti, 0, 2 * cfg->sf_idx, q->cell.id, cfg->nbits.nof_bits);
+      if(!seq) {
+        PDSCH_ERROR("Error descrambling.\n", 0);
+        return SRSLTE_ERROR;
+      }
+    }
+
+#ifdef LV_HAVE_AVX2
+    if(q->fused_rx && q->cell.nof_ports == 1 && !enable_csi && cfg->grant.mcs.mod != SRSLTE_MOD_BPSK) {
+      if(pdsch_fused_rx_scatter(q, cfg, sf_symbols, ce[0], noise_estimate, seq)) {
+        return SRSLTE_ERROR;
+      }
+      return srslte_dlsch_decode(&q->dl_sch, cfg, softbuffer, q->e, data);
+    }
+#endif /* LV_HAVE_AVX2 */
+
     // Extract symbols.
     n = srslte_pdsch_get_scatter(q, sf_symbols, q->symbols[0], &cfg->grant, cfg->sf_idx, q->add_sch_to_front);
     if(n != cfg->nbits.nof_re) {
@@ -1060,17 +1289,7 @@ int srslte_pdsch_decode_rnti_scatter(srslte_pdsch_t *q,
     srslte_demod_soft_demodulate_s(cfg->grant.mcs.mod, q->d, q->e, cfg->nbits.nof_re);
 
     // Descramble.
-    if(rnti != q->rnti) {
-      srslte_sequence_t seq;
-      if(srslte_sequence_pdsch(&seq, rnti, 0, 2 * cfg->sf_idx, q->cell.id, cfg->nbits.nof_bits)) {
-        PDSCH_ERROR("Error descrambling.\n", 0);
-        return SRSLTE_ERROR;
-      }
-      srslte_scrambling_s_offset(&seq, q->e, 0, cfg->nbits.nof_bits);
-      srslte_sequence_free(&seq);
-    } else {
-      srslte_scrambling_s_offset(&q->seq[cfg->sf_idx], q->e, 0, cfg->nbits.nof_bits);
-    }
+    srslte_scrambling_s_offset(seq, q->e, 0, cfg->nbits.nof_bits);
 
     if(enable_csi) {
       csi_correction(q, cfg, 0, 0, q->e);
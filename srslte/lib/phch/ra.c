@@ -799,7 +799,11 @@ int dl_dci_to_grant_mcs_scatter(srslte_ra_dl_dci_t *dci, srslte_ra_dl_grant_t *g
   } else {
     n_prb = grant->nof_prb;
     grant->mcs.idx = dci->mcs_idx;
-    tbs = dl_fill_ra_mcs_scatter(&grant->mcs, n_prb);
+    if(dci->mcs_table == SRSLTE_RA_DL_MCS_TABLE_256QAM) {
+      tbs = dl_fill_ra_mcs_256qam_scatter(&grant->mcs, n_prb);
+    } else {
+      tbs = dl_fill_ra_mcs_scatter(&grant->mcs, n_prb);
+    }
     if(tbs) {
       last_dl_tbs[dci->harq_process%8] = tbs;
     } else {
@@ -808,7 +812,11 @@ int dl_dci_to_grant_mcs_scatter(srslte_ra_dl_dci_t *dci, srslte_ra_dl_grant_t *g
     }
     if(dci->nof_tb == 2) {
       grant->mcs2.idx = dci->mcs_idx_1;
-      tbs = dl_fill_ra_mcs_scatter(&grant->mcs2, n_prb);
+      if(dci->mcs_table == SRSLTE_RA_DL_MCS_TABLE_256QAM) {
+        tbs = dl_fill_ra_mcs_256qam_scatter(&grant->mcs2, n_prb);
+      } else {
+        tbs = dl_fill_ra_mcs_scatter(&grant->mcs2, n_prb);
+      }
     }
   }
   grant->Qm = srslte_mod_bits_x_symbol(grant->mcs.mod);
@@ -850,6 +858,29 @@ int dl_fill_ra_mcs_scatter(srslte_ra_mcs_t *mcs, uint32_t nprb) {
   return tbs;
 }
 
+// Modulation order and TBS for the 256QAM MCS table.
+// Modulation orders follow Table 7.1.7.1-1A in 36.213, MCS 28 to 31 are reserved.
+int dl_fill_ra_mcs_256qam_scatter(srslte_ra_mcs_t *mcs, uint32_t nprb) {
+  int tbs = -1;
+  if(mcs->idx < 5) {
+    mcs->mod = SRSLTE_MOD_QPSK;
+  } else if(mcs->idx < 11) {
+    mcs->mod = SRSLTE_MOD_16QAM;
+  } else if(mcs->idx < 20) {
+    mcs->mod = SRSLTE_MOD_64QAM;
+  } else if(mcs->idx < 28) {
+    mcs->mod = SRSLTE_MOD_256QAM;
+  } else {
+    fprintf(stderr, "Invalid MCS value for the 256QAM table.\n");
+    return SRSLTE_ERROR;
+  }
+  tbs = srslte_ra_tbs_from_idx_256qam_scatter(mcs->idx, nprb);
+  if(tbs >= 0) {
+    mcs->tbs = tbs;
+  }
+  return tbs;
+}
+
 static int get_bw_index(uint32_t n_prb) {
   int ret = -1;
   switch(n_prb) {
@@ -903,6 +934,35 @@ int srslte_ra_tbs_from_idx_scatter(uint32_t tbs_idx, uint32_t n_prb) {
   return ret;
 }
 
+// TBS in bits for the 256QAM MCS table, the MCS index is also the TBS index.
+int srslte_ra_tbs_from_idx_256qam_scatter(uint32_t mcs_idx, uint32_t n_prb) {
+  int ret = SRSLTE_ERROR;
+  int bw_index = get_bw_index(n_prb);
+  if(bw_index >= 0 && mcs_idx < 28) {
+    ret = 8*tbs_table_scatter_256qam[bw_index][mcs_idx];
+  } else {
+    fprintf(stderr, "[RA TBS table] 256QAM table - mcs_idx: %d - bw_index: %d\n", mcs_idx, bw_index);
+  }
+  return ret;
+}
+
+// Largest TBS in bits that can be granted with any of the MCS tables, used to size the soft buffers.
+int srslte_ra_max_tbs_scatter(uint32_t n_prb) {
+  int tbs = srslte_ra_tbs_from_idx_scatter(31, n_prb);
+  if(get_bw_index(n_prb) >= 0) {
+    int tbs_256qam = srslte_ra_tbs_from_idx_256qam_scatter(27, n_prb);
+    if(tbs_256qam > tbs) {
+      tbs = tbs_256qam;
+    }
+  }
+  return tbs;
+}
+
+// Returns the highest valid MCS index of the given MCS table.
+uint32_t srslte_ra_max_mcs_scatter(srslte_ra_dl_mcs_table_t mcs_table) {
+  return mcs_table == SRSLTE_RA_DL_MCS_TABLE_256QAM ? 27 : 31;
+}
+
 void srslte_ra_dl_grant_to_nbits_scatter(srslte_ra_dl_grant_t *grant, bool add_sch_to_front, uint32_t eob_pss_len, srslte_cell_t cell, uint32_t sf_idx, srslte_ra_nbits_t *nbits) {
   // Compute number of RE.
   nbits->nof_re   = srslte_ra_dl_grant_nof_re_scatter(grant, add_sch_to_front, eob_pss_len, cell, sf_idx);
@@ -967,3 +1027,22 @@ uint32_t ra_re_x_prb_scatter(uint32_t subframe, uint32_t slot, uint32_t prb_idx,
 uint32_t srslte_ra_get_tb_size_scatter(uint32_t prb, uint32_t mcs) {
   return tbs_table_scatter_higher_mcs[prb][mcs];
 }
+
+// Returns the transport block size in bytes for scatter PHY for the given MCS table.
+// Returns 0 if the BW index or the MCS are out of the range of the table, e.g., MCS 28 with the 256QAM table.
+uint32_t srslte_ra_get_tb_size_mcs_table_scatter(srslte_ra_dl_mcs_table_t mcs_table, uint32_t prb, uint32_t mcs) {
+  if(prb >= sizeof(tbs_table_scatter_higher_mcs)/sizeof(tbs_table_scatter_higher_mcs[0]) || mcs > srslte_ra_max_mcs_scatter(mcs_table)) {
+    fprintf(stderr, "[RA TBS table] %s table - mcs_idx: %d - bw_index: %d out of range\n", mcs_table == SRSLTE_RA_DL_MCS_TABLE_256QAM ? "256QAM" : "64QAM", mcs, prb);
+    return 0;
+  }
+  if(mcs_table == SRSLTE_RA_DL_MCS_TABLE_256QAM) {
+    return tbs_table_scatter_256qam[prb][mcs];
+  }
+  return tbs_table_scatter_higher_mcs[prb][mcs];
+}
+
+// Returns the redundancy version of the given (re)transmission of a TB, following the LTE sequence 0, 2, 3, 1.
+uint32_t srslte_ra_rvidx_scatter(uint32_t retx_cnt) {
+  static const uint32_t rvidx_sequence[4] = {0, 2, 3, 1};
+  return rvidx_sequence[retx_cnt%4];
+}
@@ -44,6 +44,9 @@
 
 #define SRSLTE_PDSCH_MAX_TDEC_ITERS         15
 
+// Rate matched code blocks wait here, each one starting on its own byte, before being stitched in the output.
+#define SCH_ENCODE_STAGE_LEN (SRSLTE_MAX_PRB*12*12*12/8 + 2*SRSLTE_MAX_CODEBLOCKS)
+
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
 #endif /* LV_HAVE_SSE */
@@ -117,7 +120,7 @@ int srslte_sch_init_generic(srslte_sch_t *q, uint32_t phy_id) {
       goto clean;
     }
 
-    if (srslte_tcod_init_generic(&q->encoder, SRSLTE_TCOD_MAX_LEN_CB, q->phy_id)) {
+    if (srslte_tcod_init(&q->encoder, SRSLTE_TCOD_MAX_LEN_CB)) {
       fprintf(stderr, "Error initiating Turbo Coder\n");
       goto clean;
     }
@@ -128,7 +131,8 @@ int srslte_sch_init_generic(srslte_sch_t *q, uint32_t phy_id) {
 
     q->max_iterations = SRSLTE_PDSCH_MAX_TDEC_ITERS;
 
-    srslte_rm_turbo_gentables(q->phy_id);
+    srslte_rm_turbo_gentables();
+    q->rm_tables_acquired = true;
 
     // Allocate int16 for reception (LLRs)
     q->cb_in = srslte_vec_malloc(sizeof(uint8_t) * (SRSLTE_TCOD_MAX_LEN_CB+8)/8);
@@ -170,7 +174,11 @@ clean:
 }
 
 void srslte_sch_free(srslte_sch_t *q) {
-  srslte_rm_turbo_free_tables(q->phy_id);
+  // Only release the reference taken by this instance, so failed inits and double frees keep the count right.
+  if (q->rm_tables_acquired) {
+    srslte_rm_turbo_free_tables();
+    q->rm_tables_acquired = false;
+  }
 
   if (q->cb_in) {
     free(q->cb_in);
@@ -184,12 +192,88 @@ void srslte_sch_free(srslte_sch_t *q) {
   if (q->ul_interleaver) {
     free(q->ul_interleaver);
   }
+  srslte_sch_set_encode_workers(q, 0);
   srslte_tdec_free(&q->decoder);
   srslte_tcod_free(&q->encoder);
   srslte_uci_cqi_free(&q->uci_cqi);
   bzero(q, sizeof(srslte_sch_t));
 }
 
+int srslte_sch_set_encode_workers(srslte_sch_t *q, uint32_t nof_workers) {
+  if (q->encode_team) {
+    srslte_worker_team_free(q->encode_team);
+    free(q->encode_team);
+    q->encode_team = NULL;
+  }
+  if (q->encode_workers) {
+    for (uint32_t i = 0; i < q->nof_encode_workers; i++) {
+      // Only the scratch buffer is owned by the worker, the coder tables are shared with q->encoder.
+      if (q->encode_workers[i].encoder.temp) {
+        free(q->encode_workers[i].encoder.temp);
+      }
+      if (q->encode_workers[i].cb_in) {
+        free(q->encode_workers[i].cb_in);
+      }
+      if (q->encode_workers[i].parity_bits) {
+        free(q->encode_workers[i].parity_bits);
+      }
+    }
+    free(q->encode_workers);
+    q->encode_workers = NULL;
+  }
+  if (q->encode_stage) {
+    free(q->encode_stage);
+    q->encode_stage = NULL;
+  }
+  q->nof_encode_workers = 0;
+
+  if (nof_workers <= 1) {
+    return SRSLTE_SUCCESS;
+  }
+  if (nof_workers > SRSLTE_WORKER_TEAM_MAX_WORKERS) {
+    fprintf(stderr, "Error number of encode workers (%d) exceeds maximum (%d)\n", nof_workers,
+            SRSLTE_WORKER_TEAM_MAX_WORKERS);
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  q->encode_workers = calloc(nof_workers, sizeof(srslte_sch_encode_worker_t));
+  if (!q->encode_workers) {
+    goto clean;
+  }
+  q->nof_encode_workers = nof_workers;
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    srslte_sch_encode_worker_t *w = &q->encode_workers[i];
+    w->encoder = q->encoder;
+    w->encoder.temp = srslte_vec_malloc(sizeof(uint8_t) * SRSLTE_TCOD_MAX_LEN_CB/8);
+    w->crc_tb = q->crc_tb;
+    w->crc_cb = q->crc_cb;
+    w->cb_in = srslte_vec_malloc(sizeof(uint8_t) * (SRSLTE_TCOD_MAX_LEN_CB+8)/8);
+    w->parity_bits = srslte_vec_malloc(sizeof(uint8_t) * (3 * SRSLTE_TCOD_MAX_LEN_CB + 16) / 8);
+    if (!w->encoder.temp || !w->cb_in || !w->parity_bits) {
+      goto clean;
+    }
+  }
+  q->encode_stage = srslte_vec_malloc(sizeof(uint8_t) * SCH_ENCODE_STAGE_LEN);
+  if (!q->encode_stage) {
+    goto clean;
+  }
+  q->encode_team = malloc(sizeof(srslte_worker_team_t));
+  if (!q->encode_team) {
+    goto clean;
+  }
+  if (srslte_worker_team_init(q->encode_team, nof_workers)) {
+    fprintf(stderr, "Error initiating encode worker team\n");
+    free(q->encode_team);
+    q->encode_team = NULL;
+    goto clean;
+  }
+  return SRSLTE_SUCCESS;
+
+clean:
+  srslte_sch_set_encode_workers(q, 0);
+  return SRSLTE_ERROR;
+}
+
 void srslte_sch_set_max_noi(srslte_sch_t *q, uint32_t max_iterations) {
   q->max_iterations = max_iterations;
 }
@@ -202,6 +286,107 @@ uint32_t srslte_sch_last_noi(srslte_sch_t *q) {
   return q->nof_iterations;
 }
 
+typedef struct {
+  srslte_sch_t *q;
+  srslte_softbuffer_tx_t *softbuffer;
+  srslte_cbsegm_t *cb_segm;
+  uint8_t *data;
+  uint32_t rv;
+  uint32_t tb_crc;
+  uint32_t rp[SRSLTE_MAX_CODEBLOCKS];
+  uint32_t n_e[SRSLTE_MAX_CODEBLOCKS];
+  uint32_t phase[SRSLTE_MAX_CODEBLOCKS];
+  uint32_t stage_offset[SRSLTE_MAX_CODEBLOCKS];
+  int ret[SRSLTE_MAX_CODEBLOCKS];
+} encode_cb_args_t;
+
+/* Encodes and rate matches one code block into the stage buffer. Runs on any worker of the team. */
+static void encode_cb_task(void *arg, uint32_t i, uint32_t worker_idx) {
+  encode_cb_args_t *a = (encode_cb_args_t*) arg;
+  srslte_sch_encode_worker_t *w = &a->q->encode_workers[worker_idx];
+  srslte_cbsegm_t *cb_segm = a->cb_segm;
+
+  uint32_t cb_len = (i < cb_segm->C2) ? cb_segm->K2 : cb_segm->K1;
+  uint32_t cblen_idx = (i < cb_segm->C2) ? cb_segm->K2_idx : cb_segm->K1_idx;
+  // Only used with more than one CB, so there is always a CB CRC.
+  uint32_t rlen = cb_len - 24;
+
+  if (a->data) {
+    if (i < cb_segm->C - 1) {
+      memcpy(w->cb_in, &a->data[a->rp[i]/8], rlen * sizeof(uint8_t)/8);
+    } else {
+      /* The TB CRC was computed up front, append it as data so that the CB CRC covers it */
+      memcpy(w->cb_in, &a->data[a->rp[i]/8], (rlen - 24) * sizeof(uint8_t)/8);
+      for (int j = 0; j < 3; j++) {
+        w->cb_in[(rlen - 24)/8 + j] = (uint8_t) ((a->tb_crc >> (8 * (2 - j))) & 0xff);
+      }
+    }
+    srslte_tcod_encode_lut(&w->encoder, &w->crc_tb, &w->crc_cb, w->cb_in, w->parity_bits, cblen_idx, false);
+    // Only RV 0 fills the circular buffer, which may hold another TB when a retransmission comes with its data.
+    if (a->rv > 0) {
+      srslte_rm_turbo_tx_interleave_lut(a->softbuffer->buffer_b[i], w->cb_in, w->parity_bits, cblen_idx);
+    }
+  }
+
+  a->ret[i] = srslte_rm_turbo_tx_lut(a->softbuffer->buffer_b[i], w->cb_in, w->parity_bits,
+                                     &a->q->encode_stage[a->stage_offset[i]], cblen_idx, a->n_e[i], a->phase[i], a->rv);
+}
+
+/* Code block parallel version of encode_tb_off(). The TB CRC does not depend on the encoding, so it is computed
+ * first and every CB becomes independent. CBs are rate matched in their own bytes of the stage buffer with the same
+ * bit phase they have in the output, because neighbour CBs share output bytes when n_e is not a multiple of 8. They
+ * are then copied in order to their precomputed output offsets. Returns 1 if the TB does not fit and has to be
+ * encoded serially.
+ */
+static int encode_tb_off_parallel(srslte_sch_t *q,
+                                  srslte_softbuffer_tx_t *softbuffer, srslte_cbsegm_t *cb_segm,
+                                  uint32_t Qm, uint32_t rv, uint32_t nof_e_bits,
+                                  uint8_t *data, uint8_t *e_bits, uint32_t w_offset)
+{
+  encode_cb_args_t a;
+  uint32_t Gp = nof_e_bits / Qm;
+  uint32_t gamma = Gp%cb_segm->C;
+  uint32_t rp = 0, wp = 0, stage_len = 0;
+
+  a.q = q;
+  a.softbuffer = softbuffer;
+  a.cb_segm = cb_segm;
+  a.data = data;
+  a.rv = rv;
+  a.tb_crc = data ? srslte_crc_checksum_byte(&q->crc_tb, data, cb_segm->tbs) : 0;
+
+  for (uint32_t i = 0; i < cb_segm->C; i++) {
+    uint32_t cb_len = (i < cb_segm->C2) ? cb_segm->K2 : cb_segm->K1;
+    if (i <= cb_segm->C - gamma - 1) {
+      a.n_e[i] = Qm * (Gp/cb_segm->C);
+    } else {
+      a.n_e[i] = Qm * ((uint32_t) ceilf((float) Gp/cb_segm->C));
+    }
+    a.rp[i] = rp;
+    a.phase[i] = (wp + w_offset)%8;
+    a.stage_offset[i] = stage_len;
+    stage_len += (a.phase[i] + a.n_e[i] + 7)/8;
+    rp += cb_len - 24;
+    wp += a.n_e[i];
+  }
+  if (stage_len > SCH_ENCODE_STAGE_LEN) {
+    return 1;
+  }
+
+  srslte_worker_team_run(q->encode_team, encode_cb_task, &a, cb_segm->C);
+
+  wp = 0;
+  for (uint32_t i = 0; i < cb_segm->C; i++) {
+    if (a.ret[i]) {
+      fprintf(stderr, "Error in rate matching\n");
+      return SRSLTE_ERROR;
+    }
+    srslte_bit_copy(e_bits, wp + w_offset, &q->encode_stage[a.stage_offset[i]], a.phase[i], a.n_e[i]);
+    wp += a.n_e[i];
+  }
+  return SRSLTE_SUCCESS;
+}
+
 /* Encode a transport block according to 36.212 5.3.2
  *
  */
@@ -231,6 +416,14 @@ static int encode_tb_off(srslte_sch_t *q,
       return -1;
     }
 
+    if (q->encode_team && cb_segm->C > 1 && cb_segm->C <= SRSLTE_MAX_CODEBLOCKS) {
+      ret = encode_tb_off_parallel(q, softbuffer, cb_segm, Qm, rv, nof_e_bits, data, e_bits, w_offset);
+      if (ret <= 0) {
+        return ret;
+      }
+      ret = SRSLTE_ERROR_INVALID_INPUTS;
+    }
+
     uint32_t Gp = nof_e_bits / Qm;
 
     uint32_t gamma = Gp;
@@ -294,11 +487,16 @@ static int encode_tb_off(srslte_sch_t *q,
                                q->parity_bits,
                                cblen_idx,
                                last_cb);
+
+        /* Only RV 0 fills the circular buffer, which may hold another TB when a retransmission comes with its data */
+        if (rv > 0) {
+          srslte_rm_turbo_tx_interleave_lut(softbuffer->buffer_b[i], q->cb_in, q->parity_bits, cblen_idx);
+        }
       }
       DEBUG("RM cblen_idx=%d, n_e=%d, wp=%d, nof_e_bits=%d\n",cblen_idx, n_e, wp, nof_e_bits);
 
       /* Rate matching */
-      if (srslte_rm_turbo_tx_lut(q->phy_id, softbuffer->buffer_b[i], q->cb_in, q->parity_bits,
+      if (srslte_rm_turbo_tx_lut(softbuffer->buffer_b[i], q->cb_in, q->parity_bits,
         &e_bits[(wp+w_offset)/8], cblen_idx, n_e, (wp+w_offset)%8, rv))
       {
         fprintf(stderr, "Error in rate matching\n");
@@ -362,12 +560,12 @@ bool decode_tb_cb(srslte_sch_t *q,
       }
 
       if(q->llr_is_8bit) {
-        if(srslte_rm_turbo_rx_lut_8bit(q->phy_id, &e_bits_b[rp], (int8_t*) softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
+        if(srslte_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*) softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
           fprintf(stderr, "Error in rate matching\n");
           return SRSLTE_ERROR;
         }
       } else {
-        if(srslte_rm_turbo_rx_lut(q->phy_id, &e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
+        if(srslte_rm_turbo_rx_lut(&e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
           fprintf(stderr, "Error in rate matching\n");
           return SRSLTE_ERROR;
         }
@@ -70,6 +70,10 @@ int srslte_sequence_pdsch(srslte_sequence_t *seq, uint16_t rnti, int q, uint32_t
   return srslte_sequence_LTE_pr(seq, len, (rnti<<14) + (q<<13) + ((nslot/2)<<9) + cell_id);
 }
 
+srslte_sequence_t *srslte_sequence_cache_pdsch(srslte_sequence_cache_t *cache, uint16_t rnti, int q, uint32_t nslot, uint32_t cell_id, uint32_t len) {
+  return srslte_sequence_cache_get(cache, (rnti<<14) + (q<<13) + ((nslot/2)<<9) + cell_id, len);
+}
+
 /**
  * 36.211 5.3.1
  */
@@ -363,3 +363,23 @@ static const unsigned int tbs_table_std_lte[6][29] = {{19,26,32,41,51,63,75,89,1
 {173,225,277,357,453,549,645,775,871,999,999,1095,1239,1431,1620,1764,1908,1908,2052,2292,2481,2673,2865,3182,3422,3542,3822,3963,4587}, // Values for 10 MHz BW
 {261,341,421,549,669,839,967,1143,1335,1479,1479,1620,1908,2124,2385,2673,2865,2865,3062,3422,3662,4107,4395,4736,5072,5477,5669,5861,6882}, // Values for 15 MHz BW
 {349,453,573,717,903,1095,1287,1527,1764,1980,1980,2196,2481,2865,3182,3542,3822,3822,4107,4587,4904,5477,5861,6378,6882,7167,7708,7972,9422}}; // Values for 20 MHz BW
+
+// TBS Table for the 256QAM MCS table, given in bytes and indexed by MCS (0-27). The MCS index follows the modulation
+// orders of Table 7.1.7.1-1A of 36.213 and the code rates of the NR 256QAM MCS table. The sizes are computed for the
+// subframe with the fewest REs, i.e., the one carrying PSS/SSS and the SCH, and rounded down to sizes that are split
+// into code blocks of the same size and without filler bits, as the ones in the table above.
+#if(ENABLE_GUARD_BAND_HARVESTING==0)
+static const unsigned int tbs_table_scatter_256qam[6][28] = {{18,32,52,77,105,133,153,173,197,217,233,249,277,301,325,357,381,413,437,469,485,509,541,573,605,637,661,685}, // Values for 1.4 MHz BW (6 RBs)
+{60,99,161,233,317,397,453,517,581,653,693,741,807,887,967,1047,1127,1223,1303,1383,1431,1495,1596,1668,1764,1860,1932,2004}, // Values for 3 MHz BW
+{107,173,277,405,549,693,791,887,999,1127,1191,1271,1415,1548,1692,1812,1980,2124,2244,2385,2481,2609,2769,2929,3062,3222,3342,3462}, // Values for 5 MHz BW
+{225,357,581,839,1127,1415,1620,1836,2076,2321,2481,2641,2929,3182,3462,3742,4059,4347,4624,4904,5128,5352,5669,5989,6306,6666,6927,7167}, // Values for 10 MHz BW
+{341,549,871,1271,1716,2148,2481,2801,3142,3502,3742,3963,4395,4848,5240,5669,6162,6594,7007,7487,7796,8060,8601,9081,9630,10035,10483,10752}, // Values for 15 MHz BW
+{453,733,1175,1716,2292,2897,3302,3742,4203,4680,5016,5352,5925,6522,7087,7647,8236,8793,9422,10035,10371,10872,11472,12109,12866,13479,13924,14532}}; // Values for 20 MHz BW
+#else
+static const unsigned int tbs_table_scatter_256qam[6][28] = {{23,39,63,95,129,161,185,213,241,261,285,301,333,365,397,437,469,501,541,573,597,621,661,693,733,765,791,823}, // Values for 1.4 MHz BW (7 RBs)
+{60,99,161,233,317,397,453,517,581,653,693,741,807,887,967,1047,1127,1223,1303,1383,1431,1495,1596,1668,1764,1860,1932,2004}, // Values for 3 MHz BW
+{107,173,277,405,549,693,791,887,999,1127,1191,1271,1415,1548,1692,1812,1980,2124,2244,2385,2481,2609,2769,2929,3062,3222,3342,3462}, // Values for 5 MHz BW
+{225,357,581,839,1127,1415,1620,1836,2076,2321,2481,2641,2929,3182,3462,3742,4059,4347,4624,4904,5128,5352,5669,5989,6306,6666,6927,7167}, // Values for 10 MHz BW
+{341,549,871,1271,1716,2148,2481,2801,3142,3502,3742,3963,4395,4848,5240,5669,6162,6594,7007,7487,7796,8060,8601,9081,9630,10035,10483,10752}, // Values for 15 MHz BW
+{453,733,1175,1716,2292,2897,3302,3742,4203,4680,5016,5352,5925,6522,7087,7647,8236,8793,9422,10035,10371,10872,11472,12109,12866,13479,13924,14532}}; // Values for 20 MHz BW
+#endif
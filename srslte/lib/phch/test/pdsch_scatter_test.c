@@ -0,0 +1,303 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <math.h>
+#include <complex.h>
+
+#include "srslte/srslte.h"
+
+// Loopback of the scatter PDSCH (encode, AWGN channel, decode) measuring the BLER and the BER. Optionally checks that
+// the fused receiver computes the same LLRs as the separate extraction, equalization, demodulation and descrambling,
+// or retransmits the TBs not decoded with the next redundancy version, combining them in the soft buffer as HARQ does.
+
+srslte_cell_t cell = {
+  25,           // nof_prb
+  1,            // nof_ports
+  0,
+  0,            // cell_id
+  SRSLTE_CP_NORM,       // cyclic prefix
+  SRSLTE_PHICH_R_1_6,          // PHICH resources
+  SRSLTE_PHICH_NORM    // PHICH length
+};
+
+uint32_t mcs = 0;
+uint32_t subframe = 5;
+uint16_t rnti = 1234;
+uint32_t nof_tbs = 100;
+float snr_db = 30.0;
+float max_bler = 0.01;
+srslte_ra_dl_mcs_table_t mcs_table = SRSLTE_RA_DL_MCS_TABLE_64QAM;
+bool check_fused_rx = false;
+uint32_t max_tx = 1;
+
+void usage(char *prog) {
+  printf("Usage: %s [mnsNSbqerv] \n", prog);
+  printf("\t-m MCS [Default %d]\n", mcs);
+  printf("\t-n cell.nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-s subframe [Default %d]\n", subframe);
+  printf("\t-N number of TBs [Default %d]\n", nof_tbs);
+  printf("\t-S SNR in dB [Default %1.1f]\n", snr_db);
+  printf("\t-b maximum BLER [Default %1.3f]\n", max_bler);
+  printf("\t-q use the 256QAM MCS table [Default 64QAM MCS table]\n");
+  printf("\t-e check the fused receiver LLRs against the separate steps, with a random channel [Default %s]\n", check_fused_rx ? "yes" : "no");
+  printf("\t-r maximum number of HARQ transmissions per TB [Default %d]\n", max_tx);
+  printf("\t-v [set srslte_verbose to debug, default none]\n");
+}
+
+void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "mnsNSbqerv")) != -1) {
+    switch(opt) {
+    case 'm':
+      mcs = atoi(argv[optind]);
+      break;
+    case 'n':
+      cell.nof_prb = atoi(argv[optind]);
+      break;
+    case 's':
+      subframe = atoi(argv[optind]);
+      break;
+    case 'N':
+      nof_tbs = atoi(argv[optind]);
+      break;
+    case 'S':
+      snr_db = atof(argv[optind]);
+      break;
+    case 'b':
+      max_bler = atof(argv[optind]);
+      break;
+    case 'q':
+      mcs_table = SRSLTE_RA_DL_MCS_TABLE_256QAM;
+      break;
+    case 'e':
+      check_fused_rx = true;
+      break;
+    case 'r':
+      max_tx = atoi(argv[optind]);
+      break;
+    case 'v':
+      srslte_verbose++;
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t i, j;
+  int ret = -1;
+  uint8_t *data_tx = NULL, *data_rx = NULL;
+  int16_t *llr_ref = NULL;
+  cf_t *ce[SRSLTE_MAX_PORTS];
+  cf_t *sf_symbols[SRSLTE_MAX_PORTS];
+  srslte_softbuffer_tx_t softbuffer_tx;
+  srslte_softbuffer_rx_t softbuffer_rx;
+  srslte_ra_dl_grant_t grant;
+  srslte_pdsch_cfg_t pdsch_cfg;
+  srslte_pdsch_t pdsch;
+
+  parse_args(argc,argv);
+
+  bzero(&pdsch, sizeof(srslte_pdsch_t));
+  bzero(&pdsch_cfg, sizeof(srslte_pdsch_cfg_t));
+  bzero(ce, sizeof(cf_t*)*SRSLTE_MAX_PORTS);
+  bzero(sf_symbols, sizeof(cf_t*)*SRSLTE_MAX_PORTS);
+  bzero(&softbuffer_rx, sizeof(srslte_softbuffer_rx_t));
+  bzero(&softbuffer_tx, sizeof(srslte_softbuffer_tx_t));
+
+  if (mcs > srslte_ra_max_mcs_scatter(mcs_table)) {
+    fprintf(stderr, "Invalid MCS %d, maximum is %d\n", mcs, srslte_ra_max_mcs_scatter(mcs_table));
+    exit(-1);
+  }
+
+  srslte_ra_dl_dci_t dci;
+  bzero(&dci, sizeof(srslte_ra_dl_dci_t));
+  dci.mcs_idx = mcs;
+  dci.mcs_table = mcs_table;
+  dci.alloc_type = SRSLTE_RA_ALLOC_TYPE0;
+  dci.type0_alloc.rbg_bitmask = 0xffffffff;
+  if (srslte_ra_dl_dci_to_grant_scatter(&dci, cell.nof_prb, rnti, &grant)) {
+    fprintf(stderr, "Error computing resource allocation\n");
+    return ret;
+  }
+
+  /* Configure PDSCH */
+  if (srslte_pdsch_cfg_scatter(&pdsch_cfg, true, 62, cell, &grant, 2, subframe, 0)) {
+    fprintf(stderr, "Error configuring PDSCH\n");
+    exit(-1);
+  }
+
+  /* init memory */
+  for (i=0;i<cell.nof_ports;i++) {
+    ce[i] = srslte_vec_malloc(sizeof(cf_t) * SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp));
+    if (!ce[i]) {
+      perror("srslte_vec_malloc");
+      goto quit;
+    }
+    for (j=0;j<SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp);j++) {
+      if (check_fused_rx) {
+        // Known random channel, so the equalizer is exercised too.
+        ce[i][j] = (0.5f + (float) rand()/RAND_MAX) * cexpf(_Complex_I * 2 * M_PI * rand()/RAND_MAX);
+      } else {
+        ce[i][j] = 1;
+      }
+    }
+    sf_symbols[i] = srslte_vec_malloc(sizeof(cf_t)*SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp));
+    if (!sf_symbols[i]) {
+      perror("srslte_vec_malloc");
+      goto quit;
+    }
+    bzero(sf_symbols[i], sizeof(cf_t)*SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp));
+  }
+
+  data_tx = srslte_vec_malloc(sizeof(uint8_t) * grant.mcs.tbs/8);
+  // The decoder writes whole code blocks, including the TB CRC, so leave room for one more.
+  data_rx = srslte_vec_malloc(sizeof(uint8_t) * grant.mcs.tbs/8 + SRSLTE_TCOD_MAX_LEN_CB_BYTES);
+  llr_ref = srslte_vec_malloc(sizeof(int16_t) * pdsch_cfg.nbits.nof_bits);
+  if (!data_tx || !data_rx || !llr_ref) {
+    perror("srslte_vec_malloc");
+    goto quit;
+  }
+
+  if (srslte_pdsch_init_generic(&pdsch, cell, 0, true)) {
+    fprintf(stderr, "Error creating PDSCH object\n");
+    goto quit;
+  }
+  srslte_pdsch_set_rnti(&pdsch, rnti);
+  srslte_sch_set_max_noi(&pdsch.dl_sch, 10);
+
+  if (srslte_softbuffer_tx_init_scatter(&softbuffer_tx, cell.nof_prb)) {
+    fprintf(stderr, "Error initiating TX soft buffer\n");
+    goto quit;
+  }
+  if (srslte_softbuffer_rx_init_scatter(&softbuffer_rx, cell.nof_prb)) {
+    fprintf(stderr, "Error initiating RX soft buffer\n");
+    goto quit;
+  }
+
+  // Constellations are normalized to unit power, so the noise variance is given by the SNR.
+  float noise_variance = powf(10.0f, -snr_db/10.0f);
+  uint32_t nof_tb_errors = 0;
+  uint64_t nof_bit_errors = 0;
+  uint32_t nof_llr_mismatches = 0;
+  uint32_t nof_tx = 0;
+
+  printf("Mod %s, MCS %d, TBS %d bits, %d PRB, SNR %1.1f dB, %d TBs\n", srslte_mod_string(grant.mcs.mod), mcs,
+         grant.mcs.tbs, cell.nof_prb, snr_db, nof_tbs);
+
+  for (uint32_t n=0;n<nof_tbs;n++) {
+    for (i=0;i<grant.mcs.tbs/8;i++) {
+      data_tx[i] = rand()%256;
+    }
+    int decode_ret = SRSLTE_ERROR;
+    for (uint32_t k=0;k<max_tx && decode_ret;k++) {
+      nof_tx++;
+      pdsch_cfg.rv = srslte_ra_rvidx_scatter(k);
+      srslte_softbuffer_tx_reset(&softbuffer_tx);
+      if (srslte_pdsch_encode_scatter(&pdsch, &pdsch_cfg, &softbuffer_tx, data_tx, sf_symbols)) {
+        fprintf(stderr, "Error encoding PDSCH\n");
+        goto quit;
+      }
+      if (check_fused_rx) {
+        srslte_vec_prod_ccc(sf_symbols[0], ce[0], sf_symbols[0], SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp));
+      }
+      srslte_ch_awgn_c(sf_symbols[0], sf_symbols[0], sqrtf(noise_variance/2), SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp));
+
+      // The reference decoding resets the soft buffer, so it is only done for the first transmission.
+      if (check_fused_rx && k == 0) {
+        srslte_pdsch_set_fused_rx(&pdsch, false);
+        srslte_softbuffer_rx_reset_tbs(&softbuffer_rx, grant.mcs.tbs);
+        srslte_pdsch_decode_rnti_scatter(&pdsch, &pdsch_cfg, &softbuffer_rx, sf_symbols[0], ce, noise_variance, rnti, data_rx);
+        memcpy(llr_ref, pdsch.e, sizeof(int16_t) * pdsch_cfg.nbits.nof_bits);
+        srslte_pdsch_set_fused_rx(&pdsch, true);
+      }
+
+      // Retransmissions are combined with the soft bits of the previous transmissions.
+      if (k == 0) {
+        srslte_softbuffer_rx_reset_tbs(&softbuffer_rx, grant.mcs.tbs);
+      }
+      decode_ret = srslte_pdsch_decode_rnti_scatter(&pdsch, &pdsch_cfg, &softbuffer_rx, sf_symbols[0], ce, noise_variance, rnti, data_rx);
+      if (check_fused_rx && k == 0 && memcmp(llr_ref, pdsch.e, sizeof(int16_t) * pdsch_cfg.nbits.nof_bits)) {
+        nof_llr_mismatches++;
+      }
+    }
+    if (decode_ret) {
+      nof_tb_errors++;
+    }
+    for (i=0;i<grant.mcs.tbs/8;i++) {
+      nof_bit_errors += __builtin_popcount(data_tx[i] ^ data_rx[i]);
+    }
+  }
+
+  float bler = (float) nof_tb_errors/nof_tbs;
+  printf("BLER: %1.4f (%d/%d), BER: %1.2e\n", bler, nof_tb_errors, nof_tbs,
+         (double) nof_bit_errors/((double) nof_tbs*grant.mcs.tbs));
+
+  if (max_tx > 1) {
+    printf("Average number of transmissions per TB: %1.2f\n", (float) nof_tx/nof_tbs);
+  }
+
+  if (check_fused_rx) {
+    printf("Fused receiver LLR mismatches: %d/%d TBs\n", nof_llr_mismatches, nof_tbs);
+  }
+
+  ret = (bler <= max_bler && nof_llr_mismatches == 0) ? 0 : -1;
+quit:
+  srslte_pdsch_free(&pdsch);
+  srslte_softbuffer_tx_free(&softbuffer_tx);
+  srslte_softbuffer_rx_free(&softbuffer_rx);
+
+  for (i=0;i<cell.nof_ports;i++) {
+    if (ce[i]) {
+      free(ce[i]);
+    }
+    if (sf_symbols[i]) {
+      free(sf_symbols[i]);
+    }
+  }
+  if (data_tx) {
+    free(data_tx);
+  }
+  if (data_rx) {
+    free(data_rx);
+  }
+  if (llr_ref) {
+    free(llr_ref);
+  }
+  if (ret) {
+    printf("Error\n");
+  } else {
+    printf("Ok\n");
+  }
+  exit(ret);
+}
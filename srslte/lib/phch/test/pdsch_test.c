@@ -52,9 +52,10 @@ uint32_t subframe = 1;
 uint32_t rv_idx = 0;
 uint16_t rnti = 1234; 
 char *input_file = NULL; 
+uint32_t nof_encode_workers = 0;
 
 void usage(char *prog) {
-  printf("Usage: %s [fmcsrRFpnv] \n", prog);
+  printf("Usage: %s [fmcsrRFpnwv] \n", prog);
   printf("\t-f read signal from file [Default generate it with pdsch_encode()]\n");
   printf("\t-m MCS [Default %d]\n", mcs);
   printf("\t-c cell id [Default %d]\n", cell.id);
@@ -64,12 +65,13 @@ void usage(char *prog) {
   printf("\t-F cfi [Default %d]\n", cfi);
   printf("\t-p cell.nof_ports [Default %d]\n", cell.nof_ports);
   printf("\t-n cell.nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-w encode code blocks in parallel with this number of workers [Default %d]\n", nof_encode_workers);
   printf("\t-v [set srslte_verbose to debug, default none]\n");
 }
 
 void parse_args(int argc, char **argv) {
   int opt;
-  while ((opt = getopt(argc, argv, "fmcsrRFpnv")) != -1) {
+  while ((opt = getopt(argc, argv, "fmcsrRFpnwv")) != -1) {
     switch(opt) {
     case 'f':
       input_file = argv[optind];
@@ -98,6 +100,9 @@ void parse_args(int argc, char **argv) {
     case 'c':
       cell.id = atoi(argv[optind]);
       break;
+    case 'w':
+      nof_encode_workers = atoi(argv[optind]);
+      break;
     case 'v':
       srslte_verbose++;
       break;
@@ -171,7 +176,8 @@ int main(int argc, char **argv) {
     }
   }
   
-  data = srslte_vec_malloc(sizeof(uint8_t) * grant.mcs.tbs/8);
+  // The decoder also writes the transport block CRC after the data.
+  data = srslte_vec_malloc(sizeof(uint8_t) * grant.mcs.tbs/8 + SRSLTE_TCOD_MAX_LEN_CB_BYTES);
   if (!data) {
     perror("srslte_vec_malloc");
     goto quit;
@@ -183,6 +189,11 @@ int main(int argc, char **argv) {
   }
   
   srslte_pdsch_set_rnti(&pdsch, rnti);
+
+  if (srslte_sch_set_encode_workers(&pdsch.dl_sch, nof_encode_workers)) {
+    fprintf(stderr, "Error setting encode workers\n");
+    goto quit;
+  }
   
   if (srslte_softbuffer_rx_init(&softbuffer_rx, cell.nof_prb)) {
     fprintf(stderr, "Error initiating RX soft buffer\n");
@@ -0,0 +1,314 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <complex.h>
+#include <math.h>
+
+#include "srslte/resampling/channelizer.h"
+#include "srslte/utils/vector.h"
+#include "srslte/utils/debug.h"
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+#endif /* LV_HAVE_AVX2 */
+
+#define CHANNELIZER_KAISER_BETA 7.0 // About 70 dB of stopband attenuation
+
+/* Zeroth order modified Bessel function of the first kind */
+static double channelizer_bessel_i0(double x) {
+  double sum = 1.0, term = 1.0;
+  for (uint32_t k = 1; k < 32; k++) {
+    term *= (x/(2.0*k))*(x/(2.0*k));
+    sum += term;
+  }
+  return sum;
+}
+
+/* Kaiser windowed sinc with the cut-off at half the channel spacing and unitary DC gain */
+static void channelizer_design_prototype(float *h, uint32_t nof_channels, uint32_t len) {
+  double sum = 0.0;
+  double center = (len - 1)/2.0;
+  for (uint32_t l = 0; l < len; l++) {
+    double t = (l - center)/nof_channels;
+    double sinc = (t == 0.0) ? 1.0 : sin(M_PI*t)/(M_PI*t);
+    double r = 2.0*(l - center)/(len - 1);
+    double w = channelizer_bessel_i0(CHANNELIZER_KAISER_BETA*sqrt(1.0 - r*r))/channelizer_bessel_i0(CHANNELIZER_KAISER_BETA);
+    h[l] = (float)(sinc*w);
+    sum += h[l];
+  }
+  for (uint32_t l = 0; l < len; l++) {
+    h[l] /= sum;
+  }
+}
+
+/* Duplicates every tap so that it multiplies the real and imaginary parts of a sample with a single product. */
+static void channelizer_set_taps(float *taps, const float *h, uint32_t len, float scale) {
+  for (uint32_t l = 0; l < len; l++) {
+    taps[2*l] = scale*h[l];
+    taps[2*l + 1] = scale*h[l];
+  }
+}
+
+/* Plans the batched IFFT over max_nof_blocks blocks of nof_channels samples and the IFFT of a single block. */
+static int channelizer_plan_ifft(srslte_dft_plan_t *fft, srslte_dft_plan_t *fft_block, uint32_t nof_channels,
+                                 uint32_t max_nof_blocks) {
+  srslte_dft_batch_t batch;
+  bzero(&batch, sizeof(srslte_dft_batch_t));
+  batch.howmany = max_nof_blocks;
+  batch.nof_blocks = 1;
+  batch.in_dist = nof_channels;
+  batch.in_len = nof_channels*max_nof_blocks;
+  batch.out_dist = nof_channels;
+  batch.out_len = nof_channels*max_nof_blocks;
+  if (srslte_dft_plan_batch_c(fft, nof_channels, &batch, SRSLTE_DFT_BACKWARD)) {
+    return SRSLTE_ERROR;
+  }
+  batch.howmany = 1;
+  batch.in_len = nof_channels;
+  batch.out_len = nof_channels;
+  if (srslte_dft_plan_batch_c(fft_block, nof_channels, &batch, SRSLTE_DFT_BACKWARD)) {
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+/* Runs the IFFT of the first nof_blocks blocks of in into out. The batched plan transforms all max_nof_blocks blocks,
+ * so it is only used when the call fills them all. */
+static void channelizer_run_ifft(srslte_dft_plan_t *fft, srslte_dft_plan_t *fft_block, uint32_t nof_channels,
+                                 uint32_t max_nof_blocks, cf_t *in, cf_t *out, uint32_t nof_blocks) {
+  if (nof_blocks == max_nof_blocks) {
+    srslte_dft_run_batch_c(fft, in, out);
+  } else {
+    for (uint32_t n = 0; n < nof_blocks; n++) {
+      srslte_dft_run_batch_c(fft_block, &in[n*nof_channels], &out[n*nof_channels]);
+    }
+  }
+}
+
+int srslte_channelizer_init(srslte_channelizer_t *q, uint32_t nof_channels, uint32_t nof_taps, uint32_t max_nof_samples) {
+  if (q == NULL || nof_channels < 2 || nof_taps == 0 || max_nof_samples < nof_channels) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  bzero(q, sizeof(srslte_channelizer_t));
+  q->nof_channels = nof_channels;
+  q->nof_taps = nof_taps;
+  q->max_nof_blocks = max_nof_samples/nof_channels;
+
+  uint32_t len = nof_channels*nof_taps;
+  float *h = srslte_vec_malloc(sizeof(float)*len);
+  q->taps = srslte_vec_malloc(sizeof(float)*2*len);
+  q->branches = srslte_vec_malloc(sizeof(cf_t)*nof_channels*(nof_taps - 1 + q->max_nof_blocks));
+  if (!h || !q->taps || !q->branches) {
+    perror("malloc");
+    if (h) {
+      free(h);
+    }
+    srslte_channelizer_free(q);
+    return SRSLTE_ERROR;
+  }
+  channelizer_design_prototype(h, nof_channels, len);
+  channelizer_set_taps(q->taps, h, len, 1.0);
+  free(h);
+
+  // One IFFT per block, all of them planned together.
+  if (channelizer_plan_ifft(&q->fft, &q->fft_block, nof_channels, q->max_nof_blocks)) {
+    fprintf(stderr, "Error creating channelizer IFFT plan\n");
+    srslte_channelizer_free(q);
+    return SRSLTE_ERROR;
+  }
+  srslte_channelizer_reset(q);
+  return SRSLTE_SUCCESS;
+}
+
+void srslte_channelizer_free(srslte_channelizer_t *q) {
+  if (q->taps) {
+    free(q->taps);
+  }
+  if (q->branches) {
+    free(q->branches);
+  }
+  if (q->fft.p) {
+    srslte_dft_plan_free(&q->fft);
+  }
+  if (q->fft_block.p) {
+    srslte_dft_plan_free(&q->fft_block);
+  }
+  bzero(q, sizeof(srslte_channelizer_t));
+}
+
+void srslte_channelizer_reset(srslte_channelizer_t *q) {
+  bzero(q->branches, sizeof(cf_t)*q->nof_channels*(q->nof_taps - 1));
+}
+
+/* Filters the branches of one block: out[m] is the sum over p of h[p*M+m] times the sample of branch m p blocks ago.
+ * row points to the branches of the block, the older ones are the previous rows. */
+static void channelizer_filter_block(const float *taps, uint32_t M, uint32_t nof_taps, const cf_t *row, cf_t *out) {
+  uint32_t m = 0;
+#ifdef LV_HAVE_AVX2
+  for (; m + 4 <= M; m += 4) {
+    __m256 acc = _mm256_setzero_ps();
+    for (uint32_t p = 0; p < nof_taps; p++) {
+      __m256 h = _mm256_loadu_ps(&taps[2*(p*M + m)]);
+      __m256 x = _mm256_loadu_ps((const float*)&(row - p*M)[m]);
+#ifdef LV_HAVE_FMA
+      acc = _mm256_fmadd_ps(h, x, acc);
+#else
+      acc = _mm256_add_ps(acc, _mm256_mul_ps(h, x));
+#endif /* LV_HAVE_FMA */
+    }
+    _mm256_storeu_ps((float*)&out[m], acc);
+  }
+#endif /* LV_HAVE_AVX2 */
+  for (; m < M; m++) {
+    cf_t acc = 0;
+    for (uint32_t p = 0; p < nof_taps; p++) {
+      acc += taps[2*(p*M + m)]*(row - p*M)[m];
+    }
+    out[m] = acc;
+  }
+}
+
+int srslte_channelizer_execute(srslte_channelizer_t *q, const cf_t *input, cf_t **output, uint32_t nof_samples) {
+  uint32_t M = q->nof_channels;
+  if (nof_samples % M || nof_samples/M > q->max_nof_blocks) {
+    fprintf(stderr, "Channelizer input of %d samples must be a multiple of %d and at most %d\n", nof_samples, M,
+            M*q->max_nof_blocks);
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  uint32_t nof_blocks = nof_samples/M;
+  cf_t *new_rows = &q->branches[M*(q->nof_taps - 1)];
+  cf_t *filtered = (cf_t*)q->fft.in;
+
+  // Commutate the input: branch m of a block takes its (M-1-m)-th sample.
+  for (uint32_t n = 0; n < nof_blocks; n++) {
+    for (uint32_t m = 0; m < M; m++) {
+      new_rows[n*M + m] = input[n*M + M - 1 - m];
+    }
+  }
+  for (uint32_t n = 0; n < nof_blocks; n++) {
+    channelizer_filter_block(q->taps, M, q->nof_taps, &new_rows[n*M], &filtered[n*M]);
+  }
+  // The IFFT of the filtered branches of a block gives one sample of every channel.
+  channelizer_run_ifft(&q->fft, &q->fft_block, M, q->max_nof_blocks, filtered, (cf_t*)q->fft.out, nof_blocks);
+  cf_t *channels = (cf_t*)q->fft.out;
+  for (uint32_t n = 0; n < nof_blocks; n++) {
+    for (uint32_t k = 0; k < M; k++) {
+      output[k][n] = channels[n*M + k];
+    }
+  }
+  // Keep the last blocks as history of the next call.
+  memmove(q->branches, &q->branches[M*nof_blocks], sizeof(cf_t)*M*(q->nof_taps - 1));
+  return nof_blocks;
+}
+
+int srslte_synthesizer_init(srslte_synthesizer_t *q, uint32_t nof_channels, uint32_t nof_taps, uint32_t max_nof_samples) {
+  if (q == NULL || nof_channels < 2 || nof_taps == 0 || max_nof_samples < nof_channels) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  bzero(q, sizeof(srslte_synthesizer_t));
+  q->nof_channels = nof_channels;
+  q->nof_taps = nof_taps;
+  q->max_nof_blocks = max_nof_samples/nof_channels;
+
+  uint32_t len = nof_channels*nof_taps;
+  float *h = srslte_vec_malloc(sizeof(float)*len);
+  q->taps = srslte_vec_malloc(sizeof(float)*2*len);
+  q->branches = srslte_vec_malloc(sizeof(cf_t)*nof_channels*(nof_taps - 1 + q->max_nof_blocks));
+  if (!h || !q->taps || !q->branches) {
+    perror("malloc");
+    if (h) {
+      free(h);
+    }
+    srslte_synthesizer_free(q);
+    return SRSLTE_ERROR;
+  }
+  channelizer_design_prototype(h, nof_channels, len);
+  // Interpolating by nof_channels divides the amplitude by nof_channels, the taps make up for it.
+  channelizer_set_taps(q->taps, h, len, (float)nof_channels);
+  free(h);
+
+  if (channelizer_plan_ifft(&q->fft, &q->fft_block, nof_channels, q->max_nof_blocks)) {
+    fprintf(stderr, "Error creating synthesizer IFFT plan\n");
+    srslte_synthesizer_free(q);
+    return SRSLTE_ERROR;
+  }
+  srslte_synthesizer_reset(q);
+  return SRSLTE_SUCCESS;
+}
+
+void srslte_synthesizer_free(srslte_synthesizer_t *q) {
+  if (q->taps) {
+    free(q->taps);
+  }
+  if (q->branches) {
+    free(q->branches);
+  }
+  if (q->fft.p) {
+    srslte_dft_plan_free(&q->fft);
+  }
+  if (q->fft_block.p) {
+    srslte_dft_plan_free(&q->fft_block);
+  }
+  bzero(q, sizeof(srslte_synthesizer_t));
+}
+
+void srslte_synthesizer_reset(srslte_synthesizer_t *q) {
+  bzero(q->branches, sizeof(cf_t)*q->nof_channels*(q->nof_taps - 1));
+}
+
+int srslte_synthesizer_execute(srslte_synthesizer_t *q, cf_t **input, cf_t *output, uint32_t nof_samples) {
+  uint32_t M = q->nof_channels;
+  if (nof_samples > q->max_nof_blocks) {
+    fprintf(stderr, "Synthesizer input of %d samples per channel must be at most %d\n", nof_samples, q->max_nof_blocks);
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  cf_t *new_rows = &q->branches[M*(q->nof_taps - 1)];
+  cf_t *blocks = (cf_t*)q->fft.in;
+
+  // A block holds one sample of every channel.
+  for (uint32_t k = 0; k < M; k++) {
+    if (input[k]) {
+      for (uint32_t n = 0; n < nof_samples; n++) {
+        blocks[n*M + k] = input[k][n];
+      }
+    } else {
+      for (uint32_t n = 0; n < nof_samples; n++) {
+        blocks[n*M + k] = 0;
+      }
+    }
+  }
+  // The IFFT of a block gives the branches, filtered to M consecutive wideband samples.
+  channelizer_run_ifft(&q->fft, &q->fft_block, M, q->max_nof_blocks, blocks, new_rows, nof_samples);
+  for (uint32_t n = 0; n < nof_samples; n++) {
+    channelizer_filter_block(q->taps, M, q->nof_taps, &new_rows[n*M], &output[n*M]);
+  }
+  // Keep the last blocks as history of the next call.
+  memmove(q->branches, &q->branches[M*nof_samples], sizeof(cf_t)*M*(q->nof_taps - 1));
+  return M*nof_samples;
+}
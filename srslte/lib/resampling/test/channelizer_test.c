@@ -0,0 +1,173 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <unistd.h>
+#include <math.h>
+#include <complex.h>
+
+#include "srslte/srslte.h"
+#include "srslte/resampling/channelizer.h"
+
+uint32_t nof_channels = 4;
+uint32_t nof_taps = SRSLTE_CHANNELIZER_DEFAULT_TAPS;
+uint32_t nof_samples_per_channel = 1920;
+float max_leakage_db = -50.0;
+
+void usage(char *prog) {
+  printf("Usage: %s [mtnl]\n", prog);
+  printf("\t-m number of channels [Default %d]\n", nof_channels);
+  printf("\t-t taps per branch [Default %d]\n", nof_taps);
+  printf("\t-n samples per channel [Default %d]\n", nof_samples_per_channel);
+  printf("\t-l maximum leakage into the other channels in dB [Default %1.1f]\n", max_leakage_db);
+}
+
+void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "mtnl")) != -1) {
+    switch (opt) {
+    case 'm':
+      nof_channels = atoi(argv[optind]);
+      break;
+    case 't':
+      nof_taps = atoi(argv[optind]);
+      break;
+    case 'n':
+      nof_samples_per_channel = atoi(argv[optind]);
+      break;
+    case 'l':
+      max_leakage_db = atof(argv[optind]);
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  uint32_t nof_samples = nof_channels*nof_samples_per_channel;
+  // The input is channelized in two calls, so that the history kept between calls is tested as well.
+  uint32_t half = nof_channels*(nof_samples_per_channel/2);
+  // Skip the filter transient.
+  uint32_t skip = 2*nof_taps;
+
+  cf_t *input = srslte_vec_malloc(sizeof(cf_t)*nof_samples);
+  cf_t *output[nof_channels];
+  cf_t *output_second_half[nof_channels];
+  cf_t *output_full[nof_channels];
+  if (!input) {
+    perror("malloc");
+    exit(-1);
+  }
+  for (uint32_t k = 0; k < nof_channels; k++) {
+    output[k] = srslte_vec_malloc(sizeof(cf_t)*nof_samples_per_channel);
+    if (!output[k]) {
+      perror("malloc");
+      exit(-1);
+    }
+    output_second_half[k] = &output[k][half/nof_channels];
+    output_full[k] = srslte_vec_malloc(sizeof(cf_t)*nof_samples_per_channel);
+    if (!output_full[k]) {
+      perror("malloc");
+      exit(-1);
+    }
+  }
+
+  srslte_channelizer_t channelizer;
+  if (srslte_channelizer_init(&channelizer, nof_channels, nof_taps, nof_samples)) {
+    fprintf(stderr, "Error initializing channelizer\n");
+    exit(-1);
+  }
+
+  int ret = 0;
+  for (uint32_t c = 0; c < nof_channels && !ret; c++) {
+    // Tone inside channel c, offset by a fifth of the channel spacing.
+    float offset = ((c % 2) ? 0.2 : -0.2)/nof_channels;
+    float freq = (float)c/nof_channels + offset;
+    for (uint32_t i = 0; i < nof_samples; i++) {
+      input[i] = cexpf(_Complex_I*2*M_PI*freq*i);
+    }
+
+    srslte_channelizer_reset(&channelizer);
+    srslte_channelizer_execute(&channelizer, input, output, half);
+    srslte_channelizer_execute(&channelizer, &input[half], output_second_half, nof_samples - half);
+
+    // A call with all the blocks runs the batched IFFT, the calls above run one IFFT per block, both must match.
+    srslte_channelizer_reset(&channelizer);
+    srslte_channelizer_execute(&channelizer, input, output_full, nof_samples);
+    for (uint32_t k = 0; k < nof_channels; k++) {
+      for (uint32_t n = 0; n < nof_samples_per_channel; n++) {
+        if (cabsf(output_full[k][n] - output[k][n]) > 1e-4) {
+          printf("Channel %d sample %d differs between one call and two calls\n", k, n);
+          ret = -1;
+          break;
+        }
+      }
+    }
+
+    for (uint32_t k = 0; k < nof_channels; k++) {
+      float power = srslte_vec_avg_power_cf(&output[k][skip], nof_samples_per_channel - skip);
+      float power_db = 10*log10f(power + 1e-20);
+      printf("Tone in channel %d - Power in channel %d: %+6.1f dB\n", c, k, power_db);
+      if (k == c && fabsf(power_db) > 0.5) {
+        printf("Wrong gain in channel %d\n", k);
+        ret = -1;
+      }
+      if (k != c && power_db > max_leakage_db) {
+        printf("Leakage into channel %d is too high\n", k);
+        ret = -1;
+      }
+    }
+    // The tone must come out of its channel at the offset frequency and with constant amplitude.
+    float max_phase_error = 0;
+    for (uint32_t n = skip + 1; n < nof_samples_per_channel; n++) {
+      float phase = cargf(output[c][n]*conjf(output[c][n - 1]));
+      max_phase_error = fmaxf(max_phase_error, fabsf(phase - 2*M_PI*offset*nof_channels));
+    }
+    if (max_phase_error > 1e-2) {
+      printf("Wrong output frequency in channel %d, phase error: %f\n", c, max_phase_error);
+      ret = -1;
+    }
+  }
+
+  srslte_channelizer_free(&channelizer);
+  for (uint32_t k = 0; k < nof_channels; k++) {
+    free(output[k]);
+    free(output_full[k]);
+  }
+  free(input);
+
+  if (ret) {
+    exit(-1);
+  }
+  printf("Ok\n");
+  exit(0);
+}
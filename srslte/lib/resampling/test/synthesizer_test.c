@@ -0,0 +1,176 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <unistd.h>
+#include <math.h>
+#include <complex.h>
+
+#include "srslte/srslte.h"
+#include "srslte/resampling/channelizer.h"
+
+uint32_t nof_channels = 4;
+uint32_t nof_taps = SRSLTE_CHANNELIZER_DEFAULT_TAPS;
+uint32_t nof_samples_per_channel = 1920;
+float max_spurious_db = -50.0;
+
+void usage(char *prog) {
+  printf("Usage: %s [mtnl]\n", prog);
+  printf("\t-m number of channels [Default %d]\n", nof_channels);
+  printf("\t-t taps per branch [Default %d]\n", nof_taps);
+  printf("\t-n samples per channel [Default %d]\n", nof_samples_per_channel);
+  printf("\t-l maximum power of images and spurious relative to the tone in dB [Default %1.1f]\n", max_spurious_db);
+}
+
+void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "mtnl")) != -1) {
+    switch (opt) {
+    case 'm':
+      nof_channels = atoi(argv[optind]);
+      break;
+    case 't':
+      nof_taps = atoi(argv[optind]);
+      break;
+    case 'n':
+      nof_samples_per_channel = atoi(argv[optind]);
+      break;
+    case 'l':
+      max_spurious_db = atof(argv[optind]);
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  uint32_t nof_samples = nof_channels*nof_samples_per_channel;
+  // The input is synthesized in two calls, so that the history kept between calls is tested as well.
+  uint32_t half = nof_samples_per_channel/2;
+  // Skip the filter transient.
+  uint32_t skip = 2*nof_taps*nof_channels;
+
+  cf_t *tone = srslte_vec_malloc(sizeof(cf_t)*nof_samples_per_channel);
+  cf_t *output = srslte_vec_malloc(sizeof(cf_t)*nof_samples);
+  cf_t *input[nof_channels];
+  cf_t *input_second_half[nof_channels];
+  if (!tone || !output) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  srslte_synthesizer_t synthesizer;
+  if (srslte_synthesizer_init(&synthesizer, nof_channels, nof_taps, nof_samples)) {
+    fprintf(stderr, "Error initializing synthesizer\n");
+    exit(-1);
+  }
+
+  int ret = 0;
+  for (uint32_t c = 0; c < nof_channels && !ret; c++) {
+    // Tone in channel c, offset by a fifth of the channel spacing. The other channels are idle.
+    float offset = (c % 2) ? 0.2 : -0.2;
+    for (uint32_t n = 0; n < nof_samples_per_channel; n++) {
+      tone[n] = cexpf(_Complex_I*2*M_PI*offset*n);
+    }
+    for (uint32_t k = 0; k < nof_channels; k++) {
+      input[k] = (k == c) ? tone : NULL;
+      input_second_half[k] = (k == c) ? &tone[half] : NULL;
+    }
+
+    srslte_synthesizer_reset(&synthesizer);
+    srslte_synthesizer_execute(&synthesizer, input, output, half);
+    srslte_synthesizer_execute(&synthesizer, input_second_half, &output[nof_channels*half], nof_samples_per_channel - half);
+
+    // The tone must come out at the center of channel c plus the offset, everything else is images and spurious.
+    double freq = (c + offset)/nof_channels;
+    cf_t amplitude = 0;
+    for (uint32_t i = skip; i < nof_samples; i++) {
+      amplitude += output[i]*cexp(-_Complex_I*2*M_PI*freq*i);
+    }
+    amplitude /= (nof_samples - skip);
+    float residual = 0;
+    for (uint32_t i = skip; i < nof_samples; i++) {
+      cf_t e = output[i] - amplitude*cexp(_Complex_I*2*M_PI*freq*i);
+      residual += crealf(e)*crealf(e) + cimagf(e)*cimagf(e);
+    }
+    residual /= (nof_samples - skip);
+    float gain_db = 20*log10f(cabsf(amplitude) + 1e-20);
+    float spurious_db = 10*log10f(residual + 1e-20) - gain_db;
+    printf("Tone in channel %d - Gain: %+6.2f dB - Spurious: %+6.1f dB\n", c, gain_db, spurious_db);
+    if (fabsf(gain_db) > 0.5) {
+      printf("Wrong gain in channel %d\n", c);
+      ret = -1;
+    }
+    if (spurious_db > max_spurious_db) {
+      printf("Spurious of channel %d are too high\n", c);
+      ret = -1;
+    }
+  }
+
+  // An impulse on the last sample of the first call must come out after the delay of the prototype filter.
+  float delay = ((float)nof_channels*nof_taps - 1)/2;
+  bzero(tone, sizeof(cf_t)*nof_samples_per_channel);
+  tone[half - 1] = 1.0;
+  for (uint32_t c = 0; c < nof_channels && !ret; c++) {
+    for (uint32_t k = 0; k < nof_channels; k++) {
+      input[k] = (k == c) ? tone : NULL;
+      input_second_half[k] = (k == c) ? &tone[half] : NULL;
+    }
+
+    srslte_synthesizer_reset(&synthesizer);
+    srslte_synthesizer_execute(&synthesizer, input, output, half);
+    srslte_synthesizer_execute(&synthesizer, input_second_half, &output[nof_channels*half], nof_samples_per_channel - half);
+
+    uint32_t peak = 0;
+    for (uint32_t i = 0; i < nof_samples; i++) {
+      if (cabsf(output[i]) > cabsf(output[peak])) {
+        peak = i;
+      }
+    }
+    float peak_delay = (float)peak - nof_channels*(half - 1);
+    printf("Impulse in channel %d - Delay: %1.1f samples\n", c, peak_delay);
+    if (fabsf(peak_delay - delay) > 0.5) {
+      printf("Wrong delay in channel %d, expected %1.1f samples\n", c, delay);
+      ret = -1;
+    }
+  }
+
+  srslte_synthesizer_free(&synthesizer);
+  free(output);
+  free(tone);
+
+  if (ret) {
+    exit(-1);
+  }
+  printf("Ok\n");
+  exit(0);
+}
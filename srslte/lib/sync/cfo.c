@@ -33,6 +33,14 @@
 #include "srslte/utils/vector.h"
 #include "srslte/utils/debug.h"
 
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+#define PROD_AVX(a,b) _mm256_addsub_ps(_mm256_mul_ps(a,_mm256_moveldup_ps(b)),_mm256_mul_ps(_mm256_shuffle_ps(a,a,0xB1),_mm256_movehdup_ps(b)))
+
+#define CFO_ROTATOR_REGS 4
+#endif
+
 int srslte_cfo_init(srslte_cfo_t *h, uint32_t nsamples) {
   int ret = SRSLTE_ERROR;
   bzero(h, sizeof(srslte_cfo_t));
@@ -91,6 +99,66 @@ void srslte_cfo_correct(srslte_cfo_t *h, cf_t *input, cf_t *output, float freq)
   srslte_vec_prod_ccc(h->cur_cexp, input, output, h->nsamples);
 }
 
+static cf_t cfo_phasor(double cycles) {
+  double phase = 2*M_PI*(cycles - floor(cycles));
+  return (float) cos(phase) + _Complex_I*(float) sin(phase);
+}
+
+float srslte_cfo_correct_rotator(cf_t *input, cf_t *output, float freq, float phase, uint32_t nsamples) {
+  uint32_t i = 0;
+  cf_t rot = cfo_phasor(phase);
+  cf_t step = cfo_phasor(freq);
+
+#ifdef LV_HAVE_AVX2
+  // CFO_ROTATOR_REGS registers of four consecutive samples each, so that their rotations do not wait for each other,
+  // all of them rotated by 4*CFO_ROTATOR_REGS times the frequency at each step. Each register is the rotation of the
+  // first sample (anchor) times the fixed offsets of its four samples.
+  cf_t offsets[4*CFO_ROTATOR_REGS], step_regs = cfo_phasor(4.0*CFO_ROTATOR_REGS*freq);
+  __m256 offsets_avx[CFO_ROTATOR_REGS], rot_avx[CFO_ROTATOR_REGS];
+  for(uint32_t k = 0; k < 4*CFO_ROTATOR_REGS; k++) {
+    offsets[k] = cfo_phasor((double) freq*k);
+  }
+  __m256 anchor_avx = _mm256_castpd_ps(_mm256_broadcast_sd((const double*) &rot));
+  for(uint32_t r = 0; r < CFO_ROTATOR_REGS; r++) {
+    offsets_avx[r] = _mm256_loadu_ps((float*) &offsets[4*r]);
+    rot_avx[r] = PROD_AVX(offsets_avx[r], anchor_avx);
+  }
+  __m256 step_avx = _mm256_castpd_ps(_mm256_broadcast_sd((const double*) &step_regs));
+  uint32_t block = 0;
+  for(; i + 4*CFO_ROTATOR_REGS <= nsamples; i += 4*CFO_ROTATOR_REGS) {
+    for(uint32_t r = 0; r < CFO_ROTATOR_REGS; r++) {
+      _mm256_storeu_ps((float*) &output[i+4*r], PROD_AVX(_mm256_loadu_ps((float*) &input[i+4*r]), rot_avx[r]));
+      rot_avx[r] = PROD_AVX(rot_avx[r], step_avx);
+    }
+    block += 4*CFO_ROTATOR_REGS;
+    if(block == SRSLTE_CFO_ROTATOR_BLOCK) {
+      // Restart from the exact phase of the next sample, so the rounding of the recursive products does not accumulate.
+      rot = cfo_phasor((double) phase + (double) freq*(i + 4*CFO_ROTATOR_REGS));
+      anchor_avx = _mm256_castpd_ps(_mm256_broadcast_sd((const double*) &rot));
+      for(uint32_t r = 0; r < CFO_ROTATOR_REGS; r++) {
+        rot_avx[r] = PROD_AVX(offsets_avx[r], anchor_avx);
+      }
+      block = 0;
+    }
+  }
+  _mm256_storeu_ps((float*) offsets, rot_avx[0]);
+  rot = offsets[0];
+#endif
+
+  for(uint32_t block = 0; i < nsamples; i++) {
+    output[i] = input[i]*rot;
+    rot *= step;
+    if(++block == SRSLTE_CFO_ROTATOR_BLOCK) {
+      // Restart from the exact phase of the next sample, so the rounding of the recursive products does not accumulate.
+      rot = cfo_phasor((double) phase + (double) freq*(i + 1));
+      block = 0;
+    }
+  }
+
+  double next = (double) phase + (double) freq*nsamples;
+  return (float) (next - floor(next));
+}
+
 //******************************************************************************
 //********************************** DcF-TDMA **********************************
 //******************************************************************************
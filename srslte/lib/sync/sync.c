@@ -130,7 +130,7 @@ int srslte_sync_init_generic(srslte_sync_t *q, uint32_t frame_size, uint32_t max
     // Set a CFO tolerance of approx 50 Hz.
     srslte_cfo_set_tol(&q->cfocorr2, 50.0/(15000.0*q->fft_size));
 
-#if(USE_FINE_GRAINED_CFO==1)
+#if(USE_FINE_GRAINED_CFO==1 && USE_ROTATOR_CFO==0)
     // This is a more fine-grained CFO correction frequency generator.
     if(srslte_cfo_init_finer(&q->cfocorr_finer, q->frame_size)) {
       fprintf(stderr, "Error initiating finer CFO.\n");
@@ -203,7 +203,7 @@ void srslte_sync_free_except_reentry(srslte_sync_t *q) {
     srslte_sss_synch_free(&q->sss);
     srslte_cfo_free(&q->cfocorr);
     srslte_cfo_free(&q->cfocorr2);
-#if(USE_FINE_GRAINED_CFO==1)
+#if(USE_FINE_GRAINED_CFO==1 && USE_ROTATOR_CFO==0)
     srslte_cfo_free_finer(&q->cfocorr_finer);
 #endif
     srslte_cp_synch_free(&q->cp_synch);
@@ -227,7 +227,7 @@ void srslte_sync_free(srslte_sync_t *q) {
     srslte_sss_synch_free(&q->sss);
     srslte_cfo_free(&q->cfocorr);
     srslte_cfo_free(&q->cfocorr2);
-#if(USE_FINE_GRAINED_CFO==1)
+#if(USE_FINE_GRAINED_CFO==1 && USE_ROTATOR_CFO==0)
     srslte_cfo_free_finer(&q->cfocorr_finer);
 #endif
     srslte_cp_synch_free(&q->cp_synch);
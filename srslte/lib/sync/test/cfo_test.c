@@ -32,21 +32,28 @@
 #include <math.h>
 #include <time.h>
 #include <stdbool.h>
+#include <sys/time.h>
 
 #include "srslte/srslte.h"
 
 #define MAX_MSE  0.1
+#define MAX_ROTATOR_ERROR 1e-5
+
+/* The table corrector accumulates the table index in single precision, so its error grows with the number of samples
+ * and it is only checked up to one 1.4 MHz subframe. The rotator is checked for any number of samples. */
+#define MAX_TABLE_NSAMPLES 1920
 
 float freq = 0;
 int num_samples = 1000;
+int nof_repetitions = 0;
 
 void usage(char *prog) {
-  printf("Usage: %s -f freq -n num_samples\n", prog);
+  printf("Usage: %s -f freq -n num_samples [-b nof_repetitions]\n", prog);
 }
 
 void parse_args(int argc, char **argv) {
   int opt;
-  while ((opt = getopt(argc, argv, "nf")) != -1) {
+  while ((opt = getopt(argc, argv, "nfb")) != -1) {
     switch (opt) {
     case 'n':
       num_samples = atoi(argv[optind]);
@@ -54,6 +61,9 @@ void parse_args(int argc, char **argv) {
     case 'f':
       freq = atof(argv[optind]);
       break;
+    case 'b':
+      nof_repetitions = atoi(argv[optind]);
+      break;
     default:
       usage(argv[0]);
       exit(-1);
@@ -61,11 +71,48 @@ void parse_args(int argc, char **argv) {
   }
 }
 
+/* Times the table based and the phase rotator corrections. The frequency moves by more than the tolerance at every
+ * call, as it does when a new estimate is applied to each subframe, so the table based ones regenerate their table. */
+void benchmark(cf_t *input, cf_t *output) {
+  srslte_cfo_t table, finer;
+  struct timeval t[3];
+  float phase = 0;
+  int n;
+
+  if (srslte_cfo_init(&table, num_samples) || srslte_cfo_init_finer(&finer, num_samples)) {
+    fprintf(stderr, "Error initiating CFO\n");
+    exit(-1);
+  }
+  gettimeofday(&t[1], NULL);
+  for (n=0;n<nof_repetitions;n++) {
+    srslte_cfo_correct(&table, input, output, freq + (n%2)*1e-4);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  printf("Table:  %.2f us\n", (float) (t[0].tv_sec*1e6 + t[0].tv_usec)/nof_repetitions);
+  gettimeofday(&t[1], NULL);
+  for (n=0;n<nof_repetitions;n++) {
+    srslte_cfo_correct_finer(&finer, input, output, freq + (n%2)*1e-4);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  printf("Finer:  %.2f us\n", (float) (t[0].tv_sec*1e6 + t[0].tv_usec)/nof_repetitions);
+  gettimeofday(&t[1], NULL);
+  for (n=0;n<nof_repetitions;n++) {
+    phase = srslte_cfo_correct_rotator(input, output, freq + (n%2)*1e-4, phase, num_samples);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  printf("Rotator: %.2f us\n", (float) (t[0].tv_sec*1e6 + t[0].tv_usec)/nof_repetitions);
+  srslte_cfo_free(&table);
+  srslte_cfo_free_finer(&finer);
+}
+
 int main(int argc, char **argv) {
   int i;
   cf_t *input, *output;
   srslte_cfo_t cfocorr;
-  float mse;
+  float mse, err_rotator;
 
   if (argc < 5) {
     usage(argv[0]);
@@ -103,12 +150,40 @@ int main(int argc, char **argv) {
     mse += cabsf(input[i] - output[i]) / num_samples;
   }
 
+  /* The rotator is compared to the exact exponential, split in two calls to check the phase continuity. */
+  cf_t *exact = malloc(sizeof(cf_t) * num_samples);
+  cf_t *rotated = malloc(sizeof(cf_t) * num_samples);
+  if (!exact || !rotated) {
+    perror("malloc");
+    exit(-1);
+  }
+  for (i=0;i<num_samples;i++) {
+    input[i] = cexpf(I*2*M_PI*(float) rand()/RAND_MAX);
+  }
+  for (i=0;i<num_samples;i++) {
+    exact[i] = cexp(I*2*M_PI*fmod((double) freq*i, 1.0));
+  }
+  float phase = srslte_cfo_correct_rotator(input, rotated, freq, 0, num_samples/2);
+  srslte_cfo_correct_rotator(&input[num_samples/2], &rotated[num_samples/2], freq, phase, num_samples - num_samples/2);
+  err_rotator = 0;
+  for (i=0;i<num_samples;i++) {
+    err_rotator = fmaxf(err_rotator, cabsf(input[i]*exact[i] - rotated[i]));
+  }
+  printf("Rotator error: %e\n", err_rotator);
+
+  if (nof_repetitions > 0) {
+    benchmark(input, output);
+  }
+
   srslte_cfo_free(&cfocorr);
+  free(exact);
+  free(rotated);
   free(input);
   free(output);
 
-  printf("MSE: %f\n", mse);
-  if (mse > MAX_MSE) {
+  bool check_table = num_samples <= MAX_TABLE_NSAMPLES;
+  printf("MSE: %f%s\n", mse, check_table ? "" : " (not checked)");
+  if ((check_table && mse > MAX_MSE) || err_rotator > MAX_ROTATOR_ERROR) {
     printf("MSE too large\n");
     exit(-1);
   } else {
@@ -0,0 +1,266 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "srslte/srslte.h"
+
+// Several UE DL objects, each with its own RNTI and MCS, decoding subframes concurrently on separate threads, as the
+// PHYs do. Some subframes are sent without PDCCH so that they can only be decoded by reusing the last DCI found, which
+// has to be the one of the same object: a DCI shared between objects has the RNTI and MCS of another one.
+
+#define MAX_NOF_INSTANCES 8
+
+#define CFI 1
+
+srslte_cell_t cell = {
+  25,           // nof_prb
+  1,            // nof_ports
+  0,
+  0,            // cell_id
+  SRSLTE_CP_NORM,       // cyclic prefix
+  SRSLTE_PHICH_R_1_6,          // PHICH resources
+  SRSLTE_PHICH_NORM    // PHICH length
+};
+
+uint32_t nof_instances = 4;
+uint32_t nof_subframes = 100;
+uint32_t mcs = 10;
+uint32_t no_pdcch_period = 4;
+uint32_t last_dci_max_age = 1000;
+
+typedef struct {
+  uint32_t id;
+  uint16_t rnti;
+  uint32_t mcs;
+  uint32_t nof_decoded;
+  uint32_t nof_errors;
+} instance_t;
+
+void usage(char *prog) {
+  printf("Usage: %s [pNmnlv] \n", prog);
+  printf("\t-p number of concurrent UE DL objects [Default %d]\n", nof_instances);
+  printf("\t-N number of subframes per object [Default %d]\n", nof_subframes);
+  printf("\t-m MCS of the first object, the next ones use higher MCS [Default %d]\n", mcs);
+  printf("\t-n cell.nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-l one out of this number of subframes is sent without PDCCH, 0 to always send it [Default %d]\n", no_pdcch_period);
+  printf("\t-v [set srslte_verbose to debug, default none]\n");
+}
+
+void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "pNmnlv")) != -1) {
+    switch(opt) {
+    case 'p':
+      nof_instances = atoi(argv[optind]);
+      break;
+    case 'N':
+      nof_subframes = atoi(argv[optind]);
+      break;
+    case 'm':
+      mcs = atoi(argv[optind]);
+      break;
+    case 'n':
+      cell.nof_prb = atoi(argv[optind]);
+      break;
+    case 'l':
+      no_pdcch_period = atoi(argv[optind]);
+      break;
+    case 'v':
+      srslte_verbose++;
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+// Transmits nof_subframes TBs to its own UE DL object and checks the decoded data.
+void *instance_work(void *arg) {
+  instance_t *inst = (instance_t*) arg;
+  srslte_regs_t regs;
+  srslte_pcfich_t pcfich;
+  srslte_pdcch_t pdcch;
+  srslte_pdsch_t pdsch;
+  srslte_pdsch_cfg_t pdsch_cfg;
+  srslte_softbuffer_tx_t softbuffer_tx;
+  srslte_refsignal_cs_t csr_signal;
+  srslte_ofdm_t ifft;
+  srslte_ue_dl_t ue_dl;
+  srslte_ra_dl_dci_t ra_dl;
+  srslte_ra_dl_grant_t grant;
+  srslte_dci_msg_t dci_msg;
+  srslte_dci_location_t locations[SRSLTE_NSUBFRAMES_X_FRAME][30];
+  cf_t *sf_symbols[SRSLTE_MAX_PORTS];
+  uint32_t tbs;
+  cf_t *sf_buffer = srslte_vec_malloc(sizeof(cf_t)*SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp));
+  cf_t *output = srslte_vec_malloc(sizeof(cf_t)*SRSLTE_SF_LEN_PRB(cell.nof_prb));
+  uint8_t *data_tx, *data_rx;
+  unsigned int seed = inst->id;
+
+  bzero(&ra_dl, sizeof(srslte_ra_dl_dci_t));
+  ra_dl.mcs_idx = inst->mcs;
+  ra_dl.alloc_type = SRSLTE_RA_ALLOC_TYPE0;
+  ra_dl.type0_alloc.rbg_bitmask = 0xffffffff;
+  if (srslte_ra_dl_dci_to_grant(&ra_dl, cell.nof_prb, inst->rnti, &grant)) {
+    fprintf(stderr, "Error computing resource allocation\n");
+    exit(-1);
+  }
+  tbs = grant.mcs.tbs;
+  data_tx = srslte_vec_malloc(tbs/8);
+  // The decoder writes whole code blocks, including the TB CRC, so leave room for one more.
+  data_rx = srslte_vec_malloc(tbs/8 + SRSLTE_TCOD_MAX_LEN_CB_BYTES);
+  if (!sf_buffer || !output || !data_tx || !data_rx) {
+    perror("srslte_vec_malloc");
+    exit(-1);
+  }
+  for (uint32_t i = 0; i < SRSLTE_MAX_PORTS; i++) {
+    sf_symbols[i] = sf_buffer;
+  }
+
+  if (srslte_regs_init(&regs, cell) || srslte_regs_set_cfi(&regs, CFI) ||
+      srslte_pcfich_init(&pcfich, &regs, cell) ||
+      srslte_pdcch_init(&pdcch, &regs, cell) ||
+      srslte_pdsch_init_generic(&pdsch, cell, inst->id, false) ||
+      srslte_softbuffer_tx_init(&softbuffer_tx, cell.nof_prb) ||
+      srslte_refsignal_cs_init(&csr_signal, cell) ||
+      srslte_ofdm_tx_init(&ifft, cell.cp, cell.nof_prb)) {
+    fprintf(stderr, "Error initiating transmitter %d\n", inst->id);
+    exit(-1);
+  }
+  srslte_ofdm_set_normalize(&ifft, true);
+  srslte_pdsch_set_rnti(&pdsch, inst->rnti);
+  for (uint32_t i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
+    srslte_pdcch_ue_locations(&pdcch, locations[i], 30, i, CFI, inst->rnti);
+  }
+
+  if (srslte_ue_dl_init_generic(&ue_dl, cell, inst->id, false)) {
+    fprintf(stderr, "Error initiating UE DL %d\n", inst->id);
+    exit(-1);
+  }
+  srslte_ue_dl_set_rnti(&ue_dl, inst->rnti);
+  srslte_ue_dl_set_expected_cfi(&ue_dl, CFI);
+  srslte_ue_dl_set_last_dci_reuse(&ue_dl, true, last_dci_max_age);
+
+  for (uint32_t n = 0; n < nof_subframes; n++) {
+    uint32_t sf_idx = n%SRSLTE_NSUBFRAMES_X_FRAME;
+    bool send_pdcch = n == 0 || no_pdcch_period == 0 || n%no_pdcch_period != 0;
+
+    for (uint32_t i = 0; i < tbs/8; i++) {
+      data_tx[i] = (uint8_t) rand_r(&seed);
+    }
+    // Every subframe carries new data.
+    ra_dl.ndi = !ra_dl.ndi;
+
+    bzero(sf_buffer, sizeof(cf_t)*SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp));
+    srslte_refsignal_cs_put_sf(cell, 0, csr_signal.pilots[0][sf_idx], sf_buffer);
+    srslte_pcfich_encode(&pcfich, CFI, sf_symbols, sf_idx);
+    if (send_pdcch) {
+      srslte_dci_msg_pack_pdsch(&ra_dl, SRSLTE_DCI_FORMAT1, &dci_msg, cell.nof_prb, false);
+      if (srslte_pdcch_encode(&pdcch, &dci_msg, locations[sf_idx][0], inst->rnti, sf_symbols, sf_idx, CFI)) {
+        fprintf(stderr, "Error encoding DCI message\n");
+        exit(-1);
+      }
+    }
+    if (srslte_ra_dl_dci_to_grant(&ra_dl, cell.nof_prb, inst->rnti, &grant) ||
+        srslte_pdsch_cfg(&pdsch_cfg, cell, &grant, CFI, sf_idx, 0)) {
+      fprintf(stderr, "Error configuring PDSCH\n");
+      exit(-1);
+    }
+    srslte_softbuffer_tx_reset(&softbuffer_tx);
+    if (srslte_pdsch_encode(&pdsch, &pdsch_cfg, &softbuffer_tx, data_tx, sf_symbols)) {
+      fprintf(stderr, "Error encoding PDSCH\n");
+      exit(-1);
+    }
+    srslte_ofdm_tx_sf(&ifft, sf_buffer, output);
+
+    int nof_bits = srslte_ue_dl_decode_rnti(&ue_dl, output, data_rx, n, inst->rnti);
+    if (nof_bits == tbs && !memcmp(data_tx, data_rx, tbs/8)) {
+      inst->nof_decoded++;
+    } else {
+      INFO("Object %d: subframe %d (%s PDCCH) not decoded\n", inst->id, n, send_pdcch ? "with" : "without");
+      inst->nof_errors++;
+    }
+  }
+
+  srslte_ue_dl_free(&ue_dl);
+  srslte_ofdm_tx_free(&ifft);
+  srslte_refsignal_cs_free(&csr_signal);
+  srslte_softbuffer_tx_free(&softbuffer_tx);
+  srslte_pdsch_free(&pdsch);
+  srslte_pdcch_free(&pdcch);
+  srslte_pcfich_free(&pcfich);
+  srslte_regs_free(&regs);
+  free(sf_buffer);
+  free(output);
+  free(data_tx);
+  free(data_rx);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  pthread_t threads[MAX_NOF_INSTANCES];
+  instance_t instances[MAX_NOF_INSTANCES];
+  uint32_t nof_errors = 0;
+
+  parse_args(argc, argv);
+
+  if (nof_instances == 0 || nof_instances > MAX_NOF_INSTANCES) {
+    fprintf(stderr, "Number of objects must be between 1 and %d\n", MAX_NOF_INSTANCES);
+    exit(-1);
+  }
+
+  for (uint32_t i = 0; i < nof_instances; i++) {
+    instances[i].id = i;
+    instances[i].rnti = 1234 + 111*i;
+    instances[i].mcs = (mcs + 3*i)%29;
+    instances[i].nof_decoded = 0;
+    instances[i].nof_errors = 0;
+    if (pthread_create(&threads[i], NULL, instance_work, &instances[i])) {
+      perror("pthread_create");
+      exit(-1);
+    }
+  }
+  for (uint32_t i = 0; i < nof_instances; i++) {
+    pthread_join(threads[i], NULL);
+    printf("Object %d: RNTI %d, MCS %d, decoded %d/%d subframes\n", i, instances[i].rnti, instances[i].mcs,
+           instances[i].nof_decoded, nof_subframes);
+    nof_errors += instances[i].nof_errors;
+  }
+
+  if (nof_errors > 0) {
+    printf("Error: %d subframes not decoded\n", nof_errors);
+    exit(-1);
+  }
+  printf("Ok\n");
+  exit(0);
+}
@@ -42,10 +42,35 @@ const uint32_t nof_ue_formats = 2;
 static srslte_dci_format_t common_formats[] = {SRSLTE_DCI_FORMAT1A,SRSLTE_DCI_FORMAT1C};
 const uint32_t nof_common_formats = 2;
 
-// This define is used to enable or disable the usage of the last successful DCI to decode a subframe where DCI was not found.
+// This define is used to enable or disable by default the usage of the last successful DCI to decode a subframe where DCI was not found.
 #define ENABLE_USE_OF_LAST_SUFRAME 0
-static srslte_dci_msg_t last_dci_msg;
-static srslte_ra_mcs_t last_ra_mcs;
+
+static double ue_dl_elapsed_ms(struct timespec *start, struct timespec *end) {
+  return (end->tv_sec - start->tv_sec)*1000.0 + (end->tv_nsec - start->tv_nsec)/1000000.0;
+}
+
+// Copies the last DCI found for the RNTI into dci_msg, provided its reuse is enabled and it is not older than the
+// maximum age. Returns true if it was copied.
+static bool ue_dl_get_last_dci(srslte_ue_dl_t *q, uint16_t rnti, srslte_dci_msg_t *dci_msg) {
+  if(!q->use_last_dci || !q->last_dci.valid || q->last_dci.rnti != rnti) {
+    return false;
+  }
+  if(q->last_dci_max_age > 0 && ue_dl_elapsed_ms(&q->last_dci.timestamp, &q->decoding_start_timestamp) > (double)q->last_dci_max_age) {
+    q->last_dci.valid = false;
+    return false;
+  }
+  memcpy(dci_msg, &q->last_dci.dci_msg, sizeof(srslte_dci_msg_t));
+  return true;
+}
+
+static void ue_dl_store_last_dci(srslte_ue_dl_t *q, uint16_t rnti, srslte_dci_msg_t *dci_msg) {
+  if(q->use_last_dci) {
+    memcpy(&q->last_dci.dci_msg, dci_msg, sizeof(srslte_dci_msg_t));
+    q->last_dci.rnti = rnti;
+    q->last_dci.timestamp = q->decoding_start_timestamp;
+    q->last_dci.valid = true;
+  }
+}
 
 int srslte_ue_dl_init(srslte_ue_dl_t *q, srslte_cell_t cell) {
   return srslte_ue_dl_init_generic(q, cell, 0, false);
@@ -76,6 +101,8 @@ int srslte_ue_dl_init_generic(srslte_ue_dl_t *q, srslte_cell_t cell, uint32_t ph
     q->phy_id = phy_id;
     q->add_sch_to_front = add_sch_to_front;
     q->pss_len = SRSLTE_PSS_LEN;
+    q->use_last_dci = ENABLE_USE_OF_LAST_SUFRAME;
+    q->last_dci_max_age = SRSLTE_UE_DL_DEFAULT_LAST_DCI_MAX_AGE;
 
     if(srslte_ofdm_rx_init(&q->fft, q->cell.cp, q->cell.nof_prb)) {
       fprintf(stderr, "Error initiating FFT\n");
@@ -109,6 +136,10 @@ int srslte_ue_dl_init_generic(srslte_ue_dl_t *q, srslte_cell_t cell, uint32_t ph
       fprintf(stderr, "Error initiating soft buffer\n");
       goto clean_exit;
     }
+    if(srslte_ue_dl_set_harq_processes(q, SRSLTE_UE_DL_DEFAULT_HARQ_PROCESSES, SRSLTE_UE_DL_DEFAULT_HARQ_TIMEOUT)) {
+      fprintf(stderr, "Error initiating HARQ processes\n");
+      goto clean_exit;
+    }
     if(srslte_cfo_init(&q->sfo_correct, q->cell.nof_prb*SRSLTE_NRE)) {
       fprintf(stderr, "Error initiating SFO correct\n");
       goto clean_exit;
@@ -152,6 +183,9 @@ void srslte_ue_dl_free(srslte_ue_dl_t *q) {
     srslte_pdsch_free(&q->pdsch);
     srslte_cfo_free(&q->sfo_correct);
     srslte_softbuffer_rx_free_scatter(&q->softbuffer);
+    for(uint32_t i = 0; i < SRSLTE_RA_NOF_HARQ_PROCESSES_SCATTER; i++) {
+      srslte_softbuffer_rx_free_scatter(&q->harq[i].softbuffer);
+    }
     if(q->sf_symbols) {
       free(q->sf_symbols);
     }
@@ -188,6 +222,9 @@ void srslte_ue_dl_set_rnti(srslte_ue_dl_t *q, uint16_t rnti) {
 
 void srslte_ue_dl_reset(srslte_ue_dl_t *q) {
   srslte_softbuffer_rx_reset(&q->softbuffer);
+  srslte_ue_dl_reset_harq(q);
+  q->last_dci.valid = false;
+  srslte_chest_dl_start_burst(&q->chest);
   bzero(&q->pdsch_cfg, sizeof(srslte_pdsch_cfg_t));
 }
 
@@ -310,8 +347,7 @@ int srslte_ue_dl_decode_rnti(srslte_ue_dl_t *q, cf_t *input, uint8_t *data, uint
 
   q->found_dci = srslte_ue_dl_find_dl_dci(q, q->decoded_cfi, sf_idx, rnti, &dci_msg);
   // If DCI is not found but we already decoded a subframe, then, we try to use the last DCI to decode the data.
-  if(ENABLE_USE_OF_LAST_SUFRAME && q->nof_detected > 0 && q->found_dci == 0) {
-    memcpy((uint8_t*)&dci_msg, (uint8_t*)&last_dci_msg, sizeof(srslte_dci_msg_t));
+  if(q->found_dci == 0 && ue_dl_get_last_dci(q, rnti, &dci_msg)) {
     q->found_dci = 1;
   }
   if(q->found_dci == 1) {
@@ -363,10 +399,7 @@ int srslte_ue_dl_decode_rnti(srslte_ue_dl_t *q, cf_t *input, uint8_t *data, uint
   if(q->found_dci == 1 && ret == SRSLTE_SUCCESS) {
     q->nof_detected++; // If CFI is equal to expected, DCI is found and data is correctly decoded, then we increment the number of correctly decoded packets.
     // Store last found DCI.
-    if(ENABLE_USE_OF_LAST_SUFRAME && (q->pdsch_cfg.grant.mcs.mod != last_ra_mcs.mod || q->pdsch_cfg.grant.mcs.tbs != last_ra_mcs.tbs || q->pdsch_cfg.grant.mcs.idx != last_ra_mcs.idx)) {
-      memcpy((uint8_t*)&last_ra_mcs, (uint8_t*)&q->pdsch_cfg.grant.mcs, sizeof(srslte_ra_mcs_t));
-      memcpy((uint8_t*)&last_dci_msg, (uint8_t*)&dci_msg, sizeof(srslte_dci_msg_t));
-    }
+    ue_dl_store_last_dci(q, rnti, &dci_msg);
     return q->pdsch_cfg.grant.mcs.tbs;  // Transport Block (TB) size in bits.
   } else {
     return 0;
@@ -595,6 +628,15 @@ void srslte_ue_dl_set_cfo_csr(srslte_ue_dl_t *q, bool flag) {
   srslte_chest_dl_set_cfo_csr(&q->chest, flag);
 }
 
+void srslte_ue_dl_set_burst_tracking(srslte_ue_dl_t *q, bool enable) {
+  srslte_chest_dl_set_burst_tracking(&q->chest, enable, SRSLTE_CHEST_DL_DEFAULT_TRACK_MIN_GAIN,
+                                     SRSLTE_CHEST_DL_DEFAULT_TRACK_MAX_RESIDUAL);
+}
+
+void srslte_ue_dl_start_burst(srslte_ue_dl_t *q) {
+  srslte_chest_dl_start_burst(&q->chest);
+}
+
 //******************************************************************************
 //***************** Scatter system customized implementations ******************
 //******************************************************************************
@@ -606,6 +648,77 @@ void srslte_ue_dl_set_pss_length(srslte_ue_dl_t *q, uint32_t pss_len) {
   q->pss_len = pss_len;
 }
 
+void srslte_ue_dl_set_mcs_table(srslte_ue_dl_t *q, srslte_ra_dl_mcs_table_t mcs_table) {
+  q->mcs_table = mcs_table;
+}
+
+// Allocates the soft buffers of nof_processes DL HARQ processes and releases the ones not used anymore. The soft bits
+// of all the processes are discarded.
+int srslte_ue_dl_set_harq_processes(srslte_ue_dl_t *q, uint32_t nof_processes, uint32_t timeout_ms) {
+  if(nof_processes == 0 || nof_processes > SRSLTE_RA_NOF_HARQ_PROCESSES_SCATTER) {
+    UE_DL_ERROR("Invalid number of HARQ processes: %d. It has to be between 1 and %d.\n", nof_processes, SRSLTE_RA_NOF_HARQ_PROCESSES_SCATTER);
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  for(uint32_t i = nof_processes; i < q->nof_harq_processes; i++) {
+    srslte_softbuffer_rx_free_scatter(&q->harq[i].softbuffer);
+  }
+  for(uint32_t i = q->nof_harq_processes; i < nof_processes; i++) {
+    if(srslte_softbuffer_rx_init_scatter(&q->harq[i].softbuffer, q->cell.nof_prb)) {
+      UE_DL_ERROR("Error initiating soft buffer of HARQ process %d\n", i);
+      q->nof_harq_processes = i;
+      return SRSLTE_ERROR;
+    }
+  }
+  q->nof_harq_processes = nof_processes;
+  q->harq_timeout = timeout_ms;
+  srslte_ue_dl_reset_harq(q);
+  return SRSLTE_SUCCESS;
+}
+
+// Sets the HARQ process and the retransmission counter of the next TB when the PDCCH is not decoded, i.e., when they
+// are known by the MAC from its schedule instead of being signalled in the DCI. A counter of 0 starts a new TB.
+void srslte_ue_dl_set_harq_scatter(srslte_ue_dl_t *q, uint32_t harq_pid, uint32_t retx_cnt) {
+  q->harq_pid = harq_pid%SRSLTE_RA_NOF_HARQ_PROCESSES_SCATTER;
+  q->harq_retx_cnt = retx_cnt;
+}
+
+// Enables the decoding of subframes whose DCI was not found with the last DCI found for the same RNTI, as long as it is
+// not older than max_age_ms. A maximum age of 0 disables the age check.
+void srslte_ue_dl_set_last_dci_reuse(srslte_ue_dl_t *q, bool enable, uint32_t max_age_ms) {
+  q->use_last_dci = enable;
+  q->last_dci_max_age = max_age_ms;
+  q->last_dci.valid = false;
+}
+
+void srslte_ue_dl_reset_harq(srslte_ue_dl_t *q) {
+  for(uint32_t i = 0; i < q->nof_harq_processes; i++) {
+    q->harq[i].active = false;
+    q->harq[i].nof_tx = 0;
+  }
+  q->harq_pid = 0;
+  q->harq_retx_cnt = 0;
+}
+
+// Returns the HARQ process the TB belongs to. Its soft bits are discarded, i.e., a new TB starts, when the NDI toggles,
+// the TB size changes, the process timed out or its last TB was decoded. Otherwise the transmission is combined with
+// the previous ones.
+static srslte_ue_dl_harq_t *ue_dl_get_harq(srslte_ue_dl_t *q, srslte_ra_dl_dci_t *dci, uint32_t tbs) {
+  srslte_ue_dl_harq_t *harq = &q->harq[dci->harq_process%q->nof_harq_processes];
+  bool timed_out = q->harq_timeout > 0 && ue_dl_elapsed_ms(&harq->last_rx, &q->decoding_start_timestamp) > (double)q->harq_timeout;
+
+  // Format 1C does not carry HARQ information, so every transmission is decoded on its own.
+  if(!harq->active || harq->ndi != dci->ndi || harq->tbs != tbs || dci->rv_idx < 0 || timed_out) {
+    srslte_softbuffer_rx_reset_tbs(&harq->softbuffer, tbs);
+    harq->active = true;
+    harq->ndi = dci->ndi;
+    harq->tbs = tbs;
+    harq->nof_tx = 0;
+  }
+  harq->nof_tx++;
+  harq->last_rx = q->decoding_start_timestamp;
+  return harq;
+}
+
 unsigned int srslte_ue_dl_reverse(register unsigned int x) {
   x = (((x & 0xaaaaaaaa) >> 1) | ((x & 0x55555555) << 1));
   x = (((x & 0xcccccccc) >> 2) | ((x & 0x33333333) << 2));
@@ -645,6 +758,7 @@ int srslte_ue_dl_decode_rnti_scatter(srslte_ue_dl_t *q, cf_t *input, uint8_t *da
   srslte_dci_msg_t dci_msg;
   srslte_ra_dl_dci_t dci_unpacked;
   srslte_ra_dl_grant_t grant;
+  srslte_ue_dl_harq_t *harq;
   int ret = SRSLTE_ERROR;
 
   // Get the time when decoding started.
@@ -678,19 +792,23 @@ int srslte_ue_dl_decode_rnti_scatter(srslte_ue_dl_t *q, cf_t *input, uint8_t *da
     q->found_dci = srslte_ue_dl_find_dl_dci(q, q->decoded_cfi, sf_idx, rnti, &dci_msg);
 
     // If DCI is not found but we already decoded a subframe, then, we try to use the last DCI to decode the data.
-    if(ENABLE_USE_OF_LAST_SUFRAME && q->nof_detected > 0 && q->found_dci == 0) {
-      memcpy((uint8_t*)&dci_msg, (uint8_t*)&last_dci_msg, sizeof(srslte_dci_msg_t));
+    if(q->found_dci == 0 && ue_dl_get_last_dci(q, rnti, &dci_msg)) {
       q->found_dci = 1;
     }
   } else {
     q->found_dci = 1;
     srslte_ue_dl_update_radl(&ra_dl, mcs, q->cell.nof_prb);
+    // HARQ information set by the MAC. A retransmission counter of 0 toggles the NDI of the process, starting a new TB.
+    ra_dl.harq_process = q->harq_pid;
+    ra_dl.rv_idx = srslte_ra_rvidx_scatter(q->harq_retx_cnt);
+    ra_dl.ndi = (q->harq_retx_cnt == 0) != q->harq[q->harq_pid%q->nof_harq_processes].ndi;
     srslte_dci_msg_pack_pdsch(&ra_dl, SRSLTE_DCI_FORMAT1, &dci_msg, q->cell.nof_prb, false);
   }
 
   if(q->found_dci == 1) {
 
     // Convert DCI message into DL grant.
+    dci_unpacked.mcs_table = q->mcs_table;
     if(srslte_dci_msg_to_dl_grant_scatter(&dci_msg, rnti, q->cell.nof_prb, q->cell.nof_ports, &dci_unpacked, &grant)) {
       UE_DL_ERROR("Error unpacking DCI\n",0);
       return SRSLTE_ERROR;
@@ -703,11 +821,10 @@ int srslte_ue_dl_decode_rnti_scatter(srslte_ue_dl_t *q, cf_t *input, uint8_t *da
       uint32_t sfn = tti/10;
       uint32_t k   = (sfn/2)%4;
       rvidx        = ((uint32_t) ceilf((float)1.5*k))%4;
-      srslte_softbuffer_rx_reset_tbs(&q->softbuffer, grant.mcs.tbs);
     } else {
       rvidx = dci_unpacked.rv_idx;
-      srslte_softbuffer_rx_reset_tbs(&q->softbuffer, grant.mcs.tbs);
     }
+    harq = ue_dl_get_harq(q, &dci_unpacked, grant.mcs.tbs);
 
     if(srslte_ue_dl_cfg_grant_scatter(q, &grant, q->decoded_cfi, sf_idx, rvidx)) {
       return SRSLTE_ERROR;
@@ -720,11 +837,17 @@ int srslte_ue_dl_decode_rnti_scatter(srslte_ue_dl_t *q, cf_t *input, uint8_t *da
     q->noise_estimate = srslte_chest_dl_get_noise_estimate(&q->chest);
 
     if(q->pdsch_cfg.grant.mcs.mod > 0 && q->pdsch_cfg.grant.mcs.tbs >= 0) {
-      ret = srslte_pdsch_decode_rnti_scatter(&q->pdsch, &q->pdsch_cfg, &q->softbuffer,
+      ret = srslte_pdsch_decode_rnti_scatter(&q->pdsch, &q->pdsch_cfg, &harq->softbuffer,
                                              q->sf_symbols, q->ce,
                                              q->noise_estimate,
                                              rnti, data);
-      if(ret == SRSLTE_ERROR) {
+      if(ret == SRSLTE_SUCCESS) {
+        // The TB is complete, the next transmission of this process starts a new one.
+        harq->active = false;
+        if(harq->nof_tx > 1) {
+          q->harq_combined++;
+        }
+      } else if(ret == SRSLTE_ERROR) {
         q->pkt_errors++; // CFI is equal to the expected value and DCI was found but data was not correctly decoded.
       } else if(ret == SRSLTE_ERROR_INVALID_INPUTS) {
         UE_DL_ERROR("Error calling srslte_pdsch_decode()\n",0);
@@ -738,10 +861,7 @@ int srslte_ue_dl_decode_rnti_scatter(srslte_ue_dl_t *q, cf_t *input, uint8_t *da
   if(q->found_dci == 1 && ret == SRSLTE_SUCCESS) {
     q->nof_detected++; // If CFI is equal to expected, DCI is found and data is correctly decoded, then we increment the number of correctly decoded packets.
     // Store last found DCI.
-    if(ENABLE_USE_OF_LAST_SUFRAME && (q->pdsch_cfg.grant.mcs.mod != last_ra_mcs.mod || q->pdsch_cfg.grant.mcs.tbs != last_ra_mcs.tbs || q->pdsch_cfg.grant.mcs.idx != last_ra_mcs.idx)) {
-      memcpy((uint8_t*)&last_ra_mcs, (uint8_t*)&q->pdsch_cfg.grant.mcs, sizeof(srslte_ra_mcs_t));
-      memcpy((uint8_t*)&last_dci_msg, (uint8_t*)&dci_msg, sizeof(srslte_dci_msg_t));
-    }
+    ue_dl_store_last_dci(q, rnti, &dci_msg);
     return q->pdsch_cfg.grant.mcs.tbs;  // Transport Block (TB) size in bits.
   } else {
     return 0;
@@ -661,7 +661,7 @@ static int find_peak_ok(srslte_ue_sync_t *q, size_t channel) {
       // Here we align the subframe with the start of the buffer.
       memcpy((uint8_t*)q->input_buffer[q->subframe_buffer_counter], (uint8_t*)(q->input_buffer[q->subframe_buffer_counter]+offset), num_of_samples_to_copy*sizeof(cf_t));
       // We read samples if there still are samples to be read from USRP in order to complete the subframe IQ samples.
-      if(srslte_rf_recv_with_time(q->stream, (q->input_buffer[q->subframe_buffer_counter]+num_of_samples_to_copy), num_of_missing_samples, true, &(q->last_timestamp.full_secs), &(q->last_timestamp.frac_secs), channel) < 0) {
+      if(q->recv_callback(q->stream, (q->input_buffer[q->subframe_buffer_counter]+num_of_samples_to_copy), num_of_missing_samples, &q->last_timestamp, channel) < 0) {
         return SRSLTE_ERROR;
       }
     }
@@ -801,7 +801,7 @@ static inline int receive_samples_old(srslte_ue_sync_t *q, size_t channel) {
   //srslte_rf_get_time(q->stream, &full_secs, &frac_secs);
 
   // Get N subframes from the USRP getting more samples and keeping the previous samples, if any
-  if(srslte_rf_recv_with_time(q->stream, &q->input_buffer[q->subframe_buffer_counter][num_of_samples_to_stay], offset, true, &(q->last_timestamp.full_secs), &(q->last_timestamp.frac_secs), channel) < 0) {
+  if(q->recv_callback(q->stream, &q->input_buffer[q->subframe_buffer_counter][num_of_samples_to_stay], offset, &q->last_timestamp, channel) < 0) {
     UE_SYNC_ERROR("Error receive_samples at receive_samples() - subframe_buffer_counter: %d - num_of_samples_to_stay: %d - offset: %d\n", q->subframe_buffer_counter, num_of_samples_to_stay, offset);
     return SRSLTE_ERROR;
   }
@@ -863,7 +863,7 @@ static inline int receive_samples(srslte_ue_sync_t *q, size_t channel) {
   //srslte_rf_get_time(q->stream, &full_secs, &frac_secs);
 
   // Get N subframes from the USRP getting more samples and keeping the previous samples, if any
-  if(srslte_rf_recv_with_time(q->stream, &q->input_buffer[q->subframe_buffer_counter][num_of_samples_to_stay], offset, true, &(q->last_timestamp.full_secs), &(q->last_timestamp.frac_secs), channel) < 0) {
+  if(q->recv_callback(q->stream, &q->input_buffer[q->subframe_buffer_counter][num_of_samples_to_stay], offset, &q->last_timestamp, channel) < 0) {
     UE_SYNC_ERROR("PHY ID: %d - Error at receive_samples at receive_samples() - subframe_buffer_counter: %d - num_of_samples_to_stay: %d - offset: %d\n", channel, q->subframe_buffer_counter, num_of_samples_to_stay, offset);
     return SRSLTE_ERROR;
   }
@@ -903,7 +903,7 @@ static inline int receive_samples_after_peak_found(srslte_ue_sync_t *q, size_t c
   // Check if we still have to read more samples from USRP in order to have a full subframe in the buffer.
   if(q->num_of_samples_still_in_buffer < q->frame_len) {
     // Read samples from the USRP in order to have at least one full subframe in the buffer.
-    if(srslte_rf_recv_with_time(q->stream, (q->input_buffer[q->subframe_buffer_counter]+q->frame_len+q->num_of_samples_still_in_buffer), (q->sf_len-q->num_of_samples_still_in_buffer), true, &(q->last_timestamp.full_secs), &(q->last_timestamp.frac_secs), channel) < 0) {
+    if(q->recv_callback(q->stream, (q->input_buffer[q->subframe_buffer_counter]+q->frame_len+q->num_of_samples_still_in_buffer), (q->sf_len-q->num_of_samples_still_in_buffer), &q->last_timestamp, channel) < 0) {
       UE_SYNC_ERROR("Error receiving samples at receive_samples_after_peak_found() - subframe_buffer_counter: %d - num_of_samples_still_in_buffer: %d - num_of_samples_still_in_buffer: %d\n",q->subframe_buffer_counter,q->num_of_samples_still_in_buffer,q->num_of_samples_still_in_buffer);
       return SRSLTE_ERROR;
     }
@@ -1023,7 +1023,11 @@ int srslte_ue_synchronize(srslte_ue_sync_t *q, size_t channel) {
           float cfo_estimate = srslte_sync_get_cfo_new(&q->sfind);
           // Correct CFO based on the estimation done for the subframe via PSS or CP.
           if(fabs(cfo_estimate) > 0.01) { // Only correct if CFO is greater than or equal to 150 Hz (i.e., 0.01).
-#if(USE_FINE_GRAINED_CFO==1)
+#if(USE_ROTATOR_CFO==1)
+            srslte_cfo_correct_rotator((q->input_buffer[q->subframe_buffer_counter] + q->subframe_start_index),
+                          (q->input_buffer[q->subframe_buffer_counter] + q->subframe_start_index),
+                          -cfo_estimate / q->fft_size, 0, q->frame_len);
+#elif(USE_FINE_GRAINED_CFO==1)
             //UE_SYNC_PRINT("CFO before correction: %1.4f\n",cfo_estimate*15000.0);
             // Apply fine-grained CFO correction.
             srslte_cfo_correct_finer(&q->sfind.cfocorr_finer,
@@ -1077,7 +1081,11 @@ int srslte_ue_synchronize(srslte_ue_sync_t *q, size_t channel) {
           float cfo_estimate = srslte_sync_get_cfo_new(&q->sfind);
           // Correct CFO based on the estimation done for the subframe via PSS or CP.
           if(fabs(cfo_estimate) > 0.01) { // Only correct if CFO is greater than or equal to 150 Hz (i.e., 0.01).
-#if(USE_FINE_GRAINED_CFO==1)
+#if(USE_ROTATOR_CFO==1)
+            srslte_cfo_correct_rotator((q->input_buffer[q->subframe_buffer_counter] + q->subframe_start_index),
+                          (q->input_buffer[q->subframe_buffer_counter] + q->subframe_start_index),
+                          -cfo_estimate / q->fft_size, 0, q->frame_len);
+#elif(USE_FINE_GRAINED_CFO==1)
             // Apply fine-grained CFO correction.
             srslte_cfo_correct_finer(&q->sfind.cfocorr_finer,
                           (q->input_buffer[q->subframe_buffer_counter] + q->subframe_start_index),
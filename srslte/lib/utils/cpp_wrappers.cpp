@@ -121,6 +121,55 @@ int tx_cb_size(tx_cb_handle handle) {
   return static_cast<int>(handle->tx_cb_ptr->size());
 }
 
+bool tx_cb_full(tx_cb_handle handle) {
+  return handle->tx_cb_ptr->full();
+}
+
+//************************** Tx basic control deadline ordered queue ********************************
+void tx_pq_make(tx_pq_handle* handle, uint64_t size) {
+  *handle = new tx_pq_t;
+  (*handle)->tx_pq_ptr = new PriorityQueue<basic_ctrl_t, std::vector<basic_ctrl_t>, tx_deadline_later>();
+  (*handle)->capacity = size;
+}
+
+// Free all allocated resources.
+void tx_pq_free(tx_pq_handle* handle) {
+  PriorityQueue<basic_ctrl_t, std::vector<basic_ctrl_t>, tx_deadline_later> *ptr = ((*handle)->tx_pq_ptr);
+  delete ptr;
+  delete *handle;
+  *handle = NULL;
+}
+
+// Push basic control into queue, keeping it ordered by deadline. Returns false if the queue is full.
+bool tx_pq_push(tx_pq_handle handle, basic_ctrl_t* const basic_ctrl) {
+  if(handle->tx_pq_ptr->size() >= handle->capacity) {
+    return false;
+  }
+  handle->tx_pq_ptr->push_back(*basic_ctrl);
+  return true;
+}
+
+// Read basic control with the earliest deadline.
+void tx_pq_top(tx_pq_handle handle, basic_ctrl_t* const basic_ctrl) {
+  *basic_ctrl = handle->tx_pq_ptr->front();
+}
+
+void tx_pq_pop(tx_pq_handle handle) {
+  handle->tx_pq_ptr->pop_front();
+}
+
+bool tx_pq_empty(tx_pq_handle handle) {
+  return handle->tx_pq_ptr->empty();
+}
+
+int tx_pq_size(tx_pq_handle handle) {
+  return static_cast<int>(handle->tx_pq_ptr->size());
+}
+
+bool tx_pq_full(tx_pq_handle handle) {
+  return handle->tx_pq_ptr->size() >= handle->capacity;
+}
+
 //************************** Rx basic control Circular buffer ********************************
 void rx_param_cb_make(rx_param_cb_handle* handle, uint64_t size) {
   *handle = new rx_param_cb_t;
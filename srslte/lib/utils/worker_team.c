@@ -0,0 +1,141 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "srslte/utils/worker_team.h"
+
+// Takes tasks until there are none left. Must be called with the mutex locked, returns with it locked.
+static void run_tasks(srslte_worker_team_t *q, uint32_t worker_idx) {
+  while (q->next_task < q->nof_tasks) {
+    uint32_t task_idx = q->next_task++;
+    pthread_mutex_unlock(&q->mutex);
+    q->fn(q->arg, task_idx, worker_idx);
+    pthread_mutex_lock(&q->mutex);
+    q->nof_done++;
+    if (q->nof_done == q->nof_tasks) {
+      pthread_cond_signal(&q->done_cvar);
+    }
+  }
+}
+
+typedef struct {
+  srslte_worker_team_t *team;
+  uint32_t worker_idx;
+} worker_args_t;
+
+static void *worker_thread(void *arg) {
+  srslte_worker_team_t *q = ((worker_args_t*) arg)->team;
+  uint32_t worker_idx = ((worker_args_t*) arg)->worker_idx;
+  uint64_t generation = 0;
+
+  pthread_mutex_lock(&q->mutex);
+  while (q->running) {
+    if (q->generation == generation) {
+      pthread_cond_wait(&q->start_cvar, &q->mutex);
+      continue;
+    }
+    generation = q->generation;
+    run_tasks(q, worker_idx);
+  }
+  pthread_mutex_unlock(&q->mutex);
+  free(arg);
+  return NULL;
+}
+
+int srslte_worker_team_init(srslte_worker_team_t *q, uint32_t nof_workers) {
+  if (q == NULL || nof_workers == 0 || nof_workers > SRSLTE_WORKER_TEAM_MAX_WORKERS) {
+    return -1;
+  }
+  bzero(q, sizeof(srslte_worker_team_t));
+  q->nof_workers = nof_workers;
+  q->running = true;
+  pthread_mutex_init(&q->mutex, NULL);
+  pthread_cond_init(&q->start_cvar, NULL);
+  pthread_cond_init(&q->done_cvar, NULL);
+  for (uint32_t i = 1; i < nof_workers; i++) {
+    worker_args_t *args = malloc(sizeof(worker_args_t));
+    if (!args) {
+      srslte_worker_team_free(q);
+      return -1;
+    }
+    args->team = q;
+    args->worker_idx = i;
+    if (pthread_create(&q->threads[q->nof_threads], NULL, worker_thread, args)) {
+      perror("pthread_create");
+      free(args);
+      srslte_worker_team_free(q);
+      return -1;
+    }
+    q->nof_threads++;
+  }
+  return 0;
+}
+
+void srslte_worker_team_free(srslte_worker_team_t *q) {
+  if (q && q->nof_workers > 0) {
+    pthread_mutex_lock(&q->mutex);
+    q->running = false;
+    pthread_cond_broadcast(&q->start_cvar);
+    pthread_mutex_unlock(&q->mutex);
+    for (uint32_t i = 0; i < q->nof_threads; i++) {
+      pthread_join(q->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&q->mutex);
+    pthread_cond_destroy(&q->start_cvar);
+    pthread_cond_destroy(&q->done_cvar);
+    bzero(q, sizeof(srslte_worker_team_t));
+  }
+}
+
+void srslte_worker_team_run(srslte_worker_team_t *q, srslte_worker_team_fn_t fn, void *arg, uint32_t nof_tasks) {
+  if (nof_tasks == 0) {
+    return;
+  }
+  if (q->nof_threads == 0 || nof_tasks == 1) {
+    // Nothing to share, avoid waking up the threads.
+    for (uint32_t i = 0; i < nof_tasks; i++) {
+      fn(arg, i, 0);
+    }
+    return;
+  }
+  pthread_mutex_lock(&q->mutex);
+  q->fn = fn;
+  q->arg = arg;
+  q->nof_tasks = nof_tasks;
+  q->next_task = 0;
+  q->nof_done = 0;
+  q->generation++;
+  pthread_cond_broadcast(&q->start_cvar);
+  run_tasks(q, 0);
+  while (q->nof_done < q->nof_tasks) {
+    pthread_cond_wait(&q->done_cvar, &q->mutex);
+  }
+  pthread_mutex_unlock(&q->mutex);
+}